@@ -23,6 +23,7 @@
 #include "gflags/gflags.h"
 
 #include "paddle/fluid/distributed/common/utils.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 
 namespace paddle {
 namespace distributed {
@@ -134,39 +135,19 @@ class DAdam : public DenseOptimizer {
   void update(const float* update_values, size_t num, int begin,
               int end) override {
     auto update_numel = end - begin;
-    std::vector<float> grad, grad2, tmp;
-    grad.resize(update_numel);
-    grad2.resize(update_numel);
-    tmp.resize(update_numel);
-
-    auto blas = GetBlas<float>();
-    blas.VCOPY(update_numel, update_values + begin, grad.data());
-    blas.VCOPY(update_numel, update_values + begin, grad2.data());
-
-    blas.SCAL(update_numel, 1 - beta1, grad.data());
-    blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-    blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-    blas.SCAL(update_numel, beta1, moment1 + begin);
-    blas.VADD(update_numel, moment1 + begin, grad.data(), moment1 + begin);
-    blas.SCAL(update_numel, beta2, moment2 + begin);
-    blas.VADD(update_numel, moment2 + begin, grad2.data(), moment2 + begin);
-
     beta1_pow[0] = beta1_pow[0] * beta1;
     beta2_pow[0] = beta2_pow[0] * beta2;
-
     float lr_ = *(global_learning_rate_)*learning_rate[0];
-    lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
-
-    float* tmp_ = tmp.data();
-    float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
-
-    SQRT<float>(update_numel, moment2 + begin, tmp_);
-    ADD<float>(update_numel, tmp_, eps_, tmp_);
 
-    blas.VDIV(update_numel, moment1 + begin, tmp_, tmp_);
-    blas.SCAL(update_numel, lr_, tmp_);
-    blas.VSUB(update_numel, param + begin, tmp_, param + begin);
+    // [begin, end) is updated as one row.
+    const int64_t row = 0;
+    operators::jit::adam_attr_t attr(1, update_numel, 1, update_numel, 1,
+                                     beta1, beta2, epsilon);
+    auto adam = operators::jit::KernelFuncs<operators::jit::AdamTuple<float>,
+                                            platform::CPUPlace>::Cache()
+                    .At(attr);
+    adam(&lr_, beta1_pow, beta2_pow, update_values + begin, &row,
+         param + begin, moment1 + begin, moment2 + begin, &attr);
   }
 
   float* learning_rate;
@@ -25,6 +25,7 @@
 
 #include "paddle/fluid/distributed/common/utils.h"
 #include "paddle/fluid/distributed/table/depends/large_scale_kv.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 
 namespace paddle {
 namespace distributed {
@@ -159,7 +160,13 @@ class SAdam : public SparseOptimizer {
   void update(const uint64_t* keys, const float* update_values, size_t num,
               const std::vector<uint64_t>& offsets,
               ValueBlock* block) override {
-    auto blas = GetBlas<float>();
+    // Every value is updated as one row of update_numel.
+    const int64_t row = 0;
+    operators::jit::adam_attr_t attr(1, update_numel, 1, update_numel, 1,
+                                     beta1, beta2, epsilon);
+    auto adam = operators::jit::KernelFuncs<operators::jit::AdamTuple<float>,
+                                            platform::CPUPlace>::Cache()
+                    .At(attr);
     for (auto x : offsets) {
       auto id = keys[x];
       if (!block->GetEntry(id)) continue;
@@ -174,34 +181,8 @@ class SAdam : public SparseOptimizer {
       beta1_pow[0] = beta1_pow[0] * beta1;
       beta2_pow[0] = beta2_pow[0] * beta2;
 
-      lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
-
-      std::vector<float> grad, grad2, tmp;
-      grad.resize(update_numel);
-      grad2.resize(update_numel);
-      tmp.resize(update_numel);
-
-      blas.VCOPY(update_numel, update_values + x * update_numel, grad.data());
-      blas.VCOPY(update_numel, update_values + x * update_numel, grad2.data());
-
-      blas.SCAL(update_numel, 1 - beta1, grad.data());
-      blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-      blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-      blas.SCAL(update_numel, beta1, moment1);
-      blas.VADD(update_numel, moment1, grad.data(), moment1);
-      blas.SCAL(update_numel, beta2, moment2);
-      blas.VADD(update_numel, moment2, grad2.data(), moment2);
-
-      float* tmp_ = tmp.data();
-      float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
-
-      SQRT<float>(update_numel, moment2, tmp_);
-      ADD<float>(update_numel, tmp_, eps_, tmp_);
-
-      blas.VDIV(update_numel, moment1, tmp_, tmp_);
-      blas.SCAL(update_numel, lr_, tmp_);
-      blas.VSUB(update_numel, param, tmp_, param);
+      adam(&lr_, beta1_pow, beta2_pow, update_values + x * update_numel, &row,
+           param, moment1, moment2, &attr);
     }
   }
 
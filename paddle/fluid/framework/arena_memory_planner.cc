@@ -0,0 +1,82 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/arena_memory_planner.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+static size_t AlignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t PlanArenaOffsets(const std::vector<ArenaBuffer>& buffers,
+                        size_t alignment, std::vector<size_t>* offsets) {
+  PADDLE_ENFORCE_GT(alignment, 0,
+                    platform::errors::InvalidArgument(
+                        "The alignment of the arena should be positive."));
+  offsets->assign(buffers.size(), 0);
+
+  std::vector<size_t> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (buffers[a].size != buffers[b].size) {
+      return buffers[a].size > buffers[b].size;
+    }
+    return buffers[a].first_op < buffers[b].first_op;
+  });
+
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  std::vector<size_t> conflicts;
+  for (size_t id : order) {
+    const ArenaBuffer& buffer = buffers[id];
+    PADDLE_ENFORCE_LE(buffer.first_op, buffer.last_op,
+                      platform::errors::InvalidArgument(
+                          "The buffer is used from op %d to op %d.",
+                          buffer.first_op, buffer.last_op));
+    conflicts.clear();
+    for (size_t other : placed) {
+      if (buffers[other].first_op <= buffer.last_op &&
+          buffer.first_op <= buffers[other].last_op) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [&](size_t a, size_t b) {
+      return (*offsets)[a] < (*offsets)[b];
+    });
+
+    size_t offset = 0;
+    for (size_t other : conflicts) {
+      size_t other_offset = (*offsets)[other];
+      if (offset + buffer.size <= other_offset) {
+        break;
+      }
+      offset = std::max(
+          offset, AlignUp(other_offset + buffers[other].size, alignment));
+    }
+    (*offsets)[id] = offset;
+    arena_size = std::max(arena_size, offset + buffer.size);
+    placed.push_back(id);
+  }
+  return AlignUp(arena_size, alignment);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,38 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+// A buffer used from the first_op-th op to the last_op-th op, both inclusive.
+struct ArenaBuffer {
+  size_t first_op;
+  size_t last_op;
+  size_t size;
+};
+
+// Assign every buffer an offset in one arena, so that the buffers alive at
+// the same time never overlap. The buffers are placed from the largest one,
+// each at the lowest aligned offset which fits between the placed buffers
+// overlapping it in time. Returns the size of the arena.
+size_t PlanArenaOffsets(const std::vector<ArenaBuffer>& buffers,
+                        size_t alignment, std::vector<size_t>* offsets);
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,86 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/arena_memory_planner.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+static void CheckNoOverlap(const std::vector<ArenaBuffer>& buffers,
+                           const std::vector<size_t>& offsets,
+                           size_t arena_size, size_t alignment) {
+  ASSERT_EQ(offsets.size(), buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    EXPECT_EQ(offsets[i] % alignment, 0UL);
+    EXPECT_LE(offsets[i] + buffers[i].size, arena_size);
+    for (size_t j = i + 1; j < buffers.size(); ++j) {
+      bool alive_together = buffers[i].first_op <= buffers[j].last_op &&
+                            buffers[j].first_op <= buffers[i].last_op;
+      bool overlap = offsets[i] < offsets[j] + buffers[j].size &&
+                     offsets[j] < offsets[i] + buffers[i].size;
+      EXPECT_FALSE(alive_together && overlap)
+          << "buffer " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+TEST(ArenaMemoryPlanner, chain) {
+  // a -> b -> c -> d, every buffer is released after the next op, so two
+  // slots are enough.
+  std::vector<ArenaBuffer> buffers = {
+      {0, 1, 100}, {1, 2, 200}, {2, 3, 100}, {3, 4, 200}};
+  std::vector<size_t> offsets;
+  size_t arena_size = PlanArenaOffsets(buffers, 64, &offsets);
+  CheckNoOverlap(buffers, offsets, arena_size, 64);
+  EXPECT_EQ(arena_size, 384UL);
+  EXPECT_EQ(offsets[1], offsets[3]);
+  EXPECT_EQ(offsets[0], offsets[2]);
+}
+
+TEST(ArenaMemoryPlanner, fill_gap) {
+  // The small buffer fits in the gap left by the released second buffer.
+  std::vector<ArenaBuffer> buffers = {
+      {0, 4, 256}, {0, 1, 256}, {0, 4, 256}, {3, 4, 64}};
+  std::vector<size_t> offsets;
+  size_t arena_size = PlanArenaOffsets(buffers, 64, &offsets);
+  CheckNoOverlap(buffers, offsets, arena_size, 64);
+  EXPECT_EQ(arena_size, 768UL);
+  EXPECT_EQ(offsets[3], offsets[1]);
+}
+
+TEST(ArenaMemoryPlanner, random) {
+  std::mt19937 rng(0);
+  for (int round = 0; round < 20; ++round) {
+    std::vector<ArenaBuffer> buffers;
+    size_t total_size = 0;
+    for (int i = 0; i < 100; ++i) {
+      size_t first_op = rng() % 50;
+      size_t last_op = first_op + rng() % 10;
+      size_t size = 1 + rng() % 4096;
+      buffers.push_back(ArenaBuffer{first_op, last_op, size});
+      total_size += (size + 31) / 32 * 32;
+    }
+    std::vector<size_t> offsets;
+    size_t arena_size = PlanArenaOffsets(buffers, 32, &offsets);
+    CheckNoOverlap(buffers, offsets, arena_size, 32);
+    EXPECT_LE(arena_size, total_size);
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
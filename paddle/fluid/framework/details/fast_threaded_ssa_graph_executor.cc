@@ -13,7 +13,9 @@
 // limitations under the License.
 #include "paddle/fluid/framework/details/fast_threaded_ssa_graph_executor.h"
 
+#include <cstring>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -30,6 +32,8 @@ namespace paddle {
 namespace framework {
 namespace details {
 
+static constexpr size_t kNoOp = std::numeric_limits<size_t>::max();
+
 FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
     const ExecutionStrategy &strategy, const std::vector<Scope *> &local_scopes,
     const std::vector<Scope *> &local_exec_scopes,
@@ -39,9 +43,7 @@ FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
       local_exec_scopes_(local_exec_scopes),
       places_(places),
       graph_(graph),
-      fetch_ctxs_(places),
-      // add one more thread for generate op_deps
-      prepare_pool_(1) {
+      fetch_ctxs_(places) {
   if (ir::IsTopologySortOperationsUnique(*graph_)) {
     VLOG(10)
         << "Change thread number to 1 because the toposort order is unique";
@@ -57,17 +59,33 @@ FastThreadedSSAGraphExecutor::FastThreadedSSAGraphExecutor(
       traced_ops_.push_back(&node->Wrapper<OpHandleBase>());
     }
   }
-  for (auto &op : ir::FilterByNodeWrapper<OpHandleBase>(*graph_)) {
+  op_handles_ = ir::FilterByNodeWrapper<OpHandleBase>(*graph_);
+  num_graph_ops_ = op_handles_.size();
+  PADDLE_ENFORCE_GT(num_graph_ops_, 0,
+                    platform::errors::PreconditionNotMet(
+                        "The graph doesn't have operators."));
+  for (size_t i = 0; i < num_graph_ops_; ++i) {
+    op_ids_.emplace(op_handles_[i], i);
+  }
+
+  op_deps_.reserve(num_graph_ops_);
+  pending_offsets_.reserve(num_graph_ops_ + 1);
+  pending_offsets_.push_back(0);
+  for (size_t i = 0; i < num_graph_ops_; ++i) {
+    auto *op = op_handles_[i];
     int dep = static_cast<int>(op->NotReadyInputSize());
-    op_deps_.emplace(op, dep);
+    op_deps_.push_back(dep);
     if (dep == 0) {
-      bootstrap_ops_.emplace_back(op);
+      bootstrap_ops_.push_back(i);
+    }
+    for (auto *output : op->Outputs()) {
+      for (auto *pending_op : output->PendingOps()) {
+        pending_ops_.push_back(op_ids_.at(pending_op));
+      }
     }
+    pending_offsets_.push_back(pending_ops_.size());
   }
-  PADDLE_ENFORCE_GT(op_deps_.size(), 0,
-                    platform::errors::PreconditionNotMet(
-                        "The graph doesn't have operators."));
-  PrepareAtomicOpDeps();
+  fetch_pending_ops_.resize(num_graph_ops_);
 }
 
 FetchResultType FastThreadedSSAGraphExecutor::Run(
@@ -75,10 +93,8 @@ FetchResultType FastThreadedSSAGraphExecutor::Run(
   VLOG(3) << "enter FastThreadedSSAGraphExecutor Run";
   std::unique_ptr<platform::RecordEvent> event(
       new platform::RecordEvent("FastThreadedSSAGraphExecutorPrepare"));
-  std::unique_ptr<std::unordered_map<OpHandleBase *, std::atomic<int>>>
-      op_deps = atomic_op_deps_.get();
-  PrepareAtomicOpDeps();
-  size_t num_ops = op_deps->size();
+  op_handles_.resize(num_graph_ops_);
+  PrepareAtomicOpDeps(num_graph_ops_ + fetch_tensors.size());
 
   FetchResultType fetches;
   if (return_merged) {
@@ -88,12 +104,12 @@ FetchResultType FastThreadedSSAGraphExecutor::Run(
   }
   std::unordered_map<std::string, std::vector<VarHandleBase *>> fetched_vars;
   std::vector<OpHandleBase *> fetch_ops;
-  std::vector<OpHandleBase *> ready_fetch_ops;
+  std::vector<size_t> ready_fetch_ops;
   exception_.Clear();
-  InsertFetchOps(fetch_tensors, &fetches, &fetched_vars, op_deps.get(),
-                 &fetch_ops, &ready_fetch_ops, return_merged);
+  InsertFetchOps(fetch_tensors, &fetches, &fetched_vars, &fetch_ops,
+                 &ready_fetch_ops, return_merged);
   event.reset(nullptr);
-  if (strategy_.num_threads_ == 1 && traced_ops_.size() == num_ops) {
+  if (strategy_.num_threads_ == 1 && traced_ops_.size() == num_graph_ops_) {
     // If the num_threads is 1, we can record the order of operator's
     // execution in the first iteration, and in subsequent iterations,
     // run the recorded operators directly. This strategy could make the
@@ -106,37 +122,31 @@ FetchResultType FastThreadedSSAGraphExecutor::Run(
     }
   } else {
     traced_ops_.clear();
-    remaining_ = 0;
-    auto complete_q = std::make_shared<BlockingQueue<size_t>>();
+    num_complete_ = 0;
+    // Run holds a task itself until all the bootstrap ops are scheduled, so
+    // that the running tasks can not drop to zero before that.
+    remaining_ = 1;
     VLOG(3) << "number of bootstrap_ops_: " << bootstrap_ops_.size();
     VLOG(3) << "number of ready_fetch_ops: " << ready_fetch_ops.size();
-    for (auto op : bootstrap_ops_) {
-      RunOpAsync(op_deps.get(), op, complete_q);
+    for (auto op_id : bootstrap_ops_) {
+      RunOpAsync(op_id);
     }
-    for (auto op : ready_fetch_ops) {
-      RunOpAsync(op_deps.get(), op, complete_q);
+    for (auto op_id : ready_fetch_ops) {
+      RunOpAsync(op_id);
     }
-
-    size_t num_complete = 0;
-    while (num_complete != op_deps->size()) {
-      size_t num_comp = complete_q->Pop();
-      if (num_comp == -1UL) {
-        int remaining = 0;
-        while (true) {
-          remaining = remaining_;
-          if (remaining == 0) {
-            break;
-          }
-          for (int i = 0; i < remaining; ++i) {
-            complete_q->Pop();
-          }
-        }
-        if (exception_.IsCaught()) {
-          ExecutionFinal(&fetch_ops);
-        }
-      }
-      num_complete += num_comp;
+    FinishTask(0);
+    {
+      std::unique_lock<std::mutex> lock(finish_mutex_);
+      finish_cv_.wait(lock, [this] { return remaining_ == 0; });
     }
+    if (exception_.IsCaught()) {
+      ExecutionFinal(&fetch_ops);
+    }
+    PADDLE_ENFORCE_EQ(
+        num_complete_.load(), op_handles_.size(),
+        platform::errors::Fatal("%d of %d ops are completed, the rest ones "
+                                "are never ready.",
+                                num_complete_.load(), op_handles_.size()));
   }
   // Wait FetchOps.
   if (!fetch_ops.empty()) {
@@ -153,9 +163,13 @@ FetchResultType FastThreadedSSAGraphExecutor::Run(
 void FastThreadedSSAGraphExecutor::InsertFetchOps(
     const std::vector<std::string> &fetch_tensors, FetchResultType *fetches,
     std::unordered_map<std::string, std::vector<VarHandleBase *>> *fetched_vars,
-    std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
     std::vector<OpHandleBase *> *fetch_ops,
-    std::vector<OpHandleBase *> *ready_fetch_ops, bool return_merged) {
+    std::vector<size_t> *ready_fetch_ops, bool return_merged) {
+  for (auto op_id : fetch_generated_ops_) {
+    fetch_pending_ops_[op_id].clear();
+  }
+  fetch_generated_ops_.clear();
+
   std::unordered_set<std::string> fetch_tensor_set(fetch_tensors.begin(),
                                                    fetch_tensors.end());
   for (auto &fetch_var_name : fetch_tensor_set) {
@@ -192,6 +206,8 @@ void FastThreadedSSAGraphExecutor::InsertFetchOps(
     auto *op = new FetchAsyncOpHandle(fetch_node, fetches, i, &local_scopes_,
                                       &local_exec_scopes_, return_merged);
     fetch_ops->emplace_back(op);
+    size_t fetch_id = op_handles_.size();
+    op_handles_.push_back(op);
 
     for (auto &p : places_) {
       op->SetDeviceContext(p, fetch_ctxs_.Get(p));
@@ -207,19 +223,24 @@ void FastThreadedSSAGraphExecutor::InsertFetchOps(
       if (compute_op) {
         compute_op->SetLockAndRecordEventFree(false);
       }
+      if (op != nullptr) {
+        size_t op_id = op_ids_.at(op);
+        if (fetch_pending_ops_[op_id].empty()) {
+          fetch_generated_ops_.push_back(op_id);
+        }
+        fetch_pending_ops_[op_id].push_back(fetch_id);
+      }
     }
 
     int dep = static_cast<int>(op->NotReadyInputSize());
-    (*op_deps)[op] = dep;
+    atomic_op_deps_[fetch_id] = dep;
     if (dep == 0) {
-      ready_fetch_ops->emplace_back(op);
+      ready_fetch_ops->emplace_back(fetch_id);
     }
   }
 }
 
-bool FastThreadedSSAGraphExecutor::RunOp(
-    OpHandleBase *op, const std::shared_ptr<BlockingQueue<size_t>> &complete_q,
-    size_t *complete) {
+bool FastThreadedSSAGraphExecutor::RunOp(OpHandleBase *op, size_t *complete) {
   RunOpSync(op);
   if (LIKELY(!exception_.IsCaught())) {
     if (LIKELY(!strategy_.dry_run_)) {
@@ -228,25 +249,29 @@ bool FastThreadedSSAGraphExecutor::RunOp(
     ++(*complete);
     return true;
   } else {
-    --remaining_;
-    complete_q->Push(-1UL);
     return false;
   }
 }
 
-void FastThreadedSSAGraphExecutor::RunOpAsync(
-    std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
-    OpHandleBase *op,
-    const std::shared_ptr<BlockingQueue<size_t>> &complete_q) {
+void FastThreadedSSAGraphExecutor::FinishTask(size_t complete) {
+  num_complete_ += complete;
+  if (remaining_.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> guard(finish_mutex_);
+    finish_cv_.notify_one();
+  }
+}
+
+void FastThreadedSSAGraphExecutor::RunOpAsync(size_t op_id) {
   ++remaining_;
-  auto func = [=] {
-    std::deque<OpHandleBase *> op_queue;
-    op_queue.push_front(op);
+  auto func = [this, op_id] {
+    std::deque<size_t> op_queue;
+    op_queue.push_front(op_id);
 
     size_t complete = 0;
     while (!op_queue.empty()) {
-      OpHandleBase *op_to_run = op_queue.back();
+      size_t op_to_run = op_queue.back();
       op_queue.pop_back();
+      OpHandleBase *op = op_handles_[op_to_run];
 
       // The Op involves data transfer of multiple devices may block other
       // computations emit. For example:
@@ -257,47 +282,54 @@ void FastThreadedSSAGraphExecutor::RunOpAsync(
       // before scheduling.
       // In this scenario, calculation and communication may not overlap.
       // Therefore, emit the op in the queue before running multi device op.
-      if (op_to_run->IsMultiDeviceTransfer()) {
+      if (op->IsMultiDeviceTransfer()) {
         while (!op_queue.empty()) {
-          OpHandleBase *post_op = op_queue.back();
+          size_t post_op = op_queue.back();
           op_queue.pop_back();
-          RunOpAsync(op_deps, post_op, complete_q);
+          RunOpAsync(post_op);
         }
       }
-      VLOG(3) << "start to run op: " << op_to_run->Name();
-      if (!RunOp(op_to_run, complete_q, &complete)) {
+      VLOG(3) << "start to run op: " << op->Name();
+      if (!RunOp(op, &complete)) {
+        FinishTask(complete);
         return;
       }
-      auto &outputs = op_to_run->Outputs();
-      op_to_run = nullptr;
-      for (auto &output : outputs) {
-        for (auto &pending_op : output->PendingOps()) {
-          std::atomic<int> &deps = op_deps->at(pending_op);
-          if (deps.fetch_sub(1) != 1) continue;
-
-          // NOTE(zjl): op with highest priority should run
-          // first without switching to another thread.
-          if (pending_op->GetPriority() == OpHandleBase::Priority::kHighest) {
-            op_queue.push_back(pending_op);
-          } else if (pending_op->IsMultiDeviceTransfer()) {
-            // multi device ops should be scheduled prior to computing ops
-            op_queue.push_front(pending_op);
+      size_t next_op = kNoOp;
+      auto schedule = [&](size_t pending_id) {
+        if (atomic_op_deps_[pending_id].fetch_sub(1) != 1) return;
+
+        OpHandleBase *pending_op = op_handles_[pending_id];
+        // NOTE(zjl): op with highest priority should run
+        // first without switching to another thread.
+        if (pending_op->GetPriority() == OpHandleBase::Priority::kHighest) {
+          op_queue.push_back(pending_id);
+        } else if (pending_op->IsMultiDeviceTransfer()) {
+          // multi device ops should be scheduled prior to computing ops
+          op_queue.push_front(pending_id);
+        } else {
+          if (next_op == kNoOp) {
+            next_op = pending_id;
           } else {
-            if (op_to_run == nullptr) {
-              op_to_run = pending_op;
-            } else {
-              RunOpAsync(op_deps, pending_op, complete_q);
-            }
+            RunOpAsync(pending_id);
           }
         }
+      };
+      // The fetch ops have no pending ops.
+      if (op_to_run < num_graph_ops_) {
+        for (size_t i = pending_offsets_[op_to_run];
+             i < pending_offsets_[op_to_run + 1]; ++i) {
+          schedule(pending_ops_[i]);
+        }
+        for (size_t fetch_id : fetch_pending_ops_[op_to_run]) {
+          schedule(fetch_id);
+        }
       }
 
-      if (op_to_run != nullptr) {
-        op_queue.push_front(op_to_run);
+      if (next_op != kNoOp) {
+        op_queue.push_front(next_op);
       }
     }
-    --remaining_;
-    complete_q->Push(complete);
+    FinishTask(complete);
   };
   if (pool_) {
     pool_->enqueue(func);
@@ -306,15 +338,17 @@ void FastThreadedSSAGraphExecutor::RunOpAsync(
   }
 }
 
-void FastThreadedSSAGraphExecutor::PrepareAtomicOpDeps() {
-  atomic_op_deps_ = prepare_pool_.enqueue([&] {
-    auto *op_deps = new std::unordered_map<OpHandleBase *, std::atomic<int>>;
-    for (auto &pair : op_deps_) {
-      (*op_deps)[pair.first] = pair.second;
-    }
-    return std::unique_ptr<
-        std::unordered_map<OpHandleBase *, std::atomic<int>>>(op_deps);
-  });
+void FastThreadedSSAGraphExecutor::PrepareAtomicOpDeps(size_t num_ops) {
+  static_assert(sizeof(std::atomic<int>) == sizeof(int),
+                "The counters are reset by copying the int dependencies.");
+  if (atomic_op_deps_capacity_ < num_ops) {
+    atomic_op_deps_.reset(new std::atomic<int>[num_ops]);
+    atomic_op_deps_capacity_ = num_ops;
+  }
+  // The tasks reading the counters are scheduled after this, through the
+  // locked queue of the thread pool.
+  std::memcpy(static_cast<void *>(atomic_op_deps_.get()), op_deps_.data(),
+              num_graph_ops_ * sizeof(int));
 }
 
 const ir::Graph &FastThreadedSSAGraphExecutor::Graph() const { return *graph_; }
@@ -14,11 +14,13 @@
 
 #pragma once
 #include <ThreadPool.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include "paddle/fluid/framework/blocking_queue.h"
 #include "paddle/fluid/framework/details/exception_holder.h"
 #include "paddle/fluid/framework/details/execution_strategy.h"
 #include "paddle/fluid/framework/details/ssa_graph_executor.h"
@@ -49,31 +51,45 @@ class FastThreadedSSAGraphExecutor : public SSAGraphExecutor {
   std::vector<platform::Place> places_;
   ir::Graph *graph_;
 
-  std::unordered_map<OpHandleBase *, int> op_deps_;
-  std::vector<OpHandleBase *> bootstrap_ops_;
+  // The op handles are numbered when the executor is built, the ops of the
+  // graph come first and the fetch ops of a run follow them.
+  std::vector<OpHandleBase *> op_handles_;
+  size_t num_graph_ops_{0};
+  std::unordered_map<OpHandleBase *, size_t> op_ids_;
+  // The pending ops of the graph op i are
+  // pending_ops_[pending_offsets_[i], pending_offsets_[i + 1]).
+  std::vector<size_t> pending_offsets_;
+  std::vector<size_t> pending_ops_;
+  // The fetch ops of the current run waiting for the graph op.
+  std::vector<std::vector<size_t>> fetch_pending_ops_;
+  std::vector<size_t> fetch_generated_ops_;
+  std::vector<int> op_deps_;
+  std::vector<size_t> bootstrap_ops_;
 
   platform::DeviceContextPool fetch_ctxs_;
-  std::atomic<int> remaining_;
 
-  std::future<
-      std::unique_ptr<std::unordered_map<OpHandleBase *, std::atomic<int>>>>
-      atomic_op_deps_;
+  // The dependency counters of a run, reset from op_deps_ by one memcpy.
+  std::unique_ptr<std::atomic<int>[]> atomic_op_deps_;
+  size_t atomic_op_deps_capacity_{0};
+
+  // The number of the running tasks, the last one finishing wakes up Run.
+  std::atomic<int> remaining_{0};
+  std::atomic<size_t> num_complete_{0};
+  std::mutex finish_mutex_;
+  std::condition_variable finish_cv_;
   ExceptionHolder exception_;
 
   std::unique_ptr<::ThreadPool> pool_;
-  ::ThreadPool prepare_pool_;
 
   std::vector<OpHandleBase *> traced_ops_;
 
-  bool RunOp(OpHandleBase *op,
-             const std::shared_ptr<BlockingQueue<size_t>> &complete_q,
-             size_t *complete);
+  bool RunOp(OpHandleBase *op, size_t *complete);
+
+  void RunOpAsync(size_t op_id);
 
-  void RunOpAsync(std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
-                  OpHandleBase *op,
-                  const std::shared_ptr<BlockingQueue<size_t>> &complete_q);
+  inline void FinishTask(size_t complete);
 
-  void PrepareAtomicOpDeps();
+  void PrepareAtomicOpDeps(size_t num_ops);
 
   inline void RecordOps(OpHandleBase *op);
 
@@ -87,9 +103,8 @@ class FastThreadedSSAGraphExecutor : public SSAGraphExecutor {
       const std::vector<std::string> &fetch_tensors, FetchResultType *fetches,
       std::unordered_map<std::string, std::vector<VarHandleBase *>>
           *fetched_vars,
-      std::unordered_map<OpHandleBase *, std::atomic<int>> *op_deps,
       std::vector<OpHandleBase *> *fetch_ops,
-      std::vector<OpHandleBase *> *ready_fetch_ops, bool return_merged);
+      std::vector<size_t> *ready_fetch_ops, bool return_merged);
 };
 }  // namespace details
 }  // namespace framework
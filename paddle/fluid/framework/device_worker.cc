@@ -133,9 +133,16 @@ void DeviceWorker::DumpField(const Scope& scope, int dump_mode,
                                                    // 1: random with insid hash,
                                                    // 2: random with random
                                                    // number
-  size_t batch_size = device_reader_->GetCurBatchSize();
-  auto& ins_id_vec = device_reader_->GetInsIdVec();
-  auto& ins_content_vec = device_reader_->GetInsContentVec();
+  DumpFieldOfBatch(scope, dump_mode, dump_interval,
+                   device_reader_->GetCurBatchSize(),
+                   device_reader_->GetInsIdVec(),
+                   device_reader_->GetInsContentVec());
+}
+
+void DeviceWorker::DumpFieldOfBatch(
+    const Scope& scope, int dump_mode, int dump_interval, size_t batch_size,
+    const std::vector<std::string>& ins_id_vec,
+    const std::vector<std::string>& ins_content_vec) {
   if (ins_id_vec.size() > 0) {
     batch_size = ins_id_vec.size();
   }
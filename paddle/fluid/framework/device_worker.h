@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <atomic>
+#include <exception>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -205,6 +206,12 @@ class DeviceWorker {
   virtual void DumpParam(const Scope& scope, const int batch_id);
   virtual void DumpField(const Scope& scope, int dump_mode,
                          int dump_interval = 10000);
+  // dump the fields of a batch whose ins ids are given instead of read
+  // from device_reader_, e.g. when the reader runs ahead of the compute
+  void DumpFieldOfBatch(const Scope& scope, int dump_mode, int dump_interval,
+                        size_t batch_size,
+                        const std::vector<std::string>& ins_id_vec,
+                        const std::vector<std::string>& ins_content_vec);
   Scope* root_scope_ = nullptr;
   Scope* thread_scope_;
   paddle::platform::Place place_;
@@ -276,10 +283,11 @@ class HogwildWorker : public CPUWorkerBase {
 class DownpourWorker : public HogwildWorker {
  public:
   DownpourWorker() {}
-  virtual ~DownpourWorker() {}
+  virtual ~DownpourWorker() { StopPrefetch(); }
   virtual void Initialize(const TrainerDesc& desc);
   virtual void TrainFiles();
   virtual void TrainFilesWithProfiler();
+  virtual void BindingDataFeedMemory();
 
  protected:
   std::shared_ptr<paddle::framework::FleetWrapper> fleet_ptr_;
@@ -291,6 +299,31 @@ class DownpourWorker : public HogwildWorker {
   void CopySparseTable();
   void CopyDenseTable();
   void CopyDenseVars();
+  // pipeline mode: a batch read and pulled ahead of the compute
+  struct PrefetchedBatch {
+    int batch_size = 0;
+    std::unique_ptr<Scope> scope;
+    std::map<uint64_t, std::vector<uint64_t>> features;
+    std::map<uint64_t, std::vector<std::vector<float>>> feature_values;
+    std::vector<std::string> ins_ids;
+    std::vector<std::string> ins_contents;
+    std::exception_ptr error;
+  };
+  // pipeline mode: start / join the thread that runs PrefetchLoop
+  void StartPrefetch();
+  void StopPrefetch();
+  // takes free batches, fills them by PrefetchBatch and queues them to
+  // ready_batches_ until the reader is exhausted
+  void PrefetchLoop();
+  // reads a batch into prefetch_scope_, moves it into batch->scope and
+  // pulls its sparse values, returns the batch size
+  int PrefetchBatch(PrefetchedBatch* batch);
+  // moves the next ready batch into thread_scope_, returns its size
+  int NextPrefetchedBatch();
+  // waits for the oldest pushes beyond max_inflight_push_
+  void WaitPushStatus(std::vector<::std::future<int32_t>>* status);
+  // waits for all the pushes left at the end of the training, if bounded
+  void DrainPushStatus(std::vector<::std::future<int32_t>>* status);
 
   DownpourWorkerParameter param_;
   // copy table
@@ -332,6 +365,21 @@ class DownpourWorker : public HogwildWorker {
   std::map<int32_t, uint64_t> cond2table_map_;
   std::set<uint64_t> condvalue_set_;
   bool flag_partial_push_;
+  // pipeline of read / pull sparse / compute / push
+  bool pipeline_pull_sparse_ = false;
+  size_t max_inflight_push_ = 0;
+  // the feed vars bound to device_reader_, each batch read into them is
+  // moved into the scope of a PrefetchedBatch
+  std::unique_ptr<Scope> prefetch_scope_;
+  std::vector<std::string> prefetch_feed_names_;
+  // all prefetch batches, at most this many batches are read ahead
+  std::vector<std::shared_ptr<PrefetchedBatch>> prefetch_batches_;
+  Channel<std::shared_ptr<PrefetchedBatch>> free_batches_;
+  Channel<std::shared_ptr<PrefetchedBatch>> ready_batches_;
+  std::thread prefetch_thread_;
+  // ins ids of the batch in thread_scope_, for DumpFieldOfBatch
+  std::vector<std::string> cur_ins_ids_;
+  std::vector<std::string> cur_ins_contents_;
 
  private:
   // std::vector<std::string> dump_param_;
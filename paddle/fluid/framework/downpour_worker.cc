@@ -12,6 +12,9 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
+#include <future>  // NOLINT
+
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 
@@ -30,6 +33,10 @@ class Variable;
 namespace paddle {
 namespace framework {
 
+// number of batches the prefetch thread may read and pull ahead of the
+// compute in pipeline mode
+static constexpr size_t kPrefetchBatchNum = 2;
+
 void DownpourWorker::Initialize(const TrainerDesc& desc) {
   param_ = desc.downpour_param();
   for (int i = 0; i < param_.sparse_table_size(); ++i) {
@@ -83,6 +90,9 @@ void DownpourWorker::Initialize(const TrainerDesc& desc) {
 
   need_to_push_sparse_ = param_.push_sparse();
   need_to_push_dense_ = param_.push_dense();
+  pipeline_pull_sparse_ = param_.pipeline_pull_sparse();
+  max_inflight_push_ =
+      static_cast<size_t>(std::max(param_.max_inflight_push(), 0));
 
   fleet_ptr_ = FleetWrapper::GetInstance();
   fetch_config_ = desc.fetch_config();
@@ -122,6 +132,163 @@ void DownpourWorker::Initialize(const TrainerDesc& desc) {
   }
 }
 
+void DownpourWorker::BindingDataFeedMemory() {
+  if (pipeline_pull_sparse_ && copy_table_config_.need_copy()) {
+    // copied tables must be ready before the pull of each batch
+    LOG(WARNING) << "pipeline_pull_sparse is disabled with copy_table_config";
+    pipeline_pull_sparse_ = false;
+  }
+  if (!pipeline_pull_sparse_) {
+    HogwildWorker::BindingDataFeedMemory();
+    return;
+  }
+  // the reader always fills prefetch_scope_, PrefetchBatch moves each batch
+  // into a PrefetchedBatch and NextPrefetchedBatch into thread_scope_
+  prefetch_scope_.reset(new Scope());
+  prefetch_feed_names_.clear();
+  const std::vector<std::string>& input_feed =
+      device_reader_->GetUseSlotAlias();
+  for (auto name : input_feed) {
+    if (thread_scope_->FindVar(name) == nullptr) {
+      device_reader_->AddFeedVar(nullptr, name);
+      continue;
+    }
+    device_reader_->AddFeedVar(prefetch_scope_->Var(name), name);
+    prefetch_feed_names_.push_back(name);
+  }
+  prefetch_batches_.resize(kPrefetchBatchNum);
+  for (auto& batch : prefetch_batches_) {
+    batch = std::make_shared<PrefetchedBatch>();
+    batch->scope.reset(new Scope());
+    for (auto& name : prefetch_feed_names_) {
+      batch->scope->Var(name);
+    }
+    // PullSparseVarsSync skips slots without embedding var in scope, keep
+    // the same slots as thread_scope_ so that FillSparseValue lines up
+    for (auto& it : sparse_value_names_) {
+      for (auto& name : it.second) {
+        if (thread_scope_->FindVar(name) != nullptr) {
+          batch->scope->Var(name);
+        }
+      }
+    }
+  }
+}
+
+void DownpourWorker::StartPrefetch() {
+  free_batches_ = MakeChannel<std::shared_ptr<PrefetchedBatch>>();
+  ready_batches_ = MakeChannel<std::shared_ptr<PrefetchedBatch>>();
+  free_batches_->Write(prefetch_batches_);
+  prefetch_thread_ = std::thread(&DownpourWorker::PrefetchLoop, this);
+}
+
+void DownpourWorker::StopPrefetch() {
+  if (!prefetch_thread_.joinable()) {
+    return;
+  }
+  // wakes up the prefetch thread if the compute stopped early
+  free_batches_->Close();
+  ready_batches_->Close();
+  prefetch_thread_.join();
+}
+
+void DownpourWorker::PrefetchLoop() {
+  std::shared_ptr<PrefetchedBatch> batch;
+  while (free_batches_->Get(batch)) {
+    try {
+      batch->batch_size = PrefetchBatch(batch.get());
+    } catch (...) {
+      batch->batch_size = 0;
+      batch->error = std::current_exception();
+    }
+    bool finished = batch->batch_size <= 0;
+    ready_batches_->Put(std::move(batch));
+    if (finished) {
+      break;
+    }
+  }
+}
+
+int DownpourWorker::PrefetchBatch(PrefetchedBatch* batch) {
+  int batch_size = device_reader_->Next();
+  if (batch_size <= 0) {
+    return batch_size;
+  }
+  for (auto& name : prefetch_feed_names_) {
+    std::swap(*batch->scope->FindVar(name)->GetMutable<LoDTensor>(),
+              *prefetch_scope_->FindVar(name)->GetMutable<LoDTensor>());
+  }
+  if (need_dump_field_) {
+    batch->ins_ids = device_reader_->GetInsIdVec();
+    batch->ins_contents = device_reader_->GetInsContentVec();
+  }
+  for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
+       ++i) {
+    uint64_t tid = static_cast<uint64_t>(
+        param_.program_config(0).pull_sparse_table_id(i));
+    TableParameter table;
+    for (auto j : param_.sparse_table()) {
+      if (j.table_id() == tid) {
+        table = j;
+        break;
+      }
+    }
+    fleet_ptr_->PullSparseVarsSync(
+        *batch->scope, tid, sparse_key_names_.at(tid), &batch->features[tid],
+        &batch->feature_values[tid], table.fea_dim(),
+        sparse_value_names_.at(tid));
+  }
+  return batch_size;
+}
+
+int DownpourWorker::NextPrefetchedBatch() {
+  std::shared_ptr<PrefetchedBatch> batch;
+  if (!ready_batches_->Get(batch)) {
+    return 0;
+  }
+  std::exception_ptr error = batch->error;
+  batch->error = nullptr;
+  int batch_size = batch->batch_size;
+  if (batch_size > 0) {
+    for (auto& name : prefetch_feed_names_) {
+      std::swap(*thread_scope_->FindVar(name)->GetMutable<LoDTensor>(),
+                *batch->scope->FindVar(name)->GetMutable<LoDTensor>());
+    }
+    features_.swap(batch->features);
+    feature_values_.swap(batch->feature_values);
+    cur_ins_ids_.swap(batch->ins_ids);
+    cur_ins_contents_.swap(batch->ins_contents);
+  }
+  free_batches_->Put(std::move(batch));
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return batch_size;
+}
+
+void DownpourWorker::WaitPushStatus(
+    std::vector<::std::future<int32_t>>* status) {
+  if (max_inflight_push_ == 0 || status->size() <= max_inflight_push_) {
+    return;
+  }
+  size_t wait_num = status->size() - max_inflight_push_;
+  for (size_t i = 0; i < wait_num; ++i) {
+    (*status)[i].wait();
+  }
+  status->erase(status->begin(), status->begin() + wait_num);
+}
+
+void DownpourWorker::DrainPushStatus(
+    std::vector<::std::future<int32_t>>* status) {
+  if (max_inflight_push_ == 0) {
+    return;
+  }
+  for (auto& t : *status) {
+    t.wait();
+  }
+  status->resize(0);
+}
+
 void DownpourWorker::CollectLabelInfo(size_t table_idx) {
   if (no_cvm_) {
     return;
@@ -477,8 +644,13 @@ void DownpourWorker::TrainFilesWithProfiler() {
   int cur_batch;
   int batch_cnt = 0;
   uint64_t total_inst = 0;
+  if (prefetch_scope_ != nullptr) {
+    StartPrefetch();
+  }
   timeline.Start();
-  while ((cur_batch = device_reader_->Next()) > 0) {
+  while ((cur_batch = prefetch_scope_ != nullptr ? NextPrefetchedBatch()
+                                                 : device_reader_->Next()) >
+         0) {
     timeline.Pause();
     read_time += timeline.ElapsedSec();
     total_time += timeline.ElapsedSec();
@@ -509,9 +681,11 @@ void DownpourWorker::TrainFilesWithProfiler() {
         }
       }
       timeline.Start();
-      fleet_ptr_->PullSparseVarsSync(
-          *thread_scope_, tid, sparse_key_names_[tid], &features_[tid],
-          &feature_values_[tid], table.fea_dim(), sparse_value_names_[tid]);
+      if (prefetch_scope_ == nullptr) {
+        fleet_ptr_->PullSparseVarsSync(
+            *thread_scope_, tid, sparse_key_names_[tid], &features_[tid],
+            &feature_values_[tid], table.fea_dim(), sparse_value_names_[tid]);
+      }
       timeline.Pause();
       pull_sparse_time += timeline.ElapsedSec();
       total_time += timeline.ElapsedSec();
@@ -653,7 +827,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
         push_sparse_status_.resize(0);
       }
 
-      if (tmp_push_sparse_wait_times == -1) {
+      if (tmp_push_sparse_wait_times == -1 && max_inflight_push_ == 0) {
         push_sparse_status_.resize(0);
       }
 
@@ -661,6 +835,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
       VLOG(3) << "push dense table id size: "
               << param_.program_config(0).push_dense_table_id_size();
     }
+    WaitPushStatus(&push_sparse_status_);
 
     if (need_to_push_dense_) {
       for (int i = 0; i < param_.program_config(0).push_dense_table_id_size();
@@ -730,6 +905,8 @@ void DownpourWorker::TrainFilesWithProfiler() {
     }
     timeline.Start();
   }
+  StopPrefetch();
+  DrainPushStatus(&push_sparse_status_);
   if (copy_table_config_.need_copy()) {
     CopySparseTable();
     CopyDenseTable();
@@ -743,7 +920,12 @@ void DownpourWorker::TrainFiles() {
   device_reader_->Start();
   int batch_cnt = 0;
   int cur_batch;
-  while ((cur_batch = device_reader_->Next()) > 0) {
+  if (prefetch_scope_ != nullptr) {
+    StartPrefetch();
+  }
+  while ((cur_batch = prefetch_scope_ != nullptr ? NextPrefetchedBatch()
+                                                 : device_reader_->Next()) >
+         0) {
     if (copy_table_config_.need_copy()) {
       if (batch_cnt % copy_table_config_.batch_num() == 0) {
         CopySparseTable();
@@ -751,7 +933,7 @@ void DownpourWorker::TrainFiles() {
         CopyDenseVars();
       }
     }
-    // pull sparse here
+    // pull sparse here, already done by the prefetch thread in pipeline mode
     for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
          ++i) {
       uint64_t tid = static_cast<uint64_t>(
@@ -763,9 +945,11 @@ void DownpourWorker::TrainFiles() {
           break;
         }
       }
-      fleet_ptr_->PullSparseVarsSync(
-          *thread_scope_, tid, sparse_key_names_[tid], &features_[tid],
-          &feature_values_[tid], table.fea_dim(), sparse_value_names_[tid]);
+      if (prefetch_scope_ == nullptr) {
+        fleet_ptr_->PullSparseVarsSync(
+            *thread_scope_, tid, sparse_key_names_[tid], &features_[tid],
+            &feature_values_[tid], table.fea_dim(), sparse_value_names_[tid]);
+      }
       CollectLabelInfo(i);
       FillSparseValue(i);
       auto nid_iter = std::find(sparse_value_names_[tid].begin(),
@@ -955,10 +1139,11 @@ void DownpourWorker::TrainFiles() {
         push_sparse_status_.resize(0);
       }
 
-      if (tmp_push_sparse_wait_times == -1) {
+      if (tmp_push_sparse_wait_times == -1 && max_inflight_push_ == 0) {
         push_sparse_status_.resize(0);
       }
     }
+    WaitPushStatus(&push_sparse_status_);
 
     if (need_to_push_dense_) {
       for (int i = 0; i < param_.program_config(0).push_dense_table_id_size();
@@ -969,7 +1154,13 @@ void DownpourWorker::TrainFiles() {
       }
     }
     if (need_dump_field_) {
-      DumpField(*thread_scope_, dump_mode_, dump_interval_);
+      if (prefetch_scope_ != nullptr) {
+        // the reader is already ahead of this batch
+        DumpFieldOfBatch(*thread_scope_, dump_mode_, dump_interval_,
+                         cur_batch, cur_ins_ids_, cur_ins_contents_);
+      } else {
+        DumpField(*thread_scope_, dump_mode_, dump_interval_);
+      }
     }
     if (need_dump_param_ && thread_id_ == 0) {
       DumpParam(*thread_scope_, batch_cnt);
@@ -979,6 +1170,8 @@ void DownpourWorker::TrainFiles() {
     thread_scope_->DropKids();
     ++batch_cnt;
   }
+  StopPrefetch();
+  DrainPushStatus(&push_sparse_status_);
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
   }
@@ -0,0 +1,240 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/data_feed_factory.h"
+#include "paddle/fluid/framework/device_worker.h"
+#include "paddle/fluid/framework/program_desc.h"
+
+namespace paddle {
+namespace framework {
+
+// records the batches seen by the compute, which run no op. With
+// fake_push_ it also records the sparse pushes still in flight after each
+// batch and adds a pending one, since the pushes are no-op without PSLIB
+class TestDownpourWorker : public DownpourWorker {
+ public:
+  void PrintFetchVars() override {
+    auto& words = thread_scope_->FindVar("words")->Get<LoDTensor>();
+    batches_.emplace_back(words.data<int64_t>(),
+                          words.data<int64_t>() + words.numel());
+    if (fake_push_) {
+      inflight_push_.push_back(push_sparse_status_.size());
+      push_sparse_status_.push_back(std::async(std::launch::deferred, [this] {
+        ++waited_push_;
+        return 0;
+      }));
+    }
+  }
+  using DownpourWorker::WaitPushStatus;
+
+  bool fake_push_ = false;
+  std::vector<std::vector<int64_t>> batches_;
+  std::vector<size_t> inflight_push_;
+  int waited_push_ = 0;
+};
+
+static const char* kDataFile = "TestDownpourWorker.data";
+static const int kInsNum = 7;
+
+static DataFeedDesc MakeDataFeedDesc() {
+  DataFeedDesc desc;
+  desc.set_name("MultiSlotDataFeed");
+  desc.set_batch_size(2);
+  for (auto name : {"words", "label"}) {
+    auto* slot = desc.mutable_multi_slot_desc()->add_slots();
+    slot->set_name(name);
+    slot->set_type("uint64");
+    slot->set_is_dense(false);
+    slot->set_is_used(true);
+  }
+  return desc;
+}
+
+static void WriteDataFile() {
+  std::ofstream data(kDataFile);
+  for (int i = 0; i < kInsNum; ++i) {
+    data << "1 " << i + 1 << " 1 " << i % 2 << "\n";
+  }
+}
+
+static TrainerDesc MakeTrainerDesc(bool pipeline, int max_inflight_push) {
+  TrainerDesc desc;
+  auto* param = desc.mutable_downpour_param();
+  param->add_program_config()->set_program_id("0");
+  param->set_push_sparse(false);
+  param->set_push_dense(false);
+  param->set_pipeline_pull_sparse(pipeline);
+  param->set_max_inflight_push(max_inflight_push);
+  return desc;
+}
+
+// adds a sparse table keyed by words, its embedding is not in the program
+// so that the pull and the fill skip it
+static TrainerDesc MakeSparseTrainerDesc(int max_inflight_push) {
+  TrainerDesc desc = MakeTrainerDesc(false, max_inflight_push);
+  auto* param = desc.mutable_downpour_param();
+  auto* table = param->add_sparse_table();
+  table->set_table_id(0);
+  table->add_sparse_key_name("words");
+  table->add_sparse_value_name("words_emb");
+  table->add_sparse_grad_name("words_emb@GRAD");
+  table->set_fea_dim(11);
+  table->set_emb_dim(9);
+  table->set_label_var_name("label");
+  param->mutable_program_config(0)->add_pull_sparse_table_id(0);
+  param->mutable_program_config(0)->add_push_sparse_table_id(0);
+  param->set_push_sparse(true);
+  return desc;
+}
+
+// trains kDataFile with a program that only holds the feed vars, returns
+// the batches seen by the compute and the dumped instances. If inflight_push
+// is given, fakes the sparse pushes and returns how many were in flight after
+// each batch and how many were waited for in the end
+static std::vector<std::vector<int64_t>> TrainFiles(
+    const TrainerDesc& desc, bool profiler, std::vector<std::string>* dumped,
+    std::vector<size_t>* inflight_push, int* waited_push) {
+  std::mutex mutex_for_pick_file;
+  size_t file_idx = 0;
+  auto reader = DataFeedFactory::CreateDataFeed("MultiSlotDataFeed");
+  reader->Init(MakeDataFeedDesc());
+  reader->SetFileListMutex(&mutex_for_pick_file);
+  reader->SetFileListIndex(&file_idx);
+  reader->SetFileList({kDataFile});
+
+  ProgramDesc program;
+  for (auto name : {"words", "label"}) {
+    program.MutableBlock(0)->Var(name)->SetType(proto::VarType::LOD_TENSOR);
+  }
+  std::vector<std::string> dump_fields{"words"};
+  auto dump_channel = MakeChannel<std::string>();
+
+  Scope root_scope;
+  std::vector<std::vector<int64_t>> batches;
+  {
+    TestDownpourWorker worker;
+    worker.fake_push_ = inflight_push != nullptr;
+    worker.SetNeedDumpField(dumped != nullptr);
+    worker.SetNeedDumpParam(false);
+    worker.SetDumpFieldVector(dump_fields);
+    worker.SetChannelWriter(dump_channel.get());
+    worker.Initialize(desc);
+    worker.SetRootScope(&root_scope);
+    worker.SetDataFeed(reader.get());
+    worker.SetPlace(platform::CPUPlace());
+    worker.CreateDeviceResource(program);
+    worker.BindingDataFeedMemory();
+    if (profiler) {
+      worker.TrainFilesWithProfiler();
+    } else {
+      worker.TrainFiles();
+    }
+    batches.swap(worker.batches_);
+    if (inflight_push != nullptr) {
+      inflight_push->swap(worker.inflight_push_);
+      *waited_push = worker.waited_push_;
+    }
+  }
+  if (dumped != nullptr) {
+    dump_channel->Close();
+    dump_channel->ReadAll(*dumped);
+  }
+  return batches;
+}
+
+static std::vector<std::vector<int64_t>> TrainFiles(
+    bool pipeline, std::vector<std::string>* dumped) {
+  return TrainFiles(MakeTrainerDesc(pipeline, 0), false, dumped, nullptr,
+                    nullptr);
+}
+
+TEST(DownpourWorker, PipelinePullSparse) {
+  WriteDataFile();
+  auto expected = TrainFiles(false, nullptr);
+  ASSERT_EQ(expected.size(), 4UL);
+  EXPECT_EQ(expected[0], std::vector<int64_t>({1, 2}));
+  EXPECT_EQ(expected[3], std::vector<int64_t>({7}));
+  for (int repeat = 0; repeat < 5; ++repeat) {
+    EXPECT_EQ(TrainFiles(true, nullptr), expected);
+  }
+
+  // the dumped instances stay in step with the computed batch while the
+  // reader runs ahead
+  std::vector<std::string> expected_dumped;
+  std::vector<std::string> dumped;
+  EXPECT_EQ(TrainFiles(false, &expected_dumped), expected);
+  EXPECT_EQ(TrainFiles(true, &dumped), expected);
+  EXPECT_EQ(expected_dumped.size(), static_cast<size_t>(kInsNum));
+  EXPECT_EQ(dumped, expected_dumped);
+  std::remove(kDataFile);
+}
+
+TEST(DownpourWorker, MaxInflightPush) {
+  TestDownpourWorker worker;
+  worker.Initialize(MakeTrainerDesc(false, 2));
+  std::vector<std::promise<int32_t>> promises(5);
+  std::vector<std::future<int32_t>> status;
+  for (auto& promise : promises) {
+    status.push_back(promise.get_future());
+  }
+  // only the oldest pushes beyond the bound are waited for
+  for (int i = 0; i < 3; ++i) {
+    promises[i].set_value(0);
+  }
+  worker.WaitPushStatus(&status);
+  ASSERT_EQ(status.size(), 2UL);
+  for (auto& s : status) {
+    EXPECT_EQ(s.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+  }
+  worker.WaitPushStatus(&status);
+  EXPECT_EQ(status.size(), 2UL);
+
+  promises[3].set_value(0);
+  promises[4].set_value(0);
+  TestDownpourWorker unbounded;
+  unbounded.Initialize(MakeTrainerDesc(false, 0));
+  unbounded.WaitPushStatus(&status);
+  EXPECT_EQ(status.size(), 2UL);
+}
+
+#ifndef PADDLE_WITH_PSLIB
+TEST(DownpourWorker, MaxInflightSparsePush) {
+  WriteDataFile();
+  auto expected = TrainFiles(false, nullptr);
+  // the sparse pushes stay bounded and are all waited for at the end, with
+  // and without the profiler
+  for (bool profiler : {false, true}) {
+    std::vector<size_t> inflight_push;
+    int waited_push = 0;
+    EXPECT_EQ(TrainFiles(MakeSparseTrainerDesc(2), profiler, nullptr,
+                         &inflight_push, &waited_push),
+              expected);
+    EXPECT_EQ(inflight_push, std::vector<size_t>({0, 1, 2, 2}));
+    EXPECT_EQ(waited_push, static_cast<int>(expected.size()));
+  }
+  std::remove(kDataFile);
+}
+#endif
+
+}  // namespace framework
+}  // namespace paddle
@@ -200,22 +200,7 @@ class GlooWrapper {
     gloo::AllreduceOptions opts(context_);
     opts.setInput(sendbuf.data(), sendbuf.size());
     opts.setOutput(recvbuf.data(), recvbuf.size());
-    if (mode == "sum") {
-      opts.setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::sum<T>));
-    } else if (mode == "max") {
-      opts.setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::max<T>));
-    } else if (mode == "min") {
-      opts.setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::min<T>));
-    } else {
-      PADDLE_ENFORCE_EQ(0, 1, paddle::platform::errors::InvalidArgument(
-                                  "AllReduce mode not known: " + mode));
-    }
+    SetReduceFunction<T>(&opts, mode);
     gloo::allreduce(opts);
 #else
     LOG(WARNING) << "AllReduce does nothing when WITH_GLOO=OFF";
@@ -223,6 +208,22 @@ class GlooWrapper {
     return recvbuf;
   }
 
+  // In-place allreduce on the count elements of data, no extra buffer is
+  // allocated.
+  template <typename T>
+  void AllReduce(T* data, size_t count, const std::string& mode = "sum") {
+    CHECK_EQ(is_initialized_, true);
+#ifdef PADDLE_WITH_GLOO
+    gloo::AllreduceOptions opts(context_);
+    // gloo reduces in place when only the output is set
+    opts.setOutput(data, count);
+    SetReduceFunction<T>(&opts, mode);
+    gloo::allreduce(opts);
+#else
+    LOG(WARNING) << "AllReduce does nothing when WITH_GLOO=OFF";
+#endif
+  }
+
   template <typename T>
   std::vector<T> AllGather(T& input) {  // NOLINT
     CHECK_EQ(is_initialized_, true);
@@ -239,6 +240,29 @@ class GlooWrapper {
   }
 
  protected:
+#ifdef PADDLE_WITH_GLOO
+  template <typename T>
+  void SetReduceFunction(gloo::AllreduceOptions* opts,
+                         const std::string& mode) {
+    if (mode == "sum") {
+      opts->setReduceFunction(
+          static_cast<void (*)(void*, const void*, const void*, size_t)>(
+              &gloo::sum<T>));
+    } else if (mode == "max") {
+      opts->setReduceFunction(
+          static_cast<void (*)(void*, const void*, const void*, size_t)>(
+              &gloo::max<T>));
+    } else if (mode == "min") {
+      opts->setReduceFunction(
+          static_cast<void (*)(void*, const void*, const void*, size_t)>(
+              &gloo::min<T>));
+    } else {
+      PADDLE_ENFORCE_EQ(0, 1, paddle::platform::errors::InvalidArgument(
+                                  "AllReduce mode not known: " + mode));
+    }
+  }
+#endif
+
   bool is_initialized_ = false;
 #ifdef PADDLE_WITH_GLOO
   std::shared_ptr<gloo::Context> context_ = nullptr;
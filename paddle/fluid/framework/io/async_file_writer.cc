@@ -0,0 +1,139 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/async_file_writer.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+bool IsReady(const AsyncFileWriter::Future& f) {
+  return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void ThrowIfFailed(const AsyncFileWriter::Future& f) {
+  auto& ex = f.get();
+  if (ex != nullptr) {
+    throw platform::EnforceNotMet(*ex);
+  }
+}
+
+void WriteFile(const std::string& filename, const std::string& content) {
+  std::string tmp = filename + ".tmp";
+  std::ofstream fout(tmp, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+                    platform::errors::Unavailable(
+                        "Cannot open %s to save variables.", tmp));
+  fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+  fout.close();
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+                    platform::errors::Unavailable(
+                        "Failed to write %d bytes to %s.", content.size(), tmp));
+#ifdef _WIN32
+  // rename does not replace an existing file on Windows
+  std::remove(filename.c_str());
+#endif
+  PADDLE_ENFORCE_EQ(
+      std::rename(tmp.c_str(), filename.c_str()), 0,
+      platform::errors::Unavailable("Failed to rename %s to %s.", tmp,
+                                    filename));
+}
+
+}  // namespace
+
+AsyncFileWriter& AsyncFileWriter::Instance() {
+  static AsyncFileWriter writer;
+  return writer;
+}
+
+// One thread keeps the files written in the order of submission, so a later
+// write of the same file always wins.
+AsyncFileWriter::AsyncFileWriter() : pool_(new ThreadPool(1)) {}
+
+AsyncFileWriter::~AsyncFileWriter() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : pending_) {
+    auto& ex = item.second.get();
+    if (ex != nullptr) {
+      LOG(ERROR) << "Failed to write " << item.first << ": " << ex->what();
+    }
+  }
+}
+
+AsyncFileWriter::Future AsyncFileWriter::Write(const std::string& filename,
+                                               std::string&& content) {
+  // wait for the previous write of the same file, so that its error is
+  // reported and the snapshots of one file do not pile up in memory
+  Wait(filename);
+
+  // the task is copied into the pool, so share the content instead
+  auto data = std::make_shared<std::string>(std::move(content));
+  Future f = pool_->RunAndGetException(
+      [filename, data] { WriteFile(filename, *data); });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    // drop the finished writes that nobody needs to be told about
+    if (IsReady(it->second) && it->second.get() == nullptr) {
+      it = pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  pending_[filename] = f;
+  return f;
+}
+
+void AsyncFileWriter::Wait(const std::string& filename) {
+  Future f;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(filename);
+    if (it == pending_.end()) return;
+    f = it->second;
+    pending_.erase(it);
+  }
+  ThrowIfFailed(f);
+}
+
+void AsyncFileWriter::WaitAll() {
+  std::map<std::string, Future> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.swap(pending_);
+  }
+  const Future* failed = nullptr;
+  for (auto& item : pending) {
+    if (item.second.get() != nullptr && failed == nullptr) {
+      failed = &item.second;
+    }
+  }
+  if (failed != nullptr) {
+    ThrowIfFailed(*failed);
+  }
+}
+
+size_t AsyncFileWriter::PendingCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "paddle/fluid/framework/threadpool.h"
+
+namespace paddle {
+namespace framework {
+
+// AsyncFileWriter writes files in a background thread, so that the caller
+// only pays for snapshotting the content into memory, e.g. save ops when
+// FLAGS_async_save is on.
+//
+// Every file is written to "<filename>.tmp" and then renamed to <filename>,
+// so that readers never see a partially written file. Files are written in
+// the order they are submitted.
+class AsyncFileWriter {
+ public:
+  using Future =
+      std::shared_future<std::unique_ptr<platform::EnforceNotMet>>;
+
+  static AsyncFileWriter& Instance();
+
+  AsyncFileWriter();
+  // Waits for all the pending writes.
+  ~AsyncFileWriter();
+
+  // Queue `content` to be written to `filename`. The returned future holds
+  // the error of the write, if any.
+  Future Write(const std::string& filename, std::string&& content);
+
+  // Wait until the pending write of `filename` finishes, and throw its error.
+  // Returns immediately if `filename` is not being written.
+  void Wait(const std::string& filename);
+
+  // Wait until all the pending writes finish, and throw the first error.
+  void WaitAll();
+
+  // Number of writes that have not been waited.
+  size_t PendingCount();
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, Future> pending_;
+  std::unique_ptr<ThreadPool> pool_;
+
+  DISABLE_COPY_AND_ASSIGN(AsyncFileWriter);
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,202 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/crypto/cipher_stream.h"
+
+#include <cstring>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'D', 'C', 'S'};
+constexpr uint32_t kVersion = 0;
+// uint64 index | uint8 is_last
+constexpr size_t kChunkHeaderSize = sizeof(uint64_t) + sizeof(uint8_t);
+
+// Returns the chunk size of the stream.
+size_t ReadHeader(std::istream* in) {
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  uint32_t chunk_size;
+  in->read(magic, sizeof(magic));
+  in->read(reinterpret_cast<char*>(&version), sizeof(version));
+  in->read(reinterpret_cast<char*>(&chunk_size), sizeof(chunk_size));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(*in) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0,
+      true, platform::errors::InvalidArgument(
+                "The input is not a chunked cipher stream, please encrypt it "
+                "by EncryptStream."));
+  PADDLE_ENFORCE_EQ(version, kVersion,
+                    platform::errors::Unimplemented(
+                        "Unsupported cipher stream version %d, expected %d.",
+                        version, kVersion));
+  PADDLE_ENFORCE_EQ(
+      chunk_size > 0 && chunk_size <= kMaxCipherStreamChunkSize, true,
+      platform::errors::InvalidArgument(
+          "The chunk size %d of the cipher stream should be in (0, %d].",
+          chunk_size, kMaxCipherStreamChunkSize));
+  return chunk_size;
+}
+
+std::ifstream OpenCipherFile(const std::string& filename) {
+  std::ifstream fin(filename, std::ios::in | std::ios::binary);
+  PADDLE_ENFORCE_EQ(
+      fin.is_open(), true,
+      platform::errors::Unavailable("Failed to open file %s.", filename));
+  return fin;
+}
+
+}  // namespace
+
+void EncryptStream(Cipher* cipher, const std::string& key, std::istream* in,
+                   std::ostream* out, size_t chunk_size) {
+  PADDLE_ENFORCE_EQ(
+      chunk_size > 0 && chunk_size <= kMaxCipherStreamChunkSize, true,
+      platform::errors::InvalidArgument(
+          "The chunk size %d of cipher stream should be in (0, %d].",
+          chunk_size, kMaxCipherStreamChunkSize));
+  uint32_t chunk_size_u32 = static_cast<uint32_t>(chunk_size);
+  out->write(kMagic, sizeof(kMagic));
+  out->write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+  out->write(reinterpret_cast<const char*>(&chunk_size_u32),
+             sizeof(chunk_size_u32));
+
+  std::string plaintext;
+  uint64_t index = 0;
+  bool is_last = false;
+  while (!is_last) {
+    plaintext.resize(kChunkHeaderSize + chunk_size);
+    in->read(&plaintext[kChunkHeaderSize], chunk_size);
+    size_t size = static_cast<size_t>(in->gcount());
+    is_last = in->peek() == std::istream::traits_type::eof();
+    plaintext.resize(kChunkHeaderSize + size);
+    std::memcpy(&plaintext[0], &index, sizeof(index));
+    plaintext[sizeof(index)] = static_cast<char>(is_last);
+
+    std::string ciphertext = cipher->Encrypt(plaintext, key);
+    uint32_t length = static_cast<uint32_t>(ciphertext.size());
+    out->write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out->write(ciphertext.data(), ciphertext.size());
+    ++index;
+  }
+  PADDLE_ENFORCE_EQ(static_cast<bool>(*out), true,
+                    platform::errors::Unavailable(
+                        "Failed to write the encrypted cipher stream."));
+}
+
+void DecryptStream(Cipher* cipher, const std::string& key, std::istream* in,
+                   const std::function<void(const char*, size_t)>& callback) {
+  DecryptStreamBuf buf(cipher, key, in);
+  const char* data;
+  size_t size;
+  while (buf.ReadChunk(&data, &size)) {
+    callback(data, size);
+  }
+}
+
+bool IsCipherStreamFile(const std::string& filename) {
+  std::ifstream fin(filename, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  fin.read(magic, sizeof(magic));
+  return static_cast<bool>(fin) &&
+         std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+DecryptStreamBuf::DecryptStreamBuf(Cipher* cipher, const std::string& key,
+                                   std::istream* in)
+    : cipher_(cipher), key_(key), in_(in) {
+  max_chunk_length_ =
+      ReadHeader(in_) + kChunkHeaderSize + kMaxCipherStreamOverhead;
+  setg(nullptr, nullptr, nullptr);
+}
+
+bool DecryptStreamBuf::ReadChunk(const char** data, size_t* size) {
+  if (underflow() == traits_type::eof()) {
+    return false;
+  }
+  *data = gptr();
+  *size = static_cast<size_t>(egptr() - gptr());
+  setg(eback(), egptr(), egptr());
+  return true;
+}
+
+DecryptStreamBuf::int_type DecryptStreamBuf::underflow() {
+  while (gptr() == egptr()) {
+    if (!NextChunk()) {
+      return traits_type::eof();
+    }
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+bool DecryptStreamBuf::NextChunk() {
+  if (finished_) {
+    return false;
+  }
+  uint32_t length = 0;
+  in_->read(reinterpret_cast<char*>(&length), sizeof(length));
+  PADDLE_ENFORCE_LE(length, max_chunk_length_,
+                    platform::errors::InvalidArgument(
+                        "Chunk %d of the cipher stream has %d bytes, larger "
+                        "than the limit %d of its chunk size.",
+                        next_index_, length, max_chunk_length_));
+  ciphertext_.resize(length);
+  if (*in_ && length > 0) {
+    in_->read(&ciphertext_[0], length);
+  }
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(*in_), true,
+      platform::errors::InvalidArgument(
+          "The cipher stream is truncated before chunk %d.", next_index_));
+
+  plaintext_ = cipher_->Decrypt(ciphertext_, key_);
+  PADDLE_ENFORCE_GE(plaintext_.size(), kChunkHeaderSize,
+                    platform::errors::InvalidArgument(
+                        "Chunk %d of the cipher stream is broken.",
+                        next_index_));
+  uint64_t index;
+  std::memcpy(&index, plaintext_.data(), sizeof(index));
+  PADDLE_ENFORCE_EQ(index, next_index_,
+                    platform::errors::InvalidArgument(
+                        "Chunk %d of the cipher stream is out of order, "
+                        "expected chunk %d.",
+                        index, next_index_));
+  ++next_index_;
+  finished_ = plaintext_[sizeof(index)] != 0;
+  if (finished_) {
+    PADDLE_ENFORCE_EQ(in_->peek(), std::istream::traits_type::eof(),
+                      platform::errors::InvalidArgument(
+                          "Unexpected data after the last chunk of the "
+                          "cipher stream."));
+  }
+
+  char* begin = &plaintext_[0];
+  setg(begin, begin + kChunkHeaderSize, begin + plaintext_.size());
+  return true;
+}
+
+DecryptInputStream::DecryptInputStream(Cipher* cipher, const std::string& key,
+                                       const std::string& filename)
+    : std::istream(nullptr),
+      fin_(OpenCipherFile(filename)),
+      buf_(cipher, key, &fin_) {
+  init(&buf_);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "paddle/fluid/framework/io/crypto/cipher.h"
+
+namespace paddle {
+namespace framework {
+
+// Chunked cipher stream, so that large files (e.g. combined parameters) can
+// be decrypted without holding the whole ciphertext and plaintext in memory.
+//
+// Layout:
+//   header: "PDCS" | uint32 version | uint32 chunk_size
+//   chunks: { uint32 length | Encrypt(uint64 index | uint8 is_last | data) }
+//
+// Every chunk is encrypted independently by Cipher::Encrypt. With an
+// authenticated cipher (AES_GCM_NoPadding) every chunk carries its own tag,
+// and the index and last flag inside the ciphertext reject reordered,
+// dropped or truncated chunks.
+constexpr size_t kCipherStreamChunkSize = 4UL << 20;
+// The chunk size and the chunk length read from a stream are checked against
+// these bounds before allocating, so a broken file can not force huge
+// allocations. The overhead covers the IV, padding and tag of the ciphers.
+constexpr size_t kMaxCipherStreamChunkSize = 256UL << 20;
+constexpr size_t kMaxCipherStreamOverhead = 1024;
+
+// Encrypt all the data of `in` to `out` chunk by chunk.
+void EncryptStream(Cipher* cipher, const std::string& key, std::istream* in,
+                   std::ostream* out,
+                   size_t chunk_size = kCipherStreamChunkSize);
+
+// Decrypt a chunked stream, `callback` receives the plaintext of every
+// chunk in order. The data pointer is only valid during the call.
+void DecryptStream(Cipher* cipher, const std::string& key, std::istream* in,
+                   const std::function<void(const char*, size_t)>& callback);
+
+// Whether the file starts with the header of a chunked cipher stream.
+bool IsCipherStreamFile(const std::string& filename);
+
+// A streambuf that decrypts one chunk at a time when its get area is
+// exhausted, so that readers like DeserializeFromStream copy the plaintext
+// directly into their destination buffers.
+class DecryptStreamBuf : public std::streambuf {
+ public:
+  DecryptStreamBuf(Cipher* cipher, const std::string& key, std::istream* in);
+
+  // Whether all chunks up to the last one have been decrypted.
+  bool finished() const { return finished_; }
+
+  // Take the remaining plaintext of the current chunk, or of the next one
+  // if it is exhausted. Returns false at the end of the stream.
+  bool ReadChunk(const char** data, size_t* size);
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  bool NextChunk();
+
+  Cipher* cipher_;
+  std::string key_;
+  std::istream* in_;
+  size_t max_chunk_length_;
+  std::string ciphertext_;
+  std::string plaintext_;
+  uint64_t next_index_{0};
+  bool finished_{false};
+};
+
+// std::istream over a chunked cipher file.
+class DecryptInputStream : public std::istream {
+ public:
+  DecryptInputStream(Cipher* cipher, const std::string& key,
+                     const std::string& filename);
+
+  bool finished() const { return buf_.finished(); }
+
+ private:
+  std::ifstream fin_;
+  DecryptStreamBuf buf_;
+};
+
+}  // namespace framework
+}  // namespace paddle
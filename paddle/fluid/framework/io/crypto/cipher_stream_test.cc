@@ -0,0 +1,132 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/crypto/cipher_stream.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "paddle/fluid/framework/io/crypto/cipher_utils.h"
+
+namespace paddle {
+namespace framework {
+
+class CipherStreamTest : public ::testing::Test {
+ public:
+  std::string key;
+  std::string plaintext;
+
+  void SetUp() override {
+    key = CipherUtils::GenKey(256);
+    for (int i = 0; i < 1000; ++i) {
+      plaintext.push_back(static_cast<char>(i * 7 % 256));
+    }
+  }
+  static std::shared_ptr<Cipher> CreateCipher(const std::string& cipher_name);
+};
+
+std::shared_ptr<Cipher> CipherStreamTest::CreateCipher(
+    const std::string& cipher_name) {
+  std::ofstream fout("cipher_stream_test.conf");
+  fout << "cipher_name : " << cipher_name << std::endl;
+  fout.close();
+  return CipherFactory::CreateCipher("cipher_stream_test.conf");
+}
+
+TEST_F(CipherStreamTest, encrypt_decrypt) {
+  std::vector<std::string> name_list(
+      {"AES_CTR_NoPadding", "AES_CBC_PKCSPadding", "AES_ECB_PKCSPadding",
+       "AES_GCM_NoPadding"});
+  std::string filename("cipher_stream_test.ciphertext");
+  for (auto& name : name_list) {
+    auto cipher = CipherStreamTest::CreateCipher(name);
+    // 1000 is not a multiple of the chunk size, and 0 byte input has only
+    // the last empty chunk
+    for (size_t chunk_size : {64UL, 100UL, 4096UL}) {
+      for (auto& input : {plaintext, std::string()}) {
+        std::istringstream in(input);
+        std::ofstream fout(filename, std::ios::binary);
+        EncryptStream(cipher.get(), key, &in, &fout, chunk_size);
+        fout.close();
+        EXPECT_TRUE(IsCipherStreamFile(filename));
+
+        DecryptInputStream fin(cipher.get(), key, filename);
+        std::string output{std::istreambuf_iterator<char>(fin),
+                           std::istreambuf_iterator<char>()};
+        EXPECT_EQ(input, output);
+        EXPECT_TRUE(fin.finished());
+
+        std::ifstream cipher_in(filename, std::ios::binary);
+        std::string output1;
+        DecryptStream(cipher.get(), key, &cipher_in,
+                      [&](const char* data, size_t size) {
+                        EXPECT_LE(size, chunk_size);
+                        output1.append(data, size);
+                      });
+        EXPECT_EQ(input, output1);
+      }
+    }
+  }
+}
+
+TEST_F(CipherStreamTest, reject_broken_stream) {
+  auto cipher = CipherStreamTest::CreateCipher("AES_GCM_NoPadding");
+  std::istringstream in(plaintext);
+  std::ostringstream out;
+  EncryptStream(cipher.get(), key, &in, &out, 64);
+  std::string ciphertext = out.str();
+
+  // offsets of the chunks, skipping "PDCS" | version | chunk_size
+  std::vector<size_t> offsets;
+  for (size_t offset = 12; offset < ciphertext.size();) {
+    offsets.push_back(offset);
+    uint32_t length;
+    memcpy(&length, &ciphertext[offset], sizeof(length));
+    offset += sizeof(length) + length;
+  }
+  ASSERT_EQ(offsets.size(), 1000UL / 64 + 1);
+  auto decrypt = [&](const std::string& input) {
+    std::istringstream broken_in(input);
+    DecryptStream(cipher.get(), key, &broken_in,
+                  [](const char* data, size_t size) {});
+  };
+
+  // drop the last chunk
+  EXPECT_ANY_THROW(decrypt(ciphertext.substr(0, offsets.back())));
+  // swap the first two chunks
+  std::string reordered = ciphertext.substr(0, offsets[0]) +
+                          ciphertext.substr(offsets[1], offsets[2] - offsets[1]) +
+                          ciphertext.substr(offsets[0], offsets[1] - offsets[0]) +
+                          ciphertext.substr(offsets[2]);
+  EXPECT_ANY_THROW(decrypt(reordered));
+  // tamper with the payload of the first chunk
+  std::string tampered = ciphertext;
+  tampered[offsets[0] + 4 + 16 + 20] ^= 1;
+  EXPECT_ANY_THROW(decrypt(tampered));
+  // a chunk length far beyond the chunk size
+  std::string oversized = ciphertext;
+  uint32_t length = 0xFFFFFFF0;
+  memcpy(&oversized[offsets[0]], &length, sizeof(length));
+  EXPECT_ANY_THROW(decrypt(oversized));
+  // a chunk size beyond the limit in the header
+  std::string huge_chunk_size = ciphertext;
+  uint32_t chunk_size = 0xFFFFFFFF;
+  memcpy(&huge_chunk_size[8], &chunk_size, sizeof(chunk_size));
+  EXPECT_ANY_THROW(decrypt(huge_chunk_size));
+}
+
+}  // namespace framework
+}  // namespace paddle
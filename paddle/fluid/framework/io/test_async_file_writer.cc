@@ -0,0 +1,62 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "paddle/fluid/framework/io/async_file_writer.h"
+
+namespace paddle {
+namespace framework {
+
+static std::string ReadFile(const std::string& filename) {
+  std::ifstream fin(filename, std::ios::binary);
+  std::stringstream ss;
+  ss << fin.rdbuf();
+  return ss.str();
+}
+
+TEST(AsyncFileWriter, WriteAndWait) {
+  AsyncFileWriter writer;
+  writer.Write("async_writer_a.txt", std::string(1 << 20, 'a'));
+  writer.Write("async_writer_b.txt", "b");
+  writer.Write("async_writer_b.txt", "bb");
+  writer.Wait("async_writer_a.txt");
+  EXPECT_EQ(ReadFile("async_writer_a.txt"), std::string(1 << 20, 'a'));
+
+  writer.WaitAll();
+  EXPECT_EQ(writer.PendingCount(), 0UL);
+  EXPECT_EQ(ReadFile("async_writer_b.txt"), "bb");
+  // the temporary file has been renamed
+  EXPECT_FALSE(std::ifstream("async_writer_b.txt.tmp").good());
+  // nothing is pending
+  writer.Wait("async_writer_c.txt");
+}
+
+TEST(AsyncFileWriter, Error) {
+  AsyncFileWriter writer;
+  auto f = writer.Write("not_exist_dir/async_writer.txt", "a");
+  EXPECT_NE(f.get(), nullptr);
+  EXPECT_THROW(writer.WaitAll(), platform::EnforceNotMet);
+  EXPECT_EQ(writer.PendingCount(), 0UL);
+
+  writer.Write("not_exist_dir/async_writer.txt", "a");
+  EXPECT_THROW(writer.Wait("not_exist_dir/async_writer.txt"),
+               platform::EnforceNotMet);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,539 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/ir/cost_data.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <tuple>
+
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/lod_tensor_array.h"
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/selected_rows.h"
+
+DECLARE_string(cost_model_profile_path);
+
+namespace paddle {
+namespace framework {
+
+using ir::Graph;
+using platform::Event;
+
+const double CostData::NOT_MEASURED = -1;
+
+static const char kCostDataHeader[] = "paddle_cost_data";
+static const int kCostDataVersion = 1;
+
+namespace {
+
+// A pair of push and pop events, the events pushed between them are its
+// children.
+struct EventRange {
+  const Event* push{nullptr};
+  const Event* pop{nullptr};
+  std::vector<size_t> children;
+};
+
+// Returns the outermost ranges of the events of a thread.
+std::vector<size_t> BuildEventRanges(const std::vector<Event>& events,
+                                     std::vector<EventRange>* ranges) {
+  std::vector<size_t> roots;
+  std::vector<size_t> stack;
+  for (auto& event : events) {
+    if (event.type() == platform::EventType::kPushRange) {
+      size_t index = ranges->size();
+      ranges->emplace_back();
+      ranges->back().push = &event;
+      if (stack.empty()) {
+        roots.push_back(index);
+      } else {
+        (*ranges)[stack.back()].children.push_back(index);
+      }
+      stack.push_back(index);
+    } else if (event.type() == platform::EventType::kPopRange) {
+      // Close the innermost range of the same name, the ranges opened in it
+      // are left unclosed.
+      for (size_t i = stack.size(); i > 0; --i) {
+        auto& range = (*ranges)[stack[i - 1]];
+        if (range.push->name() == event.name()) {
+          range.pop = &event;
+          stack.resize(i - 1);
+          break;
+        }
+      }
+    }
+  }
+  return roots;
+}
+
+double ElapsedMs(const EventRange& range) {
+  double time_ms = range.push->CpuElapsedMs(*range.pop);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  time_ms += range.push->CudaElapsedMs(*range.pop);
+#endif
+  return time_ms;
+}
+
+// Match the ops of a block to the candidate ranges in order. The ops of a
+// sub-block run repeatedly in the range of the op holding it, so the matching
+// wraps around and the time of all the runs is summed.
+bool SetBlockTime(const ProgramDesc& program, int block_id,
+                  const std::vector<EventRange>& ranges,
+                  const std::vector<size_t>& candidates, bool repeated,
+                  std::map<CostData::OpKey, double>* op_time_ms,
+                  std::map<CostData::OpKey, int>* op_run_count) {
+  const BlockDesc& block = program.Block(block_id);
+  size_t op_size = block.OpSize();
+  if (op_size == 0) {
+    return true;
+  }
+
+  auto record = [&](size_t op_id, const EventRange& range) {
+    if (range.pop == nullptr) {
+      return false;
+    }
+    CostData::OpKey key(block_id, static_cast<int>(op_id));
+    (*op_time_ms)[key] += ElapsedMs(range);
+    ++(*op_run_count)[key];
+    const OpDesc* op_desc = block.Op(op_id);
+    if (op_desc->HasAttr("sub_block")) {
+      int sub_block_id = op_desc->GetBlockAttrId("sub_block");
+      return SetBlockTime(program, sub_block_id, ranges, range.children, true,
+                          op_time_ms, op_run_count);
+    }
+    return true;
+  };
+
+  bool success = true;
+  if (repeated) {
+    size_t op_id = 0;
+    for (size_t index : candidates) {
+      if (ranges[index].push->name() != block.Op(op_id)->Type()) {
+        continue;
+      }
+      if (!record(op_id, ranges[index])) {
+        LOG(WARNING) << "Input time_events for Op " << op_id << " of block "
+                     << block_id << " have wrong format, skip this run.";
+        success = false;
+      }
+      op_id = (op_id + 1) % op_size;
+    }
+    return success;
+  }
+
+  size_t cursor = 0;
+  for (size_t op_id = 0; op_id < op_size; ++op_id) {
+    const std::string& op_type = block.Op(op_id)->Type();
+    size_t index = cursor;
+    while (index < candidates.size() &&
+           ranges[candidates[index]].push->name() != op_type) {
+      ++index;
+    }
+    if (index >= candidates.size() ||
+        !record(op_id, ranges[candidates[index]])) {
+      LOG(WARNING) << "Input time_events for Op " << op_id << ", type '"
+                   << op_type << "' have wrong format, skip this Op.";
+      success = false;
+    }
+    if (index < candidates.size()) {
+      cursor = index + 1;
+    }
+  }
+  return success;
+}
+
+// The variables of the sub-blocks are kept in the kid scopes.
+const Variable* FindVarInScopeTree(const Scope& scope,
+                                   const std::string& name) {
+  const Variable* var = scope.FindLocalVar(name);
+  if (var != nullptr) {
+    return var;
+  }
+  for (const Scope* kid : scope.kids()) {
+    var = FindVarInScopeTree(*kid, name);
+    if (var != nullptr) {
+      return var;
+    }
+  }
+  return nullptr;
+}
+
+int64_t TensorBytes(const Tensor& tensor) {
+  if (!tensor.IsInitialized()) {
+    return 0;
+  }
+  return tensor.numel() * static_cast<int64_t>(SizeOfType(tensor.type()));
+}
+
+int64_t VarBytes(const Variable* var) {
+  if (var == nullptr) {
+    return 0;
+  }
+  if (var->IsType<LoDTensor>()) {
+    return TensorBytes(var->Get<LoDTensor>());
+  } else if (var->IsType<SelectedRows>()) {
+    return TensorBytes(var->Get<SelectedRows>().value());
+  } else if (var->IsType<LoDTensorArray>()) {
+    int64_t bytes = 0;
+    for (auto& tensor : var->Get<LoDTensorArray>()) {
+      bytes += TensorBytes(tensor);
+    }
+    return bytes;
+  }
+  return 0;
+}
+
+std::vector<std::string> OpVarNames(const OpDesc& op_desc) {
+  std::vector<std::string> names = op_desc.InputArgumentNames();
+  auto outputs = op_desc.OutputArgumentNames();
+  names.insert(names.end(), outputs.begin(), outputs.end());
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  names.erase(std::remove(names.begin(), names.end(), kEmptyVarName),
+              names.end());
+  return names;
+}
+
+}  // namespace
+
+CostData::~CostData() {
+  // TODO(zhhsplendid): when we save a copy of program/graph, we should delete
+  // here.
+}
+
+double CostData::GetOpTimeMs(int op_id) const { return GetOpTimeMs(0, op_id); }
+double CostData::GetOpMemoryBytes(int op_id) const {
+  return GetOpMemoryBytes(0, op_id);
+}
+
+template <typename T>
+static T FindOrNotMeasured(const std::map<CostData::OpKey, T>& costs,
+                           int block_id, int op_id) {
+  auto iter = costs.find(CostData::OpKey(block_id, op_id));
+  return iter == costs.end() ? static_cast<T>(CostData::NOT_MEASURED)
+                             : iter->second;
+}
+
+double CostData::GetOpTimeMs(int block_id, int op_id) const {
+  return FindOrNotMeasured(op_time_ms_, block_id, op_id);
+}
+int CostData::GetOpRunCount(int block_id, int op_id) const {
+  auto iter = op_run_count_.find(OpKey(block_id, op_id));
+  return iter == op_run_count_.end() ? 0 : iter->second;
+}
+double CostData::GetOpMemoryBytes(int block_id, int op_id) const {
+  return FindOrNotMeasured(op_memory_bytes_, block_id, op_id);
+}
+double CostData::GetOpPeakMemoryBytes(int block_id, int op_id) const {
+  return FindOrNotMeasured(op_peak_memory_bytes_, block_id, op_id);
+}
+bool CostData::HasOpCost(int block_id, int op_id) const {
+  return op_types_.count(OpKey(block_id, op_id)) > 0;
+}
+
+double CostData::GetWholeTimeMs() const { return whole_time_ms_; }
+double CostData::GetWholeMemoryBytes() const { return whole_memory_bytes_; }
+double CostData::GetWholePeakMemoryBytes() const {
+  return whole_peak_memory_bytes_;
+}
+
+double CostData::GetOpTypeTimeMs(const std::string& op_type) const {
+  auto iter = op_type_costs_.find(op_type);
+  return iter == op_type_costs_.end() ? NOT_MEASURED : iter->second.first;
+}
+double CostData::GetOpTypeMemoryBytes(const std::string& op_type) const {
+  auto iter = op_type_costs_.find(op_type);
+  return iter == op_type_costs_.end() ? NOT_MEASURED : iter->second.second;
+}
+
+const Graph* CostData::GetGraph() const { return graph_; }
+const ProgramDesc* CostData::GetProgram() const { return program_; }
+
+bool CostData::SetCostData(const ProgramDesc& program,
+                           const std::vector<std::vector<Event>>& time_events) {
+  // TODO(zhhsplendid): Make a copy so that CostData can be available even if
+  // SWE changes Program, the copy can be saved into pointer program_
+  if (program.Size() == 0) {
+    whole_time_ms_ = 0;
+    whole_memory_bytes_ = 0;
+    return true;
+  }
+
+  if (time_events.empty()) {
+    LOG(WARNING) << "Input time_events for CostModel is empty";
+    return false;
+  }
+
+  const std::vector<Event>& main_thread_events = time_events[0];
+  const BlockDesc& global_block = program.Block(0);
+  if (global_block.OpSize() == 0) {
+    whole_time_ms_ = 0;
+    whole_memory_bytes_ = 0;
+    return true;
+  }
+
+  for (size_t block_id = 0; block_id < program.Size(); ++block_id) {
+    const BlockDesc& block = program.Block(block_id);
+    for (size_t op_id = 0; op_id < block.OpSize(); ++op_id) {
+      op_types_[OpKey(block_id, op_id)] = block.Op(op_id)->Type();
+    }
+  }
+
+  op_time_ms_.clear();
+  op_run_count_.clear();
+  std::vector<EventRange> ranges;
+  std::vector<size_t> roots = BuildEventRanges(main_thread_events, &ranges);
+  bool event_to_cost_success = SetBlockTime(program, 0, ranges, roots, false,
+                                            &op_time_ms_, &op_run_count_);
+
+  size_t event_index = 0;
+  int start_profiler_idx = -1;
+  int stop_profiler_idx = -1;
+  while (event_index < main_thread_events.size()) {
+    if (main_thread_events[event_index].name() == "_start_profiler_") {
+      start_profiler_idx = event_index;
+    } else if (main_thread_events[event_index].name() == "_stop_profiler_") {
+      stop_profiler_idx = event_index;
+      break;
+    }
+    ++event_index;
+  }
+  if (start_profiler_idx != -1 && stop_profiler_idx != -1) {
+    double cpu_time_ms = main_thread_events[start_profiler_idx].CpuElapsedMs(
+        main_thread_events[stop_profiler_idx]);
+    double gpu_time_ms = 0;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    gpu_time_ms = main_thread_events[start_profiler_idx].CudaElapsedMs(
+        main_thread_events[stop_profiler_idx]);
+#endif
+    whole_time_ms_ = gpu_time_ms + cpu_time_ms;
+  } else {
+    LOG(WARNING) << "Input time_events for whole time have wrong format";
+    event_to_cost_success = false;
+  }
+
+  BuildOpTypeCosts();
+  return event_to_cost_success;
+}
+
+void CostData::SetMemoryCostData(const ProgramDesc& program,
+                                 const Scope& scope) {
+  op_memory_bytes_.clear();
+  op_peak_memory_bytes_.clear();
+  whole_memory_bytes_ = 0;
+  whole_peak_memory_bytes_ = 0;
+
+  for (size_t block_id = 0; block_id < program.Size(); ++block_id) {
+    const BlockDesc& block = program.Block(block_id);
+    for (size_t op_id = 0; op_id < block.OpSize(); ++op_id) {
+      const OpDesc* op_desc = block.Op(op_id);
+      OpKey key(block_id, op_id);
+      op_types_[key] = op_desc->Type();
+      int64_t bytes = 0;
+      for (auto& name : OpVarNames(*op_desc)) {
+        bytes += VarBytes(FindVarInScopeTree(scope, name));
+      }
+      op_memory_bytes_[key] = bytes;
+    }
+    for (auto* var_desc : block.AllVars()) {
+      whole_memory_bytes_ +=
+          VarBytes(FindVarInScopeTree(scope, var_desc->Name()));
+    }
+  }
+
+  // The persistable tensors are always alive, the others are alive from the
+  // first op using them to the last one.
+  const BlockDesc& global_block = program.Block(0);
+  size_t op_size = global_block.OpSize();
+  std::vector<int64_t> delta(op_size + 1, 0);
+  int64_t persistable_bytes = 0;
+  std::unordered_map<std::string, std::pair<size_t, size_t>> live_ranges;
+  for (size_t op_id = 0; op_id < op_size; ++op_id) {
+    for (auto& name : OpVarNames(*global_block.Op(op_id))) {
+      auto iter = live_ranges.find(name);
+      if (iter == live_ranges.end()) {
+        live_ranges.emplace(name, std::make_pair(op_id, op_id));
+      } else {
+        iter->second.second = op_id;
+      }
+    }
+  }
+  for (auto* var_desc : global_block.AllVars()) {
+    int64_t bytes = VarBytes(scope.FindLocalVar(var_desc->Name()));
+    if (var_desc->Persistable()) {
+      persistable_bytes += bytes;
+      continue;
+    }
+    auto iter = live_ranges.find(var_desc->Name());
+    if (iter != live_ranges.end()) {
+      delta[iter->second.first] += bytes;
+      delta[iter->second.second + 1] -= bytes;
+    }
+  }
+  int64_t alive_bytes = persistable_bytes;
+  whole_peak_memory_bytes_ = persistable_bytes;
+  for (size_t op_id = 0; op_id < op_size; ++op_id) {
+    alive_bytes += delta[op_id];
+    op_peak_memory_bytes_[OpKey(0, op_id)] = alive_bytes;
+    whole_peak_memory_bytes_ =
+        std::max(whole_peak_memory_bytes_, static_cast<double>(alive_bytes));
+  }
+
+  BuildOpTypeCosts();
+}
+
+void CostData::BuildOpTypeCosts() {
+  // type -> (time, runs, memory bytes, ops with memory bytes)
+  std::unordered_map<std::string, std::tuple<double, int, double, int>> sums;
+  for (auto& pair : op_types_) {
+    auto& sum = sums[pair.second];
+    auto time_iter = op_time_ms_.find(pair.first);
+    if (time_iter != op_time_ms_.end()) {
+      std::get<0>(sum) += time_iter->second;
+      std::get<1>(sum) += GetOpRunCount(pair.first.first, pair.first.second);
+    }
+    auto memory_iter = op_memory_bytes_.find(pair.first);
+    if (memory_iter != op_memory_bytes_.end()) {
+      std::get<2>(sum) += memory_iter->second;
+      ++std::get<3>(sum);
+    }
+  }
+  op_type_costs_.clear();
+  for (auto& pair : sums) {
+    auto& sum = pair.second;
+    op_type_costs_[pair.first] = std::make_pair(
+        std::get<1>(sum) > 0 ? std::get<0>(sum) / std::get<1>(sum)
+                             : NOT_MEASURED,
+        std::get<3>(sum) > 0 ? std::get<2>(sum) / std::get<3>(sum)
+                             : NOT_MEASURED);
+  }
+}
+
+// The format is
+//   paddle_cost_data <version>
+//   whole <time_ms> <memory_bytes> <peak_memory_bytes>
+//   op <block_id> <op_id> <op_type> <time_ms> <run_count> <memory_bytes>
+//      <peak_memory_bytes>
+// per line, and NOT_MEASURED is saved as -1.
+bool CostData::Save(const std::string& path) const {
+  std::ofstream fout(path);
+  if (!fout.is_open()) {
+    LOG(WARNING) << "Cannot open " << path << " to save the cost data.";
+    return false;
+  }
+  fout.precision(17);
+  fout << kCostDataHeader << " " << kCostDataVersion << "\n";
+  fout << "whole " << whole_time_ms_ << " " << whole_memory_bytes_ << " "
+       << whole_peak_memory_bytes_ << "\n";
+  for (auto& pair : op_types_) {
+    int block_id = pair.first.first;
+    int op_id = pair.first.second;
+    fout << "op " << block_id << " " << op_id << " " << pair.second << " "
+         << GetOpTimeMs(block_id, op_id) << " "
+         << GetOpRunCount(block_id, op_id) << " "
+         << GetOpMemoryBytes(block_id, op_id) << " "
+         << GetOpPeakMemoryBytes(block_id, op_id) << "\n";
+  }
+  fout.close();
+  return !fout.fail();
+}
+
+bool CostData::Load(const std::string& path) {
+  std::ifstream fin(path);
+  if (!fin.is_open()) {
+    LOG(WARNING) << "Cannot open " << path << " to load the cost data.";
+    return false;
+  }
+  std::string header;
+  int version = -1;
+  fin >> header >> version;
+  if (header != kCostDataHeader || version != kCostDataVersion) {
+    LOG(WARNING) << path << " is not the cost data of version "
+                 << kCostDataVersion << ".";
+    return false;
+  }
+
+  CostData cost_data;
+  std::string line;
+  std::getline(fin, line);
+  while (std::getline(fin, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream is(line);
+    std::string tag;
+    is >> tag;
+    if (tag == "whole") {
+      is >> cost_data.whole_time_ms_ >> cost_data.whole_memory_bytes_ >>
+          cost_data.whole_peak_memory_bytes_;
+    } else if (tag == "op") {
+      OpKey key;
+      std::string op_type;
+      double time_ms, memory_bytes, peak_memory_bytes;
+      int run_count;
+      is >> key.first >> key.second >> op_type >> time_ms >> run_count >>
+          memory_bytes >> peak_memory_bytes;
+      if (is.fail()) {
+        LOG(WARNING) << "Invalid line in the cost data " << path << ": "
+                     << line;
+        return false;
+      }
+      cost_data.op_types_[key] = op_type;
+      if (time_ms != NOT_MEASURED) {
+        cost_data.op_time_ms_[key] = time_ms;
+        cost_data.op_run_count_[key] = run_count;
+      }
+      if (memory_bytes != NOT_MEASURED) {
+        cost_data.op_memory_bytes_[key] = memory_bytes;
+      }
+      if (peak_memory_bytes != NOT_MEASURED) {
+        cost_data.op_peak_memory_bytes_[key] = peak_memory_bytes;
+      }
+    }
+    if (is.fail() || (tag != "whole" && tag != "op")) {
+      LOG(WARNING) << "Invalid line in the cost data " << path << ": "
+                   << line;
+      return false;
+    }
+  }
+  cost_data.BuildOpTypeCosts();
+  *this = std::move(cost_data);
+  return true;
+}
+
+const CostData* GetProfiledCostData() {
+  static std::unique_ptr<CostData> cost_data = [] {
+    std::unique_ptr<CostData> data;
+    if (!FLAGS_cost_model_profile_path.empty()) {
+      data.reset(new CostData());
+      if (!data->Load(FLAGS_cost_model_profile_path)) {
+        LOG(WARNING) << "Failed to load the cost data from "
+                     << FLAGS_cost_model_profile_path
+                     << ", no profile is used.";
+        data.reset();
+      }
+    }
+    return data;
+  }();
+  return cost_data.get();
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/platform/event.h"
+
+namespace paddle {
+namespace framework {
+
+class Scope;
+
+namespace ir {
+class Graph;
+}  // namespace ir
+
+class CostData {
+ public:
+  // (block id, op index in the block)
+  using OpKey = std::pair<int, int>;
+
+  CostData() {}
+
+  ~CostData();
+
+  // Ops of the global block
+  double GetOpTimeMs(int op_id) const;
+  double GetOpMemoryBytes(int op_id) const;
+
+  // The time of all the runs of the op, the ops in the sub-blocks may run
+  // many times in a run of the program.
+  double GetOpTimeMs(int block_id, int op_id) const;
+  int GetOpRunCount(int block_id, int op_id) const;
+  // The bytes of the input and output tensors of the op.
+  double GetOpMemoryBytes(int block_id, int op_id) const;
+  // The bytes of the tensors alive while the op is running.
+  double GetOpPeakMemoryBytes(int block_id, int op_id) const;
+  bool HasOpCost(int block_id, int op_id) const;
+
+  double GetWholeTimeMs() const;
+  double GetWholeMemoryBytes() const;
+  double GetWholePeakMemoryBytes() const;
+
+  // The average cost of a run of the measured ops of a type, or
+  // NOT_MEASURED. Used by the callers whose ops can not be mapped to the
+  // measured program, e.g. the executors and the passes which transform it.
+  double GetOpTypeTimeMs(const std::string& op_type) const;
+  double GetOpTypeMemoryBytes(const std::string& op_type) const;
+
+  const ir::Graph* GetGraph() const;
+  const ProgramDesc* GetProgram() const;
+
+  // Set the time costs of the ops in all blocks from the time events. The ops
+  // of a sub-block are matched to the events nested in the events of the op
+  // holding the sub-block, and the time of all the runs is summed.
+  bool SetCostData(
+      const ProgramDesc& program,
+      const std::vector<std::vector<platform::Event>>& time_events);
+
+  // Set the memory costs from the tensors left in the scope by a run without
+  // garbage collection. The peak bytes of the global block ops are estimated
+  // by releasing the non-persistable tensors after their last use, as the
+  // garbage collector does.
+  void SetMemoryCostData(const ProgramDesc& program, const Scope& scope);
+
+  // Persist the costs to a text file, and load them back.
+  bool Save(const std::string& path) const;
+  bool Load(const std::string& path);
+
+  static const double NOT_MEASURED;
+
+ private:
+  void BuildOpTypeCosts();
+
+  ir::Graph* graph_{nullptr};
+  ProgramDesc* program_{nullptr};
+  std::map<OpKey, std::string> op_types_;
+  std::map<OpKey, double> op_time_ms_;        // from Op id to time
+  std::map<OpKey, int> op_run_count_;         // from Op id to run times
+  std::map<OpKey, double> op_memory_bytes_;   // from Op id to memory bytes
+  std::map<OpKey, double> op_peak_memory_bytes_;  // from Op id to peak bytes
+  std::map<OpKey, double> comm_;  // from Op id to communicate cost
+  // from Op type to the average time and memory bytes of a run
+  std::unordered_map<std::string, std::pair<double, double>> op_type_costs_;
+  double whole_time_ms_{
+      NOT_MEASURED};  // time cost of the whole program or graph
+  double whole_memory_bytes_{
+      NOT_MEASURED};  // memory cost of the whole program or graph
+  double whole_peak_memory_bytes_{
+      NOT_MEASURED};  // peak memory of the whole program or graph
+  double whole_comm_{
+      NOT_MEASURED};  // communication cost of the whole program or graph
+};
+
+// The cost data loaded from FLAGS_cost_model_profile_path, which the
+// executors and the IR passes query to make cost-driven choices. Returns
+// nullptr if no profile is set or it fails to load.
+const CostData* GetProfiledCostData();
+
+}  // namespace framework
+}  // namespace paddle
@@ -23,134 +23,9 @@
 namespace paddle {
 namespace framework {
 
-using ir::Graph;
 using platform::Event;
 using platform::MemEvent;
 
-const double CostData::NOT_MEASURED = -1;
-
-CostData::~CostData() {
-  // TODO(zhhsplendid): when we save a copy of program/graph, we should delete
-  // here.
-}
-
-double CostData::GetOpTimeMs(int op_id) const { return op_time_ms_.at(op_id); }
-double CostData::GetOpMemoryBytes(int op_id) const {
-  return op_memory_bytes_.at(op_id);
-}
-double CostData::GetWholeTimeMs() const { return whole_time_ms_; }
-double CostData::GetWholeMemoryBytes() const { return whole_memory_bytes_; }
-
-const Graph* CostData::GetGraph() const { return graph_; }
-const ProgramDesc* CostData::GetProgram() const { return program_; }
-
-bool CostData::SetCostData(const ProgramDesc& program,
-                           const std::vector<std::vector<Event>>& time_events) {
-  // TODO(zhhsplendid): Make a copy so that CostData can be available even if
-  // SWE changes Program, the copy can be saved into pointer program_
-  if (program.Size() == 0) {
-    whole_time_ms_ = 0;
-    whole_memory_bytes_ = 0;
-    return true;
-  }
-
-  if (time_events.empty()) {
-    LOG(WARNING) << "Input time_events for CostModel is empty";
-    return false;
-  }
-
-  std::vector<Event> main_thread_events = time_events[0];
-  // Support global block only
-  // TODO(zhhsplendid): support sub blocks
-  const BlockDesc& global_block = program.Block(0);
-  size_t op_size = global_block.OpSize();
-  if (op_size == 0) {
-    whole_time_ms_ = 0;
-    whole_memory_bytes_ = 0;
-    return true;
-  }
-
-  bool event_to_cost_success = true;
-  size_t event_index = 0;
-  for (size_t i = 0; i < op_size; ++i) {
-    const OpDesc* op_desc = global_block.Op(i);
-    std::string op_type = op_desc->Type();
-
-    while (event_index < main_thread_events.size()) {
-      if (main_thread_events[event_index].name() == op_type &&
-          main_thread_events[event_index].type() ==
-              platform::EventType::kPushRange) {
-        break;
-      }
-      ++event_index;
-    }
-    if (event_index >= main_thread_events.size()) {
-      LOG(WARNING) << "Input time_events for Op " << i << ", type '" << op_type
-                   << "' have wrong format, skip this Op.";
-      event_to_cost_success = false;
-      continue;
-    }
-    size_t op_push_index = event_index;
-
-    while (event_index < main_thread_events.size()) {
-      // Is it possible to Push a lot of Ops with same type and then Pop?
-      // ControlFlow Op can be like that, but this version only support global
-      // block
-      // TODO(zhhsplendid): make a more strict mapping between push and pop
-      if (main_thread_events[event_index].name() == op_type &&
-          main_thread_events[event_index].type() ==
-              platform::EventType::kPopRange) {
-        break;
-      }
-      ++event_index;
-    }
-    if (event_index >= main_thread_events.size()) {
-      LOG(WARNING) << "Input time_events for Op " << i << ", type '" << op_type
-                   << "' have wrong format, skip this Op.";
-      event_to_cost_success = false;
-      continue;
-    }
-    size_t op_pop_index = event_index;
-    double cpu_time_ms = main_thread_events[op_push_index].CpuElapsedMs(
-        main_thread_events[op_pop_index]);
-    double gpu_time_ms = 0;
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    gpu_time_ms = main_thread_events[op_push_index].CudaElapsedMs(
-        main_thread_events[op_pop_index]);
-#endif
-    double time_ms = gpu_time_ms + cpu_time_ms;
-    op_time_ms_[i] = time_ms;
-  }
-
-  event_index = 0;
-  int start_profiler_idx = -1;
-  int stop_profiler_idx = -1;
-  while (event_index < main_thread_events.size()) {
-    if (main_thread_events[event_index].name() == "_start_profiler_") {
-      start_profiler_idx = event_index;
-    } else if (main_thread_events[event_index].name() == "_stop_profiler_") {
-      stop_profiler_idx = event_index;
-      break;
-    }
-    ++event_index;
-  }
-  if (start_profiler_idx != -1 && stop_profiler_idx != -1) {
-    double cpu_time_ms = main_thread_events[start_profiler_idx].CpuElapsedMs(
-        main_thread_events[stop_profiler_idx]);
-    double gpu_time_ms = 0;
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    gpu_time_ms = main_thread_events[start_profiler_idx].CudaElapsedMs(
-        main_thread_events[stop_profiler_idx]);
-#endif
-    whole_time_ms_ = gpu_time_ms + cpu_time_ms;
-  } else {
-    LOG(WARNING) << "Input time_events for whole time have wrong format";
-    event_to_cost_success = false;
-  }
-
-  return event_to_cost_success;
-}
-
 void PrintEvents(const std::vector<std::vector<Event>>* time_events,
                  const std::vector<std::vector<MemEvent>>* mem_events) {
   if (time_events != nullptr) {
@@ -232,7 +107,12 @@ CostData CostModel::ProfileMeasure(
   // TODO(zhhsplendid): handle the case that Profiler is already enabled
   SetTracerOption(platform::TracerOption::kAllOpDetail);
   EnableProfiler(profiler_state);
-  executor.Run(main_program, &scope, /*block_id = */ 0);
+  // The variables of all blocks are kept in the scope and its kid scopes
+  // without garbage collection, to measure the memory costs.
+  executor.Run(main_program, &scope, /*block_id = */ 0,
+               /*create_local_scope = */ false, /*create_vars = */ true,
+               /*skip_ref_cnt_vars = */ {}, /*force_disable_gc = */ true,
+               /*keep_kid_scopes = */ true);
 
   std::unique_ptr<std::vector<std::vector<Event>>> time_events(
       new std::vector<std::vector<Event>>());
@@ -248,6 +128,7 @@ CostData CostModel::ProfileMeasure(
   // Convert events to cost data
   CostData cost_data;
   cost_data.SetCostData(main_program, *time_events);
+  cost_data.SetMemoryCostData(main_program, scope);
 
   return cost_data;
 }
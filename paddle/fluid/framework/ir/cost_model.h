@@ -22,6 +22,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "paddle/fluid/framework/ir/cost_data.h"
 #include "paddle/fluid/framework/ir/graph.h"
 #include "paddle/fluid/framework/ir/node.h"
 #include "paddle/fluid/framework/program_desc.h"
@@ -31,50 +32,13 @@
 namespace paddle {
 namespace framework {
 
-class CostData {
- public:
-  CostData() {}
-
-  ~CostData();
-
-  // Support global block only
-  // TODO(zhhsplendid): add support for sub-block
-  double GetOpTimeMs(int op_id) const;
-  double GetOpMemoryBytes(int op_id) const;
-  double GetWholeTimeMs() const;
-  double GetWholeMemoryBytes() const;
-
-  const ir::Graph* GetGraph() const;
-  const ProgramDesc* GetProgram() const;
-
-  // Support Time Event only
-  // TODO(zhhsplendid): add memory
-  bool SetCostData(
-      const ProgramDesc& program,
-      const std::vector<std::vector<platform::Event>>& time_events);
-
-  static const double NOT_MEASURED;
-
- private:
-  ir::Graph* graph_{nullptr};
-  ProgramDesc* program_{nullptr};
-  std::map<int, double> op_time_ms_;  // from Op Node id to time
-  std::map<int, double>
-      op_memory_bytes_;         // from Op Node id to total memory bytes
-  std::map<int, double> comm_;  // from Op Node id to communicate cost
-  double whole_time_ms_{
-      NOT_MEASURED};  // time cost of the whole program or graph
-  double whole_memory_bytes_{
-      NOT_MEASURED};  // memory cost of the whole program or graph
-  double whole_comm_{
-      NOT_MEASURED};  // communication cost of the whole program or graph
-};
-
 class CostModel {
  public:
   CostModel() {}
   ~CostModel() {}
 
+  // Run the main program once with the profiler, and measure the time, the
+  // memory traffic and the peak memory of its ops in all blocks.
   CostData ProfileMeasure(
       const ProgramDesc& main_program, const ProgramDesc& startup_program,
       const std::string& device,
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/fluid/framework/ir/cost_model.h"
+#include <fstream>
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/operator.h"
@@ -129,6 +130,14 @@ TEST(CostModelTest, TestProfileMeasure_Program) {
   EXPECT_GT(op0_time_ms, 0);
   EXPECT_GT(op1_time_ms, 0);
   EXPECT_GT(cost_data.GetWholeTimeMs(), op0_time_ms + op1_time_ms);
+  EXPECT_EQ(cost_data.GetOpRunCount(0, 0), 1);
+  EXPECT_EQ(cost_data.GetOpRunCount(0, 1), 1);
+  // The tensors are kept in the scope after the run
+  EXPECT_GE(cost_data.GetOpMemoryBytes(0), 0);
+  EXPECT_GE(cost_data.GetOpPeakMemoryBytes(0, 0), 0);
+  EXPECT_GE(cost_data.GetWholePeakMemoryBytes(), 0);
+  EXPECT_EQ(cost_data.GetOpPeakMemoryBytes(0, 2), CostData::NOT_MEASURED);
+  EXPECT_GT(cost_data.GetOpTypeTimeMs("fake_test_op"), 0);
 }
 
 TEST(CostModelTest, TestProfileMeasure_UnsupportedDevice) {
@@ -205,5 +214,53 @@ TEST(CostDataTest, TestNoWholeEvent) {
   EXPECT_EQ(cost_data.SetCostData(program, time_events), false);
 }
 
+TEST(CostDataTest, TestSaveLoad) {
+  CostData cost_data;
+  ProgramDesc program = CreateTestProgram();
+  std::vector<platform::Event> thread_events;
+  thread_events.push_back(
+      platform::Event(platform::EventType::kPushRange, "_start_profiler_", 0));
+  for (int i = 0; i < 2; ++i) {
+    thread_events.push_back(
+        platform::Event(platform::EventType::kPushRange, "fake_test_op", 0));
+    thread_events.push_back(
+        platform::Event(platform::EventType::kPopRange, "fake_test_op", 0));
+  }
+  thread_events.push_back(
+      platform::Event(platform::EventType::kPushRange, "_stop_profiler_", 0));
+  std::vector<std::vector<platform::Event>> time_events{thread_events};
+  EXPECT_EQ(cost_data.SetCostData(program, time_events), true);
+  EXPECT_EQ(cost_data.GetOpRunCount(0, 1), 1);
+  EXPECT_EQ(cost_data.GetOpMemoryBytes(0), CostData::NOT_MEASURED);
+
+  std::string path = "cost_data_test.txt";
+  EXPECT_TRUE(cost_data.Save(path));
+  CostData loaded;
+  EXPECT_TRUE(loaded.Load(path));
+  EXPECT_EQ(loaded.GetWholeTimeMs(), cost_data.GetWholeTimeMs());
+  EXPECT_EQ(loaded.GetOpTimeMs(0), cost_data.GetOpTimeMs(0));
+  EXPECT_EQ(loaded.GetOpTimeMs(1), cost_data.GetOpTimeMs(1));
+  EXPECT_EQ(loaded.GetOpRunCount(0, 0), 1);
+  EXPECT_TRUE(loaded.HasOpCost(0, 1));
+  EXPECT_FALSE(loaded.HasOpCost(0, 2));
+  EXPECT_EQ(loaded.GetOpMemoryBytes(0), CostData::NOT_MEASURED);
+  EXPECT_EQ(loaded.GetOpTypeTimeMs("fake_test_op"),
+            cost_data.GetOpTypeTimeMs("fake_test_op"));
+  EXPECT_EQ(loaded.GetOpTypeTimeMs("not_exist_op"), CostData::NOT_MEASURED);
+}
+
+TEST(CostDataTest, TestLoadInvalidFile) {
+  CostData cost_data;
+  EXPECT_FALSE(cost_data.Load("not_exist_cost_data.txt"));
+
+  std::string path = "invalid_cost_data.txt";
+  {
+    std::ofstream fout(path);
+    fout << "paddle_cost_data 1\nop 0 x fake_test_op\n";
+  }
+  EXPECT_FALSE(cost_data.Load(path));
+  EXPECT_EQ(cost_data.GetWholeTimeMs(), CostData::NOT_MEASURED);
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -63,6 +63,11 @@ ir::Graph *FuseElewiseAddActPass::FuseElewiseAddAct(
     GET_IR_NODE_FROM_SUBGRAPH(act_out, act_out, elewise_add_act_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(act, act, elewise_add_act_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(ele_add, ele_add, elewise_add_act_pattern);
+    if (!IsFusionProfitable({ele_add->Op()->Type(), act->Op()->Type()},
+                            "fused_elemwise_add_activation")) {
+      VLOG(4) << "skip FuseElewiseAddAct fuse, which is slower in the profile";
+      return;
+    }
 
     std::string ele_x_n = subgraph.at(x)->Name();
     std::string ele_y_n = ele_y->Name();
@@ -115,6 +120,11 @@ ir::Graph *FuseElewiseAddActPass::FuseActElewiseAdd(
                               act_elewise_add_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(act, act, act_elewise_add_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(ele_add, ele_add, act_elewise_add_pattern);
+    if (!IsFusionProfitable({act->Op()->Type(), ele_add->Op()->Type()},
+                            "fused_elemwise_add_activation")) {
+      VLOG(4) << "skip FuseActElewiseAdd fuse, which is slower in the profile";
+      return;
+    }
 
     std::string act_i_n = subgraph.at(x)->Name();
     std::string act_o_n = act_out->Name();
@@ -170,6 +180,13 @@ ir::Graph *FuseElewiseAddActPass::FuseElewiseAddActInplaceGrad(
                               elewise_add_act_grad_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(d_ele_x, d_ele_x, elewise_add_act_grad_pattern);
     GET_IR_NODE_FROM_SUBGRAPH(d_ele_y, d_ele_y, elewise_add_act_grad_pattern);
+    if (!IsFusionProfitable(
+            {act_grad->Op()->Type(), ele_add_grad->Op()->Type()},
+            "fused_elemwise_add_activation_grad")) {
+      VLOG(4) << "skip FuseElewiseAddActGrad1 fuse, which is slower in the "
+                 "profile";
+      return;
+    }
 
     std::string d_act_out_n = subgraph.at(d_act_out)->Name();
     std::string act_out_n = act_out->Name();
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/ir/fuse_pass_base.h"
 
+#include "paddle/fluid/framework/ir/cost_data.h"
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -75,6 +76,24 @@ FuseOptions FusePassBase::FindFuseOption(const Node& node1,
 #endif
 }
 
+bool FusePassBase::IsFusionProfitable(const std::vector<std::string>& op_types,
+                                      const std::string& fused_op_type) const {
+  const CostData* cost_data = GetProfiledCostData();
+  if (cost_data == nullptr) return true;
+  double fused_time_ms = cost_data->GetOpTypeTimeMs(fused_op_type);
+  if (fused_time_ms == CostData::NOT_MEASURED) return true;
+  double time_ms = 0;
+  for (auto& op_type : op_types) {
+    double op_time_ms = cost_data->GetOpTypeTimeMs(op_type);
+    if (op_time_ms == CostData::NOT_MEASURED) return true;
+    time_ms += op_time_ms;
+  }
+  VLOG(3) << "The profiled time of " << fused_op_type << " is "
+          << fused_time_ms << " ms, and the ops it replaces take " << time_ms
+          << " ms.";
+  return fused_time_ms < time_ms;
+}
+
 }  // namespace ir
 }  // namespace framework
 }  // namespace paddle
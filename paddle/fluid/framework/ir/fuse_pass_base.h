@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/framework/ir/graph.h"
 #include "paddle/fluid/framework/ir/op_compat_sensible_pass.h"
@@ -58,6 +59,12 @@ class FusePassBase : public OpCompatSensiblePass {
   virtual FuseOptions FindFuseOption(const Node& node1,
                                      const Node& node2) const;
 
+  // Whether the fused op is measured faster than the ops it replaces in the
+  // profile set by FLAGS_cost_model_profile_path. Returns true if there is no
+  // profile or any of the ops is not measured.
+  bool IsFusionProfitable(const std::vector<std::string>& op_types,
+                          const std::string& fused_op_type) const;
+
   mutable Graph* graph_;
   mutable std::string repr_;
 };
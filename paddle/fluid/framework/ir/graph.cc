@@ -370,6 +370,55 @@ std::unique_ptr<Graph> Graph::CloneSubGraph(const size_t idx) {
   return cloned_sub_graph;
 }
 
+void Graph::SyncOpTypeIndex() {
+  if (FLAGS_convert_all_blocks) {
+    if (IsMainGraph()) {
+      return GetSubGraph(0)->SyncOpTypeIndex();
+    }
+  }
+  std::vector<ir::Node *> changed_nodes;
+  for (auto iter = op_type_index_.begin(); iter != op_type_index_.end();) {
+    auto &nodes = iter->second;
+    for (auto node_iter = nodes.begin(); node_iter != nodes.end();) {
+      if ((*node_iter)->Op()->Type() != iter->first) {
+        changed_nodes.push_back(*node_iter);
+        node_iter = nodes.erase(node_iter);
+      } else {
+        ++node_iter;
+      }
+    }
+    if (nodes.empty()) {
+      iter = op_type_index_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  for (auto *node : changed_nodes) {
+    VLOG(4) << "Re-index op node " << node->Name() << " as "
+            << node->Op()->Type();
+    op_type_index_[node->Op()->Type()].insert(node);
+  }
+}
+
+void Graph::EraseFromOpTypeIndex(ir::Node *node) {
+  auto iter = op_type_index_.find(node->Op()->Type());
+  if (iter != op_type_index_.end() && iter->second.erase(node)) {
+    if (iter->second.empty()) {
+      op_type_index_.erase(iter);
+    }
+    return;
+  }
+  // The type of the OpDesc was changed after the node was indexed.
+  for (iter = op_type_index_.begin(); iter != op_type_index_.end(); ++iter) {
+    if (iter->second.erase(node)) {
+      if (iter->second.empty()) {
+        op_type_index_.erase(iter);
+      }
+      return;
+    }
+  }
+}
+
 bool IsControlDepVar(const ir::Node &var) {
   return var.Name().find(ir::Node::kControlDepVarName) != std::string::npos;
 }
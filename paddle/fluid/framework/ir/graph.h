@@ -18,6 +18,7 @@ limitations under the License. */
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -293,6 +294,7 @@ class Graph {
     }
     nodes_.clear();
     node_set_.clear();
+    op_type_index_.clear();
     return ret;
   }
 
@@ -309,9 +311,30 @@ class Graph {
     ret.reset(nodes_.at(node).release());
     nodes_.erase(node);
     node_set_.erase(node);
+    if (node->IsOp() && node->Op()) {
+      EraseFromOpTypeIndex(node);
+    }
     return ret;
   }
 
+  // The op nodes whose OpDesc has the type op_type. The index is updated
+  // incrementally when nodes are added or removed, call SyncOpTypeIndex first
+  // if the type of an OpDesc may have been changed in place.
+  const std::unordered_set<ir::Node *> &OpNodesOfType(
+      const std::string &op_type) const {
+    if (FLAGS_convert_all_blocks) {
+      if (IsMainGraph()) {
+        return GetSubGraph(0)->OpNodesOfType(op_type);
+      }
+    }
+    static const std::unordered_set<ir::Node *> empty_set;
+    auto iter = op_type_index_.find(op_type);
+    return iter == op_type_index_.end() ? empty_set : iter->second;
+  }
+
+  // Re-index the op nodes whose OpDesc type was changed by OpDesc::SetType.
+  void SyncOpTypeIndex();
+
   // NOTE low performance, but simple and secure.
   Node *RetrieveNode(int id) {
     if (FLAGS_convert_all_blocks) {
@@ -352,6 +375,9 @@ class Graph {
                           "The node to be added already exists."));
     nodes_[node].reset(node);
     node_set_.insert(node);
+    if (node->IsOp() && node->Op()) {
+      op_type_index_[node->Op()->Type()].insert(node);
+    }
     return node;
   }
 
@@ -420,6 +446,8 @@ class Graph {
 
   std::unique_ptr<Graph> CloneSubGraph(const size_t idx);
 
+  void EraseFromOpTypeIndex(ir::Node *node);
+
   // NOTE: program_ shouldn't be exposed to user.
   const ProgramDesc program_;
   // NOTE: main_graph_ doesn't hold any node. It's used as a container of
@@ -431,6 +459,9 @@ class Graph {
   std::map<std::string, std::function<void(void)>> attr_dels_;
   std::map<ir::Node *, std::unique_ptr<ir::Node>> nodes_;
   std::unordered_set<ir::Node *> node_set_;
+  // The op nodes indexed by the type of their OpDesc.
+  std::unordered_map<std::string, std::unordered_set<ir::Node *>>
+      op_type_index_;
   size_t num_node_created_{0};  // help to generate a unique node id.
   // NOTE(Aurelius84): Whether is constructed with partial ProgramDesc.
   // In case of @to_static, whole trainning program is splited into two
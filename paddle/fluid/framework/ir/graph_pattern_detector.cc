@@ -77,6 +77,7 @@ void PDPattern::AddEdge(PDNode *a, PDNode *b) {
 
 void GraphPatternDetector::operator()(Graph *graph,
                                       GraphPatternDetector::handle_t handler) {
+  graph->SyncOpTypeIndex();
   if (!MarkPDNodesInGraph(*graph)) {
     return;
   }
@@ -100,11 +101,22 @@ bool GraphPatternDetector::MarkPDNodesInGraph(const ir::Graph &graph) {
   VLOG(3) << "mark pdnodes in graph";
   if (graph.Nodes().empty()) return false;
 
-  for (auto &node : GraphTraits::DFS(graph)) {
-    for (const auto &pdnode : pattern_.nodes()) {
-      if (pdnode->Tell(&node)) {
-        VLOG(4) << "Node " << node.Name() << " marked as " << pdnode->name();
-        pdnodes2nodes_[pdnode.get()].insert(&node);
+  // Only the PDNodes whose candidates can't be collected from the op type
+  // index need to tell all the nodes of the graph.
+  std::vector<const PDNode *> unindexed_pdnodes;
+  for (const auto &pdnode : pattern_.nodes()) {
+    if (!MarkIndexedPDNode(graph, pdnode.get())) {
+      unindexed_pdnodes.push_back(pdnode.get());
+    }
+  }
+
+  if (!unindexed_pdnodes.empty()) {
+    for (auto &node : GraphTraits::DFS(graph)) {
+      for (const auto *pdnode : unindexed_pdnodes) {
+        if (pdnode->Tell(&node)) {
+          VLOG(4) << "Node " << node.Name() << " marked as " << pdnode->name();
+          pdnodes2nodes_[pdnode].insert(&node);
+        }
       }
     }
   }
@@ -120,6 +132,42 @@ bool GraphPatternDetector::MarkPDNodesInGraph(const ir::Graph &graph) {
   return !pdnodes2nodes_.empty();
 }
 
+bool GraphPatternDetector::MarkIndexedPDNode(const ir::Graph &graph,
+                                             const PDNode *pdnode) {
+  if (pdnode->teller_ || pdnode->index_hint_ == PDNode::IndexHint::kNone) {
+    return false;
+  }
+
+  auto mark = [&](Node *node) {
+    if (node && pdnode->Tell(node)) {
+      VLOG(4) << "Node " << node->Name() << " marked as " << pdnode->name();
+      pdnodes2nodes_[pdnode].insert(node);
+    }
+  };
+  for (const auto &op_type : pdnode->index_op_types_) {
+    for (auto *op : graph.OpNodesOfType(op_type)) {
+      switch (pdnode->index_hint_) {
+        case PDNode::IndexHint::kOpType:
+          mark(op);
+          break;
+        case PDNode::IndexHint::kOpInput:
+          for (auto *var : op->inputs) {
+            mark(var);
+          }
+          break;
+        case PDNode::IndexHint::kOpOutput:
+          for (auto *var : op->outputs) {
+            mark(var);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return true;
+}
+
 // The intermediate Nodes can only link to the nodes inside the pattern, or this
 // subgraph will be dropped.
 void GraphPatternDetector::ValidateByNodeRole(
@@ -402,6 +450,7 @@ PDNode *PDNode::assert_is_op() {
 }
 
 PDNode *PDNode::assert_is_op(const std::string &op_type) {
+  SetIndexHint(IndexHint::kOpType, {op_type});
   asserts_.emplace_back([op_type](Node *x) {
     return x && x->IsOp() && x->Op()->Type() == op_type;
   });
@@ -454,6 +503,7 @@ PDNode *PDNode::assert_is_op_nth_input(const std::string &op_type,
 
 PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
                                         const std::string &argument, int nth) {
+  SetIndexHint(IndexHint::kOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -467,6 +517,7 @@ PDNode *PDNode::assert_is_op_nth_output(const std::string &op_type,
 }
 
 PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
+  SetIndexHint(IndexHint::kOpInput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -481,6 +532,7 @@ PDNode *PDNode::assert_is_only_input_of_op(const std::string &op_type) {
 }
 
 PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
+  SetIndexHint(IndexHint::kOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -495,6 +547,7 @@ PDNode *PDNode::assert_is_only_output_of_op(const std::string &op_type) {
 }
 
 PDNode *PDNode::assert_is_op_output(const std::string &op_type) {
+  SetIndexHint(IndexHint::kOpOutput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -515,6 +568,7 @@ PDNode *PDNode::assert_is_op_output(const std::string &op_type,
 }
 
 PDNode *PDNode::assert_is_op_input(const std::string &op_type) {
+  SetIndexHint(IndexHint::kOpInput, {op_type});
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -572,6 +626,7 @@ PDNode *PDNode::assert_more(PDNode::teller_t &&teller) {
 }
 
 PDNode *PDNode::assert_is_ops(const std::unordered_set<std::string> &op_types) {
+  SetIndexHint(IndexHint::kOpType, op_types);
   asserts_.emplace_back([op_types](Node *x) {
     return x && x->IsOp() && op_types.count(x->Op()->Type());
   });
@@ -597,6 +652,7 @@ PDNode *PDNode::assert_is_ops_nth_input(
 PDNode *PDNode::assert_is_ops_nth_output(
     const std::unordered_set<std::string> &op_types,
     const std::string &argument, int nth) {
+  SetIndexHint(IndexHint::kOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -610,6 +666,7 @@ PDNode *PDNode::assert_is_ops_nth_output(
 }
 PDNode *PDNode::assert_is_ops_output(
     const std::unordered_set<std::string> &op_types) {
+  SetIndexHint(IndexHint::kOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
@@ -632,6 +689,7 @@ PDNode *PDNode::assert_is_ops_output(
 
 PDNode *PDNode::assert_is_ops_input(
     const std::unordered_set<std::string> &op_types) {
+  SetIndexHint(IndexHint::kOpInput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -654,6 +712,7 @@ PDNode *PDNode::assert_is_ops_input(
 
 PDNode *PDNode::assert_is_only_input_of_ops(
     const std::unordered_set<std::string> &op_types) {
+  SetIndexHint(IndexHint::kOpInput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->outputs) {
@@ -669,6 +728,7 @@ PDNode *PDNode::assert_is_only_input_of_ops(
 
 PDNode *PDNode::assert_is_only_output_of_ops(
     const std::unordered_set<std::string> &op_types) {
+  SetIndexHint(IndexHint::kOpOutput, op_types);
   assert_is_var();
   asserts_.emplace_back([=](Node *x) {
     for (auto *op : x->inputs) {
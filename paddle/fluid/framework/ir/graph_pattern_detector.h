@@ -179,7 +179,27 @@ struct PDNode {
 
   PDNode(PDNode&& other) = default;
 
+  // How the candidates of this node can be collected from the op type index
+  // of the graph, instead of telling every node of the graph.
+  enum class IndexHint {
+    kNone,     // all the nodes of the graph are candidates,
+    kOpType,   // the op nodes of index_op_types_,
+    kOpInput,  // the inputs of the op nodes of index_op_types_,
+    kOpOutput  // the outputs of the op nodes of index_op_types_.
+  };
+
+  // Only the first hint is kept, since the node must satisfy all the
+  // assertions, any of them gives a superset of the matched nodes.
+  void SetIndexHint(IndexHint hint,
+                    const std::unordered_set<std::string>& op_types) {
+    if (index_hint_ == IndexHint::kNone) {
+      index_hint_ = hint;
+      index_op_types_ = op_types;
+    }
+  }
+
   friend class PDPattern;
+  friend class GraphPatternDetector;
 
   // Will removed latter.
   teller_t teller_;
@@ -188,6 +208,8 @@ struct PDNode {
   std::string name_;
   Type type_;
   Role role_{Role::kUnknown};
+  IndexHint index_hint_{IndexHint::kNone};
+  std::unordered_set<std::string> index_op_types_;
 };
 
 /*
@@ -292,6 +314,10 @@ class GraphPatternDetector {
   // Mark the nodes that fits the pattern.
   bool MarkPDNodesInGraph(const ir::Graph& graph);
 
+  // Mark the candidates of pdnode collected from the op type index of graph,
+  // return false if pdnode has no index hint.
+  bool MarkIndexedPDNode(const ir::Graph& graph, const PDNode* pdnode);
+
   // Detect all the pattern and output the hit records.
   std::vector<subgraph_t> DetectPatterns();
 
@@ -203,6 +203,61 @@ TEST(GraphPatternDetector, IntermediateCheck) {
   ASSERT_EQ(count, 1);
 }
 
+static int CountSubgraphsOfActOutput(Graph* graph, const std::string& act) {
+  GraphPatternDetector detector;
+  auto* op = detector.mutable_pattern()->NewNode("act")->assert_is_op(act);
+  auto* out = detector.mutable_pattern()
+                  ->NewNode("act_out")
+                  ->assert_is_op_output(act, "Out");
+  op->LinksTo({out});
+
+  int count = 0;
+  detector(graph, [&](const GraphPatternDetector::subgraph_t& g,
+                      Graph* graph) { ++count; });
+  return count;
+}
+
+TEST(GraphPatternDetector, OpTypeIndex) {
+  // a -> relu -> b -> sigmoid -> c -> tanh -> d
+  ProgramDesc program;
+  auto* block = program.MutableBlock(0);
+  for (auto name : {"a", "b", "c", "d"}) {
+    block->Var(name);
+  }
+  std::vector<std::string> types = {"relu", "sigmoid", "tanh"};
+  std::vector<std::string> vars = {"a", "b", "c", "d"};
+  for (size_t i = 0; i < types.size(); ++i) {
+    auto* op = block->AppendOp();
+    op->SetType(types[i]);
+    op->SetInput("X", {vars[i]});
+    op->SetOutput("Out", {vars[i + 1]});
+  }
+  Graph graph(program);
+  ASSERT_EQ(graph.OpNodesOfType("relu").size(), 1UL);
+  ASSERT_EQ(graph.OpNodesOfType("conv2d").size(), 0UL);
+  ASSERT_EQ(CountSubgraphsOfActOutput(&graph, "relu"), 1);
+
+  // The index follows the type changed in place.
+  Node* tanh = *graph.OpNodesOfType("tanh").begin();
+  tanh->Op()->SetType("relu");
+  ASSERT_EQ(CountSubgraphsOfActOutput(&graph, "relu"), 2);
+  ASSERT_EQ(CountSubgraphsOfActOutput(&graph, "tanh"), 0);
+  ASSERT_EQ(graph.OpNodesOfType("relu").size(), 2UL);
+  ASSERT_EQ(graph.OpNodesOfType("tanh").size(), 0UL);
+
+  // Removed nodes are dropped from the index.
+  Node* sigmoid = *graph.OpNodesOfType("sigmoid").begin();
+  for (auto* var : sigmoid->inputs) {
+    var->outputs.clear();
+  }
+  for (auto* var : sigmoid->outputs) {
+    var->inputs.clear();
+  }
+  graph.RemoveNode(sigmoid);
+  ASSERT_EQ(graph.OpNodesOfType("sigmoid").size(), 0UL);
+  ASSERT_EQ(CountSubgraphsOfActOutput(&graph, "sigmoid"), 0);
+}
+
 }  // namespace ir
 }  // namespace framework
 }  // namespace paddle
@@ -347,6 +347,64 @@ void DeserializeFromStream(std::istream &is, LoDTensor *tensor,
   TensorFromStream(is, static_cast<Tensor *>(tensor), dev_ctx);
 }
 
+size_t SkipLoDTensorInStream(std::istream &is) {
+  size_t total = 0;
+  auto skip = [&is, &total](size_t size) {
+    is.seekg(static_cast<std::streamoff>(size), is.cur);
+    total += size;
+  };
+  auto read = [&is, &total](void *dst, size_t size) {
+    is.read(reinterpret_cast<char *>(dst), static_cast<std::streamsize>(size));
+    total += size;
+  };
+  {
+    // the 1st field, unit32_t version for LoDTensor
+    uint32_t version;
+    read(&version, sizeof(version));
+    PADDLE_ENFORCE_EQ(
+        version, 0U,
+        platform::errors::InvalidArgument(
+            "Deserialize to tensor failed, maybe the loaded file is "
+            "not a paddle model(expected file format: 0, but %u found).",
+            version));
+  }
+  {
+    // the 2st field, LoD information
+    uint64_t lod_level;
+    read(&lod_level, sizeof(lod_level));
+    for (uint64_t i = 0; i < lod_level; ++i) {
+      uint64_t size;
+      read(&size, sizeof(size));
+      skip(size);
+    }
+  }
+  // the 3st field, Tensor: uint32_t version, int32_t desc size, desc, data
+  uint32_t version;
+  read(&version, sizeof(version));
+  PADDLE_ENFORCE_EQ(
+      version, 0U,
+      platform::errors::InvalidArgument(
+          "tensor version %u is not supported, Only version 0 is supported",
+          version));
+  int32_t size;
+  read(&size, sizeof(size));
+  PADDLE_ENFORCE_EQ(static_cast<bool>(is) && size >= 0, true,
+                    platform::errors::InvalidArgument(
+                        "Cannot read the tensor desc, the stream is broken."));
+  std::unique_ptr<char[]> buf(new char[size]);
+  read(buf.get(), size);
+  proto::VarType::TensorDesc desc;
+  PADDLE_ENFORCE_EQ(
+      desc.ParseFromArray(buf.get(), size), true,
+      platform::errors::InvalidArgument("Cannot parse tensor desc"));
+  int64_t numel = 1;
+  for (auto dim : desc.dims()) {
+    numel *= dim;
+  }
+  skip(static_cast<size_t>(numel) * SizeOfType(desc.data_type()));
+  return total;
+}
+
 std::vector<LoDTensor> LoDTensor::SplitLoDTensor(
     const std::vector<platform::Place> places) const {
   PADDLE_ENFORCE_GT(places.size(), 0,
@@ -241,6 +241,13 @@ void DeserializeFromStream(std::istream& is, LoDTensor* tensor,
                            const size_t& seek,
                            const std::vector<int64_t>& shape);
 
+/*
+ * Skip a LoDTensor written by SerializeToStream, only its headers are read.
+ * Returns the number of bytes it occupies in the stream, so that the tensors
+ * of a combined file can be indexed and loaded in parallel.
+ */
+size_t SkipLoDTensorInStream(std::istream& is);
+
 /*
  * Convert between length-based LoD and offset-based LoD.
  * The implementation of LoDTensor class use offset-based LoD.
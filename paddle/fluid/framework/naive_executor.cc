@@ -13,7 +13,12 @@
 // limitations under the License.
 
 #include "paddle/fluid/framework/naive_executor.h"
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "paddle/fluid/framework/arena_memory_planner.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/variable_helper.h"
 #include "paddle/fluid/platform/denormal.h"
@@ -23,6 +28,25 @@
 
 namespace paddle {
 namespace framework {
+
+// The alignment of the buffers in the memory arena.
+static constexpr size_t kArenaAlignment = 64;
+// The number of the cached arena plans, the cache is cleared when it is full.
+static constexpr size_t kMaxArenaPlans = 32;
+
+// A view of a range of the arena, which keeps the arena alive.
+class ArenaAllocation : public memory::Allocation {
+ public:
+  ArenaAllocation(const std::shared_ptr<memory::Allocation> &arena,
+                  size_t offset, size_t size)
+      : memory::Allocation(static_cast<uint8_t *>(arena->ptr()) + offset,
+                           size, arena->place()),
+        arena_(arena) {}
+
+ private:
+  std::shared_ptr<memory::Allocation> arena_;
+};
+
 void NaiveExecutor::Prepare(Scope *scope, const ProgramDesc &program_desc,
                             int block_id, bool with_feed_fetch_ops) {
   if (!scope) {
@@ -40,11 +64,269 @@ void NaiveExecutor::Run() {
   platform::AttachPointerHashToMKLDNNKey(this, place_);
 #endif
   platform::ScopedFlushDenormal flush;
-  for (auto &op : ops_) {
+  std::vector<int64_t> signature;
+  bool arena_planned = false;
+  if (arena_enabled_) {
+    signature = InputShapeSignature();
+    auto it = arena_plans_.find(signature);
+    if (it != arena_plans_.end()) {
+      BindArenaPlan(&it->second);
+      arena_planned = true;
+    }
+  }
+  last_run_sampled_ = latency_sampling_period_ > 0 &&
+                      num_runs_++ % latency_sampling_period_ == 0;
+  std::chrono::steady_clock::time_point run_start;
+  if (last_run_sampled_) {
+    run_start = std::chrono::steady_clock::now();
+  }
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    auto &op = ops_[i];
     VLOG(4) << std::this_thread::get_id() << " run "
             << op->DebugStringEx(scope_) << " on scope " << scope_;
     op->SetIsCalledByExecutor(false);
-    op->Run(*scope_, place_);
+    if (last_run_sampled_) {
+      auto op_start = std::chrono::steady_clock::now();
+      op->Run(*scope_, place_);
+      op_latencies_[i]->Record(WaitAndGetElapsedUs(op_start));
+    } else {
+      op->Run(*scope_, place_);
+    }
+  }
+  if (last_run_sampled_) {
+    run_latency_->Record(WaitAndGetElapsedUs(run_start));
+  }
+  if (arena_enabled_ && !arena_planned) {
+    BuildArenaPlan(std::move(signature));
+  }
+}
+
+void NaiveExecutor::EnableLatencySampling(double sampling_rate) {
+  PADDLE_ENFORCE_EQ(
+      sampling_rate >= 0.0 && sampling_rate <= 1.0, true,
+      platform::errors::InvalidArgument(
+          "The latency sampling rate should be in [0, 1], but got %f.",
+          sampling_rate));
+  // Skip the first run, which is slowed down by the allocations and the
+  // kernel choices.
+  num_runs_ = 1;
+  last_run_sampled_ = false;
+  if (sampling_rate == 0.0) {
+    latency_sampling_period_ = 0;
+    run_latency_.reset();
+    op_latencies_.clear();
+    return;
+  }
+  latency_sampling_period_ =
+      std::max<uint64_t>(std::llround(1.0 / sampling_rate), 1);
+  CreateLatencyHistograms();
+}
+
+void NaiveExecutor::CreateLatencyHistograms() {
+  run_latency_.reset(new platform::LatencyHistogram());
+  op_latencies_.clear();
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    op_latencies_.emplace_back(new platform::LatencyHistogram());
+  }
+}
+
+std::vector<std::pair<std::string, const platform::LatencyHistogram *>>
+NaiveExecutor::OpLatencies() const {
+  std::vector<std::pair<std::string, const platform::LatencyHistogram *>> res;
+  for (size_t i = 0; i < op_latencies_.size(); ++i) {
+    res.emplace_back(ops_[i]->Type(), op_latencies_[i].get());
+  }
+  return res;
+}
+
+void NaiveExecutor::ResetLatencies() {
+  if (run_latency_) {
+    run_latency_->Reset();
+  }
+  for (auto &latency : op_latencies_) {
+    latency->Reset();
+  }
+}
+
+double NaiveExecutor::WaitAndGetElapsedUs(
+    const std::chrono::steady_clock::time_point &start) const {
+  if (!platform::is_cpu_place(place_)) {
+    platform::DeviceContextPool::Instance().Get(place_)->Wait();
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+void NaiveExecutor::EnableMemoryArena(
+    const std::vector<std::string> &input_names,
+    const std::vector<std::string> &output_names) {
+  PADDLE_ENFORCE_NOT_NULL(scope_,
+                          platform::errors::PreconditionNotMet(
+                              "Need to init scope in NaiveExecutor firstly."));
+  arena_enabled_ = false;
+  arena_inputs_.clear();
+  arena_vars_.clear();
+  arena_excluded_vars_.clear();
+  arena_plans_.clear();
+  arena_.reset();
+
+  std::unordered_set<std::string> excluded_names(input_names.begin(),
+                                                 input_names.end());
+  excluded_names.insert(output_names.begin(), output_names.end());
+  std::unordered_map<Variable *, size_t> var_index;
+  std::unordered_set<Variable *> excluded_vars;
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    auto &op = ops_[i];
+    // The variables of the sub-blocks live in the kid scopes created while
+    // running, and can not be planned.
+    if (op->HasAttr("sub_block")) {
+      LOG(WARNING) << "The memory arena is disabled for the program with the "
+                   << op->Type() << " op holding a sub-block.";
+      return;
+    }
+    for (auto *var_map : {&op->Inputs(), &op->Outputs()}) {
+      for (auto &item : *var_map) {
+        for (auto &name : item.second) {
+          if (name == kEmptyVarName) {
+            continue;
+          }
+          // The persistable variables are created in the ancestor scope.
+          Variable *var = scope_->FindLocalVar(name);
+          if (var == nullptr || excluded_names.count(name)) {
+            var = scope_->FindVar(name);
+            if (var != nullptr && excluded_vars.insert(var).second) {
+              arena_excluded_vars_.push_back(var);
+            }
+            continue;
+          }
+          auto it = var_index.find(var);
+          if (it == var_index.end()) {
+            var_index.emplace(var, arena_vars_.size());
+            arena_vars_.emplace_back(var, std::make_pair(i, i));
+          } else {
+            arena_vars_[it->second].second.second = i;
+          }
+        }
+      }
+    }
+  }
+  for (auto &name : input_names) {
+    arena_inputs_.push_back(scope_->FindVar(name));
+  }
+  arena_enabled_ = true;
+}
+
+std::vector<int64_t> NaiveExecutor::InputShapeSignature() const {
+  std::vector<int64_t> signature;
+  for (auto *var : arena_inputs_) {
+    if (var == nullptr || !var->IsType<LoDTensor>()) {
+      signature.push_back(-1);
+      continue;
+    }
+    auto &tensor = var->Get<LoDTensor>();
+    auto &dims = tensor.dims();
+    signature.push_back(dims.size());
+    for (int i = 0; i < dims.size(); ++i) {
+      signature.push_back(dims[i]);
+    }
+    signature.push_back(tensor.IsInitialized() ? tensor.type() : -1);
+    // The sizes of the sequence ops depend on the LoD.
+    signature.push_back(tensor.lod().size());
+    for (auto &level : tensor.lod()) {
+      signature.push_back(level.size());
+      signature.insert(signature.end(), level.begin(), level.end());
+    }
+  }
+  return signature;
+}
+
+void NaiveExecutor::BuildArenaPlan(std::vector<int64_t> &&signature) {
+  // The tensors sharing a buffer, e.g. the output of an inplace reshape and
+  // its input, are grouped and placed as one buffer used by all their ops.
+  std::unordered_set<const memory::Allocation *> excluded_holders;
+  for (auto *var : arena_excluded_vars_) {
+    if (var->IsType<LoDTensor>() && var->Get<LoDTensor>().IsInitialized()) {
+      excluded_holders.insert(var->Get<LoDTensor>().Holder().get());
+    }
+  }
+
+  ArenaPlan plan;
+  std::vector<ArenaBuffer> buffers;
+  std::unordered_map<const memory::Allocation *, size_t> group_index;
+  for (auto &item : arena_vars_) {
+    Variable *var = item.first;
+    if (!var->IsType<LoDTensor>() || !var->Get<LoDTensor>().IsInitialized()) {
+      continue;
+    }
+    auto *tensor = var->GetMutable<LoDTensor>();
+    const memory::Allocation *holder = tensor->Holder().get();
+    if (excluded_holders.count(holder) ||
+        !platform::is_same_place(holder->place(), place_)) {
+      continue;
+    }
+    auto it = group_index.find(holder);
+    if (it == group_index.end()) {
+      group_index.emplace(holder, buffers.size());
+      buffers.push_back(
+          ArenaBuffer{item.second.first, item.second.second, holder->size()});
+      plan.groups.emplace_back(1, tensor);
+    } else {
+      auto &buffer = buffers[it->second];
+      buffer.first_op = std::min(buffer.first_op, item.second.first);
+      buffer.last_op = std::max(buffer.last_op, item.second.second);
+      plan.groups[it->second].push_back(tensor);
+    }
+  }
+  plan.arena_size = PlanArenaOffsets(buffers, kArenaAlignment, &plan.offsets);
+  for (auto &buffer : buffers) {
+    plan.sizes.push_back(buffer.size);
+  }
+
+  if (VLOG_IS_ON(3)) {
+    size_t total_size = 0;
+    for (auto &buffer : buffers) {
+      total_size += buffer.size;
+    }
+    VLOG(3) << "NaiveExecutor plans " << buffers.size()
+            << " buffers of total " << total_size << " bytes in the arena of "
+            << plan.arena_size << " bytes.";
+  }
+
+  if (arena_plans_.size() >= kMaxArenaPlans) {
+    VLOG(3) << "The arena plans of NaiveExecutor are full, clear "
+            << arena_plans_.size() << " plans.";
+    arena_plans_.clear();
+  }
+  auto &cached_plan = arena_plans_[std::move(signature)];
+  cached_plan = std::move(plan);
+  // Release the buffers allocated in this run.
+  BindArenaPlan(&cached_plan);
+}
+
+void NaiveExecutor::BindArenaPlan(ArenaPlan *plan) {
+  if (arena_ == nullptr || arena_->size() < plan->arena_size) {
+    // The views of the old arena are released with the cached plans, and the
+    // old arena is freed once no tensor refers to it.
+    for (auto &item : arena_plans_) {
+      item.second.views.clear();
+    }
+    arena_.reset();
+    arena_ = memory::AllocShared(place_, plan->arena_size);
+  }
+  if (plan->views.empty()) {
+    for (size_t i = 0; i < plan->groups.size(); ++i) {
+      plan->views.emplace_back(std::make_shared<ArenaAllocation>(
+          arena_, plan->offsets[i], plan->sizes[i]));
+    }
+  }
+  for (size_t i = 0; i < plan->groups.size(); ++i) {
+    for (auto *tensor : plan->groups[i]) {
+      if (tensor->Holder() != plan->views[i]) {
+        tensor->clear();
+        tensor->ResetHolder(plan->views[i]);
+      }
+    }
   }
 }
 
@@ -122,6 +404,9 @@ void NaiveExecutor::CleanFeedFetchOps() {
     }
   }
   ops_.swap(ops);
+  if (latency_sampling_period_ > 0) {
+    CreateLatencyHistograms();
+  }
 }
 
 NaiveExecutor::~NaiveExecutor() {
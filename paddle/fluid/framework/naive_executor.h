@@ -14,14 +14,19 @@
 
 #pragma once
 
+#include <chrono>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/latency_histogram.h"
 #include "paddle/fluid/platform/place.h"
 
 namespace paddle {
@@ -56,6 +61,34 @@ class NaiveExecutor {
   // Run all the operators.
   void Run();
 
+  // Place the non-persistable tensors in one preallocated arena instead of
+  // allocating them op by op. The offsets are planned from the tensor sizes of
+  // the first run with each shape signature of the inputs, and are cached for
+  // the later runs. The inputs and outputs are never placed in the arena.
+  // Must be called after the variables are created.
+  void EnableMemoryArena(const std::vector<std::string>& input_names,
+                         const std::vector<std::string>& output_names);
+
+  // The bytes of the arena, 0 if no plan is made yet.
+  size_t MemoryArenaSize() const { return arena_ ? arena_->size() : 0; }
+
+  // Record the latency of every op and of the whole run in histograms, for
+  // one of about every 1 / sampling_rate runs. The sampled runs wait for the
+  // device after each op, so that the latencies are those of the ops. A rate
+  // of 0 turns the sampling off and clears the histograms.
+  void EnableLatencySampling(double sampling_rate);
+  // Whether the last run was sampled.
+  bool LastRunSampled() const { return last_run_sampled_; }
+  // nullptr if the sampling is off.
+  const platform::LatencyHistogram* RunLatency() const {
+    return run_latency_.get();
+  }
+  // The op types and latencies of the ops in the order of running, empty if
+  // the sampling is off.
+  std::vector<std::pair<std::string, const platform::LatencyHistogram*>>
+  OpLatencies() const;
+  void ResetLatencies();
+
   // Get an tensor to operating directly, without the need for feed_ops.
   LoDTensor* FindTensor(const std::string& name);
 
@@ -67,11 +100,46 @@ class NaiveExecutor {
   void CreateOps(const ProgramDesc& desc, int block_id,
                  bool with_feed_fetch_ops);
 
+ private:
+  struct ArenaPlan {
+    // The tensors sharing a buffer are placed at the same offset.
+    std::vector<std::vector<LoDTensor*>> groups;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    size_t arena_size{0};
+    // The views of the arena bound to the groups, created on the first bind
+    // after the arena is allocated.
+    std::vector<std::shared_ptr<memory::Allocation>> views;
+  };
+
+  std::vector<int64_t> InputShapeSignature() const;
+  void BuildArenaPlan(std::vector<int64_t>&& signature);
+  void BindArenaPlan(ArenaPlan* plan);
+  void CreateLatencyHistograms();
+  double WaitAndGetElapsedUs(
+      const std::chrono::steady_clock::time_point& start) const;
+
  private:
   const platform::Place place_;
   // Catch the required resource to avoid recreate.
   std::vector<std::unique_ptr<OperatorBase>> ops_;
   Scope* scope_;
+
+  bool arena_enabled_{false};
+  std::vector<Variable*> arena_inputs_;
+  // The planned variables with the index of the first and last op using them.
+  std::vector<std::pair<Variable*, std::pair<size_t, size_t>>> arena_vars_;
+  // The variables whose buffers can not be placed, e.g. the inputs, outputs
+  // and parameters, and so can not the buffers shared with them.
+  std::vector<Variable*> arena_excluded_vars_;
+  std::map<std::vector<int64_t>, ArenaPlan> arena_plans_;
+  std::shared_ptr<memory::Allocation> arena_;
+
+  uint64_t latency_sampling_period_{0};
+  uint64_t num_runs_{0};
+  bool last_run_sampled_{false};
+  std::unique_ptr<platform::LatencyHistogram> run_latency_;
+  std::vector<std::unique_ptr<platform::LatencyHistogram>> op_latencies_;
 };
 
 }  // namespace framework
@@ -64,6 +64,54 @@ TEST(NaiveExecutor, Basic) {
   }
 }
 
+TEST(NaiveExecutor, LatencySampling) {
+  ProgramDesc program;
+  auto* main_block = program.MutableBlock(0);
+  for (auto name : {"a", "b", "c"}) {
+    main_block->Var(name)->SetType(proto::VarType::LOD_TENSOR);
+  }
+  auto* add = main_block->AppendOp();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"a"});
+  add->SetInput("Y", {"b"});
+  add->SetOutput("Out", {"c"});
+
+  auto place = platform::CPUPlace();
+  NaiveExecutor exe(place);
+  exe.Prepare(nullptr, program, 0, false);
+  for (auto name : {"a", "b"}) {
+    auto* tensor = exe.FindTensor(name);
+    tensor->Resize({1, 4});
+    std::fill_n(tensor->mutable_data<float>(place), 4, 1.f);
+  }
+
+  EXPECT_EQ(exe.RunLatency(), nullptr);
+  EXPECT_TRUE(exe.OpLatencies().empty());
+
+  // One of every two runs is sampled, the first run is skipped.
+  exe.EnableLatencySampling(0.5);
+  for (int i = 0; i < 4; ++i) {
+    exe.Run();
+    EXPECT_EQ(exe.LastRunSampled(), i % 2 == 1);
+  }
+  ASSERT_NE(exe.RunLatency(), nullptr);
+  EXPECT_EQ(exe.RunLatency()->Count(), 2UL);
+  auto op_latencies = exe.OpLatencies();
+  ASSERT_EQ(op_latencies.size(), 1UL);
+  EXPECT_EQ(op_latencies[0].first, "elementwise_add");
+  EXPECT_EQ(op_latencies[0].second->Count(), 2UL);
+  EXPECT_LE(op_latencies[0].second->Percentile(0.5),
+            exe.RunLatency()->Percentile(1.0) * 1.25);
+
+  exe.ResetLatencies();
+  EXPECT_EQ(exe.RunLatency()->Count(), 0UL);
+
+  exe.EnableLatencySampling(0.0);
+  exe.Run();
+  EXPECT_FALSE(exe.LastRunSampled());
+  EXPECT_EQ(exe.RunLatency(), nullptr);
+}
+
 }  // namespace framework
 }  // namespace paddle
 
@@ -18,6 +18,7 @@
 #include <unordered_set>
 
 #include "paddle/fluid/framework/details/share_tensor_buffer_functor.h"
+#include "paddle/fluid/framework/ir/cost_data.h"
 #include "paddle/fluid/platform/profiler.h"
 
 PADDLE_DEFINE_EXPORTED_bool(new_executor_use_inplace, true,
@@ -27,6 +28,9 @@ namespace paddle {
 namespace framework {
 // NOTE(Aurelius84): Need a better strategy to determine it.
 static constexpr size_t kHostNumThreads = 4;
+// The ops measured cheaper than this are run in the current thread instead of
+// being dispatched to the work queue, see RunNextInstruction.
+static constexpr double kInlineOpMaxTimeMs = 0.01;
 
 InterpreterCore::InterpreterCore(const platform::Place& place,
                                  const ProgramDesc& main_prog,
@@ -108,6 +112,7 @@ void InterpreterCore::Convert() {
   vec_instruction_.reserve(vec_func_list_.size());
   dependecy_count_.resize(vec_func_list_.size());
   vec_meta_info_.resize(global_scope_->var_list.size());
+  const CostData* cost_data = GetProfiledCostData();
   for (size_t i = 0; i < vec_func_list_.size(); ++i) {
     Instruction temp_inst;
     auto* op_base = op_list_[i];
@@ -118,6 +123,11 @@ void InterpreterCore::Convert() {
     temp_inst.input_index_ = vec_func_list_[i].input_index;
     temp_inst.output_index_ = vec_func_list_[i].output_index;
     temp_inst.type_ = vec_func_list_[i].type_;
+    if (cost_data != nullptr) {
+      double time_ms = cost_data->GetOpTypeTimeMs(op_base->Type());
+      temp_inst.run_inline_ =
+          time_ms != CostData::NOT_MEASURED && time_ms < kInlineOpMaxTimeMs;
+    }
 
     OpInOutInfo info;
 
@@ -411,12 +421,16 @@ void InterpreterCore::RunNextInstruction(const Instruction& instr) {
       }
     }
 
+    // only keep one op running in current thread, except the cheap ops
+    // which cost less than dispatching them to other threads. They run after
+    // the rest ops are dispatched, since running one runs its ready
+    // successors too.
+    std::vector<size_t> run_inline;
     for (size_t i = 0; i < next_instr.direct_run_.size(); ++i) {
       auto next_id = next_instr.direct_run_[i];
       if (IsReady(next_id)) {
-        // only keep one op running in current thread
-        if (i == 0) {
-          RunInstructionAsync(next_id);
+        if (i == 0 || vec_instruction_[next_id].run_inline_) {
+          run_inline.push_back(next_id);
           continue;
         }
         // move rest ops into other threads
@@ -425,6 +439,9 @@ void InterpreterCore::RunNextInstruction(const Instruction& instr) {
             [&, next_id] { RunInstructionAsync(next_id); });
       }
     }
+    for (auto next_id : run_inline) {
+      RunInstructionAsync(next_id);
+    }
   }
 }
 
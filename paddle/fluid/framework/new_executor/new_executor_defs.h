@@ -519,6 +519,8 @@ struct Instruction {
 
   platform::DeviceContext* dev_ctx_;  // not owned
   OpFuncType type_;
+  // measured cheap by the profiled cost data, run it in the current thread
+  bool run_inline_{false};
 
   std::vector<std::pair<Variable*, Variable*>> vec_inplace_in_to_out_;
 };
@@ -418,6 +418,25 @@ class ExecutionContext {
     return temp_tensor;
   }
 
+  // The same as AllocateTmpTensor, but on CPU the memory is taken from the
+  // scratch workspace of the calling thread, see memory::AllocScratch. The
+  // tensor should only hold the temporary data of the kernel, and be released
+  // before the kernel returns.
+  template <typename T, typename DevContext>
+  Tensor AllocateScratchTensor(const framework::DDim& dim,
+                               const DevContext& dev_ctx) const {
+    auto scratch_ptr = memory::AllocScratch(dev_ctx, product(dim) * sizeof(T));
+    auto& deleter = scratch_ptr.get_deleter();
+    auto* allocation_ptr = scratch_ptr.release();
+
+    paddle::framework::Tensor temp_tensor(
+        framework::ToDataType(std::type_index(typeid(T))));
+    temp_tensor.Resize(dim);
+    temp_tensor.ResetHolder(std::shared_ptr<memory::allocation::Allocation>(
+        allocation_ptr, deleter));
+    return temp_tensor;
+  }
+
   const RuntimeContext Context() const { return ctx_; }
 
   std::string DebugString() const { return op_.DebugString(); }
@@ -16,6 +16,7 @@
 
 #include <fstream>
 
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/imperative/layer.h"
 
 namespace paddle {
@@ -35,21 +36,6 @@ void CheckInStreamState(std::istream& istre, size_t length) {
   }
 }
 
-struct DeserializedDataFunctor {
-  DeserializedDataFunctor(void** buf, Tensor* tensor,
-                          const platform::Place& place)
-      : buf_(buf), tensor_(tensor), place_(place) {}
-
-  template <typename T>
-  void apply() {
-    *buf_ = tensor_->mutable_data<T>(place_);
-  }
-
-  void** buf_;
-  Tensor* tensor_;
-  platform::Place place_;
-};
-
 size_t ReadTensorNumber(std::istream& istre) {
   char* tensor_number_mark_buffer = new char[tensor_number_mark.size()];
   istre.read(tensor_number_mark_buffer,
@@ -272,42 +258,12 @@ bool SaveTensorToDisk(const std::string& file_name,
     fout.write(reinterpret_cast<const char*>(&name_length),
                sizeof(name_length));
     fout.write(itera.first.c_str(), sizeof(char) * name_length);
-    // write tensor version
-    constexpr uint32_t version = 0;
-    fout.write(reinterpret_cast<const char*>(&version), sizeof(version));
-
-    // the 2nd field, tensor description
-    // int32_t  size
-    // void*    protobuf message
-    auto tensor = itera.second;
-
-    proto::VarType::TensorDesc desc;
-    desc.set_data_type(tensor->type());
-    auto dims = framework::vectorize(tensor->dims());
-    auto* pb_dims = desc.mutable_dims();
-    pb_dims->Resize(static_cast<int>(dims.size()), 0);
-    std::copy(dims.begin(), dims.end(), pb_dims->begin());
-    int32_t size = desc.ByteSize();
-    fout.write(reinterpret_cast<const char*>(&size), sizeof(size));
-    auto out = desc.SerializeAsString();
-    fout.write(out.data(), size);
-
-    // save tensor
-    uint64_t data_size =
-        tensor->numel() * framework::SizeOfType(tensor->type());
-    auto* data_ptr = tensor->data<void>();
-    if (platform::is_gpu_place(tensor->place())) {
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-      framework::Tensor temp;
-      TensorCopySync(*tensor, platform::CPUPlace(), &temp);
-      data_ptr = temp.data<void>();
-#else
-      PADDLE_THROW(platform::errors::Unavailable(
-          "Tensor is in CUDA device, but paddle not compiled with CUDA."));
-#endif
-    }
-    fout.write(static_cast<const char*>(data_ptr),
-               static_cast<std::streamsize>(data_size));
+    // then the tensor, in the same layout as TensorToStream. The data of
+    // GPU tensors is copied to host chunk by chunk while it is written.
+    auto* tensor = itera.second;
+    auto& dev_ctx = *platform::DeviceContextPool::Instance().Get(
+        tensor->place());
+    TensorToStream(fout, *tensor, dev_ctx);
   }
 
   if (!fout) {
@@ -334,47 +290,16 @@ bool LoadTensorFromDisk(
 
   size_t tensor_number = ReadTensorNumber(fin);
 
+  auto& cpu_ctx =
+      *platform::DeviceContextPool::Instance().Get(platform::CPUPlace());
   for (size_t i = 0; i < tensor_number; ++i) {
     std::string str_tensor_name = ReadTensorName(fin);
 
     std::shared_ptr<Tensor> tensor_temp(new Tensor());
-    uint32_t version;
-    fin.read(reinterpret_cast<char*>(&version), sizeof(version));
-    CheckInStreamState(fin, sizeof(version));
-    PADDLE_ENFORCE_EQ(version, 0U, platform::errors::InvalidArgument(
-                                       "Only version 0 tensor is supported."));
-    proto::VarType::TensorDesc desc;
-    {
-      // int32_t size
-      // proto buffer
-      int32_t size;
-      fin.read(reinterpret_cast<char*>(&size), sizeof(size));
-      CheckInStreamState(fin, sizeof(size));
-      std::unique_ptr<char[]> buf(new char[size]);
-      fin.read(reinterpret_cast<char*>(buf.get()), size);
-      CheckInStreamState(fin, sizeof(size));
-      PADDLE_ENFORCE_EQ(
-          desc.ParseFromArray(buf.get(), size), true,
-          platform::errors::InvalidArgument("Parse tensor desc failed."));
-    }
-
-    {  // read tensor
-      std::vector<int64_t> dims;
-      dims.reserve(static_cast<size_t>(desc.dims().size()));
-      std::copy(desc.dims().begin(), desc.dims().end(),
-                std::back_inserter(dims));
-      auto new_dim = framework::make_ddim(dims);
-      tensor_temp->Resize(new_dim);
-      void* buf;
-      framework::VisitDataType(desc.data_type(),
-                               DeserializedDataFunctor(&buf, tensor_temp.get(),
-                                                       platform::CPUPlace()));
-      size_t size =
-          tensor_temp->numel() * framework::SizeOfType(desc.data_type());
-
-      fin.read(reinterpret_cast<char*>(buf), size);
-      CheckInStreamState(fin, size);
-    }
+    // read the tensor data directly into its allocation
+    TensorFromStream(fin, tensor_temp.get(), cpu_ctx);
+    CheckInStreamState(
+        fin, tensor_temp->numel() * framework::SizeOfType(tensor_temp->type()));
 
     (*map_tensor)[str_tensor_name] = tensor_temp;
   }
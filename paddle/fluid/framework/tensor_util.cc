@@ -792,6 +792,68 @@ void TensorIsfiniteV2(const framework::Tensor& tensor, framework::Tensor* out) {
   platform::VisitPlace(place, visitor);
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// The data of GPU tensors is staged through two pinned buffers, so that the
+// copy of one chunk overlaps with the stream IO of the other one.
+constexpr size_t kStagingBufSize = 1024 * 1024 * 64;  // 64MB
+
+static void WriteGPUDataToStream(std::ostream& os, const void* data,
+                                 size_t size, const platform::CUDAPlace& place,
+                                 const platform::CUDADeviceContext& dev_ctx) {
+  if (size == 0) return;
+  platform::CUDAPinnedPlace pinned;
+  size_t buf_size = std::min(kStagingBufSize, size);
+  memory::AllocationPtr bufs[2] = {memory::Alloc(pinned, buf_size),
+                                   memory::Alloc(pinned, buf_size)};
+  uintptr_t src = reinterpret_cast<uintptr_t>(data);
+  size_t offset = 0;
+  size_t chunk = buf_size;
+  memory::Copy(pinned, bufs[0]->ptr(), place, data, chunk, dev_ctx.stream());
+  dev_ctx.Wait();
+  for (int i = 0; chunk != 0; i ^= 1) {
+    size_t next_offset = offset + chunk;
+    size_t next_chunk = std::min(buf_size, size - next_offset);
+    if (next_chunk != 0) {
+      memory::Copy(pinned, bufs[i ^ 1]->ptr(), place,
+                   reinterpret_cast<const void*>(src + next_offset),
+                   next_chunk, dev_ctx.stream());
+    }
+    os.write(static_cast<const char*>(bufs[i]->ptr()),
+             static_cast<std::streamsize>(chunk));
+    dev_ctx.Wait();
+    offset = next_offset;
+    chunk = next_chunk;
+  }
+}
+
+static void ReadGPUDataFromStream(std::istream& is, void* data, size_t size,
+                                  const platform::CUDAPlace& place,
+                                  const platform::CUDADeviceContext& dev_ctx) {
+  if (size == 0) return;
+  platform::CUDAPinnedPlace pinned;
+  size_t buf_size = std::min(kStagingBufSize, size);
+  memory::AllocationPtr bufs[2] = {memory::Alloc(pinned, buf_size),
+                                   memory::Alloc(pinned, buf_size)};
+  uintptr_t dst = reinterpret_cast<uintptr_t>(data);
+  for (size_t offset = 0, i = 0; offset < size; i ^= 1) {
+    size_t chunk = std::min(buf_size, size - offset);
+    is.read(static_cast<char*>(bufs[i]->ptr()),
+            static_cast<std::streamsize>(chunk));
+    // bufs[i] is refilled only after its previous copy has finished
+    dev_ctx.Wait();
+    PADDLE_ENFORCE_EQ(static_cast<bool>(is), true,
+                      platform::errors::Unavailable(
+                          "Failed to read %d bytes of tensor data from the "
+                          "stream, the stream may be truncated.",
+                          chunk));
+    memory::Copy(place, reinterpret_cast<void*>(dst + offset), pinned,
+                 bufs[i]->ptr(), chunk, dev_ctx.stream());
+    offset += chunk;
+  }
+  dev_ctx.Wait();
+}
+#endif
+
 void TensorToStream(std::ostream& os, const Tensor& tensor,
                     const platform::DeviceContext& dev_ctx) {
   {  // the 1st field, uint32_t version
@@ -821,23 +883,10 @@ void TensorToStream(std::ostream& os, const Tensor& tensor,
                           "tensor size %d overflow when writing tensor", size));
     if (platform::is_gpu_place(tensor.place())) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-      constexpr size_t kBufSize = 1024 * 1024 * 64;  // 64MB
-      std::unique_ptr<char[]> buf(new char[kBufSize]);
-      auto& gpu_dev_ctx =
-          static_cast<const platform::CUDADeviceContext&>(dev_ctx);
-      platform::CPUPlace cpu;
-      uintptr_t data = reinterpret_cast<uintptr_t>(data_ptr);
-      while (size != 0) {
-        size_t size_to_write = std::min(kBufSize, static_cast<size_t>(size));
-        memory::Copy(cpu, buf.get(),
-                     BOOST_GET_CONST(platform::CUDAPlace, tensor.place()),
-                     reinterpret_cast<const void*>(data), size_to_write,
-                     gpu_dev_ctx.stream());
-        gpu_dev_ctx.Wait();
-        os.write(buf.get(), size_to_write);
-        data += size_to_write;
-        size -= size_to_write;
-      }
+      WriteGPUDataToStream(
+          os, data_ptr, static_cast<size_t>(size),
+          BOOST_GET_CONST(platform::CUDAPlace, tensor.place()),
+          static_cast<const platform::CUDADeviceContext&>(dev_ctx));
 #else
       PADDLE_THROW(platform::errors::Unimplemented(
           "CUDAPlace is not supported when not compiled with CUDA"));
@@ -909,29 +958,33 @@ struct DeserializedDataFunctor {
   platform::Place place_;
 };
 
-void TensorFromStream(std::istream& is, Tensor* tensor,
-                      const platform::DeviceContext& dev_ctx,
-                      const size_t& seek, const std::vector<int64_t>& shape) {
+// the 1st and 2nd fields written by TensorToStream: uint32_t version, then
+// int32_t size and the protobuf message of the tensor description
+static void ReadTensorDesc(std::istream& is, proto::VarType::TensorDesc* desc) {
   uint32_t version;
   is.read(reinterpret_cast<char*>(&version), sizeof(version));
-
   PADDLE_ENFORCE_EQ(
       version, 0U,
       platform::errors::InvalidArgument(
           "tensor version %u is not supported, Only version 0 is supported",
           version));
+  int32_t size;
+  is.read(reinterpret_cast<char*>(&size), sizeof(size));
+  PADDLE_ENFORCE_EQ(static_cast<bool>(is) && size >= 0, true,
+                    platform::errors::Unavailable(
+                        "Cannot read tensor desc, the stream is broken."));
+  std::unique_ptr<char[]> buf(new char[size]);
+  is.read(reinterpret_cast<char*>(buf.get()), size);
+  PADDLE_ENFORCE_EQ(
+      desc->ParseFromArray(buf.get(), size), true,
+      platform::errors::InvalidArgument("Cannot parse tensor desc"));
+}
 
+void TensorFromStream(std::istream& is, Tensor* tensor,
+                      const platform::DeviceContext& dev_ctx,
+                      const size_t& seek, const std::vector<int64_t>& shape) {
   proto::VarType::TensorDesc desc;
-  {  // int32_t size
-    // proto buffer
-    int32_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
-    std::unique_ptr<char[]> buf(new char[size]);
-    is.read(reinterpret_cast<char*>(buf.get()), size);
-    PADDLE_ENFORCE_EQ(
-        desc.ParseFromArray(buf.get(), size), true,
-        platform::errors::InvalidArgument("Cannot parse tensor desc"));
-  }
+  ReadTensorDesc(is, &desc);
   {  // read tensor
     tensor->Resize(framework::make_ddim(shape));
     size_t seekg = seek * framework::SizeOfType(desc.data_type());
@@ -940,11 +993,22 @@ void TensorFromStream(std::istream& is, Tensor* tensor,
     void* buf;
     auto ctx = platform::CPUDeviceContext();
     size_t size = tensor->numel() * framework::SizeOfType(desc.data_type());
-    if (platform::is_gpu_place(dev_ctx.GetPlace()) ||
-        platform::is_xpu_place(dev_ctx.GetPlace()) ||
-        platform::is_npu_place(dev_ctx.GetPlace())) {
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
-    defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_ASCEND_CL)
+    if (platform::is_gpu_place(dev_ctx.GetPlace())) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      framework::VisitDataType(
+          desc.data_type(),
+          DeserializedDataFunctor(&buf, tensor, dev_ctx.GetPlace()));
+      ReadGPUDataFromStream(
+          is, buf, size,
+          BOOST_GET_CONST(platform::CUDAPlace, dev_ctx.GetPlace()),
+          static_cast<const platform::CUDADeviceContext&>(dev_ctx));
+#else
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "CUDAPlace is not supported when not compiled with CUDA"));
+#endif
+    } else if (platform::is_xpu_place(dev_ctx.GetPlace()) ||
+               platform::is_npu_place(dev_ctx.GetPlace())) {
+#if defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_ASCEND_CL)
       Tensor cpu_tensor;
       cpu_tensor.Resize(framework::make_ddim(shape));
       framework::VisitDataType(
@@ -957,10 +1021,7 @@ void TensorFromStream(std::istream& is, Tensor* tensor,
         dev_ctx.Wait();
       }
 #else
-      if (platform::is_gpu_place(dev_ctx.GetPlace())) {
-        PADDLE_THROW(platform::errors::Unimplemented(
-            "CUDAPlace is not supported when not compiled with CUDA"));
-      } else if (platform::is_xpu_place(dev_ctx.GetPlace())) {
+      if (platform::is_xpu_place(dev_ctx.GetPlace())) {
         PADDLE_THROW(platform::errors::Unimplemented(
             "XPUPlace is not supported when not compiled with XPU"));
       } else {
@@ -979,24 +1040,8 @@ void TensorFromStream(std::istream& is, Tensor* tensor,
 
 void TensorFromStream(std::istream& is, Tensor* tensor,
                       const platform::DeviceContext& dev_ctx) {
-  uint32_t version;
-  is.read(reinterpret_cast<char*>(&version), sizeof(version));
-  PADDLE_ENFORCE_EQ(
-      version, 0U,
-      platform::errors::InvalidArgument(
-          "tensor version %u is not supported, Only version 0 is supported",
-          version));
   proto::VarType::TensorDesc desc;
-  {  // int32_t size
-     // proto buffer
-    int32_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
-    std::unique_ptr<char[]> buf(new char[size]);
-    is.read(reinterpret_cast<char*>(buf.get()), size);
-    PADDLE_ENFORCE_EQ(
-        desc.ParseFromArray(buf.get(), size), true,
-        platform::errors::InvalidArgument("Cannot parse tensor desc"));
-  }
+  ReadTensorDesc(is, &desc);
   {  // read tensor
     std::vector<int64_t> dims;
     dims.reserve(static_cast<size_t>(desc.dims().size()));
@@ -1005,11 +1050,22 @@ void TensorFromStream(std::istream& is, Tensor* tensor,
     void* buf;
     auto ctx = platform::CPUDeviceContext();
     size_t size = tensor->numel() * framework::SizeOfType(desc.data_type());
-    if (platform::is_gpu_place(dev_ctx.GetPlace()) ||
-        platform::is_xpu_place(dev_ctx.GetPlace()) ||
-        platform::is_npu_place(dev_ctx.GetPlace())) {
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP) || \
-    defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_ASCEND_CL)
+    if (platform::is_gpu_place(dev_ctx.GetPlace())) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      framework::VisitDataType(
+          desc.data_type(),
+          DeserializedDataFunctor(&buf, tensor, dev_ctx.GetPlace()));
+      ReadGPUDataFromStream(
+          is, buf, size,
+          BOOST_GET_CONST(platform::CUDAPlace, dev_ctx.GetPlace()),
+          static_cast<const platform::CUDADeviceContext&>(dev_ctx));
+#else
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "CUDAPlace is not supported when not compiled with CUDA"));
+#endif
+    } else if (platform::is_xpu_place(dev_ctx.GetPlace()) ||
+               platform::is_npu_place(dev_ctx.GetPlace())) {
+#if defined(PADDLE_WITH_XPU) || defined(PADDLE_WITH_ASCEND_CL)
       Tensor cpu_tensor;
       cpu_tensor.Resize(framework::make_ddim(dims));
       framework::VisitDataType(
@@ -1022,10 +1078,7 @@ void TensorFromStream(std::istream& is, Tensor* tensor,
         dev_ctx.Wait();
       }
 #else
-      if (platform::is_gpu_place(dev_ctx.GetPlace())) {
-        PADDLE_THROW(platform::errors::Unimplemented(
-            "CUDAPlace is not supported when not compiled with CUDA"));
-      } else if (platform::is_xpu_place(dev_ctx.GetPlace())) {
+      if (platform::is_xpu_place(dev_ctx.GetPlace())) {
         PADDLE_THROW(platform::errors::Unimplemented(
             "XPUPlace is not supported when not compiled with XPU"));
       } else {
@@ -508,10 +508,36 @@ TEST(Tensor, FromAndToStream) {
     for (int i = 0; i < 6; ++i) {
       EXPECT_EQ(dst_ptr[i], array[i]);
     }
+
+    // read back to GPU through the pinned staging buffers
+    Tensor gpu_dst_tensor;
+    std::istringstream gpu_iss(oss.str());
+    TensorFromStream(gpu_iss, &gpu_dst_tensor, gpu_ctx);
+    EXPECT_EQ(gpu_dst_tensor.dims(), src_tensor.dims());
+    Tensor cpu_tensor;
+    TensorCopySync(gpu_dst_tensor, platform::CPUPlace(), &cpu_tensor);
+    for (int i = 0; i < 6; ++i) {
+      EXPECT_EQ(cpu_tensor.data<int>()[i], array[i]);
+    }
     delete gpu_place;
   }
 #endif
 }
 
+TEST(Tensor, FromTruncatedStream) {
+  framework::Tensor src_tensor;
+  src_tensor.Resize({2, 3});
+  src_tensor.mutable_data<int>(platform::CPUPlace());
+  platform::CPUDeviceContext cpu_ctx;
+  std::ostringstream oss;
+  TensorToStream(oss, src_tensor, cpu_ctx);
+
+  // only the version and a part of the desc size are left
+  std::istringstream iss(oss.str().substr(0, 6));
+  framework::Tensor dst_tensor;
+  EXPECT_THROW(TensorFromStream(iss, &dst_tensor, cpu_ctx),
+               paddle::platform::EnforceNotMet);
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace imperative {
+
+/**
+ * A monotonic arena for the short-lived objects of a backward pass, e.g. the
+ * per-node states and the gradient accumulators of BasicEngine. Objects are
+ * only freed together by Reset, which runs their destructors in the reverse
+ * order of creation and keeps the chunks for the next backward pass.
+ */
+class AutogradArena {
+ public:
+  explicit AutogradArena(size_t chunk_size = 16 * 1024)
+      : chunk_size_(chunk_size) {}
+
+  ~AutogradArena() { Reset(); }
+
+  template <typename T, typename... ARGS>
+  T* New(ARGS&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned types are not supported by AutogradArena.");
+    void* ptr = Allocate(sizeof(T), alignof(T));
+    T* obj = new (ptr) T(std::forward<ARGS>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      destructors_.emplace_back(
+          [](void* p) { reinterpret_cast<T*>(p)->~T(); }, obj);
+    }
+    return obj;
+  }
+
+  void Reset() {
+    for (auto iter = destructors_.rbegin(); iter != destructors_.rend();
+         ++iter) {
+      iter->first(iter->second);
+    }
+    destructors_.clear();
+    cur_chunk_ = 0;
+    offset_ = 0;
+  }
+
+  // The number of bytes held by the arena, including the free space.
+  size_t Capacity() const {
+    size_t capacity = 0;
+    for (auto& chunk : chunks_) {
+      capacity += chunk.second;
+    }
+    return capacity;
+  }
+
+ private:
+  void* Allocate(size_t size, size_t align) {
+    while (cur_chunk_ < chunks_.size()) {
+      auto& chunk = chunks_[cur_chunk_];
+      size_t offset = (offset_ + align - 1) / align * align;
+      if (offset + size <= chunk.second) {
+        offset_ = offset + size;
+        return chunk.first.get() + offset;
+      }
+      ++cur_chunk_;
+      offset_ = 0;
+    }
+    size_t chunk_size = std::max(chunk_size_, size);
+    chunks_.emplace_back(std::unique_ptr<char[]>(new char[chunk_size]),
+                         chunk_size);
+    cur_chunk_ = chunks_.size() - 1;
+    offset_ = size;
+    return chunks_.back().first.get();
+  }
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(AutogradArena);
+
+ private:
+  size_t chunk_size_;
+  std::vector<std::pair<std::unique_ptr<char[]>, size_t>> chunks_;
+  size_t cur_chunk_{0};
+  size_t offset_{0};
+  std::vector<std::pair<void (*)(void*), void*>> destructors_;
+};
+
+}  // namespace imperative
+}  // namespace paddle
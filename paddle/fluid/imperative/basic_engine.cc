@@ -15,8 +15,11 @@
 #include "paddle/fluid/imperative/basic_engine.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <memory>
-#include <queue>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -32,6 +35,7 @@
 #include "paddle/fluid/platform/profiler.h"
 
 DECLARE_bool(sort_sum_gradient);
+DECLARE_int32(dygraph_backward_num_threads);
 
 namespace paddle {
 namespace imperative {
@@ -110,17 +114,36 @@ void BasicEngine::Init(
     VariableWrapper* init_grad_var = var->GradVarBase()->SharedVar().get();
     auto& accumulator = accumulators_[init_grad_var];
     if (!accumulator) {
-      if (FLAGS_sort_sum_gradient) {
-        accumulator.reset(new SortedGradientAccumulator(init_grad_var));
-      } else {
-        accumulator.reset(new EagerGradientAccumulator(init_grad_var));
-      }
+      accumulator = CreateGradientAccumulator(init_grad_var);
     }
 
     init_nodes_.push_back(init_node);
   }
 }
 
+GradientAccumulator* BasicEngine::CreateGradientAccumulator(
+    VariableWrapper* var) {
+  GradientAccumulator* accumulator = nullptr;
+  if (FLAGS_sort_sum_gradient) {
+    accumulator = arena_.New<SortedGradientAccumulator>(var);
+  } else {
+    accumulator = arena_.New<EagerGradientAccumulator>(var);
+  }
+  accumulator_states_[accumulator] = arena_.New<AccumulatorState>();
+  return accumulator;
+}
+
+BasicEngineNodeState* BasicEngine::GetOrCreateNodeState(
+    const std::shared_ptr<GradOpNode>& node) {
+  auto* state = node->EngineState();
+  if (state == nullptr) {
+    state = arena_.New<BasicEngineNodeState>(node);
+    node->SetEngineState(state);
+    node_states_.push_back(state);
+  }
+  return state;
+}
+
 void BasicEngine::CheckBackwardInputs(const OpBase& op) {
   for (auto& pair : op.GetInsMap()) {
     if (!pair.second.IsGrad()) {
@@ -169,11 +192,7 @@ void BasicEngine::PrepareGradAccumulators(
       if (!var->HasGradNode()) {
         auto& accumulator = accumulators_[var.get()];
         if (!accumulator) {
-          if (FLAGS_sort_sum_gradient) {
-            accumulator.reset(new SortedGradientAccumulator(var.get()));
-          } else {
-            accumulator.reset(new EagerGradientAccumulator(var.get()));
-          }
+          accumulator = CreateGradientAccumulator(var.get());
         }
 
         accumulator->IncreaseRefCnt();
@@ -218,15 +237,14 @@ void BasicEngine::PrepareGradAccumulators(
           }
 
           if (find_grad_node_of_var) {
-            auto& accumulator =
-                accumulators_with_grad_node_[grad_pending_node][var.get()];
-
+            auto* state = grad_pending_node->EngineState();
+            auto* accumulator = state->FindAccumulator(var.get());
             if (!accumulator) {
-              if (FLAGS_sort_sum_gradient) {
-                accumulator.reset(new SortedGradientAccumulator(var.get()));
-              } else {
-                accumulator.reset(new EagerGradientAccumulator(var.get()));
-              }
+              accumulator = CreateGradientAccumulator(var.get());
+              state->accumulators =
+                  arena_.New<BasicEngineNodeState::AccumulatorEdge>(
+                      BasicEngineNodeState::AccumulatorEdge{
+                          var.get(), accumulator, state->accumulators});
             }
 
             accumulator->IncreaseRefCnt();
@@ -250,42 +268,32 @@ void BasicEngine::PrepareGradAccumulators(
 
 void BasicEngine::PrepareDeps() {
   PADDLE_ENFORCE_EQ(
-      node_deps_.empty(), true,
+      node_states_.empty(), true,
       platform::errors::AlreadyExists("Op deps are not empty before preparing "
                                       "it for backward network execution."));
-  PADDLE_ENFORCE_EQ(accumulators_with_grad_node_.empty(), true,
-                    platform::errors::AlreadyExists(
-                        "Accumulators with grad_node as the key are not empty "
-                        "before preparing it for backward network execution."));
 
-  std::queue<GradOpNode*> q;
-  std::unordered_set<GradOpNode*> visited;
-
-  for (size_t i = 0; i < init_nodes_.size(); ++i) {
-    q.push(init_nodes_[i].get());
-    visited.insert(init_nodes_[i].get());
+  for (auto& init_node : init_nodes_) {
+    GetOrCreateNodeState(init_node);
   }
 
-  while (!q.empty()) {
-    auto* cur_node = q.front();
-    q.pop();
+  // node_states_ is also the queue of the BFS, the states of the newly
+  // visited nodes are appended to it.
+  for (size_t i = 0; i < node_states_.size(); ++i) {
+    auto* cur_node = node_states_[i]->node.get();
 
     const auto& grad_pending_nodes = cur_node->GradPendingNodes();
 
-    for (auto& cur_op : *cur_node) {
-      cur_op.EnforceHasInOut();
-      PrepareGradAccumulators(cur_op, grad_pending_nodes);
-    }
-
     for (auto& grad_pending_node : grad_pending_nodes) {
       PADDLE_ENFORCE_NOT_NULL(
           grad_pending_node,
           platform::errors::NotFound("Grad pending node is nullptr."));
-      ++node_deps_[grad_pending_node.get()];
-      if (visited.count(grad_pending_node.get()) == 0) {
-        visited.insert(grad_pending_node.get());
-        q.push(grad_pending_node.get());
-      }
+      ++GetOrCreateNodeState(grad_pending_node)->deps;
+    }
+
+    for (auto& cur_op : *cur_node) {
+      cur_op.EnforceHasInOut();
+      PrepareGradAccumulators(cur_op, grad_pending_nodes);
+      all_cpu_ops_ = all_cpu_ops_ && platform::is_cpu_place(cur_op.place());
     }
   }
 }
@@ -325,9 +333,12 @@ static bool IsInputCanInplace(const std::shared_ptr<VariableWrapper>& var) {
   return false;
 }
 
-static void PerformBackwardInplace(const std::string& op_type,
-                                   const NameVarMap<VariableWrapper>& ins,
-                                   NameVarMap<VariableWrapper>* outs) {
+// If inplace_vars is nullptr, an input can be reused when the op holds the
+// only reference to it, otherwise it must be in inplace_vars.
+static void PerformBackwardInplace(
+    const std::string& op_type, const NameVarMap<VariableWrapper>& ins,
+    NameVarMap<VariableWrapper>* outs,
+    const std::unordered_set<VariableWrapper*>* inplace_vars) {
   auto& infer_inplace =
       paddle::framework::OpInfoMap::Instance().Get(op_type).infer_inplace_;
 
@@ -342,7 +353,10 @@ static void PerformBackwardInplace(const std::string& op_type,
             auto& in_var = p.second[0];
             VLOG(10) << p.first << " use_count: " << in_var.use_count();
             // the refcount of var to be inplaced should be 1
-            if (in_var.use_count() == 1) {
+            bool can_inplace = inplace_vars == nullptr
+                                   ? in_var.use_count() == 1
+                                   : inplace_vars->count(in_var.get()) > 0;
+            if (can_inplace) {
               if (IsInputCanInplace(in_var)) {
                 in_tensor =
                     in_var->MutableVar()->GetMutable<framework::LoDTensor>();
@@ -376,260 +390,400 @@ static void PerformBackwardInplace(const std::string& op_type,
   }
 }
 
-void BasicEngine::Execute() {
-  if (init_nodes_.empty()) {
-    return;
-  }
-
-  PrepareDeps();
-  // Start execute Computation graph
-  std::queue<std::shared_ptr<GradOpNode>> q;
-  for (size_t i = 0; i < init_nodes_.size(); ++i) {
-    if (node_deps_[init_nodes_[i].get()] == 0) {
-      q.push(std::move(init_nodes_[i]));
-    }
-  }
-
-  size_t op_num = 0;
-
-  while (!q.empty()) {
-    auto shared_cur_node = std::move(q.front());
-    q.pop();
-
-    auto& inplace_grad_name_map = shared_cur_node->InplaceGradNameMap();
-
-    for (auto& cur_op : *shared_cur_node) {
-      platform::RecordEvent op_type_record_event(cur_op.Type());
-
-      ++op_num;
-
-      // CheckBackWardInput
-      CheckBackwardInputs(cur_op);
-
-      // Step 1: Run Backward OP
-      auto& bwd_ins = cur_op.GetInsMap();
-      auto& bwd_outs = cur_op.GetOutsMap();
-
-      /**
-       * [ Why need temporary outputs here? ]
-       *
-       * - construct the temp output map, avoid to disrupt graph
-       * - replace the element in the map by temp var, because a
-       *   var may be coresponding to several grad var in one op
-       */
-      NameVarMap<VariableWrapper> tmp_outs(bwd_outs);
+void BasicEngine::RunGradNode(
+    BasicEngineNodeState* cur_state,
+    std::vector<BasicEngineNodeState*>* ready_states) {
+  auto* cur_node = cur_state->node.get();
+
+  auto& inplace_grad_name_map = cur_node->InplaceGradNameMap();
+
+  for (auto& cur_op : *cur_node) {
+    platform::RecordEvent op_type_record_event(cur_op.Type());
+
+    ++op_num_;
+
+    // CheckBackWardInput
+    CheckBackwardInputs(cur_op);
+
+    // Step 1: Run Backward OP
+    auto& bwd_ins = cur_op.GetInsMap();
+    auto& bwd_outs = cur_op.GetOutsMap();
+
+    /**
+     * [ Why need temporary outputs here? ]
+     *
+     * - construct the temp output map, avoid to disrupt graph
+     * - replace the element in the map by temp var, because a
+     *   var may be coresponding to several grad var in one op
+     */
+    NameVarMap<VariableWrapper> tmp_outs(bwd_outs);
+
+    // The output grad vars of Inplace grad op. Because Inplace grad op does
+    // not use the Inplace strategy, new output grad vars need to be created.
+    std::vector<std::pair<std::shared_ptr<VariableWrapper>,
+                          std::shared_ptr<VariableWrapper>>>
+        inplace_output_grad_var_list;
+    std::vector<
+        std::pair<GradientAccumulator*, std::shared_ptr<VariableWrapper>>>
+        need_accu_var_list;
+    // leaf_accumulators : hooks and accumulate-grad for leaf tensor.
+    // It should be orderly and not repeated, because multiple cards must
+    // ensure that the order of vars is the same.
+    std::vector<GradientAccumulator*> leaf_accumulators;
+
+    // The accumulators are only looked up here, they are modified under their
+    // own locks below.
+    for (auto& pair : tmp_outs) {
+      if (!pair.second.IsGrad()) {
+        continue;
+      }
 
-      for (auto& pair : tmp_outs) {
-        if (!pair.second.IsGrad()) {
+      for (auto& var : pair.second) {
+        if (!var) {
           continue;
         }
 
-        for (auto& var : pair.second) {
-          if (!var) {
-            continue;
-          }
-
-          std::unordered_map<VariableWrapper*,
-                             std::unique_ptr<GradientAccumulator>>::iterator
-              iter;
-          if (!var->HasGradNode()) {
-            VLOG(10) << "Find gradient of var (" << var->Name()
-                     << ") with no grad_node.";
-            iter = accumulators_.find(var.get());
-            PADDLE_ENFORCE_EQ(
-                iter != accumulators_.end(), true,
-                platform::errors::NotFound(
-                    "Cannot find gradient of variable %s", var->Name()));
-          } else {
-            bool flag_find_grad = false;
-            VLOG(10) << "Find gradient of var (" << var->Name()
-                     << ") with grad_node.";
-            for (auto& grad_pending_node :
-                 shared_cur_node->GradPendingNodes()) {
-              const auto& iter_grad_node =
-                  accumulators_with_grad_node_.find(grad_pending_node);
-              if (iter_grad_node != accumulators_with_grad_node_.end()) {
-                iter = iter_grad_node->second.find(var.get());
-                if (iter != iter_grad_node->second.end()) {
-                  flag_find_grad = true;
-                  break;
-                }
-              }
+        GradientAccumulator* accumulator = nullptr;
+        if (!var->HasGradNode()) {
+          VLOG(10) << "Find gradient of var (" << var->Name()
+                   << ") with no grad_node.";
+          auto iter = accumulators_.find(var.get());
+          PADDLE_ENFORCE_EQ(
+              iter != accumulators_.end(), true,
+              platform::errors::NotFound(
+                  "Cannot find gradient of variable %s", var->Name()));
+          accumulator = iter->second;
+        } else {
+          VLOG(10) << "Find gradient of var (" << var->Name()
+                   << ") with grad_node.";
+          for (auto& grad_pending_node : cur_node->GradPendingNodes()) {
+            accumulator =
+                grad_pending_node->EngineState()->FindAccumulator(var.get());
+            if (accumulator) {
+              break;
             }
-            PADDLE_ENFORCE_EQ(
-                flag_find_grad, true,
-                platform::errors::NotFound(
-                    "Cannot find gradient of variable %s", var->Name()));
           }
+          PADDLE_ENFORCE_NOT_NULL(
+              accumulator,
+              platform::errors::NotFound(
+                  "Cannot find gradient of variable %s", var->Name()));
+        }
 
-          // leaf_accumulators_ : hooks and accumulate-grad for leaf tensor,
-          // it should be orderly and not reapeated.
-          if (var->IsLeafGrad()) {
-            if (std::find(leaf_accumulators_.begin(), leaf_accumulators_.end(),
-                          iter->second.get()) == leaf_accumulators_.end()) {
-              leaf_accumulators_.push_back(iter->second.get());
-            }
+        if (var->IsLeafGrad()) {
+          if (std::find(leaf_accumulators.begin(), leaf_accumulators.end(),
+                        accumulator) == leaf_accumulators.end()) {
+            leaf_accumulators.push_back(accumulator);
+          }
 
-            if (iter->second->HasInnerVar()) {
-              var = iter->second->InnerVar();
-            }
+          if (accumulator->HasInnerVar()) {
+            var = accumulator->InnerVar();
           }
+        }
 
-          if (var->OverridedStopGradient() || iter->second->RefCnt() > 1) {
-            auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
-            tmp_var->SetType(var->Type());
-            tmp_var->SetForwardDataType(var->ForwardDataType());
-            var = tmp_var;
-            need_accu_var_list_.emplace_back(iter->second.get(), var);
-            VLOG(10) << "create temporary var of " << var->Name()
-                     << " for sum gradient within this graph!";
-          } else if (!inplace_grad_name_map.empty() &&
-                     inplace_grad_name_map.count(pair.first) &&
-                     bwd_ins.count(inplace_grad_name_map.at(pair.first))) {
-            // When calculate Inplace grad op, create a new output var.
-            // If a tmp var has been created, there is no need to create it
-            // again.
-            for (auto& in_var :
-                 bwd_ins.at(inplace_grad_name_map.at(pair.first))) {
-              if (in_var == var) {
-                auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
-                tmp_var->SetType(var->Type());
-                tmp_var->SetForwardDataType(var->ForwardDataType());
-                inplace_output_grad_var_list_.emplace_back(var, tmp_var);
-                var = tmp_var;
-                VLOG(10) << "Inplace grad op does not use the Inplace "
-                            "strategy, a temporary output var ("
-                         << var->Name() << ") will be created.";
-                break;
-              }
+        if (var->OverridedStopGradient() || accumulator->RefCnt() > 1) {
+          auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
+          tmp_var->SetType(var->Type());
+          tmp_var->SetForwardDataType(var->ForwardDataType());
+          var = tmp_var;
+          need_accu_var_list.emplace_back(accumulator, var);
+          VLOG(10) << "create temporary var of " << var->Name()
+                   << " for sum gradient within this graph!";
+        } else if (!inplace_grad_name_map.empty() &&
+                   inplace_grad_name_map.count(pair.first) &&
+                   bwd_ins.count(inplace_grad_name_map.at(pair.first))) {
+          // When calculate Inplace grad op, create a new output var.
+          // If a tmp var has been created, there is no need to create it
+          // again.
+          for (auto& in_var :
+               bwd_ins.at(inplace_grad_name_map.at(pair.first))) {
+            if (in_var == var) {
+              auto tmp_var = std::make_shared<VariableWrapper>(var->Name());
+              tmp_var->SetType(var->Type());
+              tmp_var->SetForwardDataType(var->ForwardDataType());
+              inplace_output_grad_var_list.emplace_back(var, tmp_var);
+              var = tmp_var;
+              VLOG(10) << "Inplace grad op does not use the Inplace "
+                          "strategy, a temporary output var ("
+                       << var->Name() << ") will be created.";
+              break;
             }
           }
         }
       }
+    }
 
-      VLOG(4) << "Check whether there is any inplace operation affecting "
-                 "gradient calculation.";
-      for (auto& pair : bwd_ins) {
-        for (auto& var_wrapper : pair.second) {
-          auto wrapper_version_snapshot = var_wrapper->InplaceVersionSnapshot();
-          auto tensor_version =
-              var_wrapper->MutableVar()->CurrentInplaceVersion();
-          PADDLE_ENFORCE_EQ(
-              tensor_version, wrapper_version_snapshot,
-              platform::errors::PermissionDenied(
-                  "Tensor '%s' used in gradient computation in grad op '%s' "
-                  "has been "
-                  "modified by an inplace operation. "
-                  "Its version is %s but the expected version is %s. "
-                  "Please fix your code to void calling an inplace operator "
-                  "after using the Tensor which will used in gradient "
-                  "computation.",
-                  var_wrapper->Name(), cur_op.Type(), tensor_version,
-                  wrapper_version_snapshot));
-
-          VLOG(6) << " The version of Tensor '" << var_wrapper->Name()
-                  << "' is [ " << wrapper_version_snapshot << " ]";
-        }
+    VLOG(4) << "Check whether there is any inplace operation affecting "
+               "gradient calculation.";
+    for (auto& pair : bwd_ins) {
+      for (auto& var_wrapper : pair.second) {
+        auto wrapper_version_snapshot = var_wrapper->InplaceVersionSnapshot();
+        auto tensor_version =
+            var_wrapper->MutableVar()->CurrentInplaceVersion();
+        PADDLE_ENFORCE_EQ(
+            tensor_version, wrapper_version_snapshot,
+            platform::errors::PermissionDenied(
+                "Tensor '%s' used in gradient computation in grad op '%s' "
+                "has been "
+                "modified by an inplace operation. "
+                "Its version is %s but the expected version is %s. "
+                "Please fix your code to void calling an inplace operator "
+                "after using the Tensor which will used in gradient "
+                "computation.",
+                var_wrapper->Name(), cur_op.Type(), tensor_version,
+                wrapper_version_snapshot));
+
+        VLOG(6) << " The version of Tensor '" << var_wrapper->Name()
+                << "' is [ " << wrapper_version_snapshot << " ]";
       }
+    }
 
-      /**
-       * [ Why need temporary inputs here? ]
-       *
-       * - Hook execution should not change original input tensor.
-       *   User can register hook for Tensor's gradient, It is expected
-       *   that the hook only affects the gradient of the backward
-       *   propagation, and does not affect the gradient value input
-       *   as the hook.
-       * - use `tmp_ins_ptr`, only copy bwd_ins when the var in bwd_ins
-       *   hold hooks
-       */
-      auto tmp_ins_ptr = CallGradientHooks(bwd_ins, cur_op.Type());
-
-      if (!tmp_ins_ptr) {
-        PerformBackwardInplace(cur_op.Type(), bwd_ins, &tmp_outs);
-      }
+    /**
+     * [ Why need temporary inputs here? ]
+     *
+     * - Hook execution should not change original input tensor.
+     *   User can register hook for Tensor's gradient, It is expected
+     *   that the hook only affects the gradient of the backward
+     *   propagation, and does not affect the gradient value input
+     *   as the hook.
+     * - use `tmp_ins_ptr`, only copy bwd_ins when the var in bwd_ins
+     *   hold hooks
+     */
+    auto tmp_ins_ptr = CallGradientHooks(bwd_ins, cur_op.Type());
+
+    if (!tmp_ins_ptr) {
+      PerformBackwardInplace(cur_op.Type(), bwd_ins, &tmp_outs,
+                             inplace_vars_ready_ ? &inplace_vars_ : nullptr);
+    }
 
-      {
-        VLOG(3) << "Start to execute grad op " << cur_op.Type();
-        try {
-          if (tmp_ins_ptr == nullptr) {
-            OpBase::Run(cur_op.InnerOp(), bwd_ins, tmp_outs, cur_op.Attrs(),
-                        cur_op.DefaultAttrsMap(), cur_op.place());
-          } else {
-            OpBase::Run(cur_op.InnerOp(), *tmp_ins_ptr, tmp_outs,
-                        cur_op.Attrs(), cur_op.DefaultAttrsMap(),
-                        cur_op.place());
-          }
-        } catch (platform::EnforceNotMet& exception) {
-          Clear();
-          throw std::move(exception);
-        } catch (std::exception& ex) {
-          Clear();
-          PADDLE_THROW(platform::errors::External("%s", ex.what()));
+    {
+      VLOG(3) << "Start to execute grad op " << cur_op.Type();
+      try {
+        if (tmp_ins_ptr == nullptr) {
+          OpBase::Run(cur_op.InnerOp(), bwd_ins, tmp_outs, cur_op.Attrs(),
+                      cur_op.DefaultAttrsMap(), cur_op.place());
+        } else {
+          OpBase::Run(cur_op.InnerOp(), *tmp_ins_ptr, tmp_outs,
+                      cur_op.Attrs(), cur_op.DefaultAttrsMap(),
+                      cur_op.place());
         }
+      } catch (platform::EnforceNotMet& exception) {
+        throw std::move(exception);
+      } catch (std::exception& ex) {
+        PADDLE_THROW(platform::errors::External("%s", ex.what()));
       }
+    }
 
-      for (auto& pair : inplace_output_grad_var_list_) {
-        *pair.first = std::move(*pair.second);
-      }
+    for (auto& pair : inplace_output_grad_var_list) {
+      *pair.first = std::move(*pair.second);
+    }
 
-      // Step 2: Sum Gradient of This graph
-      for (auto& pair : need_accu_var_list_) {
-        pair.first->SumGrad(std::move(pair.second), cur_op.id());
-      }
+    // Step 2: Sum Gradient of This graph
+    for (auto& pair : need_accu_var_list) {
+      auto* state = accumulator_states_.at(pair.first);
+      std::lock_guard<std::mutex> guard(state->mutex);
+      pair.first->SumGrad(std::move(pair.second), cur_op.id());
+    }
 
-      // Step 3: Call Hooks && Sum Gradient with Pre-Graph && Call BackwardHooks
-      for (auto* accumulator : leaf_accumulators_) {
-        if (!accumulator->SumGradCompleted()) {
+    // Step 3: Call Hooks && Sum Gradient with Pre-Graph && Call BackwardHooks
+    for (auto* accumulator : leaf_accumulators) {
+      {
+        // Only the first node that sees the sum completed calls the hooks.
+        auto* state = accumulator_states_.at(accumulator);
+        std::lock_guard<std::mutex> guard(state->mutex);
+        if (state->hooks_called || !accumulator->SumGradCompleted()) {
           continue;
         }
-        // 1. Call Hooks for `inner_var_`
-        accumulator->CallGradientHooks();
+        state->hooks_called = true;
+      }
+      // The hooks, e.g. the reduce hooks of Reducer, may share state among
+      // the accumulators.
+      std::lock_guard<std::mutex> guard(hooks_mutex_);
+      // 1. Call Hooks for `inner_var_`
+      accumulator->CallGradientHooks();
 
-        // 2. Sum Gradient `inner_var_` to `var_` of Current or Previous Graph
-        accumulator->AccumulateGrad();
+      // 2. Sum Gradient `inner_var_` to `var_` of Current or Previous Graph
+      accumulator->AccumulateGrad();
 
-        // 3. Call backward Hooks for `var_`
-        accumulator->CallReduceHooks();
-      }
+      // 3. Call backward Hooks for `var_`
+      accumulator->CallReduceHooks();
+    }
 
-      need_accu_var_list_.clear();
-      inplace_output_grad_var_list_.clear();
-      leaf_accumulators_.clear();
+    if (!retain_graph_) {
+      VLOG(3) << "Remove op after op " << cur_op.Type() << " runs";
+      cur_op.ClearBackwardTrace();
+    }
+  }
 
-      if (!retain_graph_) {
-        VLOG(3) << "Remove op after op " << cur_op.Type() << " runs";
-        cur_op.ClearBackwardTrace();
-      }
+  // Step 3: Collect ready ops
+  for (auto& grad_pending_node : cur_node->GradPendingNodes()) {
+    PADDLE_ENFORCE_NOT_NULL(
+        grad_pending_node,
+        platform::errors::NotFound("Grad pending node is nullptr."));
+    auto* pending_state = grad_pending_node->EngineState();
+    if (pending_state->deps.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      ready_states->push_back(pending_state);
     }
+  }
 
-    // Step 3: Collect ready ops
-    for (auto& grad_pending_node : shared_cur_node->GradPendingNodes()) {
-      PADDLE_ENFORCE_NOT_NULL(
-          grad_pending_node,
-          platform::errors::NotFound("Grad pending node is nullptr."));
-      auto iter = node_deps_.find(grad_pending_node.get());
-      if (iter == node_deps_.end()) {
-        continue;
-      }
+  // Release the node as soon as it has run, the pending nodes are held by
+  // their own states.
+  cur_node->SetEngineState(nullptr);
+  cur_state->node.reset();
+}
+
+void BasicEngine::Execute() {
+  if (init_nodes_.empty()) {
+    return;
+  }
+
+  try {
+    PrepareDeps();
+  } catch (...) {
+    Clear();
+    throw;
+  }
+  init_nodes_.clear();
 
-      if (--(iter->second) == 0) {
-        q.push(grad_pending_node);
+  // Start execute Computation graph
+  std::vector<BasicEngineNodeState*> ready_states;
+  ready_states.reserve(node_states_.size());
+  for (auto* state : node_states_) {
+    if (state->deps == 0) {
+      ready_states.push_back(state);
+    }
+  }
+
+  op_num_ = 0;
+
+  try {
+    if (FLAGS_dygraph_backward_num_threads > 1 && all_cpu_ops_) {
+      PrepareInplaceVars();
+      ExecuteParallel(ready_states);
+    } else {
+      for (size_t ready_idx = 0; ready_idx < ready_states.size();
+           ++ready_idx) {
+        RunGradNode(ready_states[ready_idx], &ready_states);
       }
     }
+  } catch (...) {
+    Clear();
+    throw;
   }
   Clear();
 
-  VLOG(1) << "Backward op number: " << op_num;
+  VLOG(1) << "Backward op number: " << op_num_;
+}
+
+void BasicEngine::PrepareInplaceVars() {
+  struct VarRefs {
+    const std::shared_ptr<VariableWrapper>* var{nullptr};
+    // The references held by the ins and outs of the grad ops.
+    size_t graph_refs{0};
+    size_t input_refs{0};
+  };
+  std::unordered_map<VariableWrapper*, VarRefs> refs;
+  auto count_refs = [&refs](const NameVarMap<VariableWrapper>& vars,
+                            bool is_input) {
+    for (const auto& pair : vars) {
+      for (const auto& var : pair.second) {
+        if (!var) {
+          continue;
+        }
+        auto& var_refs = refs[var.get()];
+        var_refs.var = &var;
+        ++var_refs.graph_refs;
+        var_refs.input_refs += is_input;
+      }
+    }
+  };
+  for (auto* state : node_states_) {
+    for (const auto& op : *state->node) {
+      count_refs(op.GetInsMap(), true);
+      count_refs(op.GetOutsMap(), false);
+    }
+  }
+
+  // A var can be reused by the only grad op that reads it, if nothing outside
+  // the graph holds it. The ops that write it have run and released it by
+  // then, unless the graph is retained.
+  for (const auto& item : refs) {
+    const auto& var_refs = item.second;
+    if (var_refs.input_refs == 1 &&
+        static_cast<size_t>(var_refs.var->use_count()) ==
+            var_refs.graph_refs &&
+        (!retain_graph_ || var_refs.graph_refs == 1)) {
+      inplace_vars_.insert(item.first);
+    }
+  }
+  inplace_vars_ready_ = true;
+}
+
+void BasicEngine::ExecuteParallel(
+    const std::vector<BasicEngineNodeState*>& init_ready_states) {
+  size_t num_threads = FLAGS_dygraph_backward_num_threads;
+  if (work_queue_ == nullptr || work_queue_->NumThreads() != num_threads) {
+    framework::WorkQueueOptions options(num_threads,
+                                        /*allow_spinning*/ false,
+                                        /*track_task*/ true);
+    work_queue_ = framework::CreateMultiThreadedWorkQueue(options);
+  }
+
+  std::atomic<bool> has_exception{false};
+  std::exception_ptr exception = nullptr;
+  std::mutex exception_mutex;
+
+  // A task keeps running the first node that becomes ready after its node
+  // ran, and dispatches the others to the work queue, so a chain of nodes
+  // stays on the same thread.
+  std::function<void(BasicEngineNodeState*)> run_task =
+      [&](BasicEngineNodeState* state) {
+        std::vector<BasicEngineNodeState*> ready_states;
+        while (state != nullptr && !has_exception) {
+          ready_states.clear();
+          try {
+            RunGradNode(state, &ready_states);
+          } catch (...) {
+            std::lock_guard<std::mutex> guard(exception_mutex);
+            if (!has_exception) {
+              exception = std::current_exception();
+              has_exception = true;
+            }
+            return;
+          }
+          for (size_t i = 1; i < ready_states.size(); ++i) {
+            auto* next_state = ready_states[i];
+            work_queue_->AddTask([&run_task, next_state] {
+              run_task(next_state);
+            });
+          }
+          state = ready_states.empty() ? nullptr : ready_states[0];
+        }
+      };
+
+  for (auto* state : init_ready_states) {
+    work_queue_->AddTask([&run_task, state] { run_task(state); });
+  }
+  work_queue_->WaitQueueEmpty();
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
 }
 
 void BasicEngine::Clear() {
   init_nodes_.clear();
-  node_deps_.clear();
+  all_cpu_ops_ = true;
+  for (auto* state : node_states_) {
+    if (state->node) {
+      state->node->SetEngineState(nullptr);
+    }
+  }
+  node_states_.clear();
   accumulators_.clear();
-  accumulators_with_grad_node_.clear();
-  need_accu_var_list_.clear();
-  leaf_accumulators_.clear();
+  accumulator_states_.clear();
+  inplace_vars_.clear();
+  inplace_vars_ready_ = false;
+  arena_.Reset();
 }
 
 }  // namespace imperative
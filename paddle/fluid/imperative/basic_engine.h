@@ -14,11 +14,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
+#include "paddle/fluid/framework/new_executor/workqueue.h"
+#include "paddle/fluid/imperative/autograd_arena.h"
 #include "paddle/fluid/imperative/engine.h"
 #include "paddle/fluid/imperative/gradient_accumulator.h"
 
@@ -28,6 +32,37 @@ namespace imperative {
 class VarBase;
 class OpBase;
 
+// The state of a GradOpNode in a backward pass of BasicEngine, which is
+// allocated in the arena of the engine and freed in bulk by
+// BasicEngine::Clear.
+struct BasicEngineNodeState {
+  // The accumulator of a grad var that is an input of the node.
+  struct AccumulatorEdge {
+    VariableWrapper* var;
+    GradientAccumulator* accumulator;
+    AccumulatorEdge* next;
+  };
+
+  explicit BasicEngineNodeState(std::shared_ptr<GradOpNode> grad_node)
+      : node(std::move(grad_node)) {}
+
+  GradientAccumulator* FindAccumulator(VariableWrapper* var) const {
+    for (auto* edge = accumulators; edge != nullptr; edge = edge->next) {
+      if (edge->var == var) {
+        return edge->accumulator;
+      }
+    }
+    return nullptr;
+  }
+
+  // Released once the node has run.
+  std::shared_ptr<GradOpNode> node;
+  // The number of the nodes that have not run and have this node as the
+  // grad pending node.
+  std::atomic<size_t> deps{0};
+  AccumulatorEdge* accumulators{nullptr};
+};
+
 class BasicEngine : public Engine {
  public:
   void Init(const std::vector<std::shared_ptr<VarBase>>& tensors,
@@ -39,6 +74,25 @@ class BasicEngine : public Engine {
  private:
   void PrepareDeps();
 
+  // Run the grad ops of the node, and append the grad pending nodes that
+  // become ready to ready_states.
+  void RunGradNode(BasicEngineNodeState* cur_state,
+                   std::vector<BasicEngineNodeState*>* ready_states);
+
+  // Decide the input vars that the inplace grad ops can reuse from the
+  // references held by the graph, before the nodes run in parallel.
+  void PrepareInplaceVars();
+
+  // Run the ready nodes on the threads of work_queue_, only used when all the
+  // grad ops are on CPU and FLAGS_dygraph_backward_num_threads > 1.
+  void ExecuteParallel(
+      const std::vector<BasicEngineNodeState*>& init_ready_states);
+
+  BasicEngineNodeState* GetOrCreateNodeState(
+      const std::shared_ptr<GradOpNode>& node);
+
+  GradientAccumulator* CreateGradientAccumulator(VariableWrapper* var);
+
   void CheckBackwardInputs(const OpBase& op);
 
   void PrepareGradAccumulators(
@@ -49,31 +103,35 @@ class BasicEngine : public Engine {
 
  private:
   std::vector<std::shared_ptr<GradOpNode>> init_nodes_;
-  std::unordered_map<GradOpNode*, size_t> node_deps_;
+  // The node states, accumulators and accumulator edges of a backward pass.
+  AutogradArena arena_;
+  // All the nodes reachable from init_nodes_, in BFS order.
+  std::vector<BasicEngineNodeState*> node_states_;
   // The input and output of Inplace op are the same. If only `var` is used
   // as the key, then the input and output of inplace op must be gradient
-  // accumulated. Therefore, add the `grad_node` as the key to prevent the
-  // problem of gradient accumulation in inplace op.
-  std::unordered_map<std::shared_ptr<GradOpNode>,
-                     std::unordered_map<VariableWrapper*,
-                                        std::unique_ptr<GradientAccumulator>>>
-      accumulators_with_grad_node_;
+  // accumulated. Therefore, the accumulators of a var with grad_node are
+  // stored in the state of the `grad_node` to prevent the problem of gradient
+  // accumulation in inplace op.
   // Leaf var doesn't have grad_node, and leaf var with `stop_gradient=False`
   // can't use Inplace strategy. If a var doesn't have grad_node, only use
   // `var` as the key.
-  std::unordered_map<VariableWrapper*, std::unique_ptr<GradientAccumulator>>
-      accumulators_;
-  // The output grad var of Inplace grad op. Because Inplace grad op does not
-  // use the Inplace strategy, a new output grad var needs to be created.
-  std::vector<std::pair<std::shared_ptr<VariableWrapper>,
-                        std::shared_ptr<VariableWrapper>>>
-      inplace_output_grad_var_list_;
-  std::vector<std::pair<GradientAccumulator*, std::shared_ptr<VariableWrapper>>>
-      need_accu_var_list_;
-  // leaf_accumulators_ is only for leaf tensor(hooks/accumulate grad)
-  // It should be orderly and not repeated, because multiple cards must ensure
-  // that the order of vars is the same.
-  std::vector<GradientAccumulator*> leaf_accumulators_;
+  std::unordered_map<VariableWrapper*, GradientAccumulator*> accumulators_;
+  // The lock of an accumulator, which is shared by the nodes running in
+  // parallel.
+  struct AccumulatorState {
+    std::mutex mutex;
+    bool hooks_called{false};
+  };
+  std::unordered_map<GradientAccumulator*, AccumulatorState*>
+      accumulator_states_;
+  // Serializes the hooks of the leaf accumulators.
+  std::mutex hooks_mutex_;
+  // Only used when the nodes run in parallel, see PrepareInplaceVars.
+  std::unordered_set<VariableWrapper*> inplace_vars_;
+  bool inplace_vars_ready_{false};
+  std::unique_ptr<framework::WorkQueue> work_queue_;
+  bool all_cpu_ops_{true};
+  std::atomic<size_t> op_num_{0};
 
   bool retain_graph_;
 };
@@ -43,8 +43,6 @@ void GLOOParallelContext::Init() {
   int port = std::stoi(addr[1]);
   gloo_wrapper->SetHttpStore(host, port, "worker");
   gloo_wrapper->Init();
-  device_ = std::unique_ptr<platform::CPUDeviceContext>(
-      new platform::CPUDeviceContext(platform::CPUPlace()));
 }
 
 void GLOOParallelContext::InitWithRingID(int ring_id) {
@@ -52,26 +50,30 @@ void GLOOParallelContext::InitWithRingID(int ring_id) {
       platform::errors::OutOfRange("Still not implement InitWithRingID"));
 }
 
-#define GLOO_CASE(type, T, gw)                                        \
-  case type: {                                                        \
-    VLOG(4) << "Use the gloo all reduce to sync. SRC:" << src_tensor; \
-    std::vector<T> send_vector##T;                                    \
-    framework::TensorToVector<T>(src_tensor, &send_vector##T);        \
-    auto recv_vector##T = gw->AllReduce<T>(send_vector##T);           \
-    framework::TensorFromVector<T>(recv_vector##T, dst_tensor);       \
-    VLOG(4) << "DST:" << *dst_tensor;                                 \
-    break;                                                            \
+#define GLOO_CASE(type, T, gw)                                         \
+  case type: {                                                         \
+    VLOG(4) << "Use the gloo all reduce to sync. SRC:" << *dst_tensor; \
+    gw->AllReduce<T>(dst_tensor->data<T>(),                            \
+                     static_cast<size_t>(dst_tensor->numel()));        \
+    VLOG(4) << "DST:" << *dst_tensor;                                  \
+    break;                                                             \
   }
 
 void GLOOParallelContext::AllReduceByStream(const framework::Variable &src,
                                             framework::Variable *dst,
                                             int ring_id, bool use_calc_stream) {
   // AllReduce(src, dst, strategy_, ring_id, use_calc_stream);
-  auto src_tensor = src.Get<framework::LoDTensor>();
+  const auto &src_tensor = src.Get<framework::LoDTensor>();
   auto *dst_tensor = dst->GetMutable<framework::LoDTensor>();
+  // The fused gradients of Reducer are reduced in place, only copy when the
+  // destination is another variable.
+  if (&src_tensor != dst_tensor) {
+    framework::TensorCopySync(src_tensor, platform::CPUPlace(), dst_tensor);
+  }
   auto gloo_wrapper = framework::GlooWrapper::GetInstance();
-  dst_tensor->Resize(src_tensor.dims());
-  switch (src_tensor.type()) {
+  // allreduce is a collective operation itself, so no barrier is needed after
+  // it.
+  switch (dst_tensor->type()) {
     GLOO_CASE(framework::proto::VarType::FP32, float, gloo_wrapper);
     GLOO_CASE(framework::proto::VarType::FP64, double, gloo_wrapper);
     GLOO_CASE(framework::proto::VarType::INT32, int, gloo_wrapper);
@@ -81,7 +83,6 @@ void GLOOParallelContext::AllReduceByStream(const framework::Variable &src,
           platform::errors::InvalidArgument("Invalid datatype for allreduce"));
     }
   }
-  gloo_wrapper->Barrier();
 }
 
 paddle::platform::DeviceContext *GLOOParallelContext::GetDeviceContext(
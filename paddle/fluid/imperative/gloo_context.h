@@ -32,7 +32,8 @@ class GLOOParallelContext : public ParallelContext {
  public:
   explicit GLOOParallelContext(const ParallelStrategy& strategy,
                                const platform::Place& place)
-      : ParallelContext(strategy, place) {}
+      : ParallelContext(strategy, place),
+        device_(new platform::CPUDeviceContext(platform::CPUPlace())) {}
 
   ~GLOOParallelContext() override = default;
 
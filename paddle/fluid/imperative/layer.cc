@@ -365,13 +365,29 @@ void OpBase::ClearBackwardTrace() {
   outs_.clear();
 }
 
+template <typename VarType>
+static void RunPreparedOp(const framework::OperatorWithKernel& op,
+                          PreparedOp* prepared_op,
+                          const NameVarMap<VarType>& ins,
+                          const NameVarMap<VarType>& outs,
+                          const framework::AttributeMap& attrs,
+                          const framework::AttributeMap& default_attrs) {
+  auto tmp_ins_ptr = PrepareData<VarType>(op, ins, prepared_op->kernel_type());
+  if (tmp_ins_ptr == nullptr) {
+    prepared_op->Run(ins, outs, attrs, default_attrs);
+  } else {
+    prepared_op->Run(*tmp_ins_ptr, outs, attrs, default_attrs);
+  }
+}
+
 template <typename VarType>
 static void OpBaseRunImpl(const framework::OperatorBase& op,
                           const NameVarMap<VarType>& ins,
                           const NameVarMap<VarType>& outs,
                           const framework::AttributeMap& attrs,
                           const framework::AttributeMap& default_attrs,
-                          const platform::Place& place) {
+                          const platform::Place& place,
+                          std::shared_ptr<PreparedOp>* cached_op = nullptr) {
   auto* op_kernel = dynamic_cast<const framework::OperatorWithKernel*>(&op);
   PADDLE_ENFORCE_NOT_NULL(
       op_kernel, platform::errors::PermissionDenied(
@@ -412,14 +428,20 @@ static void OpBaseRunImpl(const framework::OperatorBase& op,
    * after the execution of op, but the original input is directly
    * overwritten in the previous dynamic graph implemention.
    */
-  auto prepared_op =
-      PreparedOp::Prepare(ins, outs, *op_kernel, place, attrs, default_attrs);
-  auto tmp_ins_ptr =
-      PrepareData<VarType>(*op_kernel, ins, prepared_op.kernel_type());
-  if (tmp_ins_ptr == nullptr) {
-    prepared_op.Run(ins, outs, attrs, default_attrs);
+  if (cached_op == nullptr) {
+    auto prepared_op =
+        PreparedOp::Prepare(ins, outs, *op_kernel, place, attrs, default_attrs);
+    RunPreparedOp<VarType>(*op_kernel, &prepared_op, ins, outs, attrs,
+                           default_attrs);
   } else {
-    prepared_op.Run(*tmp_ins_ptr, outs, attrs, default_attrs);
+    auto prepared_op = std::atomic_load(cached_op);
+    if (prepared_op == nullptr) {
+      prepared_op = std::make_shared<PreparedOp>(PreparedOp::Prepare(
+          ins, outs, *op_kernel, place, attrs, default_attrs));
+      std::atomic_store(cached_op, prepared_op);
+    }
+    RunPreparedOp<VarType>(*op_kernel, prepared_op.get(), ins, outs, attrs,
+                           default_attrs);
   }
 
   VLOG(4) << LayerDebugString(op.Type(), ins, outs);
@@ -444,6 +466,17 @@ void OpBase::Run(const framework::OperatorBase& op,
   OpBaseRunImpl<VarBase>(op, ins, outs, attrs, default_attrs, place);
 }
 
+void OpBase::Run(const framework::OperatorBase& op,
+                 const NameVarMap<VarBase>& ins,
+                 const NameVarMap<VarBase>& outs,
+                 const framework::AttributeMap& attrs,
+                 const framework::AttributeMap& default_attrs,
+                 const platform::Place& place,
+                 std::shared_ptr<PreparedOp>* prepared_op) {
+  OpBaseRunImpl<VarBase>(op, ins, outs, attrs, default_attrs, place,
+                         prepared_op);
+}
+
 void OpBase::Run(const framework::OperatorBase& op,
                  const NameVarMap<VariableWrapper>& ins,
                  const NameVarMap<VariableWrapper>& outs,
@@ -29,6 +29,8 @@
 namespace paddle {
 namespace imperative {
 
+class PreparedOp;
+
 // TODO(zjl): to support py_func layer
 class OpBase {
  public:
@@ -176,6 +178,16 @@ class OpBase {
                   const framework::AttributeMap& default_attrs,
                   const platform::Place& place);
 
+  // Same as above, but the kernel held by *prepared_op is reused if it is not
+  // null, otherwise the selected kernel is stored into it.
+  static void Run(const framework::OperatorBase& op,
+                  const NameVarMap<VarBase>& ins,
+                  const NameVarMap<VarBase>& outs,
+                  const framework::AttributeMap& attrs,
+                  const framework::AttributeMap& default_attrs,
+                  const platform::Place& place,
+                  std::shared_ptr<PreparedOp>* prepared_op);
+
   static void Run(const framework::OperatorBase& op,
                   const NameVarMap<VariableWrapper>& ins,
                   const NameVarMap<VariableWrapper>& outs,
@@ -199,6 +211,8 @@ class OpBase {
   size_t id_{-1UL};
 };
 
+struct BasicEngineNodeState;
+
 class GradOpNode {
  public:
   GradOpNode() = default;
@@ -267,6 +281,12 @@ class GradOpNode {
     return grad_pending_nodes_;
   }
 
+  // The state of this node in the running backward pass of BasicEngine, it is
+  // allocated in the arena of the engine and is nullptr outside the pass.
+  BasicEngineNodeState* EngineState() const { return engine_state_; }
+
+  void SetEngineState(BasicEngineNodeState* state) { engine_state_ = state; }
+
  private:
   DISABLE_COPY_AND_ASSIGN(GradOpNode);
 
@@ -276,6 +296,7 @@ class GradOpNode {
   // Mapping relationship between grad output and grad input of the grad node of
   // Inplace op.
   std::map<std::string, std::string> inplace_grad_name_map_;
+  BasicEngineNodeState* engine_state_{nullptr};
 };
 
 }  // namespace imperative
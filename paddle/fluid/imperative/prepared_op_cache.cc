@@ -0,0 +1,238 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/imperative/prepared_op_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "paddle/fluid/imperative/layer.h"
+#include "paddle/fluid/imperative/prepared_operator.h"
+#include "paddle/fluid/string/string_helper.h"
+
+namespace paddle {
+namespace imperative {
+
+static inline size_t HashCombine(size_t seed, size_t value) {
+  return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+struct AttributeHasher : public boost::static_visitor<size_t> {
+  size_t operator()(const boost::blank&) const { return 0; }
+
+  template <typename T>
+  size_t operator()(const T& value) const {
+    return std::hash<T>()(value);
+  }
+
+  template <typename T>
+  size_t operator()(const std::vector<T>& value) const {
+    size_t seed = value.size();
+    for (const T& item : value) {
+      seed = HashCombine(seed, std::hash<T>()(item));
+    }
+    return seed;
+  }
+};
+
+// The order of an unordered_map is not determined by its content, so the
+// hashes of the attributes are summed.
+static size_t HashAttributes(const framework::AttributeMap& attrs) {
+  size_t hash = attrs.size();
+  for (const auto& pair : attrs) {
+    hash += HashCombine(std::hash<std::string>()(pair.first),
+                        boost::apply_visitor(AttributeHasher(), pair.second));
+  }
+  return hash;
+}
+
+struct PlaceDeviceIdVisitor : public boost::static_visitor<int> {
+  int operator()(const platform::CUDAPlace& place) const {
+    return place.GetDeviceId();
+  }
+  int operator()(const platform::XPUPlace& place) const {
+    return place.GetDeviceId();
+  }
+  int operator()(const platform::NPUPlace& place) const {
+    return place.GetDeviceId();
+  }
+  template <typename Place>
+  int operator()(const Place&) const {
+    return 0;
+  }
+};
+
+static void AppendPlace(const platform::Place& place,
+                        std::vector<int64_t>* signature) {
+  signature->push_back(place.which());
+  signature->push_back(boost::apply_visitor(PlaceDeviceIdVisitor(), place));
+}
+
+static std::vector<int64_t> InputSignature(const NameVarBaseMap& ins) {
+  std::vector<int64_t> signature;
+  for (const auto& pair : ins) {
+    signature.push_back(
+        static_cast<int64_t>(std::hash<std::string>()(pair.first)));
+    signature.push_back(static_cast<int64_t>(pair.second.size()));
+    for (const auto& var : pair.second) {
+      if (var == nullptr) {
+        signature.push_back(-1);
+        continue;
+      }
+      signature.push_back(var->Type());
+      signature.push_back(var->DataType());
+      const auto* tensor = GetTensorFromVar(var->Var());
+      if (tensor && tensor->IsInitialized()) {
+        signature.push_back(tensor->type());
+        signature.push_back(static_cast<int64_t>(tensor->layout()));
+        AppendPlace(tensor->place(), &signature);
+        signature.push_back(tensor->numel() > 0);
+      } else {
+        signature.push_back(-1);
+      }
+    }
+  }
+  return signature;
+}
+
+std::shared_ptr<PreparedOpCache::Entry> PreparedOpCache::Get(
+    const std::string& type, const NameVarBaseMap& ins,
+    const framework::AttributeMap& attrs, const platform::Place& place,
+    Key* key) {
+  key->input_signature = InputSignature(ins);
+  size_t hash = std::hash<std::string>()(type);
+  hash = HashCombine(hash, HashAttributes(attrs));
+  hash = HashCombine(hash, place.which());
+  hash = HashCombine(hash, boost::apply_visitor(PlaceDeviceIdVisitor(), place));
+  for (int64_t value : key->input_signature) {
+    hash = HashCombine(hash, static_cast<size_t>(value));
+  }
+  key->hash = hash;
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = entries_.find(hash);
+    if (iter != entries_.end()) {
+      for (auto lru_iter : iter->second) {
+        const auto& entry = *lru_iter;
+        if (entry->type == type &&
+            platform::is_same_place(entry->place, place) &&
+            entry->input_signature == key->input_signature &&
+            entry->attrs == attrs) {
+          lru_.splice(lru_.begin(), lru_, lru_iter);
+          ++hits_;
+          return entry;
+        }
+      }
+    }
+  }
+  ++misses_;
+  return nullptr;
+}
+
+std::shared_ptr<PreparedOpCache::Entry> PreparedOpCache::Insert(
+    Key&& key, const std::string& type, const framework::AttributeMap& attrs,
+    const platform::Place& place, std::shared_ptr<framework::OperatorBase> op,
+    framework::AttributeMap&& checked_attrs,
+    const framework::AttributeMap* default_attrs) {
+  auto entry = std::make_shared<Entry>();
+  entry->hash = key.hash;
+  entry->type = type;
+  entry->place = place;
+  entry->attrs = attrs;
+  entry->input_signature = std::move(key.input_signature);
+  entry->op = std::move(op);
+  entry->checked_attrs = std::move(checked_attrs);
+  entry->default_attrs = default_attrs;
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  EvictWithoutLock(capacity_ > 0 ? capacity_ - 1 : 0);
+  lru_.push_front(entry);
+  entries_[entry->hash].push_back(lru_.begin());
+  return entry;
+}
+
+PreparedOpCache::LRUList::iterator PreparedOpCache::EraseWithoutLock(
+    LRUList::iterator lru_iter) {
+  auto bucket = entries_.find((*lru_iter)->hash);
+  auto& iters = bucket->second;
+  iters.erase(std::find(iters.begin(), iters.end(), lru_iter));
+  if (iters.empty()) {
+    entries_.erase(bucket);
+  }
+  return lru_.erase(lru_iter);
+}
+
+void PreparedOpCache::EvictWithoutLock(size_t capacity) {
+  while (lru_.size() > capacity) {
+    VLOG(5) << "Evict " << lru_.back()->type
+            << " from the prepared op cache of Tracer.";
+    EraseWithoutLock(std::prev(lru_.end()));
+  }
+}
+
+void PreparedOpCache::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+void PreparedOpCache::SetCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  capacity_ = capacity;
+  EvictWithoutLock(capacity_);
+}
+
+size_t PreparedOpCache::Capacity() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return capacity_;
+}
+
+void PreparedOpCache::SetOpTypes(const std::string& op_types) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (op_types == op_types_) {
+    return;
+  }
+  op_types_ = op_types;
+  op_type_set_.clear();
+  for (auto& op_type : string::split_string<std::string>(op_types, ",")) {
+    op_type = string::trim_spaces(op_type);
+    if (!op_type.empty()) {
+      op_type_set_.insert(op_type);
+    }
+  }
+  // Drops the entries of the op types removed from the allowlist.
+  for (auto iter = lru_.begin(); iter != lru_.end();) {
+    if (op_type_set_.count((*iter)->type)) {
+      ++iter;
+    } else {
+      iter = EraseWithoutLock(iter);
+    }
+  }
+}
+
+bool PreparedOpCache::IsCachedOpType(const std::string& type) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return op_type_set_.count(type) > 0;
+}
+
+size_t PreparedOpCache::Size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return lru_.size();
+}
+
+}  // namespace imperative
+}  // namespace paddle
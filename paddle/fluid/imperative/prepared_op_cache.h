@@ -0,0 +1,124 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/type_defs.h"
+#include "paddle/fluid/imperative/type_defs.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace imperative {
+
+class PreparedOp;
+
+/**
+ * Cache of the traced ops of Tracer. An entry holds the operator instance,
+ * the checked attributes and the selected kernel, so that tracing an op of the
+ * same type, attributes, inputs and place again skips CreateOp, the attribute
+ * checker and the kernel lookup.
+ *
+ * Besides the op type, the attributes and the place, the key contains the var
+ * type, data type, layout and place of every input, which are what
+ * GetExpectedKernelType of the ops depends on. Ops whose kernel choice depends
+ * on anything else must not be traced with the cache enabled, so only the op
+ * types in the allowlist set by SetOpTypes are cached. The least recently used
+ * entry is evicted when the cache is full.
+ */
+class PreparedOpCache {
+ public:
+  struct Key {
+    size_t hash{0};
+    std::vector<int64_t> input_signature;
+  };
+
+  struct Entry {
+    size_t hash{0};
+    std::string type;
+    platform::Place place;
+    // The attributes passed to TraceOp, part of the key.
+    framework::AttributeMap attrs;
+    std::vector<int64_t> input_signature;
+
+    std::shared_ptr<framework::OperatorBase> op;
+    framework::AttributeMap checked_attrs;
+    const framework::AttributeMap* default_attrs{nullptr};
+    // Filled by the first run of the op.
+    std::shared_ptr<PreparedOp> prepared_op;
+  };
+
+  explicit PreparedOpCache(size_t capacity) : capacity_(capacity) {}
+
+  // Returns nullptr if missed, key is filled for the following Insert.
+  std::shared_ptr<Entry> Get(const std::string& type,
+                             const NameVarBaseMap& ins,
+                             const framework::AttributeMap& attrs,
+                             const platform::Place& place, Key* key);
+
+  // Insert the entry of a missed op, the least recently used entry is evicted
+  // if the cache is full.
+  std::shared_ptr<Entry> Insert(Key&& key, const std::string& type,
+                                const framework::AttributeMap& attrs,
+                                const platform::Place& place,
+                                std::shared_ptr<framework::OperatorBase> op,
+                                framework::AttributeMap&& checked_attrs,
+                                const framework::AttributeMap* default_attrs);
+
+  void Clear();
+
+  void SetCapacity(size_t capacity);
+
+  size_t Capacity() const;
+
+  // Sets the op types to cache, separated by commas.
+  void SetOpTypes(const std::string& op_types);
+
+  bool IsCachedOpType(const std::string& type) const;
+
+  size_t Size() const;
+
+  int64_t Hits() const { return hits_; }
+
+  int64_t Misses() const { return misses_; }
+
+ private:
+  using LRUList = std::list<std::shared_ptr<Entry>>;
+
+  LRUList::iterator EraseWithoutLock(LRUList::iterator lru_iter);
+  // Evicts the least recently used entries until at most capacity are left.
+  void EvictWithoutLock(size_t capacity);
+
+  size_t capacity_;
+  std::string op_types_;
+  std::unordered_set<std::string> op_type_set_;
+  // The most recently used entry is at the front.
+  LRUList lru_;
+  std::unordered_map<size_t, std::vector<LRUList::iterator>> entries_;
+  mutable std::mutex mutex_;
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+};
+
+}  // namespace imperative
+}  // namespace paddle
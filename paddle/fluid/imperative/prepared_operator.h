@@ -174,7 +174,9 @@ class PreparedOp {
 
  private:
   const framework::OperatorBase& op_;
-  const framework::RuntimeContext& ctx_;
+  // Hold a copy, the PreparedOp may be cached and outlive the context it is
+  // prepared with.
+  framework::RuntimeContext ctx_;
   framework::OpKernelType kernel_type_;
   framework::OperatorWithKernel::OpKernelFunc func_;
   platform::DeviceContext* dev_ctx_;
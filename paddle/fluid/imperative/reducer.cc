@@ -304,7 +304,7 @@ Reducer::Reducer(const std::vector<std::shared_ptr<imperative::VarBase>> &vars,
   VLOG(3) << "Start construct the Reducer ...";
   nrings_ = parallel_ctx->GetNRings();
   nranks_ = parallel_ctx->GetNRanks();
-#ifdef PADDLE_WITH_XPU_BKCL
+#if defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
   comm_pool_.reset(new ::ThreadPool(1));
   comm_op_count_ = 0;
 #endif
@@ -791,27 +791,40 @@ void Reducer::MarkGroupReady(size_t group_index) {
     // so we expose WaitCompute() interface and call
     // it here.
     parallel_ctx_->WaitCompute(run_order);
-#ifdef PADDLE_WITH_XPU_BKCL
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      comm_op_count_ += 1;  // lock
-    }
-    // TODO(liuyuhui): Add try catch to deal with exception later,
-    // otherwise the main thread will continue to run when an exception is
-    // thrown in comm_pool_.
-    auto next_group = next_group_;
-    comm_pool_->enqueue([this, run_order, next_group, &group] {
-      auto dev_id = BOOST_GET_CONST(platform::XPUPlace, place_).device;
-      platform::SetXPUDeviceId(dev_id);
-      FusedAllReduceSchedule(run_order, group, next_group);
+#if defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
+    // Kunlun cards and CPU communicate synchronously, so the allreduce of the
+    // group runs in comm_pool_ and is waited in FinalizeBackward.
+    if (platform::is_xpu_place(place_) || platform::is_cpu_place(place_)) {
       {
         std::lock_guard<std::mutex> lock(mutex_);
-        comm_op_count_ -= 1;  // lock
-        cv_.notify_all();
+        comm_op_count_ += 1;  // lock
       }
-    });
-#elif defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL) || \
-    defined(PADDLE_WITH_GLOO)
+      auto next_group = next_group_;
+      comm_pool_->enqueue([this, run_order, next_group, &group] {
+        try {
+#ifdef PADDLE_WITH_XPU_BKCL
+          if (platform::is_xpu_place(place_)) {
+            auto dev_id = BOOST_GET_CONST(platform::XPUPlace, place_).device;
+            platform::SetXPUDeviceId(dev_id);
+          }
+#endif
+          FusedAllReduceSchedule(run_order, group, next_group);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!comm_exception_) {
+            comm_exception_ = std::current_exception();
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          comm_op_count_ -= 1;  // lock
+          cv_.notify_all();
+        }
+      });
+      continue;
+    }
+#endif
+#if defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL)
     FusedAllReduceSchedule(run_order, group, next_group_);
 #else
     PADDLE_THROW(platform::errors::PreconditionNotMet(
@@ -972,10 +985,15 @@ bool Reducer::HasGrad(size_t var_index) {
 void Reducer::FinalizeBackward() {
   groups_need_finalize_ = false;
   grad_need_hooks_ = false;
-#ifdef PADDLE_WITH_XPU_BKCL
+#if defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_GLOO)
   {
     std::unique_lock<std::mutex> lock(mutex_);
     cv_.wait(lock, [&] { return comm_op_count_ == 0; });
+    if (comm_exception_) {
+      auto exception = comm_exception_;
+      comm_exception_ = nullptr;
+      std::rethrow_exception(exception);
+    }
   }
 #endif
 
@@ -0,0 +1,233 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/fleet/gloo_wrapper.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/imperative/basic_engine.h"
+#include "paddle/fluid/imperative/gloo_context.h"
+#include "paddle/fluid/imperative/reducer.h"
+#include "paddle/fluid/imperative/tracer.h"
+
+namespace framework = paddle::framework;
+namespace imperative = paddle::imperative;
+namespace platform = paddle::platform;
+
+using vb_vector = std::vector<std::shared_ptr<imperative::VarBase>>;
+using var_pair = std::pair<std::string, vb_vector>;
+
+static const int kNRanks = 2;
+static const int64_t kBatch = 3;
+static const int64_t kInputDim = 4;
+static const int64_t kOutputDim = 2;
+
+static imperative::ParallelStrategy GetStrategy(int local_rank) {
+  imperative::ParallelStrategy strategy;
+  strategy.nranks_ = kNRanks;
+  strategy.local_rank_ = local_rank;
+  strategy.nrings_ = 1;
+  return strategy;
+}
+
+static std::shared_ptr<imperative::VarBase> CreateVar(const std::string& name,
+                                                      int64_t rows,
+                                                      int64_t cols, float base,
+                                                      bool stop_gradient) {
+  std::shared_ptr<imperative::VarBase> var(
+      new imperative::VarBase(true, name));
+  var->SetOverridedStopGradient(stop_gradient);
+  auto* tensor = var->MutableVar()->GetMutable<framework::LoDTensor>();
+  tensor->Resize(framework::make_ddim({rows, cols}));
+  auto* data = tensor->mutable_data<float>(platform::CPUPlace());
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      data[i * cols + j] = base + i + j;
+    }
+  }
+  return var;
+}
+
+// loss = mul(x, w0) + mul(x, w1) + mul(x, w2), the grads of w0 and w1 are
+// fused in one group and w2 is in another. Runs one backward with the
+// Reducer and returns the grads of the params.
+static std::vector<std::vector<float>> RunBackwardWithReducer(
+    std::shared_ptr<imperative::ParallelContext> ctx, int rank) {
+  imperative::Tracer tracer;
+  platform::CPUPlace place;
+  auto x = CreateVar("x", kBatch, kInputDim, rank, true);
+  vb_vector params;
+  vb_vector outs;
+  framework::AttributeMap mul_attrs;
+  mul_attrs["use_mkldnn"] = false;
+  for (int i = 0; i < 3; ++i) {
+    params.emplace_back(
+        CreateVar("w_" + std::to_string(i), kInputDim, kOutputDim, i, false));
+    std::shared_ptr<imperative::VarBase> out(
+        new imperative::VarBase(true, "mul_out_" + std::to_string(i)));
+    tracer.TraceOp("mul", {var_pair("X", {x}), var_pair("Y", {params[i]})},
+                   {var_pair("Out", {out})}, mul_attrs, place, true);
+    outs.emplace_back(out);
+  }
+  auto loss = outs[0];
+  for (int i = 1; i < 3; ++i) {
+    std::shared_ptr<imperative::VarBase> sum(
+        new imperative::VarBase(true, "sum_" + std::to_string(i)));
+    tracer.TraceOp("elementwise_add",
+                   {var_pair("X", {loss}), var_pair("Y", {outs[i]})},
+                   {var_pair("Out", {sum})}, framework::AttributeMap(), place,
+                   true);
+    loss = sum;
+  }
+
+  imperative::Reducer reducer(params, {{0, 1}, {2}}, {false, false, false},
+                              ctx, {1024 * 1024}, false);
+  reducer.PrepareForBackward({loss});
+  imperative::BasicEngine engine;
+  engine.Init({loss}, {nullptr});
+  engine.Execute();
+
+  std::vector<std::vector<float>> grads;
+  for (auto& param : params) {
+    std::vector<float> grad;
+    framework::TensorToVector(param->GradVar().Get<framework::LoDTensor>(),
+                              &grad);
+    grads.push_back(grad);
+  }
+  return grads;
+}
+
+template <typename T>
+static void CheckAllReduceByStream(imperative::ParallelContext* ctx,
+                                   int rank) {
+  std::vector<T> data(17);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<T>(rank * 100 + i);
+  }
+  // the copy-based allreduce of GlooWrapper as the reference
+  auto expected = framework::GlooWrapper::GetInstance()->AllReduce(data);
+
+  // in place, as the Reducer does for its fused groups
+  framework::Variable var;
+  auto* tensor = var.GetMutable<framework::LoDTensor>();
+  framework::TensorFromVector(data, tensor);
+  ctx->AllReduceByStream(var, &var, 0, false);
+  std::vector<T> result;
+  framework::TensorToVector(*tensor, &result);
+  EXPECT_EQ(result, expected);
+
+  // to another variable, the source is kept
+  framework::Variable dst;
+  framework::TensorFromVector(data, tensor);
+  ctx->AllReduceByStream(var, &dst, 0, false);
+  framework::TensorToVector(dst.Get<framework::LoDTensor>(), &result);
+  EXPECT_EQ(result, expected);
+  framework::TensorToVector(*tensor, &result);
+  EXPECT_EQ(result, data);
+}
+
+static void RunRank(int rank, const std::string& store_path) {
+  auto gloo = framework::GlooWrapper::GetInstance();
+  gloo->SetTimeoutSeconds(60, 60);
+  gloo->SetRank(rank);
+  gloo->SetSize(kNRanks);
+  gloo->SetPrefix("gloo_context_test");
+  gloo->SetIface("lo");
+  gloo->SetHdfsStore(store_path, "", "");
+  gloo->Init();
+
+  auto ctx = std::make_shared<imperative::GLOOParallelContext>(
+      GetStrategy(rank), platform::CPUPlace());
+  CheckAllReduceByStream<float>(ctx.get(), rank);
+  CheckAllReduceByStream<double>(ctx.get(), rank);
+  CheckAllReduceByStream<int>(ctx.get(), rank);
+  CheckAllReduceByStream<int64_t>(ctx.get(), rank);
+
+  // the grads are averaged over the ranks, grad(w)[k][n] = sum_b x[b][k]
+  // and x[b][k] = rank + b + k
+  for (int step = 0; step < 3; ++step) {
+    auto grads = RunBackwardWithReducer(ctx, rank);
+    ASSERT_EQ(grads.size(), 3UL);
+    for (auto& grad : grads) {
+      ASSERT_EQ(grad.size(), static_cast<size_t>(kInputDim * kOutputDim));
+      for (int64_t k = 0; k < kInputDim; ++k) {
+        float expected = kBatch * (0.5f * (kNRanks - 1) + k) +
+                         kBatch * (kBatch - 1) / 2.0f;
+        for (int64_t n = 0; n < kOutputDim; ++n) {
+          EXPECT_FLOAT_EQ(grad[k * kOutputDim + n], expected);
+        }
+      }
+    }
+  }
+  gloo->Barrier();
+}
+
+TEST(GLOOParallelContext, AllReduceWithReducer) {
+  std::string store_path = ::testing::TempDir() + "gloo_context_test_" +
+                           std::to_string(std::random_device()());
+  std::vector<pid_t> pids;
+  for (int rank = 0; rank < kNRanks; ++rank) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      RunRank(rank, store_path);
+      _exit(::testing::Test::HasFailure() ? 1 : 0);
+    }
+    pids.push_back(pid);
+  }
+  for (auto pid : pids) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+  std::system(("rm -rf " + store_path).c_str());
+}
+
+// fails every allreduce, which runs in the comm pool of the Reducer
+class FailingGLOOParallelContext : public imperative::GLOOParallelContext {
+ public:
+  using imperative::GLOOParallelContext::GLOOParallelContext;
+
+  void AllReduceByStream(const framework::Variable& src,
+                         framework::Variable* dst, int ring_id,
+                         bool use_calc_stream) override {
+    PADDLE_THROW(platform::errors::Unavailable("allreduce failed in test"));
+  }
+};
+
+TEST(GLOOParallelContext, RethrowCommException) {
+  auto ctx = std::make_shared<FailingGLOOParallelContext>(
+      GetStrategy(0), platform::CPUPlace());
+  try {
+    RunBackwardWithReducer(ctx, 0);
+    FAIL() << "the exception in the comm pool is lost";
+  } catch (platform::EnforceNotMet& e) {
+    EXPECT_NE(std::string(e.what()).find("allreduce failed in test"),
+              std::string::npos);
+  }
+}
+
+USE_OP(mul);
+USE_OP(mul_grad);
+USE_OP(elementwise_add);
+USE_OP(elementwise_add_grad);
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/imperative/autograd_arena.h"
+
+namespace paddle {
+namespace imperative {
+
+struct DestructionRecorder {
+  DestructionRecorder(int id, std::vector<int>* destroyed)
+      : id_(id), destroyed_(destroyed) {}
+
+  ~DestructionRecorder() { destroyed_->push_back(id_); }
+
+  int id_;
+  std::vector<int>* destroyed_;
+};
+
+TEST(test_autograd_arena, test_alignment_and_reuse) {
+  AutogradArena arena(64);
+  auto* c = arena.New<char>('a');
+  auto* d = arena.New<double>(1.5);
+  auto* s = arena.New<std::string>("autograd");
+  ASSERT_EQ(*c, 'a');
+  ASSERT_EQ(*d, 1.5);
+  ASSERT_EQ(*s, "autograd");
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0UL);
+
+  // Objects larger than the chunk size get their own chunk.
+  auto* big = arena.New<std::array<int64_t, 32>>();
+  big->fill(7);
+  ASSERT_EQ((*big)[31], 7);
+
+  size_t capacity = arena.Capacity();
+  arena.Reset();
+  for (int i = 0; i < 4; ++i) {
+    arena.New<double>(i);
+  }
+  // The chunks are kept after Reset.
+  ASSERT_EQ(arena.Capacity(), capacity);
+}
+
+TEST(test_autograd_arena, test_destruction_order) {
+  std::vector<int> destroyed;
+  {
+    AutogradArena arena;
+    for (int i = 0; i < 3; ++i) {
+      arena.New<DestructionRecorder>(i, &destroyed);
+    }
+    arena.Reset();
+    ASSERT_EQ(destroyed, std::vector<int>({2, 1, 0}));
+    arena.New<DestructionRecorder>(3, &destroyed);
+  }
+  ASSERT_EQ(destroyed, std::vector<int>({2, 1, 0, 3}));
+}
+
+}  // namespace imperative
+}  // namespace paddle
@@ -0,0 +1,154 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/imperative/basic_engine.h"
+#include "paddle/fluid/imperative/tracer.h"
+#include "paddle/fluid/memory/memcpy.h"
+
+namespace platform = paddle::platform;
+namespace framework = paddle::framework;
+namespace memory = paddle::memory;
+
+DECLARE_bool(sort_sum_gradient);
+DECLARE_int32(dygraph_backward_num_threads);
+
+namespace paddle {
+namespace imperative {
+
+using vb_vector = std::vector<std::shared_ptr<imperative::VarBase>>;
+using var_pair = std::pair<std::string, vb_vector>;
+
+static std::shared_ptr<VarBase> CreateVar(const std::string& name,
+                                          const std::vector<int64_t>& dims,
+                                          float offset) {
+  std::shared_ptr<VarBase> var(new VarBase(true, name));
+  var->SetOverridedStopGradient(false);
+  auto* tensor = var->MutableVar()->GetMutable<framework::LoDTensor>();
+  tensor->Resize(framework::make_ddim(dims));
+  auto* data = tensor->mutable_data<float>(platform::CPUPlace());
+  // Small integers, so that the sums are exact in any order.
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<float>((i + static_cast<int64_t>(offset)) % 5) - 2;
+  }
+  return var;
+}
+
+struct WideGraphGrads {
+  framework::LoDTensor x_grad;
+  std::vector<framework::LoDTensor> w_grads;
+  int x_hook_calls{0};
+};
+
+// out = sum_i(mul(x, w_i)), summed by a tree of elementwise_add, so the grad
+// nodes of the branches are independent and all add to the grad of x.
+static WideGraphGrads RunWideGraph(int num_branches) {
+  Tracer tracer;
+  platform::CPUPlace place;
+  auto x = CreateVar("x", {4, 6}, 0);
+  vb_vector ws;
+  vb_vector outs;
+  framework::AttributeMap mul_attrs;
+  mul_attrs["use_mkldnn"] = false;
+  for (int i = 0; i < num_branches; ++i) {
+    ws.emplace_back(CreateVar("w_" + std::to_string(i), {6, 3}, i));
+    std::shared_ptr<VarBase> out(
+        new VarBase(true, "mul_out_" + std::to_string(i)));
+    tracer.TraceOp("mul", {var_pair("X", {x}), var_pair("Y", {ws.back()})},
+                   {var_pair("Out", {out})}, mul_attrs, place, true);
+    outs.emplace_back(out);
+  }
+  framework::AttributeMap add_attrs;
+  while (outs.size() > 1) {
+    vb_vector sums;
+    for (size_t i = 0; i + 1 < outs.size(); i += 2) {
+      std::shared_ptr<VarBase> sum(
+          new VarBase(true, "sum_" + std::to_string(i)));
+      tracer.TraceOp("elementwise_add",
+                     {var_pair("X", {outs[i]}), var_pair("Y", {outs[i + 1]})},
+                     {var_pair("Out", {sum})}, add_attrs, place, true);
+      sums.emplace_back(sum);
+    }
+    if (outs.size() % 2 == 1) {
+      sums.emplace_back(outs.back());
+    }
+    outs.swap(sums);
+  }
+
+  WideGraphGrads grads;
+  x->GradVarBase()->AddVoidHook(std::make_shared<std::function<void()>>(
+      [&grads]() { ++grads.x_hook_calls; }));
+
+  BasicEngine engine;
+  engine.Init({outs[0]}, {nullptr});
+  engine.Execute();
+
+  framework::TensorCopySync(x->GradVar().Get<framework::LoDTensor>(), place,
+                            &grads.x_grad);
+  grads.w_grads.resize(ws.size());
+  for (size_t i = 0; i < ws.size(); ++i) {
+    framework::TensorCopySync(ws[i]->GradVar().Get<framework::LoDTensor>(),
+                              place, &grads.w_grads[i]);
+  }
+  return grads;
+}
+
+static void ExpectTensorEqual(const framework::LoDTensor& expected,
+                              const framework::LoDTensor& actual) {
+  ASSERT_EQ(expected.dims(), actual.dims());
+  for (int64_t i = 0; i < expected.numel(); ++i) {
+    ASSERT_EQ(expected.data<float>()[i], actual.data<float>()[i]);
+  }
+}
+
+static void TestParallelBackward(bool sort_sum_gradient) {
+  const int num_branches = 13;
+  FLAGS_sort_sum_gradient = sort_sum_gradient;
+  FLAGS_dygraph_backward_num_threads = 0;
+  auto expected = RunWideGraph(num_branches);
+  ASSERT_EQ(expected.x_hook_calls, 1);
+
+  FLAGS_dygraph_backward_num_threads = 4;
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    auto actual = RunWideGraph(num_branches);
+    ASSERT_EQ(actual.x_hook_calls, 1);
+    ExpectTensorEqual(expected.x_grad, actual.x_grad);
+    for (int i = 0; i < num_branches; ++i) {
+      ExpectTensorEqual(expected.w_grads[i], actual.w_grads[i]);
+    }
+  }
+  FLAGS_dygraph_backward_num_threads = 0;
+  FLAGS_sort_sum_gradient = false;
+}
+
+TEST(TestBasicEngine, ParallelBackwardOfWideGraph) {
+  TestParallelBackward(false);
+}
+
+TEST(TestBasicEngine, ParallelBackwardOfWideGraphWithSortedGradAccumulated) {
+  TestParallelBackward(true);
+}
+
+}  // namespace imperative
+}  // namespace paddle
+
+USE_OP(mul);
+USE_OP(mul_grad);
+USE_OP(elementwise_add);
+USE_OP(elementwise_add_grad);
@@ -30,6 +30,7 @@ namespace framework = paddle::framework;
 namespace memory = paddle::memory;
 
 DECLARE_bool(sort_sum_gradient);
+DECLARE_int32(dygraph_backward_num_threads);
 
 namespace paddle {
 namespace imperative {
@@ -259,6 +260,15 @@ TEST(TestHooks, TestGradVarLeafBackwardHookWithSortedGradAccmulated) {
   FLAGS_sort_sum_gradient = false;
 }
 
+TEST(TestHooks, TestGradVarLeafBackwardHookWithParallelBackward) {
+  FLAGS_dygraph_backward_num_threads = 4;
+  GradVarLeafBackwardHookWithGradAccmulatedTest();
+  FLAGS_sort_sum_gradient = true;
+  GradVarLeafBackwardHookWithGradAccmulatedTest();
+  FLAGS_sort_sum_gradient = false;
+  FLAGS_dygraph_backward_num_threads = 0;
+}
+
 }  // namespace imperative
 }  // namespace paddle
 
@@ -28,6 +28,8 @@
 #include "paddle/fluid/imperative/tracer.h"
 #include "paddle/fluid/memory/memcpy.h"
 
+DECLARE_string(tracer_op_cache_ops);
+
 namespace imperative = paddle::imperative;
 namespace platform = paddle::platform;
 namespace framework = paddle::framework;
@@ -85,6 +87,117 @@ TEST(test_tracer, test_trace_op) {
   }
 }
 
+TEST(test_tracer, test_trace_op_with_op_cache) {
+  imperative::Tracer tracer;
+  std::shared_ptr<imperative::VarBase> x_in(
+      new imperative::VarBase(true, "x_in"));
+  std::shared_ptr<imperative::VarBase> y_in(
+      new imperative::VarBase(true, "y_in"));
+  platform::CPUPlace place;
+  std::vector<float> src_data(10, 2.0);
+  std::vector<int64_t> dims1 = {2, 5};
+  std::vector<int64_t> dims2 = {5, 2};
+
+  auto* x_in_tensor = x_in->MutableVar()->GetMutable<framework::LoDTensor>();
+  auto* y_in_tensor = y_in->MutableVar()->GetMutable<framework::LoDTensor>();
+  x_in_tensor->Resize(framework::make_ddim(dims1));
+  auto* mutable_x = x_in_tensor->mutable_data<float>(place);
+  paddle::memory::Copy(place, mutable_x, place, src_data.data(),
+                       sizeof(float) * src_data.size());
+  y_in_tensor->Resize(framework::make_ddim(dims2));
+  auto* mutable_y = y_in_tensor->mutable_data<float>(place);
+  paddle::memory::Copy(place, mutable_y, place, src_data.data(),
+                       sizeof(float) * src_data.size());
+
+  var_pair x_pair = var_pair("X", vb_vector(1, x_in));
+  var_pair y_pair = var_pair("Y", vb_vector(1, y_in));
+  imperative::NameVarBaseMap ins = {x_pair, y_pair};
+  framework::AttributeMap mul_attr_map;
+  mul_attr_map["use_mkldnn"] = false;
+
+  auto* op_cache = tracer.GetPreparedOpCache();
+  // Not in the allowlist, the cache is not used.
+  {
+    std::shared_ptr<imperative::VarBase> vout(
+        new imperative::VarBase(true, "vout"));
+    imperative::NameVarBaseMap outs = {var_pair("Out", vb_vector(1, vout))};
+    tracer.TraceOp("mul", ins, outs, mul_attr_map, place, true);
+    ASSERT_EQ(op_cache->Misses(), 0);
+    ASSERT_EQ(op_cache->Size(), 0UL);
+  }
+
+  FLAGS_tracer_op_cache_ops = "elementwise_add, mul";
+  for (int i = 0; i < 3; ++i) {
+    std::shared_ptr<imperative::VarBase> vout(
+        new imperative::VarBase(true, "vout"));
+    imperative::NameVarBaseMap outs = {var_pair("Out", vb_vector(1, vout))};
+    tracer.TraceOp("mul", ins, outs, mul_attr_map, place, true);
+
+    const auto& out_tensor = vout->Var().Get<framework::LoDTensor>();
+    ASSERT_EQ(out_tensor.numel(), 4);
+    for (int j = 0; j < out_tensor.numel(); j++) {
+      ASSERT_EQ(out_tensor.data<float>()[j], 20.0);
+    }
+  }
+  ASSERT_EQ(op_cache->Misses(), 1);
+  ASSERT_EQ(op_cache->Hits(), 2);
+  ASSERT_EQ(op_cache->Size(), 1UL);
+
+  // Different attributes miss the cache.
+  mul_attr_map["y_num_col_dims"] = 1;
+  std::shared_ptr<imperative::VarBase> vout(
+      new imperative::VarBase(true, "vout"));
+  imperative::NameVarBaseMap outs = {var_pair("Out", vb_vector(1, vout))};
+  tracer.TraceOp("mul", ins, outs, mul_attr_map, place, true);
+  ASSERT_EQ(op_cache->Misses(), 2);
+  ASSERT_EQ(op_cache->Size(), 2UL);
+
+  // Removing mul from the allowlist drops its entries.
+  FLAGS_tracer_op_cache_ops = "elementwise_add";
+  tracer.TraceOp("mul", ins, outs, mul_attr_map, place, true);
+  ASSERT_EQ(op_cache->Misses(), 2);
+  ASSERT_EQ(op_cache->Size(), 0UL);
+  FLAGS_tracer_op_cache_ops = "";
+}
+
+TEST(test_tracer, test_prepared_op_cache_lru) {
+  PreparedOpCache op_cache(2);
+  op_cache.SetOpTypes("mul");
+  ASSERT_TRUE(op_cache.IsCachedOpType("mul"));
+  ASSERT_FALSE(op_cache.IsCachedOpType("mu"));
+
+  platform::CPUPlace place;
+  imperative::NameVarBaseMap ins;
+  auto insert = [&](int value) {
+    framework::AttributeMap attrs = {{"value", value}};
+    PreparedOpCache::Key key;
+    ASSERT_EQ(op_cache.Get("mul", ins, attrs, place, &key), nullptr);
+    op_cache.Insert(std::move(key), "mul", attrs, place, nullptr,
+                    framework::AttributeMap(attrs), nullptr);
+  };
+  auto hit = [&](int value) {
+    framework::AttributeMap attrs = {{"value", value}};
+    PreparedOpCache::Key key;
+    return op_cache.Get("mul", ins, attrs, place, &key) != nullptr;
+  };
+
+  insert(0);
+  insert(1);
+  ASSERT_TRUE(hit(0));
+  // 1 is the least recently used entry.
+  insert(2);
+  ASSERT_EQ(op_cache.Size(), 2UL);
+  ASSERT_TRUE(hit(0));
+  ASSERT_FALSE(hit(1));
+  ASSERT_TRUE(hit(2));
+
+  op_cache.SetCapacity(1);
+  ASSERT_EQ(op_cache.Size(), 1UL);
+  ASSERT_TRUE(hit(2));
+  op_cache.Clear();
+  ASSERT_EQ(op_cache.Size(), 0UL);
+}
+
 TEST(test_tracer, test_trace_op_with_backward) {
   // Doing an mul
   imperative::Tracer tracer;
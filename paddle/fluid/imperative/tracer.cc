@@ -26,6 +26,8 @@
 DECLARE_bool(use_mkldnn);
 DECLARE_string(tracer_mkldnn_ops_on);
 DECLARE_string(tracer_mkldnn_ops_off);
+DECLARE_int32(tracer_op_cache_capacity);
+DECLARE_string(tracer_op_cache_ops);
 
 namespace paddle {
 namespace imperative {
@@ -143,6 +145,21 @@ paddle::framework::GarbageCollector* Tracer::MutableGarbageCollectorIfNotExists(
   return gcs_.at(place).get();
 }
 
+// Creates the operator of type and checks attrs with its attribute checker,
+// returns the default attributes of the op.
+static const framework::AttributeMap* CreateCheckedOp(
+    const std::string& type, framework::AttributeMap* attrs,
+    std::unique_ptr<framework::OperatorBase>* op) {
+  *op = framework::OpRegistry::CreateOp(type, {}, {}, {}, false);
+  auto* attr_checker = (*op)->Info().Checker();
+  if (attr_checker) {
+    attr_checker->Check(attrs, true, /*only_check_exist_value=*/true);
+  }
+  static paddle::framework::AttributeMap empty_attrs_map = {};
+  return attr_checker == nullptr ? &empty_attrs_map
+                                 : &attr_checker->GetDefaultAttrMap();
+}
+
 void Tracer::TraceOp(const std::string& type, const NameVarBaseMap& ins,
                      const NameVarBaseMap& outs, framework::AttributeMap attrs,
                      const platform::Place& place, bool trace_backward,
@@ -163,18 +180,6 @@ void Tracer::TraceOp(const std::string& type, const NameVarBaseMap& ins,
       attrs["use_mkldnn"] = !is_off;
     }
   }
-  auto op = framework::OpRegistry::CreateOp(type, {}, {}, {}, false);
-  const auto& op_info = op->Info();
-  auto* attr_checker = op_info.Checker();
-  if (attr_checker) {
-    attr_checker->Check(&attrs, true, /*only_check_exist_value=*/true);
-  }
-
-  static paddle::framework::AttributeMap empty_attrs_map = {};
-  const paddle::framework::AttributeMap& default_attrs =
-      attr_checker == nullptr ? empty_attrs_map
-                              : attr_checker->GetDefaultAttrMap();
-
   NameVarBaseMap new_ins = ins;
   if (amp_level_ == 1) {
     VLOG(5) << "Auto mixed precision run operator: " << type;
@@ -184,6 +189,41 @@ void Tracer::TraceOp(const std::string& type, const NameVarBaseMap& ins,
     new_ins = CastPureFp16Inputs(type, ins);
   }
 
+  // MKLDNN kernels read the attributes stored in the operator instance, so
+  // the instance can not be shared.
+  std::shared_ptr<PreparedOpCache::Entry> cache_entry = nullptr;
+  bool use_op_cache = FLAGS_tracer_op_cache_capacity > 0 &&
+                      !FLAGS_tracer_op_cache_ops.empty() && !FLAGS_use_mkldnn;
+  if (use_op_cache) {
+    op_cache_.SetCapacity(FLAGS_tracer_op_cache_capacity);
+    op_cache_.SetOpTypes(FLAGS_tracer_op_cache_ops);
+    use_op_cache = op_cache_.IsCachedOpType(type);
+  }
+  if (use_op_cache) {
+    PreparedOpCache::Key key;
+    cache_entry = op_cache_.Get(type, new_ins, attrs, place, &key);
+    if (cache_entry == nullptr) {
+      auto raw_attrs = attrs;
+      std::unique_ptr<framework::OperatorBase> op;
+      const auto* default_attrs = CreateCheckedOp(type, &attrs, &op);
+      cache_entry =
+          op_cache_.Insert(std::move(key), type, raw_attrs, place,
+                           std::move(op), std::move(attrs), default_attrs);
+    }
+  }
+
+  std::unique_ptr<framework::OperatorBase> uncached_op = nullptr;
+  const framework::AttributeMap* default_attrs_ptr = nullptr;
+  if (cache_entry == nullptr) {
+    default_attrs_ptr = CreateCheckedOp(type, &attrs, &uncached_op);
+  }
+  const framework::OperatorBase& op =
+      cache_entry ? *cache_entry->op : *uncached_op;
+  const framework::AttributeMap& checked_attrs =
+      cache_entry ? cache_entry->checked_attrs : attrs;
+  const framework::AttributeMap& default_attrs =
+      cache_entry ? *cache_entry->default_attrs : *default_attrs_ptr;
+
   try {
     if (platform::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -210,7 +250,12 @@ void Tracer::TraceOp(const std::string& type, const NameVarBaseMap& ins,
 #endif
     }
 
-    OpBase::Run(*op, new_ins, outs, attrs, default_attrs, place);
+    if (cache_entry) {
+      OpBase::Run(op, new_ins, outs, checked_attrs, default_attrs, place,
+                  &cache_entry->prepared_op);
+    } else {
+      OpBase::Run(op, new_ins, outs, checked_attrs, default_attrs, place);
+    }
   } catch (platform::EnforceNotMet& exception) {
     framework::AppendErrorOpHint(type, &exception);
     throw std::move(exception);
@@ -229,11 +274,11 @@ void Tracer::TraceOp(const std::string& type, const NameVarBaseMap& ins,
 
   if (enable_program_desc_tracing_) {
     VLOG(5) << "Trace op " << type << " into ProgramDesc";
-    program_desc_tracer_->InsertOp(type, new_ins, outs, attrs);
+    program_desc_tracer_->InsertOp(type, new_ins, outs, checked_attrs);
   }
 
   if (ComputeRequiredGrad(new_ins, outs, trace_backward)) {
-    CreateGradOpNode(*op, new_ins, outs, attrs, default_attrs, place,
+    CreateGradOpNode(op, new_ins, outs, checked_attrs, default_attrs, place,
                      inplace_map);
   } else {
     VLOG(3) << "No Grad to track for Op: " << type;
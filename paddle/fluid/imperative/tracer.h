@@ -26,6 +26,7 @@
 #include "paddle/fluid/imperative/basic_engine.h"
 #include "paddle/fluid/imperative/jit/program_desc_tracer.h"
 #include "paddle/fluid/imperative/layer.h"
+#include "paddle/fluid/imperative/prepared_op_cache.h"
 #include "paddle/fluid/platform/macros.h"
 
 namespace paddle {
@@ -109,6 +110,8 @@ class Tracer {
 
   int AMPLevel() const { return amp_level_; }
 
+  PreparedOpCache* GetPreparedOpCache() { return &op_cache_; }
+
   paddle::framework::GarbageCollector* MutableGarbageCollectorIfNotExists(
       const platform::Place& place);
 
@@ -121,6 +124,9 @@ class Tracer {
   GarbageCollectorMap gcs_;
   static thread_local bool has_grad_;
   int amp_level_{0};
+  // The capacity and the op types are synced with
+  // FLAGS_tracer_op_cache_capacity and FLAGS_tracer_op_cache_ops in TraceOp.
+  PreparedOpCache op_cache_{0};
 };
 
 // To access static variable current_tracer
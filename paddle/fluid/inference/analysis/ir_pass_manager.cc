@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "paddle/fluid/inference/analysis/ir_pass_manager.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <map>
 #include <memory>
 #include <string>
@@ -250,11 +252,37 @@ std::unique_ptr<Graph> IRPassManager::Apply(std::unique_ptr<Graph> graph) {
   PADDLE_ENFORCE_NOT_NULL(graph.get(), platform::errors::PreconditionNotMet(
                                            "Graph cannot be NULL."));
   // Apply all the passes
+  pass_time_ms_.clear();
+  double total_time_ms = 0.;
   for (const auto &pass : passes_) {
     if (pass->Type() != "graph_viz_pass" && !disable_logs_) {
       PrettyLogEndl(Style::H2(), "--- Running IR pass [%s]", pass->Type());
     }
+    auto start = std::chrono::steady_clock::now();
     graph.reset(pass->Apply(graph.release()));
+    double time_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    VLOG(3) << "IR pass [" << pass->Type() << "] takes " << time_ms << " ms";
+    pass_time_ms_.emplace_back(pass->Type(), time_ms);
+    total_time_ms += time_ms;
+  }
+
+  if (!disable_logs_) {
+    auto sorted_time = pass_time_ms_;
+    std::stable_sort(sorted_time.begin(), sorted_time.end(),
+                     [](const std::pair<std::string, double> &a,
+                        const std::pair<std::string, double> &b) {
+                       return a.second > b.second;
+                     });
+    std::string slowest;
+    for (size_t i = 0; i < sorted_time.size() && i < 3; ++i) {
+      slowest += string::Sprintf("%s[%s] %.2f ms", i == 0 ? "" : ", ",
+                                 sorted_time[i].first, sorted_time[i].second);
+    }
+    PrettyLogEndl(Style::detail(),
+                  "--- IR passes take %.2f ms in total, the slowest: %s",
+                  total_time_ms, slowest);
   }
   return graph;
 }
@@ -52,11 +52,17 @@ class IRPassManager final {
 
   framework::ir::Graph &graph() const { return *graph_; }
 
+  // The time in ms taken by each pass in the last Apply, in running order.
+  const std::vector<std::pair<std::string, double>> &pass_time_ms() const {
+    return pass_time_ms_;
+  }
+
  private:
   void CreatePasses(Argument *argument, const std::vector<std::string> &passes);
 
   std::unique_ptr<Graph> graph_;
   std::vector<std::unique_ptr<Pass>> passes_;
+  std::vector<std::pair<std::string, double>> pass_time_ms_;
   bool disable_logs_{false};
 };
 
@@ -41,7 +41,11 @@ void IrGraphBuildPass::RunImpl(Argument *argument) {
   platform::Place place;
   place = platform::CPUPlace();
 
-  if (argument->model_dir_valid()) {
+  if (argument->main_program_valid()) {
+    // The program and its parameters are prepared by the predictor, e.g.
+    // decrypted while loading.
+    VLOG(3) << "use the main program loaded by the predictor";
+  } else if (argument->model_dir_valid()) {
     auto program =
         LoadModel(argument->model_dir(), argument->scope_ptr(), place);
     argument->SetMainProgram(program.release());
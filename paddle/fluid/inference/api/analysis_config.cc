@@ -142,7 +142,14 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(model_from_memory_);  // the memory model reuses prog_file_ and
                                   // params_file_ fields.
 
+  CP_MEMBER(model_decryption_enabled_);
+  CP_MEMBER(cipher_config_file_);
+  CP_MEMBER(cipher_key_);
+
   CP_MEMBER(opt_cache_dir_);
+  CP_MEMBER(use_optimized_program_cache_);
+  CP_MEMBER(use_memory_arena_);
+  CP_MEMBER(latency_sampling_rate_);
   CP_MEMBER(prog_file_);
   CP_MEMBER(params_file_);
 
@@ -599,6 +606,9 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << trt_dla_core_;
 
   ss << enable_memory_optim_;
+  ss << use_optimized_program_cache_;
+  ss << use_memory_arena_;
+  ss << latency_sampling_rate_;
 
   ss << use_mkldnn_;
   ss << mkldnn_cache_capacity_;
@@ -610,6 +620,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   for (auto &item : bfloat16_enabled_op_types_) ss << item;
   ss << ";";
   ss << model_from_memory_;
+  ss << model_decryption_enabled_;
 
   ss << with_profile_;
 
@@ -675,6 +686,26 @@ bool AnalysisConfig::enable_memory_optim() const {
   return enable_memory_optim_;
 }
 
+void AnalysisConfig::EnableOptimizedProgramCache(bool x) {
+  use_optimized_program_cache_ = x;
+  Update();
+}
+
+void AnalysisConfig::EnableMemoryArena(bool x) {
+  use_memory_arena_ = x;
+  Update();
+}
+
+void AnalysisConfig::EnableLatencySampling(double sampling_rate) {
+  PADDLE_ENFORCE_EQ(
+      sampling_rate >= 0. && sampling_rate <= 1., true,
+      platform::errors::InvalidArgument(
+          "The latency sampling rate should be in [0, 1], but got %f.",
+          sampling_rate));
+  latency_sampling_rate_ = sampling_rate;
+  Update();
+}
+
 void AnalysisConfig::SetModelBuffer(const char *prog_buffer,
                                     size_t prog_buffer_size,
                                     const char *param_buffer,
@@ -686,6 +717,15 @@ void AnalysisConfig::SetModelBuffer(const char *prog_buffer,
   Update();
 }
 
+void AnalysisConfig::SetModelDecryption(const std::string &cipher_config_file,
+                                        const std::string &key) {
+  cipher_config_file_ = cipher_config_file;
+  cipher_key_ = key;
+  model_decryption_enabled_ = true;
+
+  Update();
+}
+
 NativeConfig AnalysisConfig::ToNativeConfig() const {
   NativeConfig config;
   config.model_dir = model_dir_;
@@ -748,6 +788,9 @@ std::string AnalysisConfig::Summary() {
   if (model_from_memory_) {
     os.InsertRow({"model_from_memory", params_file_});
   }
+  if (model_decryption_enabled_) {
+    os.InsertRow({"model_cipher_config", cipher_config_file_});
+  }
   os.InsetDivider();
 
   // cpu info
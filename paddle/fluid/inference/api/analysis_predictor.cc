@@ -17,9 +17,14 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <random>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,8 +34,10 @@
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/ir/fuse_pass_base.h"
 #include "paddle/fluid/framework/ir/pass.h"
+#include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/scope_guard.h"
 #include "paddle/fluid/framework/var_type_traits.h"
 #include "paddle/fluid/framework/version.h"
 #include "paddle/fluid/inference/analysis/helper.h"
@@ -43,9 +50,16 @@
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/gpu_info.h"
+#include "paddle/fluid/platform/latency_histogram.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/profiler.h"
 
+#ifdef PADDLE_WITH_CRYPTO
+#include "paddle/fluid/framework/io/crypto/cipher.h"
+#include "paddle/fluid/framework/io/crypto/cipher_stream.h"
+#endif
+
 #ifdef PADDLE_WITH_MKLML
 #include "paddle/fluid/platform/dynload/mklml.h"
 #endif
@@ -78,6 +92,39 @@ bool IsPersistable(const framework::VarDesc *var) {
   }
   return false;
 }
+
+// Bump it when the format of the optimized program cache changes.
+constexpr int kOptimizedProgramCacheVersion = 2;
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+
+// FNV-1a, which is stable across processes and platforms, unlike std::hash.
+uint64_t HashBytes(const char *data, size_t size, uint64_t hash) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool HashFile(const std::string &path, uint64_t *hash, int64_t *size) {
+  std::ifstream fin(path, std::ios::in | std::ios::binary);
+  if (!fin.is_open()) return false;
+  std::vector<char> buffer(1 << 20);
+  *size = 0;
+  while (fin) {
+    fin.read(buffer.data(), buffer.size());
+    *hash = HashBytes(buffer.data(), fin.gcount(), *hash);
+    *size += fin.gcount();
+  }
+  return fin.eof();
+}
+
+// Returns -1 if the file does not exist.
+int64_t FileSize(const std::string &path) {
+  std::ifstream fin(path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!fin.is_open()) return -1;
+  return static_cast<int64_t>(fin.tellg());
+}
 }  // namespace
 
 bool PaddleTensorToLoDTensor(const PaddleTensor &pt, framework::LoDTensor *t,
@@ -181,6 +228,35 @@ bool AnalysisPredictor::Init(
   // Get the feed_target_names and fetch_target_names
   PrepareFeedFetch();
 
+  if (MemoryArenaUsable()) {
+    executor_->EnableMemoryArena(GetInputNames(), GetOutputNames());
+  }
+  if (config_.latency_sampling_rate() > 0.) {
+    executor_->EnableLatencySampling(config_.latency_sampling_rate());
+  }
+
+  return true;
+}
+
+bool AnalysisPredictor::MemoryArenaUsable() const {
+  // The inputs are set by the feed ops in the middle of a run with them, so
+  // the shape signature of the arena is only known without them.
+  if (!config_.memory_arena_enabled() || config_.use_feed_fetch_ops_enabled()) {
+    return false;
+  }
+  // The subgraph passes replace the subgraphs by engine ops holding
+  // sub-blocks, which NaiveExecutor::EnableMemoryArena does not support.
+  if (config_.tensorrt_engine_enabled() || config_.lite_engine_enabled() ||
+      config_.dlnne_enabled()) {
+    return false;
+  }
+  if (inference_program_) {
+    for (auto *op : inference_program_->Block(0).AllOps()) {
+      if (op->HasAttr("sub_block")) {
+        return false;
+      }
+    }
+  }
   return true;
 }
 
@@ -206,6 +282,17 @@ bool AnalysisPredictor::PrepareProgram(
     const std::shared_ptr<framework::ProgramDesc> &program) {
   if (!program) {
     if (!LoadProgramDesc()) return false;
+    // The optimized program and parameters of the same model files, passes
+    // and config are loaded from the cache directly, skipping the analysis.
+    std::string cache_prefix = OptimizedProgramCachePrefix();
+    optimized_program_cache_prefix_ = cache_prefix;
+    if (!cache_prefix.empty() && LoadOptimizedProgramCache(cache_prefix)) {
+      optimized_program_cache_hit_ = true;
+      config_.PartiallyRelease();
+      executor_->CreateVariables(*inference_program_, 0, false, sub_scope_);
+      return true;
+    }
+
     // If not cloned, the parameters should be loaded.
     // If config_.ir_optim() is True, parameters is loaded in
     // OptimizeInferenceProgram(), but other persistable variables
@@ -215,10 +302,19 @@ bool AnalysisPredictor::PrepareProgram(
     // So in both case, create persistable variables at first.
     executor_->CreateVariables(*inference_program_, 0, true, sub_scope_);
 
+    // The encrypted parameters are decrypted into scope here, so that the
+    // ir_graph_build_pass does not need to load them again.
+    if (config_.model_decryption_enabled() && !LoadEncryptedParameters()) {
+      return false;
+    }
+
     // if enable_ir_optim_ is false,
     // the analysis pass(op fuse, graph analysis, trt subgraph, mkldnn etc) will
     // not be executed.
     OptimizeInferenceProgram();
+    if (!cache_prefix.empty()) {
+      SaveOptimizedProgramCache(cache_prefix);
+    }
   } else {
     // If the program is passed from external, no need to optimize it, this
     // logic is used in the clone scenario.
@@ -428,6 +524,9 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
   // Run the inference program
   // if share variables, we need not create variables
   executor_->Run();
+  if (executor_->LastRunSampled()) {
+    PublishLatencyStats();
+  }
 
   // get fetch variable
   if (!GetFetch(output_data, scope)) {
@@ -553,7 +652,11 @@ void AnalysisPredictor::PrepareArgument() {
   argument_.SetUseFcPadding(config_.use_fc_padding());
   argument_.SetGPUDeviceId(config_.gpu_device_id());
   argument_.SetEnableAnalysisOptim(config_.enable_ir_optim_);
-  argument_.SetEnableMemoryOptim(config_.enable_memory_optim());
+  // The memory arena plans the reuse by itself, and the variables merged by
+  // the memory optimization would only lengthen the lifetimes it sees. The
+  // memory optimization is kept if the arena will not be used.
+  argument_.SetEnableMemoryOptim(config_.enable_memory_optim() &&
+                                 !MemoryArenaUsable());
   argument_.SetModelFromMemory(config_.model_from_memory_);
   // Analyze inference_program
   argument_.SetPredictorID(predictor_id_);
@@ -673,6 +776,10 @@ void AnalysisPredictor::PrepareArgument() {
 // NOTE All the members in AnalysisConfig should be copied to Argument.
 void AnalysisPredictor::OptimizeInferenceProgram() {
   PrepareArgument();
+  if (config_.model_decryption_enabled()) {
+    // program and parameters are already decrypted and loaded
+    argument_.SetMainProgram(new framework::ProgramDesc(*inference_program_));
+  }
   Analyzer().Run(&argument_);
 
   PADDLE_ENFORCE_EQ(
@@ -714,6 +821,240 @@ void AnalysisPredictor::OptimizeInferenceProgram() {
   LOG(INFO) << "======= optimize end =======";
 }
 
+std::string AnalysisPredictor::OptimizedProgramCachePrefix() {
+  if (!config_.optimized_program_cache_enabled()) return "";
+  if (!config_.ir_optim() || config_.model_decryption_enabled() ||
+      config_.tensorrt_engine_enabled() || config_.lite_engine_enabled() ||
+      config_.dlnne_enabled() || config_.mkldnn_quantizer_enabled()) {
+    LOG(WARNING) << "The optimized program cache only works with the ir "
+                    "optimization of the native kernels, it is disabled for "
+                    "the decrypted models and the TensorRT, Lite, DLNNE or "
+                    "MKLDNN quantizer engines.";
+    return "";
+  }
+
+  std::string cache_dir = config_.opt_cache_dir_;
+  if (cache_dir.empty()) {
+    if (config_.model_from_memory()) {
+      LOG(WARNING) << "The optimized program cache is disabled, please set "
+                      "the cache directory by SetOptimCacheDir() when the "
+                      "model is loaded from memory.";
+      return "";
+    }
+    cache_dir = (config_.model_dir().empty()
+                     ? inference::analysis::GetDirRoot(config_.prog_file())
+                     : config_.model_dir()) +
+                "/_opt_cache";
+  }
+  if (!inference::analysis::PathExists(cache_dir) &&
+      MKDIR(cache_dir.c_str()) == -1) {
+    LOG(WARNING) << "The optimized program cache is disabled, can not create "
+                    "the cache directory: "
+                 << cache_dir;
+    return "";
+  }
+
+  // The key covers everything the analysis depends on: the version of the
+  // framework and the cache format, the config, the passes and the content
+  // of the model files. The model loaded from memory is already part of the
+  // serialized config.
+  uint64_t hash = kFnvOffsetBasis;
+  auto hash_string = [&hash](const std::string &str) {
+    hash = HashBytes(str.data(), str.size() + 1, hash);
+  };
+  hash_string(std::to_string(kOptimizedProgramCacheVersion));
+  hash_string(paddle::get_version());
+  hash_string(config_.SerializeInfoCache());
+  for (const auto &pass : config_.pass_builder()->AllPasses()) {
+    hash_string(pass);
+  }
+  hash_string(";");
+  for (const auto &pass : config_.pass_builder()->AnalysisPasses()) {
+    hash_string(pass);
+  }
+  hash_string(";");
+
+  if (!config_.model_from_memory()) {
+    std::vector<std::string> model_files;
+    if (!config_.model_dir().empty()) {
+      model_files.push_back(config_.model_dir() + "/__model__");
+      std::vector<std::string> params;
+      for (auto *var : inference_program_->Block(0).AllVars()) {
+        if (IsPersistable(var)) {
+          params.push_back(var->Name());
+        }
+      }
+      std::sort(params.begin(), params.end());
+      for (const auto &param : params) {
+        model_files.push_back(config_.model_dir() + "/" + param);
+      }
+    } else {
+      model_files.push_back(config_.prog_file());
+      model_files.push_back(config_.params_file());
+    }
+    for (const auto &file : model_files) {
+      int64_t size = 0;
+      if (!HashFile(file, &hash, &size)) {
+        LOG(WARNING) << "The optimized program cache is disabled, can not "
+                        "read the model file: "
+                     << file;
+        return "";
+      }
+    }
+  }
+
+  std::stringstream ss;
+  ss << cache_dir << "/optim_program_" << std::hex << std::setw(16)
+     << std::setfill('0') << hash;
+  return ss.str();
+}
+
+bool AnalysisPredictor::LoadOptimizedProgramCache(const std::string &prefix) {
+  const std::string model_file = prefix + ".pdmodel";
+  const std::string params_file = prefix + ".pdiparams";
+  std::ifstream meta(prefix + ".meta");
+  if (!meta.is_open()) {
+    VLOG(3) << "The optimized program cache " << prefix << " is missed.";
+    return false;
+  }
+  int version = -1;
+  int64_t model_size = -1;
+  uint64_t model_hash = 0;
+  int64_t params_size = -1;
+  uint64_t params_hash = 0;
+  meta >> version >> model_size >> model_hash >> params_size >> params_hash;
+
+  uint64_t hash = kFnvOffsetBasis;
+  int64_t size = -1;
+  if (meta.fail() || version != kOptimizedProgramCacheVersion ||
+      !HashFile(model_file, &hash, &size) || size != model_size ||
+      hash != model_hash) {
+    LOG(WARNING) << "The optimized program cache " << prefix
+                 << " is invalid, it will be rebuilt.";
+    return false;
+  }
+
+  std::ifstream fin(model_file, std::ios::in | std::ios::binary);
+  std::string pb_content((std::istreambuf_iterator<char>(fin)),
+                         std::istreambuf_iterator<char>());
+  framework::proto::ProgramDesc proto;
+  if (!proto.ParseFromString(pb_content)) {
+    LOG(WARNING) << "Failed to parse the optimized program cache " << prefix
+                 << ", it will be rebuilt.";
+    return false;
+  }
+  auto program = std::make_shared<framework::ProgramDesc>(proto);
+  executor_->CreateVariables(*program, 0, true, sub_scope_);
+
+  std::vector<std::string> params;
+  for (auto *var : program->Block(0).AllVars()) {
+    if (IsPersistable(var)) {
+      params.push_back(var->Name());
+    }
+  }
+  if (!params.empty()) {
+    // The params file is read once more to be hashed, the load_combine op
+    // does not detect the corrupted values of the right size.
+    hash = kFnvOffsetBasis;
+    if (!HashFile(params_file, &hash, &size) || size != params_size ||
+        hash != params_hash) {
+      LOG(WARNING) << "The optimized program cache " << prefix
+                   << " is invalid, it will be rebuilt.";
+      return false;
+    }
+    std::sort(params.begin(), params.end());
+    framework::ProgramDesc load_program;
+    auto *load_block = load_program.MutableBlock(0);
+    for (auto *var : program->Block(0).AllVars()) {
+      if (IsPersistable(var)) {
+        framework::VarDesc *new_var = load_block->Var(var->Name());
+        new_var->SetShape(var->GetShape());
+        new_var->SetDataType(var->GetDataType());
+        new_var->SetType(var->GetType());
+        new_var->SetLoDLevel(var->GetLoDLevel());
+        new_var->SetPersistable(true);
+      }
+    }
+    auto *op = load_block->AppendOp();
+    op->SetType("load_combine");
+    op->SetOutput("Out", params);
+    op->SetAttr("file_path", params_file);
+    op->CheckAttrs();
+
+    try {
+      framework::NaiveExecutor e(place_);
+      e.Prepare(scope_.get(), load_program, 0, false);
+      e.Run();
+    } catch (const std::exception &e) {
+      LOG(WARNING) << "Failed to load the parameters of the optimized program "
+                      "cache "
+                   << prefix << ", it will be rebuilt: " << e.what();
+      return false;
+    }
+  }
+
+  inference_program_ = program;
+  LOG(INFO) << "Load the optimized program from cache " << prefix;
+  return true;
+}
+
+void AnalysisPredictor::SaveOptimizedProgramCache(const std::string &prefix) {
+  // The files are written to the temporary names and renamed, the meta file
+  // goes last, so that a predictor created concurrently never sees a partial
+  // entry.
+  std::random_device rd;
+  const std::string tmp_suffix = ".tmp" + std::to_string(rd());
+  const std::string model_file = prefix + ".pdmodel";
+  const std::string params_file = prefix + ".pdiparams";
+  const std::string meta_file = prefix + ".meta";
+  auto remove_tmp_files = [&] {
+    std::remove((model_file + tmp_suffix).c_str());
+    std::remove((params_file + tmp_suffix).c_str());
+    std::remove((meta_file + tmp_suffix).c_str());
+  };
+
+  try {
+    SaveProgramAndParams(model_file + tmp_suffix, params_file + tmp_suffix,
+                         false);
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "Failed to save the optimized program cache " << prefix
+                 << ": " << e.what();
+    remove_tmp_files();
+    return;
+  }
+
+  uint64_t model_hash = kFnvOffsetBasis;
+  int64_t model_size = -1;
+  uint64_t params_hash = kFnvOffsetBasis;
+  int64_t params_size = -1;
+  bool success = HashFile(model_file + tmp_suffix, &model_hash, &model_size);
+  // No params file is written without any persistable variable.
+  if (success && FileSize(params_file + tmp_suffix) >= 0) {
+    success = HashFile(params_file + tmp_suffix, &params_hash, &params_size);
+  }
+  if (success) {
+    std::ofstream meta(meta_file + tmp_suffix);
+    meta << kOptimizedProgramCacheVersion << " " << model_size << " "
+         << model_hash << " " << params_size << " " << params_hash << "\n";
+    meta.close();
+    success = !meta.fail();
+  }
+  success = success &&
+            std::rename((model_file + tmp_suffix).c_str(),
+                        model_file.c_str()) == 0 &&
+            (params_size < 0 ||
+             std::rename((params_file + tmp_suffix).c_str(),
+                         params_file.c_str()) == 0) &&
+            std::rename((meta_file + tmp_suffix).c_str(), meta_file.c_str()) ==
+                0;
+  if (!success) {
+    LOG(WARNING) << "Failed to save the optimized program cache " << prefix;
+    remove_tmp_files();
+    return;
+  }
+  LOG(INFO) << "Save the optimized program to cache " << prefix;
+}
+
 template <>
 std::unique_ptr<PaddlePredictor> CreatePaddlePredictor<
     AnalysisConfig, PaddleEngineKind::kAnalysis>(const AnalysisConfig &config) {
@@ -985,6 +1326,9 @@ bool AnalysisPredictor::ZeroCopyRun() {
 #endif
 
   executor_->Run();
+  if (executor_->LastRunSampled()) {
+    PublishLatencyStats();
+  }
 
   if (config_.shape_range_info_collected()) {
     CollectShapeRangeInfo();
@@ -1105,7 +1449,31 @@ bool AnalysisPredictor::LoadProgramDesc() {
 
   // Create ProgramDesc
   framework::proto::ProgramDesc proto;
-  if (!config_.model_from_memory()) {
+  if (config_.model_decryption_enabled()) {
+#ifdef PADDLE_WITH_CRYPTO
+    PADDLE_ENFORCE_EQ(
+        config_.model_dir().empty() && !config_.model_from_memory(), true,
+        platform::errors::InvalidArgument(
+            "Model decryption only supports the combined model files set by "
+            "SetModel(prog_file, params_file)."));
+    auto cipher =
+        framework::CipherFactory::CreateCipher(config_.cipher_config_file_);
+    std::string pb_content;
+    if (framework::IsCipherStreamFile(filename)) {
+      framework::DecryptInputStream fin(cipher.get(), config_.cipher_key_,
+                                        filename);
+      pb_content.assign(std::istreambuf_iterator<char>(fin),
+                        std::istreambuf_iterator<char>());
+    } else {
+      pb_content = cipher->DecryptFromFile(config_.cipher_key_, filename);
+    }
+    proto.ParseFromString(pb_content);
+#else
+    PADDLE_THROW(platform::errors::Unavailable(
+        "Model decryption is not supported, please compile with WITH_CRYPTO "
+        "to load encrypted models."));
+#endif
+  } else if (!config_.model_from_memory()) {
     std::string pb_content;
     // Read binary
     std::ifstream fin(filename, std::ios::in | std::ios::binary);
@@ -1186,11 +1554,144 @@ bool AnalysisPredictor::LoadParameters() {
   return true;
 }
 
+bool AnalysisPredictor::LoadEncryptedParameters() {
+#ifdef PADDLE_WITH_CRYPTO
+  PADDLE_ENFORCE_NOT_NULL(inference_program_.get(),
+                          platform::errors::PreconditionNotMet(
+                              "The inference program should be loaded first."));
+  // keep the same order as load_combine in LoadParameters
+  std::vector<std::string> params;
+  for (auto *var : inference_program_->Block(0).AllVars()) {
+    if (IsPersistable(var)) {
+      params.push_back(var->Name());
+    }
+  }
+  std::sort(params.begin(), params.end());
+
+  auto cipher =
+      framework::CipherFactory::CreateCipher(config_.cipher_config_file_);
+  const std::string &filename = config_.params_file();
+  std::unique_ptr<std::istream> fin;
+  if (framework::IsCipherStreamFile(filename)) {
+    fin.reset(new framework::DecryptInputStream(cipher.get(),
+                                                config_.cipher_key_, filename));
+  } else {
+    // encrypted as a whole by Cipher::EncryptToFile
+    fin.reset(new std::istringstream(
+        cipher->DecryptFromFile(config_.cipher_key_, filename),
+        std::ios::in | std::ios::binary));
+  }
+
+  // parameters are loaded on CPU like ir_graph_build_pass does, and copied
+  // to the device by ir_params_sync_among_devices_pass
+  platform::CPUPlace cpu_place;
+  auto &dev_ctx = *platform::DeviceContextPool::Instance().Get(cpu_place);
+  for (auto &name : params) {
+    VLOG(4) << "loading encrypted tensor: " << name;
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(*fin), true,
+        platform::errors::Unavailable(
+            "An error occurred while loading model parameters. "
+            "Please check whether the model file is complete or damaged."));
+    auto *tensor = scope_->Var(name)->GetMutable<framework::LoDTensor>();
+    framework::DeserializeFromStream(*fin, tensor, dev_ctx);
+  }
+  fin->peek();
+  PADDLE_ENFORCE_EQ(fin->eof(), true,
+                    platform::errors::Unavailable(
+                        "The encrypted parameters file %s has more data than "
+                        "the parameters of the program.",
+                        filename));
+  VLOG(3) << "decrypted " << params.size() << " parameters from " << filename;
+  return true;
+#else
+  PADDLE_THROW(platform::errors::Unavailable(
+      "Model decryption is not supported, please compile with WITH_CRYPTO "
+      "to load encrypted models."));
+  return false;
+#endif
+}
+
 uint64_t AnalysisPredictor::TryShrinkMemory() {
   ClearIntermediateTensor();
   return paddle::memory::Release(place_);
 }
 
+static LatencyStat ToLatencyStat(const std::string &name,
+                                 const platform::LatencyHistogram &latency) {
+  LatencyStat stat;
+  stat.name = name;
+  stat.count = latency.Count();
+  stat.mean_us = latency.Mean();
+  stat.p50_us = latency.Percentile(0.5);
+  stat.p99_us = latency.Percentile(0.99);
+  return stat;
+}
+
+std::vector<LatencyStat> AnalysisPredictor::GetLatencyStats(bool reset) {
+  std::vector<LatencyStat> stats;
+  if (executor_->RunLatency() == nullptr) {
+    return stats;
+  }
+  stats.emplace_back(ToLatencyStat("run", *executor_->RunLatency()));
+  auto op_latencies = executor_->OpLatencies();
+  for (size_t i = 0; i < op_latencies.size(); ++i) {
+    stats.emplace_back(ToLatencyStat(
+        "op" + std::to_string(i) + "_" + op_latencies[i].first,
+        *op_latencies[i].second));
+  }
+  if (reset) {
+    executor_->ResetLatencies();
+  }
+  return stats;
+}
+
+// The StatRegistry only keeps the pointers of the stats, which are created on
+// the first publishing of each name and freed with their predictor.
+static std::mutex *LatencyStatMutex() {
+  static auto *mutex = new std::mutex();
+  return mutex;
+}
+
+static std::map<std::string, std::unique_ptr<platform::StatValue<float>>>
+    *LatencyStatValues() {
+  static auto *stats =
+      new std::map<std::string,
+                   std::unique_ptr<platform::StatValue<float>>>();
+  return stats;
+}
+
+static void SetLatencyStatValue(const std::string &name, float value) {
+  std::lock_guard<std::mutex> guard(*LatencyStatMutex());
+  auto &stat = (*LatencyStatValues())[name];
+  if (stat == nullptr) {
+    stat.reset(new platform::StatValue<float>(name));
+  }
+  stat->reset(value);
+}
+
+static void RemoveLatencyStatValues(const std::string &prefix) {
+  std::lock_guard<std::mutex> guard(*LatencyStatMutex());
+  auto *stats = LatencyStatValues();
+  for (auto it = stats->lower_bound(prefix);
+       it != stats->end() && it->first.compare(0, prefix.size(), prefix) == 0;
+       it = stats->erase(it)) {
+    platform::StatRegistry<float>::Instance().remove(it->first);
+  }
+}
+
+std::string AnalysisPredictor::LatencyStatPrefix() const {
+  return "STAT_infer_latency_" + std::to_string(predictor_id_) + "_";
+}
+
+void AnalysisPredictor::PublishLatencyStats() {
+  for (auto &stat : GetLatencyStats()) {
+    std::string prefix = LatencyStatPrefix() + stat.name;
+    SetLatencyStatValue(prefix + "_p50_us", static_cast<float>(stat.p50_us));
+    SetLatencyStatValue(prefix + "_p99_us", static_cast<float>(stat.p99_us));
+  }
+}
+
 void AnalysisPredictor::ClearIntermediateTensor() {
   PADDLE_ENFORCE_NOT_NULL(inference_program_.get(),
                           platform::errors::PreconditionNotMet(
@@ -1290,6 +1791,9 @@ AnalysisPredictor::~AnalysisPredictor() {
   if (config_.shape_range_info_collected()) {
     StatisticShapeRangeInfo();
   }
+  if (config_.latency_sampling_rate() > 0.) {
+    RemoveLatencyStatValues(LatencyStatPrefix());
+  }
 
   memory::Release(place_);
 }
@@ -1307,12 +1811,18 @@ std::string AnalysisPredictor::GetSerializedProgram() const {
 
 // Add SaveOptimModel
 void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
+  SaveProgramAndParams(dir + "/model", dir + "/params", true);
+}
+
+void AnalysisPredictor::SaveProgramAndParams(const std::string &model_file,
+                                             const std::string &params_file,
+                                             bool save_empty_params) {
   // save model
-  std::string model_name = dir + "/model";
   std::ofstream outfile;
-  outfile.open(model_name, std::ios::out | std::ios::binary);
+  outfile.open(model_file, std::ios::out | std::ios::binary);
   std::string inference_prog_desc = GetSerializedProgram();
   outfile << inference_prog_desc;
+  outfile.close();
   // save params
   framework::ProgramDesc save_program;
   auto *save_block = save_program.MutableBlock(0);
@@ -1332,11 +1842,12 @@ void AnalysisPredictor::SaveOptimModel(const std::string &dir) {
       save_var_list.push_back(new_var->Name());
     }
   }
+  if (save_var_list.empty() && !save_empty_params) return;
   std::sort(save_var_list.begin(), save_var_list.end());
   auto *op = save_block->AppendOp();
   op->SetType("save_combine");
   op->SetInput("X", save_var_list);
-  op->SetAttr("file_path", dir + "/params");
+  op->SetAttr("file_path", params_file);
   op->CheckAttrs();
 
   platform::CPUPlace place;
@@ -1451,6 +1962,10 @@ void Predictor::ClearIntermediateTensor() {
 
 uint64_t Predictor::TryShrinkMemory() { return predictor_->TryShrinkMemory(); }
 
+std::vector<paddle::LatencyStat> Predictor::GetLatencyStats(bool reset) {
+  return predictor_->GetLatencyStats(reset);
+}
+
 int GetNumBytesOfDataType(DataType dtype) {
   switch (dtype) {
     case DataType::FLOAT32:
@@ -1461,6 +1976,8 @@ int GetNumBytesOfDataType(DataType dtype) {
       return sizeof(int32_t);
     case DataType::UINT8:
       return sizeof(uint8_t);
+    case DataType::INT8:
+      return sizeof(int8_t);
     default:
       assert(false);
       return -1;
@@ -1512,5 +2029,220 @@ Predictor *PredictorPool::Retrive(size_t idx) {
   }
   return preds_[idx - 1].get();
 }
+
+namespace {
+
+template <typename T>
+void BindAsyncInput(Tensor *handle, paddle::PaddleTensor *input) {
+  size_t size = paddle::inference::VecReduceToInt(input->shape) * sizeof(T);
+  PADDLE_ENFORCE_GE(input->data.length(), size,
+                    paddle::platform::errors::InvalidArgument(
+                        "The data of input %s has %d bytes, but its shape "
+                        "needs %d bytes.",
+                        handle->name(), input->data.length(), size));
+  auto *data = static_cast<T *>(input->data.data());
+  if (handle->place() == PlaceType::kCPU) {
+    handle->ShareExternalData<T>(data, input->shape);
+  } else {
+    handle->Reshape(input->shape);
+    handle->CopyFromCpu<T>(data);
+  }
+}
+
+template <typename T>
+void FetchAsyncOutput(Tensor *handle, paddle::PaddleTensor *output) {
+  output->data.Resize(
+      std::max(paddle::inference::VecReduceToInt(output->shape), 1) *
+      sizeof(T));
+  handle->CopyToCpu<T>(static_cast<T *>(output->data.data()));
+}
+
+}  // namespace
+
+AsyncPredictor::AsyncPredictor(const Config &config, size_t num_workers) {
+  pool_.reset(new PredictorPool(config, num_workers));
+  input_names_ = pool_->Retrive(0)->GetInputNames();
+  output_names_ = pool_->Retrive(0)->GetOutputNames();
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&AsyncPredictor::WorkerLoop, this,
+                          pool_->Retrive(i));
+  }
+}
+
+AsyncPredictor::~AsyncPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void AsyncPredictor::RunAsync(std::vector<paddle::PaddleTensor> inputs,
+                              std::vector<paddle::PaddleTensor> *outputs,
+                              Callback callback) {
+  PADDLE_ENFORCE_NOT_NULL(outputs,
+                          paddle::platform::errors::InvalidArgument(
+                              "The outputs of the request should not be "
+                              "nullptr."));
+  Push(Task{std::move(inputs), outputs, std::move(callback), nullptr});
+}
+
+std::future<bool> AsyncPredictor::RunAsync(
+    std::vector<paddle::PaddleTensor> inputs,
+    std::vector<paddle::PaddleTensor> *outputs) {
+  PADDLE_ENFORCE_NOT_NULL(outputs,
+                          paddle::platform::errors::InvalidArgument(
+                              "The outputs of the request should not be "
+                              "nullptr."));
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  Push(Task{std::move(inputs), outputs, nullptr, std::move(promise)});
+  return future;
+}
+
+void AsyncPredictor::Push(Task &&task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void AsyncPredictor::WorkerLoop(Predictor *predictor) {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    bool success = false;
+    std::exception_ptr error;
+    try {
+      success = RunTask(predictor, &task);
+    } catch (const std::exception &e) {
+      error = std::current_exception();
+      if (!task.promise) {
+        LOG(ERROR) << "The async run of the predictor failed: " << e.what();
+      }
+    } catch (...) {
+      error = std::current_exception();
+      if (!task.promise) {
+        LOG(ERROR) << "The async run of the predictor failed.";
+      }
+    }
+    if (task.promise) {
+      if (error) {
+        task.promise->set_exception(error);
+      } else {
+        task.promise->set_value(success);
+      }
+    } else if (task.callback) {
+      // An exception out of the callback would terminate the worker thread
+      // and with it the process.
+      try {
+        task.callback(success);
+      } catch (const std::exception &e) {
+        LOG(ERROR) << "The callback of an async run threw: " << e.what();
+      } catch (...) {
+        LOG(ERROR) << "The callback of an async run threw.";
+      }
+    }
+  }
+}
+
+bool AsyncPredictor::RunTask(Predictor *predictor, Task *task) {
+  PADDLE_ENFORCE_EQ(task->inputs.size(), input_names_.size(),
+                    paddle::platform::errors::InvalidArgument(
+                        "The request has %d inputs, but the model needs %d.",
+                        task->inputs.size(), input_names_.size()));
+  std::vector<std::unique_ptr<Tensor>> input_handles;
+  // Drop the bindings of the input buffers, which are freed with the request,
+  // also when the binding or the run throws. The guard runs in a destructor,
+  // so the errors are only logged.
+  DEFINE_PADDLE_SCOPE_GUARD([&] {
+    for (size_t i = 0; i < input_handles.size(); ++i) {
+      try {
+        input_handles[i]->Reshape(task->inputs[i].shape);
+      } catch (const std::exception &e) {
+        LOG(ERROR) << "Failed to release the data of input "
+                   << input_handles[i]->name() << ": " << e.what();
+      }
+    }
+  });
+  for (size_t i = 0; i < task->inputs.size(); ++i) {
+    auto &input = task->inputs[i];
+    auto handle = predictor->GetInputHandle(
+        input.name.empty() ? input_names_[i] : input.name);
+    switch (input.dtype) {
+      case DataType::FLOAT32:
+        BindAsyncInput<float>(handle.get(), &input);
+        break;
+      case DataType::INT64:
+        BindAsyncInput<int64_t>(handle.get(), &input);
+        break;
+      case DataType::INT32:
+        BindAsyncInput<int32_t>(handle.get(), &input);
+        break;
+      case DataType::UINT8:
+        BindAsyncInput<uint8_t>(handle.get(), &input);
+        break;
+      case DataType::INT8:
+        BindAsyncInput<int8_t>(handle.get(), &input);
+        break;
+      default:
+        PADDLE_THROW(paddle::platform::errors::Unimplemented(
+            "The data type of input %s is not supported by the async run.",
+            input_names_[i]));
+    }
+    input_handles.emplace_back(std::move(handle));
+    input_handles.back()->SetLoD(input.lod);
+  }
+
+  bool success = predictor->Run();
+  if (!success) {
+    return false;
+  }
+
+  auto *outputs = task->outputs;
+  outputs->resize(output_names_.size());
+  for (size_t i = 0; i < output_names_.size(); ++i) {
+    auto handle = predictor->GetOutputHandle(output_names_[i]);
+    auto &output = outputs->at(i);
+    output.name = output_names_[i];
+    output.shape = handle->shape();
+    output.lod = handle->lod();
+    output.dtype = handle->type();
+    switch (output.dtype) {
+      case DataType::FLOAT32:
+        FetchAsyncOutput<float>(handle.get(), &output);
+        break;
+      case DataType::INT64:
+        FetchAsyncOutput<int64_t>(handle.get(), &output);
+        break;
+      case DataType::INT32:
+        FetchAsyncOutput<int32_t>(handle.get(), &output);
+        break;
+      case DataType::UINT8:
+        FetchAsyncOutput<uint8_t>(handle.get(), &output);
+        break;
+      case DataType::INT8:
+        FetchAsyncOutput<int8_t>(handle.get(), &output);
+        break;
+      default:
+        PADDLE_THROW(paddle::platform::errors::Unimplemented(
+            "The data type of output %s is not supported by the async run.",
+            output_names_[i]));
+    }
+  }
+  return true;
+}
 }  // namespace services
 }  // namespace paddle_infer
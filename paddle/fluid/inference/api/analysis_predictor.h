@@ -194,6 +194,30 @@ class AnalysisPredictor : public PaddlePredictor {
   /// to get the optimized model program
   ///
   void OptimizeInferenceProgram();
+  ///
+  /// \brief Get the path prefix of the optimized program cache entry of the
+  /// loaded model, which is keyed by the hash of the model files, the passes
+  /// and the config.
+  ///
+  /// \return The path prefix, or empty if the cache is disabled or not
+  /// supported by the config.
+  ///
+  std::string OptimizedProgramCachePrefix();
+  ///
+  /// \brief Load the optimized program and its parameters from the cache
+  /// entry, the entry is validated against its meta file.
+  ///
+  /// \param[in] prefix the path prefix of the cache entry
+  /// \return Whether the cache entry is valid and loaded
+  ///
+  bool LoadOptimizedProgramCache(const std::string &prefix);
+  ///
+  /// \brief Save the optimized program and its parameters to the cache entry.
+  /// The cache is best-effort, failures are only logged.
+  ///
+  /// \param[in] prefix the path prefix of the cache entry
+  ///
+  void SaveOptimizedProgramCache(const std::string &prefix);
 
   ///
   /// \brief Clear the intermediate tensors of the predictor
@@ -212,6 +236,15 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   uint64_t TryShrinkMemory() override;
 
+  ///
+  /// \brief Get the latencies of the runs and the ops sampled since the
+  /// latency sampling is enabled or last reset.
+  ///
+  /// \param[in] reset Whether to clear the latencies after reading them.
+  /// \return The statistics of the runs, followed by those of each op.
+  ///
+  std::vector<LatencyStat> GetLatencyStats(bool reset = false) override;
+
   ///
   /// \brief Get the argument used by predictor
   ///
@@ -258,6 +291,15 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   void SaveOptimModel(const std::string &dir);
 
+ private:
+  // Save the program and the persistable variables of the predictor to the
+  // given files, the parameters are saved in the combined format. Without
+  // any persistable variable, the params file is only written if
+  // save_empty_params.
+  void SaveProgramAndParams(const std::string &model_file,
+                            const std::string &params_file,
+                            bool save_empty_params);
+
  protected:
   ///
   /// \brief Prepare predictor's required programs, including loading model
@@ -299,6 +341,21 @@ class AnalysisPredictor : public PaddlePredictor {
   /// \return Whether the function executed successfully
   ///
   bool LoadParameters();
+  ///
+  /// \brief Load the encrypted combined parameters into scope, decrypting
+  /// them chunk by chunk.
+  ///
+  /// \return Whether the function executed successfully
+  ///
+  bool LoadEncryptedParameters();
+  ///
+  /// \brief Whether the memory arena of the executor will be used. It is not
+  /// used with the feed/fetch ops, or for the programs with sub-block ops,
+  /// including the engine ops of the subgraph passes.
+  ///
+  /// \return Whether the memory arena will be used
+  ///
+  bool MemoryArenaUsable() const;
 
   ///
   /// \brief Prepare input data, only used in Run()
@@ -355,6 +412,15 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   void MkldnnPostReset();
 
+  ///
+  /// \brief Publish the p50 and p99 latencies of the runs and the ops to the
+  /// StatRegistry, after a sampled run. The names of the stats start with
+  /// LatencyStatPrefix(), so that every predictor, including the clones, has
+  /// its own stats, which are removed with the predictor.
+  ///
+  void PublishLatencyStats();
+  std::string LatencyStatPrefix() const;
+
 #if PADDLE_WITH_TENSORRT
   ///
   /// \brief save calibration table
@@ -379,6 +445,9 @@ class AnalysisPredictor : public PaddlePredictor {
   FRIEND_TEST(AnalysisPredictor, analysis_off);
   FRIEND_TEST(AnalysisPredictor, analysis_on);
   FRIEND_TEST(AnalysisPredictor, with_gpu);
+  FRIEND_TEST(AnalysisPredictor, optimized_program_cache);
+  FRIEND_TEST(AnalysisPredictor, memory_arena);
+  FRIEND_TEST(AnalysisPredictor, memory_arena_fallback);
 #endif
 
  private:
@@ -427,6 +496,11 @@ class AnalysisPredictor : public PaddlePredictor {
  private:
   // Some status here that help to determine the status inside the predictor.
   bool status_is_cloned_{false};
+  // Whether the program is loaded from the optimized program cache.
+  bool optimized_program_cache_hit_{false};
+  // The path prefix of the optimized program cache entry, empty if the cache
+  // is not used.
+  std::string optimized_program_cache_prefix_;
 
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_info_;
 };
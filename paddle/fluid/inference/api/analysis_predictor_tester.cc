@@ -15,20 +15,83 @@
 #include "paddle/fluid/inference/api/analysis_predictor.h"
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <set>
 #include <thread>  // NOLINT
 #include "paddle/fluid/framework/ir/pass.h"
 #include "paddle/fluid/framework/tensor.h"
+#include "paddle/fluid/inference/analysis/helper.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/tests/api/tester_helper.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/platform/cpu_info.h"
+#include "paddle/fluid/platform/monitor.h"
+
+#ifdef PADDLE_WITH_CRYPTO
+#include "paddle/fluid/framework/io/crypto/cipher.h"
+#include "paddle/fluid/framework/io/crypto/cipher_stream.h"
+#include "paddle/fluid/framework/io/crypto/cipher_utils.h"
+#endif
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
 
 DEFINE_string(dirname, "", "dirname to tests.");
 
 namespace paddle {
 
+// A fresh directory for the files written by a test, instead of the shared
+// test data directory.
+static std::string MakeTempDir(const std::string& name) {
+  std::random_device rd;
+  std::string dir = ::testing::TempDir() + name + "_" + std::to_string(rd());
+  PADDLE_ENFORCE_NE(MKDIR(dir.c_str()), -1,
+                    platform::errors::Unavailable(
+                        "Failed to create the directory %s.", dir));
+  return dir;
+}
+
+// Removes the files and then the directory, which should be empty then.
+static void RemoveTempDir(const std::string& dir,
+                          const std::vector<std::string>& files) {
+  for (auto& file : files) {
+    std::remove(file.c_str());
+  }
+#ifdef _WIN32
+  _rmdir(dir.c_str());
+#else
+  rmdir(dir.c_str());
+#endif
+}
+
+static std::vector<float> RunZeroCopy(PaddlePredictor* predictor,
+                                      int batch_size) {
+  std::vector<int64_t> data(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    data[i] = i % 10;
+  }
+  for (auto& name : predictor->GetInputNames()) {
+    auto tensor = predictor->GetInputTensor(name);
+    tensor->Reshape({batch_size, 1});
+    tensor->copy_from_cpu(data.data());
+  }
+  EXPECT_TRUE(predictor->ZeroCopyRun());
+  auto out = predictor->GetOutputTensor(predictor->GetOutputNames()[0]);
+  std::vector<int> shape = out->shape();
+  std::vector<float> out_data(std::accumulate(shape.begin(), shape.end(), 1,
+                                              std::multiplies<int>()));
+  out->copy_to_cpu(out_data.data());
+  return out_data;
+}
+
 TEST(AnalysisPredictor, analysis_off) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -119,6 +182,116 @@ TEST(AnalysisPredictor, analysis_on) {
   inference::CompareTensor(outputs.front(), naive_outputs.front());
 }
 
+TEST(AnalysisPredictor, optimized_program_cache) {
+  std::string cache_dir = MakeTempDir("optimized_program_cache");
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchIrOptim(true);
+  config.DisableGpu();
+  config.SetOptimCacheDir(cache_dir);
+  config.EnableOptimizedProgramCache();
+  AnalysisConfig config1(config);
+  AnalysisConfig config2(config);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+
+  // The first predictor builds the cache, the second one hits it.
+  auto predictor0 = CreatePaddlePredictor<AnalysisConfig>(config);
+  auto* analysis_predictor0 = static_cast<AnalysisPredictor*>(predictor0.get());
+  ASSERT_FALSE(analysis_predictor0->optimized_program_cache_hit_);
+  const std::string prefix =
+      analysis_predictor0->optimized_program_cache_prefix_;
+  ASSERT_FALSE(prefix.empty());
+  std::vector<PaddleTensor> outputs0;
+  ASSERT_TRUE(predictor0->Run(inputs, &outputs0));
+
+  auto predictor1 = CreatePaddlePredictor<AnalysisConfig>(config1);
+  ASSERT_TRUE(static_cast<AnalysisPredictor*>(predictor1.get())
+                  ->optimized_program_cache_hit_);
+  std::vector<PaddleTensor> outputs1;
+  ASSERT_TRUE(predictor1->Run(inputs, &outputs1));
+  ASSERT_EQ(outputs1.size(), 1UL);
+  inference::CompareTensor(outputs0.front(), outputs1.front());
+
+  // A params file corrupted in place, of the same size, is detected by its
+  // hash and the entry is rebuilt.
+  {
+    std::fstream params(prefix + ".pdiparams",
+                        std::ios::in | std::ios::out | std::ios::binary);
+    ASSERT_TRUE(params.is_open());
+    params.seekg(0, std::ios::end);
+    std::streamoff pos = params.tellg() / 2;
+    char byte = 0;
+    params.seekg(pos);
+    params.get(byte);
+    params.seekp(pos);
+    params.put(static_cast<char>(byte ^ 0x5a));
+  }
+  auto predictor2 = CreatePaddlePredictor<AnalysisConfig>(config2);
+  ASSERT_FALSE(static_cast<AnalysisPredictor*>(predictor2.get())
+                   ->optimized_program_cache_hit_);
+  std::vector<PaddleTensor> outputs2;
+  ASSERT_TRUE(predictor2->Run(inputs, &outputs2));
+  ASSERT_EQ(outputs2.size(), 1UL);
+  inference::CompareTensor(outputs0.front(), outputs2.front());
+
+  RemoveTempDir(cache_dir, {prefix + ".pdmodel", prefix + ".pdiparams",
+                            prefix + ".meta"});
+}
+
+#ifdef PADDLE_WITH_CRYPTO
+TEST(AnalysisPredictor, model_decryption) {
+  std::string dir = MakeTempDir("model_decryption");
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchIrOptim(false);
+  config.DisableGpu();
+  config.SwitchUseFeedFetchOps(false);
+  // The combined model files to encrypt.
+  auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+  static_cast<AnalysisPredictor*>(predictor.get())->SaveOptimModel(dir);
+
+  const std::string cipher_config = dir + "/cipher.conf";
+  std::ofstream(cipher_config) << "cipher_name : AES_GCM_NoPadding"
+                               << std::endl;
+  auto cipher = framework::CipherFactory::CreateCipher(cipher_config);
+  std::string key = framework::CipherUtils::GenKey(256);
+  for (auto& name : {"model", "params"}) {
+    std::ifstream in(dir + "/" + name, std::ios::binary);
+    std::ofstream out(dir + "/" + name + ".enc", std::ios::binary);
+    framework::EncryptStream(cipher.get(), key, &in, &out, 1024);
+  }
+
+  AnalysisConfig decryption_config;
+  decryption_config.SetModel(dir + "/model.enc", dir + "/params.enc");
+  decryption_config.SetModelDecryption(cipher_config, key);
+  decryption_config.DisableGpu();
+  decryption_config.SwitchUseFeedFetchOps(false);
+  auto decryption_predictor =
+      CreatePaddlePredictor<AnalysisConfig>(decryption_config);
+
+  auto expected = RunZeroCopy(predictor.get(), 4);
+  auto result = RunZeroCopy(decryption_predictor.get(), 4);
+  ASSERT_EQ(result.size(), expected.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    EXPECT_NEAR(result[i], expected[i], 1e-5);
+  }
+
+  // A wrong key fails the authentication of the chunks.
+  decryption_config.SetModelDecryption(cipher_config,
+                                       framework::CipherUtils::GenKey(256));
+  EXPECT_ANY_THROW(CreatePaddlePredictor<AnalysisConfig>(decryption_config));
+
+  RemoveTempDir(dir, {dir + "/model", dir + "/params", dir + "/model.enc",
+                      dir + "/params.enc", cipher_config});
+}
+#endif
+
 TEST(AnalysisPredictor, ZeroCopy) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -159,6 +332,112 @@ TEST(AnalysisPredictor, ZeroCopy) {
   predictor->TryShrinkMemory();
 }
 
+TEST(AnalysisPredictor, memory_arena) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.DisableGpu();
+  config.SwitchUseFeedFetchOps(false);
+  AnalysisConfig arena_config(config);
+  arena_config.EnableMemoryArena();
+  auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+  auto arena_predictor = CreatePaddlePredictor<AnalysisConfig>(arena_config);
+
+  // Plan for two shapes, and run each of them again with the cached plans.
+  for (int batch_size : {4, 7, 4, 7}) {
+    auto expected = RunZeroCopy(predictor.get(), batch_size);
+    auto result = RunZeroCopy(arena_predictor.get(), batch_size);
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+      EXPECT_NEAR(result[i], expected[i], 1e-5);
+    }
+  }
+  auto* analysis_predictor =
+      static_cast<AnalysisPredictor*>(arena_predictor.get());
+  EXPECT_GT(analysis_predictor->executor_->MemoryArenaSize(), 0UL);
+}
+
+TEST(AnalysisPredictor, memory_arena_fallback) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.DisableGpu();
+  config.EnableMemoryOptim();
+  config.EnableMemoryArena();
+
+  // The arena is not used with the feed/fetch ops, so the memory
+  // optimization is kept.
+  auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+  auto* analysis_predictor = static_cast<AnalysisPredictor*>(predictor.get());
+  EXPECT_FALSE(analysis_predictor->MemoryArenaUsable());
+  EXPECT_TRUE(analysis_predictor->analysis_argument().enable_memory_optim());
+
+  config.SwitchUseFeedFetchOps(false);
+  auto arena_predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+  analysis_predictor = static_cast<AnalysisPredictor*>(arena_predictor.get());
+  EXPECT_TRUE(analysis_predictor->MemoryArenaUsable());
+  EXPECT_FALSE(analysis_predictor->analysis_argument().enable_memory_optim());
+}
+
+TEST(AnalysisPredictor, latency_sampling) {
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.DisableGpu();
+  config.SwitchUseFeedFetchOps(false);
+  config.EnableLatencySampling(1.);
+  auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+
+  std::vector<int64_t> data(4);
+  for (int i = 0; i < 4; ++i) {
+    data[i] = i;
+  }
+  for (int i = 0; i < 3; ++i) {
+    for (auto& name : predictor->GetInputNames()) {
+      auto tensor = predictor->GetInputTensor(name);
+      tensor->Reshape({4, 1});
+      tensor->copy_from_cpu(data.data());
+    }
+    ASSERT_TRUE(predictor->ZeroCopyRun());
+  }
+
+  auto stats = predictor->GetLatencyStats(true);
+  ASSERT_GT(stats.size(), 1UL);
+  EXPECT_EQ(stats[0].name, "run");
+  EXPECT_EQ(stats[0].count, 3UL);
+  EXPECT_LE(stats[0].p50_us, stats[0].p99_us);
+  EXPECT_EQ(stats[1].name.compare(0, 4, "op0_"), 0);
+  EXPECT_EQ(stats[1].count, 3UL);
+  // Each predictor publishes its own stats, and removes them when destroyed.
+  auto published_run_stats = [] {
+    std::set<std::string> names;
+    for (auto& stat : platform::StatRegistry<float>::Instance().publish()) {
+      const std::string suffix = "_run_p99_us";
+      if (stat.key.compare(0, 19, "STAT_infer_latency_") == 0 &&
+          stat.key.size() > suffix.size() &&
+          stat.key.compare(stat.key.size() - suffix.size(), suffix.size(),
+                           suffix) == 0) {
+        names.insert(stat.key);
+      }
+    }
+    return names;
+  };
+  auto names = published_run_stats();
+  EXPECT_EQ(names.size(), 1UL);
+  {
+    auto clone = predictor->Clone();
+    for (auto& name : clone->GetInputNames()) {
+      auto tensor = clone->GetInputTensor(name);
+      tensor->Reshape({4, 1});
+      tensor->copy_from_cpu(data.data());
+    }
+    ASSERT_TRUE(clone->ZeroCopyRun());
+    EXPECT_EQ(published_run_stats().size(), 2UL);
+  }
+  EXPECT_EQ(published_run_stats(), names);
+
+  // Reset by the last read.
+  stats = predictor->GetLatencyStats();
+  EXPECT_EQ(stats[0].count, 0UL);
+}
+
 TEST(AnalysisPredictor, CollectShapeRangeInfo) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -396,4 +675,120 @@ TEST(Predictor, Run) {
   predictor->TryShrinkMemory();
 }
 
+TEST(Predictor, ShareExternalData) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  auto predictor = CreatePredictor(config);
+
+  std::vector<int64_t> input{0, 1, 2, 3};
+  for (auto& name : predictor->GetInputNames()) {
+    predictor->GetInputHandle(name)->ShareExternalData<int64_t>(input.data(),
+                                                                {4, 1});
+  }
+  ASSERT_TRUE(predictor->Run());
+  auto out = predictor->GetOutputHandle(predictor->GetOutputNames()[0]);
+  std::vector<int> shape = out->shape();
+  int numel =
+      std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+  std::vector<float> expected(numel);
+  out->CopyToCpu(expected.data());
+
+  // The output is written into the bound buffer by the run.
+  std::vector<float> out_data(numel, 0.f);
+  out->ShareExternalData<float>(out_data.data(), shape);
+  ASSERT_TRUE(predictor->Run());
+  PlaceType place;
+  int size = 0;
+  ASSERT_EQ(out->data<float>(&place, &size), out_data.data());
+  ASSERT_EQ(size, numel);
+  for (int i = 0; i < numel; ++i) {
+    EXPECT_NEAR(out_data[i], expected[i], 1e-5);
+  }
+  auto in = predictor->GetInputHandle(predictor->GetInputNames()[0]);
+  EXPECT_EQ(in->data<int64_t>(&place, &size), input.data());
+}
+
+TEST(AsyncPredictor, RunAsync) {
+  Config config;
+  config.SetModel(FLAGS_dirname);
+  services::AsyncPredictor predictor(config, 2);
+  ASSERT_EQ(predictor.GetInputNames().size(), 4UL);
+
+  auto make_inputs = [] {
+    std::vector<paddle::PaddleTensor> inputs(4);
+    for (auto& input : inputs) {
+      input.shape = {4, 1};
+      input.dtype = DataType::INT64;
+      input.data.Resize(4 * sizeof(int64_t));
+      auto* data = static_cast<int64_t*>(input.data.data());
+      for (int i = 0; i < 4; i++) {
+        data[i] = i;
+      }
+    }
+    return inputs;
+  };
+
+  std::vector<paddle::PaddleTensor> outputs0;
+  auto future = predictor.RunAsync(make_inputs(), &outputs0);
+
+  std::vector<paddle::PaddleTensor> outputs1;
+  std::promise<bool> done;
+  predictor.RunAsync(make_inputs(), &outputs1,
+                     [&done](bool success) { done.set_value(success); });
+
+  ASSERT_TRUE(future.get());
+  ASSERT_TRUE(done.get_future().get());
+  ASSERT_EQ(outputs0.size(), predictor.GetOutputNames().size());
+  ASSERT_EQ(outputs0.size(), outputs1.size());
+  for (size_t i = 0; i < outputs0.size(); ++i) {
+    ASSERT_EQ(outputs0[i].shape, outputs1[i].shape);
+    auto* data0 = static_cast<float*>(outputs0[i].data.data());
+    auto* data1 = static_cast<float*>(outputs1[i].data.data());
+    int numel = paddle::inference::VecReduceToInt(outputs0[i].shape);
+    for (int j = 0; j < numel; ++j) {
+      EXPECT_EQ(data0[j], data1[j]);
+    }
+  }
+
+  // The errors of a request are thrown by the future.
+  std::vector<paddle::PaddleTensor> outputs2;
+  auto failed = predictor.RunAsync(std::vector<paddle::PaddleTensor>(1),
+                                   &outputs2);
+  ASSERT_ANY_THROW(failed.get());
+
+  // A request failing after some inputs are bound releases them, and a
+  // throwing callback does not stop the worker.
+  auto unsupported = make_inputs();
+  unsupported.back().dtype = DataType::FLOAT16;
+  std::vector<paddle::PaddleTensor> outputs3;
+  ASSERT_ANY_THROW(predictor.RunAsync(std::move(unsupported), &outputs3).get());
+  auto too_short = make_inputs();
+  too_short.back().data.Resize(3 * sizeof(int64_t));
+  ASSERT_THROW(predictor.RunAsync(std::move(too_short), &outputs3).get(),
+               paddle::platform::EnforceNotMet);
+  std::vector<std::vector<paddle::PaddleTensor>> throwing_outputs(2);
+  std::vector<std::promise<bool>> called(2);
+  for (size_t i = 0; i < called.size(); ++i) {
+    predictor.RunAsync(make_inputs(), &throwing_outputs[i],
+                       [&called, i](bool success) {
+                         called[i].set_value(success);
+                         throw std::runtime_error("callback failed");
+                       });
+  }
+  for (auto& promise : called) {
+    ASSERT_TRUE(promise.get_future().get());
+  }
+  std::vector<paddle::PaddleTensor> outputs4;
+  ASSERT_TRUE(predictor.RunAsync(make_inputs(), &outputs4).get());
+  ASSERT_EQ(outputs4.size(), outputs0.size());
+  for (size_t i = 0; i < outputs0.size(); ++i) {
+    auto* data0 = static_cast<float*>(outputs0[i].data.data());
+    auto* data4 = static_cast<float*>(outputs4[i].data.data());
+    int numel = paddle::inference::VecReduceToInt(outputs0[i].shape);
+    for (int j = 0; j < numel; ++j) {
+      EXPECT_EQ(data0[j], data4[j]);
+    }
+  }
+}
+
 }  // namespace paddle_infer
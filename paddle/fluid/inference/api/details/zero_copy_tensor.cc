@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/fluid/framework/data_layout_transform.h"
+#include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
@@ -25,6 +26,26 @@ namespace paddle_infer {
 
 using float16 = paddle::platform::float16;
 
+namespace {
+
+// The host memory of the caller bound by Tensor::ShareExternalData, which is
+// never freed by the tensor.
+class ExternalAllocation : public paddle::memory::Allocation {
+ public:
+  ExternalAllocation(void *ptr, size_t size)
+      : paddle::memory::Allocation(ptr, size, paddle::platform::CPUPlace()) {}
+};
+
+// Drops the binding of the caller's buffer, so that the tensor does not write
+// to the buffer after the caller expects it to own its data again.
+void ReleaseExternalData(paddle::framework::LoDTensor *tensor) {
+  if (dynamic_cast<ExternalAllocation *>(tensor->Holder().get())) {
+    tensor->clear();
+  }
+}
+
+}  // namespace
+
 void Tensor::Reshape(const std::vector<int> &shape) {
   PADDLE_ENFORCE_EQ(
       name_.empty(), false,
@@ -40,6 +61,7 @@ void Tensor::Reshape(const std::vector<int> &shape) {
       var, paddle::platform::errors::PreconditionNotMet(
                "No tensor called [%s] in the runtime scope", name_));
   auto *tensor = var->GetMutable<paddle::framework::LoDTensor>();
+  ReleaseExternalData(tensor);
   tensor->Resize(paddle::framework::make_ddim(shape));
 }
 
@@ -58,6 +80,7 @@ T *Tensor::mutable_data(PlaceType place) {
           "You should call Tensor::Reshape(const std::vector<int> "
           "&shape)"
           "function before retrieving mutable_data from input tensor."));
+  ReleaseExternalData(tensor);
   switch (static_cast<int>(place)) {
     case static_cast<int>(PlaceType::kCPU): {
       return tensor->mutable_data<T>(paddle::platform::CPUPlace());
@@ -131,6 +154,7 @@ void Tensor::CopyFromCpu(const T *data) {
                         "You should call Tensor::Reshape(const "
                         "std::vector<int> &shape)"
                         "function before copying data from cpu."));
+  ReleaseExternalData(tensor);
   size_t ele_size = tensor->numel() * sizeof(T);
 
   if (place_ == PlaceType::kCPU) {
@@ -186,6 +210,28 @@ void Tensor::CopyFromCpu(const T *data) {
   }
 }
 
+template <typename T>
+void Tensor::ShareExternalData(T *data, const std::vector<int> &shape) {
+  EAGER_GET_TENSOR;
+  PADDLE_ENFORCE_NOT_NULL(data, paddle::platform::errors::InvalidArgument(
+                                    "The external data of tensor %s should "
+                                    "not be nullptr.",
+                                    name_));
+  PADDLE_ENFORCE_EQ(place_, PlaceType::kCPU,
+                    paddle::platform::errors::Unimplemented(
+                        "Only the host memory can be shared with tensor %s "
+                        "on CPU place now.",
+                        name_));
+  auto ddim = paddle::framework::make_ddim(shape);
+  auto size = paddle::framework::product(ddim) * sizeof(T);
+  // Clear the tensor first, the size of the old holder is not checked.
+  tensor->clear();
+  tensor->Resize(ddim);
+  tensor->ResetHolderWithType(
+      std::make_shared<ExternalAllocation>(static_cast<void *>(data), size),
+      paddle::framework::DataTypeTrait<T>::DataType());
+}
+
 template <typename T>
 void Tensor::CopyToCpuImpl(T *data, void *exec_stream, CallbackFunc cb,
                            void *cb_params) const {
@@ -201,6 +247,11 @@ void Tensor::CopyToCpuImpl(T *data, void *exec_stream, CallbackFunc cb,
   out.ResetHolder(mem_allocation);
 
   if (paddle::platform::is_cpu_place(t_place)) {
+    // The result is already in the buffer bound by ShareExternalData.
+    if (static_cast<void *>(data) == static_cast<const void *>(t_data) &&
+        tensor->layout() != paddle::framework::DataLayout::kMKLDNN) {
+      return;
+    }
 #ifdef PADDLE_WITH_MKLDNN
     if (tensor->layout() == paddle::framework::DataLayout::kMKLDNN)
       paddle::framework::innerTransDataLayoutFromMKLDNN(
@@ -296,6 +347,19 @@ template PD_INFER_DECL void Tensor::CopyFromCpu<uint8_t>(const uint8_t *data);
 template PD_INFER_DECL void Tensor::CopyFromCpu<int8_t>(const int8_t *data);
 template PD_INFER_DECL void Tensor::CopyFromCpu<float16>(const float16 *data);
 
+template PD_INFER_DECL void Tensor::ShareExternalData<float>(
+    float *data, const std::vector<int> &shape);
+template PD_INFER_DECL void Tensor::ShareExternalData<int64_t>(
+    int64_t *data, const std::vector<int> &shape);
+template PD_INFER_DECL void Tensor::ShareExternalData<int32_t>(
+    int32_t *data, const std::vector<int> &shape);
+template PD_INFER_DECL void Tensor::ShareExternalData<uint8_t>(
+    uint8_t *data, const std::vector<int> &shape);
+template PD_INFER_DECL void Tensor::ShareExternalData<int8_t>(
+    int8_t *data, const std::vector<int> &shape);
+template PD_INFER_DECL void Tensor::ShareExternalData<float16>(
+    float16 *data, const std::vector<int> &shape);
+
 template PD_INFER_DECL void Tensor::CopyToCpu<float>(float *data) const;
 template PD_INFER_DECL void Tensor::CopyToCpu<int64_t>(int64_t *data) const;
 template PD_INFER_DECL void Tensor::CopyToCpu<int32_t>(int32_t *data) const;
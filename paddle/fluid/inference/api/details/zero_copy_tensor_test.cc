@@ -143,4 +143,33 @@ TEST(Tensor, FillRandomDataAndCheck) {
 #endif
 }
 
+TEST(Tensor, ShareExternalData) {
+  paddle::framework::Scope scope;
+  const std::string name{"name"};
+  scope.Var(name);
+  auto tensor = CreateTensor(PlaceType::kCPU, &scope, name);
+
+  std::vector<float> buffer{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  tensor->ShareExternalData<float>(buffer.data(), {2, 3});
+  ASSERT_EQ(tensor->shape(), (std::vector<int>{2, 3}));
+  ASSERT_EQ(tensor->type(), DataType::FLOAT32);
+  PlaceType place{PlaceType::kUNK};
+  int size{-1};
+  ASSERT_EQ(tensor->data<float>(&place, &size), buffer.data());
+  ASSERT_EQ(place, PlaceType::kCPU);
+  ASSERT_EQ(size, 6);
+
+  // The copy to the bound buffer itself is skipped.
+  tensor->CopyToCpu<float>(buffer.data());
+  std::vector<float> data_out(buffer.size());
+  tensor->CopyToCpu<float>(data_out.data());
+  ASSERT_EQ(data_out, buffer);
+
+  // The copy from cpu releases the binding, instead of writing to the buffer.
+  std::vector<float> data_in(buffer.size(), 0.f);
+  tensor->CopyFromCpu<float>(data_in.data());
+  ASSERT_NE(tensor->data<float>(&place, &size), buffer.data());
+  ASSERT_EQ(buffer[0], 1.f);
+}
+
 }  // namespace paddle_infer
@@ -647,6 +647,23 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool model_from_memory() const { return model_from_memory_; }
 
+  ///
+  /// \brief Load a combined model (prog_file and params_file) encrypted by a
+  /// Cipher. A params file encrypted by EncryptStream is decrypted chunk by
+  /// chunk straight into the parameter tensors.
+  ///
+  /// \param cipher_config_file The config file of CipherFactory.
+  /// \param key The key of the cipher.
+  ///
+  void SetModelDecryption(const std::string& cipher_config_file,
+                          const std::string& key);
+  ///
+  /// \brief A boolean state telling whether the model is encrypted.
+  ///
+  /// \return bool Whether the model is decrypted while loading.
+  ///
+  bool model_decryption_enabled() const { return model_decryption_enabled_; }
+
   ///
   /// \brief Turn on memory optimize
   /// NOTE still in development.
@@ -662,6 +679,65 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool enable_memory_optim() const;
 
+  ///
+  /// \brief Turn on the cache of the optimized program.
+  /// The program and the parameters transformed by the analysis passes are
+  /// saved under the optimization cache directory, keyed by the hash of the
+  /// model files, the passes and the config. The later predictors with the
+  /// same key load them directly instead of running the passes again.
+  ///
+  /// \param x Whether to turn on the optimized program cache.
+  ///
+  void EnableOptimizedProgramCache(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the optimized program cache is
+  /// activated.
+  ///
+  /// \return bool Whether the optimized program cache is activated.
+  ///
+  bool optimized_program_cache_enabled() const {
+    return use_optimized_program_cache_;
+  }
+
+  ///
+  /// \brief Turn on the memory arena of ZeroCopyRun.
+  /// The intermediate tensors are placed at the offsets planned in one
+  /// preallocated arena, instead of being allocated op by op. The plan is
+  /// made by the first run with each shape of the inputs and cached. It
+  /// replaces the memory optimization, and only works when the feed and fetch
+  /// ops are not used, for the programs without sub-block ops and subgraph
+  /// engines. Otherwise the memory optimization is kept if enabled.
+  ///
+  /// \param x Whether to turn on the memory arena.
+  ///
+  void EnableMemoryArena(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the memory arena is activated.
+  ///
+  /// \return bool Whether the memory arena is activated.
+  ///
+  bool memory_arena_enabled() const { return use_memory_arena_; }
+
+  ///
+  /// \brief Turn on the latency sampling of the runs.
+  /// One in every 1 / sampling_rate runs is timed op by op, and the latencies
+  /// are recorded into the histograms read by
+  /// PaddlePredictor::GetLatencyStats and published to the StatRegistry as
+  /// STAT_infer_latency_<predictor id>_<name>_{p50,p99}_us, where every
+  /// clone has its own predictor id. The sampled runs wait for the device
+  /// after each op.
+  ///
+  /// \param sampling_rate The fraction of the runs to time, in [0, 1]. 0
+  /// turns the sampling off.
+  ///
+  void EnableLatencySampling(double sampling_rate = 0.01);
+  ///
+  /// \brief Get the fraction of the runs whose latencies are sampled.
+  ///
+  /// \return double The sampling rate, 0 if the sampling is off.
+  ///
+  double latency_sampling_rate() const { return latency_sampling_rate_; }
+
   ///
   /// \brief Turn on profiling report.
   /// If not turned on, no profiling report will be generated.
@@ -796,6 +872,9 @@ struct PD_INFER_DECL AnalysisConfig {
   std::unordered_set<std::string> mkldnn_enabled_op_types_;
 
   bool model_from_memory_{false};
+  bool model_decryption_enabled_{false};
+  std::string cipher_config_file_;
+  std::string cipher_key_;
 
   bool enable_ir_optim_{true};
   bool use_feed_fetch_ops_{true};
@@ -846,6 +925,9 @@ struct PD_INFER_DECL AnalysisConfig {
   // So we release the memory when the predictor is set up.
   mutable bool is_valid_{true};
   std::string opt_cache_dir_;
+  bool use_optimized_program_cache_{false};
+  bool use_memory_arena_{false};
+  double latency_sampling_rate_{0.};
 };
 
 }  // namespace paddle
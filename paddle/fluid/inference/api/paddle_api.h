@@ -156,6 +156,15 @@ struct PD_INFER_DECL PaddleTensor {
   std::vector<std::vector<size_t>> lod;  ///<  Tensor+LoD equals LoDTensor
 };
 
+/// \brief The latency statistics of a run or an op, from the sampled runs.
+struct PD_INFER_DECL LatencyStat {
+  std::string name;   ///< "run", or "op<index>_<type>" for an op.
+  uint64_t count{0};  ///< number of the sampled latencies.
+  double mean_us{0.};
+  double p50_us{0.};
+  double p99_us{0.};
+};
+
 /// \brief Represents an n-dimensional array of values.
 /// The ZeroCopyTensor is used to store the input or output of the network.
 /// Zero copy means that the tensor supports direct copy of host or device data
@@ -285,6 +294,20 @@ class PD_INFER_DECL PaddlePredictor {
     return "NotImplemented";
   }
 
+  // NOTE: new virtual methods go after the existing ones, so that the vtable
+  // layout stays compatible with the code built against older headers.
+  ///
+  /// \brief Get the latencies of the runs and the ops sampled since the
+  /// latency sampling is enabled or last reset.
+  ///
+  /// \param[in] reset Whether to clear the latencies after reading them.
+  /// \return The statistics of the runs, followed by those of each op. Empty
+  /// if the latency sampling is off.
+  ///
+  virtual std::vector<LatencyStat> GetLatencyStats(bool reset = false) {
+    return {};
+  }
+
   /// \brief Base class for NativeConfig and AnalysisConfig.
   struct Config {
     std::string model_dir; /*!< path to the model directory. */
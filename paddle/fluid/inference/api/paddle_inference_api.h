@@ -22,9 +22,15 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -148,6 +154,15 @@ class PD_INFER_DECL Predictor {
   ///
   uint64_t TryShrinkMemory();
 
+  ///
+  /// \brief Get the latencies of the runs and the ops sampled since the
+  /// latency sampling is enabled or last reset.
+  ///
+  /// \param[in] reset Whether to clear the latencies after reading them.
+  /// \return The statistics of the runs, followed by those of each op.
+  ///
+  std::vector<paddle::LatencyStat> GetLatencyStats(bool reset = false);
+
  private:
   std::unique_ptr<paddle::PaddlePredictor> predictor_;
 };
@@ -196,6 +211,90 @@ class PD_INFER_DECL PredictorPool {
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
 };
+
+///
+/// \class AsyncPredictor
+///
+/// \brief AsyncPredictor runs the predictions on its own worker threads, so
+/// that the caller is not blocked and an event-driven server needs no thread
+/// per request. Each worker owns a predictor of a PredictorPool, and every
+/// request brings its own input and output tensors, so as many requests as
+/// workers run at the same time, and the others wait in a queue.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// services::AsyncPredictor predictor(config, 4);
+/// predictor.RunAsync(std::move(inputs), &outputs, [&](bool success) {
+///   ... // use the outputs, on the worker thread.
+/// });
+/// \endcode
+///
+class PD_INFER_DECL AsyncPredictor {
+ public:
+  /// \brief The callback of a request, called on the worker thread.
+  using Callback = std::function<void(bool success)>;
+
+  AsyncPredictor() = delete;
+  AsyncPredictor(const AsyncPredictor&) = delete;
+  AsyncPredictor& operator=(const AsyncPredictor&) = delete;
+
+  /// \brief Construct with \param num_workers worker threads, each owning a
+  /// predictor.
+  explicit AsyncPredictor(const Config& config, size_t num_workers = 1);
+
+  /// \brief Finish the queued requests, then stop the workers.
+  ~AsyncPredictor();
+
+  std::vector<std::string> GetInputNames() const { return input_names_; }
+  std::vector<std::string> GetOutputNames() const { return output_names_; }
+
+  ///
+  /// \brief Queue a request and return at once.
+  /// The inputs are matched to the model inputs by name, or by position if
+  /// the names are empty, and are not copied on CPU. The outputs are filled
+  /// in the order of GetOutputNames() before the callback is called, so they
+  /// must be alive until then. The callback blocks the worker, so it should
+  /// return quickly.
+  ///
+  /// \param[in] inputs The input tensors of the request.
+  /// \param[out] outputs The output tensors of the request.
+  /// \param[in] callback Called with whether the run succeeded.
+  ///
+  void RunAsync(std::vector<paddle::PaddleTensor> inputs,
+                std::vector<paddle::PaddleTensor>* outputs,
+                Callback callback);
+
+  ///
+  /// \brief Queue a request and return a future of it at once.
+  /// The same as above, but the errors of the run are thrown by the get() of
+  /// the future.
+  ///
+  std::future<bool> RunAsync(std::vector<paddle::PaddleTensor> inputs,
+                             std::vector<paddle::PaddleTensor>* outputs);
+
+ private:
+  struct Task {
+    std::vector<paddle::PaddleTensor> inputs;
+    std::vector<paddle::PaddleTensor>* outputs;
+    Callback callback;
+    std::shared_ptr<std::promise<bool>> promise;
+  };
+
+  void Push(Task&& task);
+  void WorkerLoop(Predictor* predictor);
+  bool RunTask(Predictor* predictor, Task* task);
+
+  std::unique_ptr<PredictorPool> pool_;
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Task> tasks_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
 }  // namespace services
 
 }  // namespace paddle_infer
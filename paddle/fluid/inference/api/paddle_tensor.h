@@ -78,6 +78,20 @@ class PD_INFER_DECL Tensor {
   template <typename T>
   void CopyFromCpu(const T* data);
 
+  /// \brief Bind the tensor to the host memory of the caller, without copy.
+  /// For an input tensor, the predictor reads the data from the buffer
+  /// directly. For an output tensor, the predictor writes the result into the
+  /// buffer directly when it is large enough for the output, otherwise the
+  /// tensor gets its own memory and the result has to be fetched with
+  /// CopyToCpu, which skips the copy if the data is still in the buffer.
+  /// The buffer must outlive the runs, and the binding is released by the
+  /// next Reshape, mutable_data or CopyFromCpu of the tensor.
+  /// Only the CPU place is supported now.
+  /// \param data The host buffer, of at least the numel of the shape.
+  /// \param shape The shape of the tensor.
+  template <typename T>
+  void ShareExternalData(T* data, const std::vector<int>& shape);
+
   /// \brief Copy the tensor data to the host memory.
   /// It's usually used to get the output tensor data.
   /// \param[out] data The tensor will copy the data to the address.
@@ -0,0 +1,183 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/capi_exp/pd_async_predictor.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/inference/capi_exp/pd_types.h"
+#include "paddle/fluid/inference/capi_exp/pd_utils.h"
+#include "paddle/fluid/inference/capi_exp/types_internal.h"
+#include "paddle/fluid/inference/capi_exp/utils_internal.h"
+#include "paddle/fluid/platform/enforce.h"
+
+#define CHECK_AND_CONVERT_PD_ASYNC_PREDICTOR                              \
+  PADDLE_ENFORCE_NOT_NULL(                                                \
+      pd_predictor,                                                       \
+      paddle::platform::errors::InvalidArgument(                          \
+          "The pointer of paddle async predictor shouldn't be nullptr")); \
+  auto& predictor = pd_predictor->predictor
+
+#define CHECK_AND_CONVERT_PD_ASYNC_REQUEST                              \
+  PADDLE_ENFORCE_NOT_NULL(                                              \
+      pd_request,                                                       \
+      paddle::platform::errors::InvalidArgument(                        \
+          "The pointer of paddle async request shouldn't be nullptr")); \
+  auto& request = *pd_request
+
+namespace {
+
+void SetAsyncInput(PD_AsyncRequest* pd_request, const char* name,
+                   size_t shape_size, int32_t* shape, void* data,
+                   size_t type_size, paddle::PaddleDType dtype) {
+  CHECK_AND_CONVERT_PD_ASYNC_REQUEST;
+  PADDLE_ENFORCE_NOT_NULL(
+      name, paddle::platform::errors::InvalidArgument(
+                "The input name of the async request shouldn't be nullptr"));
+  paddle::PaddleTensor* input = nullptr;
+  for (auto& tensor : request.inputs) {
+    if (tensor.name == name) {
+      input = &tensor;
+    }
+  }
+  if (input == nullptr) {
+    request.inputs.emplace_back();
+    input = &request.inputs.back();
+    input->name = name;
+  }
+  input->shape.assign(shape, shape + shape_size);
+  size_t numel = 1;
+  for (size_t i = 0; i < shape_size; ++i) {
+    numel *= shape[i];
+  }
+  input->data.Reset(data, numel * type_size);
+  input->dtype = dtype;
+}
+
+const paddle::PaddleTensor& GetAsyncOutput(PD_AsyncRequest* pd_request,
+                                           size_t index) {
+  CHECK_AND_CONVERT_PD_ASYNC_REQUEST;
+  PADDLE_ENFORCE_LT(
+      index, request.outputs.size(),
+      paddle::platform::errors::InvalidArgument(
+          "The async request has %d outputs, but the index is %d.",
+          request.outputs.size(), index));
+  return request.outputs[index];
+}
+
+}  // namespace
+
+extern "C" {
+
+__pd_give PD_AsyncPredictor* PD_AsyncPredictorCreate(
+    __pd_take PD_Config* pd_config, size_t num_workers) {
+  PADDLE_ENFORCE_NOT_NULL(
+      pd_config, paddle::platform::errors::InvalidArgument(
+                     "The pointer of paddle config shouldn't be nullptr"));
+  PD_AsyncPredictor* pd_predictor = new PD_AsyncPredictor();
+  paddle_infer::Config* config =
+      reinterpret_cast<paddle_infer::Config*>(pd_config);
+  pd_predictor->predictor.reset(
+      new paddle_infer::services::AsyncPredictor(*config, num_workers));
+  delete config;
+  return pd_predictor;
+}
+
+__pd_give PD_OneDimArrayCstr* PD_AsyncPredictorGetInputNames(
+    __pd_keep PD_AsyncPredictor* pd_predictor) {
+  CHECK_AND_CONVERT_PD_ASYNC_PREDICTOR;
+  return paddle_infer::CvtVecToOneDimArrayCstr(predictor->GetInputNames());
+}
+
+__pd_give PD_OneDimArrayCstr* PD_AsyncPredictorGetOutputNames(
+    __pd_keep PD_AsyncPredictor* pd_predictor) {
+  CHECK_AND_CONVERT_PD_ASYNC_PREDICTOR;
+  return paddle_infer::CvtVecToOneDimArrayCstr(predictor->GetOutputNames());
+}
+
+void PD_AsyncPredictorRun(__pd_keep PD_AsyncPredictor* pd_predictor,
+                          __pd_keep PD_AsyncRequest* pd_request,
+                          PD_AsyncCallback callback, void* user_data) {
+  CHECK_AND_CONVERT_PD_ASYNC_PREDICTOR;
+  CHECK_AND_CONVERT_PD_ASYNC_REQUEST;
+  // The inputs only refer to the memory of the caller, so the copy is cheap.
+  predictor->RunAsync(request.inputs, &request.outputs,
+                      [pd_request, callback, user_data](bool success) {
+                        if (callback) {
+                          callback(success, pd_request, user_data);
+                        }
+                      });
+}
+
+void PD_AsyncPredictorDestroy(__pd_take PD_AsyncPredictor* pd_predictor) {
+  delete pd_predictor;
+}
+
+__pd_give PD_AsyncRequest* PD_AsyncRequestCreate() {
+  return new PD_AsyncRequest();
+}
+
+#define PD_ASYNC_REQUEST_SET_INPUT_IMPL(type, Type, dtype)                  \
+  void PD_AsyncRequestSetInput##Type(__pd_keep PD_AsyncRequest* pd_request, \
+                                     const char* name, size_t shape_size,   \
+                                     int32_t* shape, type* data) {          \
+    SetAsyncInput(pd_request, name, shape_size, shape, data, sizeof(type),  \
+                  paddle::PaddleDType::dtype);                              \
+  }
+PD_ASYNC_REQUEST_SET_INPUT_IMPL(float, Float, FLOAT32)
+PD_ASYNC_REQUEST_SET_INPUT_IMPL(int64_t, Int64, INT64)
+PD_ASYNC_REQUEST_SET_INPUT_IMPL(int32_t, Int32, INT32)
+PD_ASYNC_REQUEST_SET_INPUT_IMPL(uint8_t, Uint8, UINT8)
+PD_ASYNC_REQUEST_SET_INPUT_IMPL(int8_t, Int8, INT8)
+#undef PD_ASYNC_REQUEST_SET_INPUT_IMPL
+
+size_t PD_AsyncRequestGetOutputNum(__pd_keep PD_AsyncRequest* pd_request) {
+  CHECK_AND_CONVERT_PD_ASYNC_REQUEST;
+  return request.outputs.size();
+}
+
+const char* PD_AsyncRequestGetOutputName(__pd_keep PD_AsyncRequest* pd_request,
+                                         size_t index) {
+  return GetAsyncOutput(pd_request, index).name.c_str();
+}
+
+__pd_give PD_OneDimArrayInt32* PD_AsyncRequestGetOutputShape(
+    __pd_keep PD_AsyncRequest* pd_request, size_t index) {
+  return paddle_infer::CvtVecToOneDimArrayInt32(
+      GetAsyncOutput(pd_request, index).shape);
+}
+
+PD_DataType PD_AsyncRequestGetOutputDataType(
+    __pd_keep PD_AsyncRequest* pd_request, size_t index) {
+  return paddle_infer::CvtFromCxxDatatype(
+      GetAsyncOutput(pd_request, index).dtype);
+}
+
+const void* PD_AsyncRequestGetOutputData(__pd_keep PD_AsyncRequest* pd_request,
+                                         size_t index, size_t* size) {
+  auto& output = GetAsyncOutput(pd_request, index);
+  if (size) {
+    // The buffer may be larger than the output when the request is reused.
+    size_t numel = 1;
+    for (auto dim : output.shape) {
+      numel *= dim;
+    }
+    *size = numel * paddle_infer::GetNumBytesOfDataType(output.dtype);
+  }
+  return output.data.data();
+}
+
+void PD_AsyncRequestDestroy(__pd_take PD_AsyncRequest* pd_request) {
+  delete pd_request;
+}
+
+}  // extern "C"
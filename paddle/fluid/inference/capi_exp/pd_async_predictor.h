@@ -0,0 +1,227 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+///
+/// \file pd_async_predictor.h
+///
+/// \brief interface for paddle async predictor
+///
+/// \author paddle-infer@baidu.com
+/// \date 2021-08-02
+/// \since 2.2
+///
+
+#pragma once
+
+#include "pd_common.h"  // NOLINT
+
+typedef struct PD_AsyncPredictor PD_AsyncPredictor;
+typedef struct PD_AsyncRequest PD_AsyncRequest;
+typedef struct PD_Config PD_Config;
+typedef struct PD_OneDimArrayCstr PD_OneDimArrayCstr;
+typedef struct PD_OneDimArrayInt32 PD_OneDimArrayInt32;
+
+///
+/// \brief The callback of an async run, called on the worker thread of the
+/// predictor. It should return quickly since it blocks the worker.
+///
+/// \param[in] success Whether the run succeeded.
+/// \param[in] pd_request The request of the run.
+/// \param[in] user_data The user data passed to PD_AsyncPredictorRun.
+///
+typedef void (*PD_AsyncCallback)(PD_Bool success, PD_AsyncRequest* pd_request,
+                                 void* user_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+/// \brief Create a new async predictor, with worker threads each owning a
+/// predictor. The predictors share the weights if possible.
+///
+/// \param[in] pd_config config
+/// \param[in] num_workers The number of the worker threads.
+/// \return new async predictor.
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_AsyncPredictor* PD_AsyncPredictorCreate(
+    __pd_take PD_Config* pd_config, size_t num_workers);
+///
+/// \brief Get the input names
+///
+/// \param[in] pd_predictor async predictor
+/// \return input names
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_OneDimArrayCstr*
+PD_AsyncPredictorGetInputNames(__pd_keep PD_AsyncPredictor* pd_predictor);
+///
+/// \brief Get the output names
+///
+/// \param[in] pd_predictor async predictor
+/// \return output names
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_OneDimArrayCstr*
+PD_AsyncPredictorGetOutputNames(__pd_keep PD_AsyncPredictor* pd_predictor);
+///
+/// \brief Queue a request and return at once. The outputs of the request are
+/// set before the callback is called. The request must not be used or
+/// destroyed until then.
+///
+/// \param[in] pd_predictor async predictor
+/// \param[in] pd_request The request with all the inputs set.
+/// \param[in] callback Called when the run is done.
+/// \param[in] user_data Passed to the callback.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncPredictorRun(
+    __pd_keep PD_AsyncPredictor* pd_predictor,
+    __pd_keep PD_AsyncRequest* pd_request, PD_AsyncCallback callback,
+    void* user_data);
+///
+/// \brief Destroy an async predictor, after the queued requests are done.
+///
+/// \param[in] pd_predictor async predictor
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncPredictorDestroy(
+    __pd_take PD_AsyncPredictor* pd_predictor);
+
+///
+/// \brief Create a new request, which holds the inputs and outputs of one
+/// async run. A request can be reused after its run is done.
+///
+/// \return new request.
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_AsyncRequest* PD_AsyncRequestCreate();
+///
+/// \brief Set an input of the request with 'float' data type. The data is
+/// not copied, so it must be alive until the run is done.
+///
+/// \param[in] pd_request request
+/// \param[in] name The input name.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the input.
+/// \param[in] data The data of the input.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestSetInputFloat(
+    __pd_keep PD_AsyncRequest* pd_request, const char* name, size_t shape_size,
+    int32_t* shape, float* data);
+///
+/// \brief Set an input of the request with 'int64_t' data type. The data is
+/// not copied, so it must be alive until the run is done.
+///
+/// \param[in] pd_request request
+/// \param[in] name The input name.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the input.
+/// \param[in] data The data of the input.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestSetInputInt64(
+    __pd_keep PD_AsyncRequest* pd_request, const char* name, size_t shape_size,
+    int32_t* shape, int64_t* data);
+///
+/// \brief Set an input of the request with 'int32_t' data type. The data is
+/// not copied, so it must be alive until the run is done.
+///
+/// \param[in] pd_request request
+/// \param[in] name The input name.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the input.
+/// \param[in] data The data of the input.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestSetInputInt32(
+    __pd_keep PD_AsyncRequest* pd_request, const char* name, size_t shape_size,
+    int32_t* shape, int32_t* data);
+///
+/// \brief Set an input of the request with 'uint8_t' data type. The data is
+/// not copied, so it must be alive until the run is done.
+///
+/// \param[in] pd_request request
+/// \param[in] name The input name.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the input.
+/// \param[in] data The data of the input.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestSetInputUint8(
+    __pd_keep PD_AsyncRequest* pd_request, const char* name, size_t shape_size,
+    int32_t* shape, uint8_t* data);
+///
+/// \brief Set an input of the request with 'int8_t' data type. The data is
+/// not copied, so it must be alive until the run is done.
+///
+/// \param[in] pd_request request
+/// \param[in] name The input name.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the input.
+/// \param[in] data The data of the input.
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestSetInputInt8(
+    __pd_keep PD_AsyncRequest* pd_request, const char* name, size_t shape_size,
+    int32_t* shape, int8_t* data);
+///
+/// \brief Get the output number of a finished run.
+///
+/// \param[in] pd_request request
+/// \return output number
+///
+PADDLE_CAPI_EXPORT extern size_t PD_AsyncRequestGetOutputNum(
+    __pd_keep PD_AsyncRequest* pd_request);
+///
+/// \brief Get the name of an output of a finished run.
+///
+/// \param[in] pd_request request
+/// \param[in] index The index of the output.
+/// \return The output name, owned by the request.
+///
+PADDLE_CAPI_EXPORT extern const char* PD_AsyncRequestGetOutputName(
+    __pd_keep PD_AsyncRequest* pd_request, size_t index);
+///
+/// \brief Get the shape of an output of a finished run.
+///
+/// \param[in] pd_request request
+/// \param[in] index The index of the output.
+/// \return The output shape.
+///
+PADDLE_CAPI_EXPORT extern __pd_give PD_OneDimArrayInt32*
+PD_AsyncRequestGetOutputShape(__pd_keep PD_AsyncRequest* pd_request,
+                              size_t index);
+///
+/// \brief Get the data type of an output of a finished run.
+///
+/// \param[in] pd_request request
+/// \param[in] index The index of the output.
+/// \return The output data type.
+///
+PADDLE_CAPI_EXPORT extern PD_DataType PD_AsyncRequestGetOutputDataType(
+    __pd_keep PD_AsyncRequest* pd_request, size_t index);
+///
+/// \brief Get the data of an output of a finished run. The data is owned by
+/// the request, and is valid until the request is run again or destroyed.
+///
+/// \param[in] pd_request request
+/// \param[in] index The index of the output.
+/// \param[out] size The number of the bytes of the data.
+/// \return The output data.
+///
+PADDLE_CAPI_EXPORT extern const void* PD_AsyncRequestGetOutputData(
+    __pd_keep PD_AsyncRequest* pd_request, size_t index, size_t* size);
+///
+/// \brief Destroy a request object
+///
+/// \param[in] pd_request request
+///
+PADDLE_CAPI_EXPORT extern void PD_AsyncRequestDestroy(
+    __pd_take PD_AsyncRequest* pd_request);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -14,9 +14,10 @@
 
 #pragma once
 
-#include "pd_common.h"     // NOLINT
-#include "pd_config.h"     // NOLINT
-#include "pd_predictor.h"  // NOLINT
-#include "pd_tensor.h"     // NOLINT
-#include "pd_types.h"      // NOLINT
-#include "pd_utils.h"      // NOLINT
+#include "pd_async_predictor.h"  // NOLINT
+#include "pd_common.h"           // NOLINT
+#include "pd_config.h"           // NOLINT
+#include "pd_predictor.h"        // NOLINT
+#include "pd_tensor.h"           // NOLINT
+#include "pd_types.h"            // NOLINT
+#include "pd_utils.h"            // NOLINT
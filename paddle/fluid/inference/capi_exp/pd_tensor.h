@@ -246,6 +246,96 @@ PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuUint8(
 PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuInt8(
     __pd_keep PD_Tensor* pd_tensor, int8_t* data);
 ///
+/// \brief Bind the tensor to the host memory with 'float' data type, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when the memory
+/// is large enough, so PD_TensorCopyToCpuFloat() is still needed, which skips
+/// the copy if the data is already there. The memory must outlive the runs,
+/// and the binding is released by the next PD_TensorReshape(),
+/// PD_TensorMutableData*() or PD_TensorCopyFromCpu*(). Only the CPU place is
+/// supported now.
+///
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The host memory, of at least the size of the shape.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape to set.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataFloat(
+    __pd_keep PD_Tensor* pd_tensor, float* data, size_t shape_size,
+    int32_t* shape);
+///
+/// \brief Bind the tensor to the host memory with 'int64_t' data type, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when the memory
+/// is large enough, so PD_TensorCopyToCpuInt64() is still needed, which skips
+/// the copy if the data is already there. The memory must outlive the runs,
+/// and the binding is released by the next PD_TensorReshape(),
+/// PD_TensorMutableData*() or PD_TensorCopyFromCpu*(). Only the CPU place is
+/// supported now.
+///
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The host memory, of at least the size of the shape.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape to set.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt64(
+    __pd_keep PD_Tensor* pd_tensor, int64_t* data, size_t shape_size,
+    int32_t* shape);
+///
+/// \brief Bind the tensor to the host memory with 'int32_t' data type, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when the memory
+/// is large enough, so PD_TensorCopyToCpuInt32() is still needed, which skips
+/// the copy if the data is already there. The memory must outlive the runs,
+/// and the binding is released by the next PD_TensorReshape(),
+/// PD_TensorMutableData*() or PD_TensorCopyFromCpu*(). Only the CPU place is
+/// supported now.
+///
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The host memory, of at least the size of the shape.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape to set.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt32(
+    __pd_keep PD_Tensor* pd_tensor, int32_t* data, size_t shape_size,
+    int32_t* shape);
+///
+/// \brief Bind the tensor to the host memory with 'uint8_t' data type, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when the memory
+/// is large enough, so PD_TensorCopyToCpuUint8() is still needed, which skips
+/// the copy if the data is already there. The memory must outlive the runs,
+/// and the binding is released by the next PD_TensorReshape(),
+/// PD_TensorMutableData*() or PD_TensorCopyFromCpu*(). Only the CPU place is
+/// supported now.
+///
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The host memory, of at least the size of the shape.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape to set.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataUint8(
+    __pd_keep PD_Tensor* pd_tensor, uint8_t* data, size_t shape_size,
+    int32_t* shape);
+///
+/// \brief Bind the tensor to the host memory with 'int8_t' data type, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when the memory
+/// is large enough, so PD_TensorCopyToCpuInt8() is still needed, which skips
+/// the copy if the data is already there. The memory must outlive the runs,
+/// and the binding is released by the next PD_TensorReshape(),
+/// PD_TensorMutableData*() or PD_TensorCopyFromCpu*(). Only the CPU place is
+/// supported now.
+///
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The host memory, of at least the size of the shape.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape to set.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt8(
+    __pd_keep PD_Tensor* pd_tensor, int8_t* data, size_t shape_size,
+    int32_t* shape);
+///
 /// \brief Get the tensor shape
 /// \param[in] pd_tensor tensor.
 /// \return The tensor shape.
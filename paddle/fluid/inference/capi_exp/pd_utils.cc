@@ -215,6 +215,8 @@ PD_DataType CvtFromCxxDatatype(DataType data_type) {
       return PD_DATA_INT32;
     case DataType::UINT8:
       return PD_DATA_UINT8;
+    case DataType::INT8:
+      return PD_DATA_INT8;
     default:
       return PD_DATA_UNK;
   }
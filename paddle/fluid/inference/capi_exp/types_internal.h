@@ -27,3 +27,12 @@ typedef struct PD_Tensor {
 typedef struct PD_Predictor {
   std::shared_ptr<paddle_infer::Predictor> predictor;
 } PD_Predictor;
+
+typedef struct PD_AsyncPredictor {
+  std::unique_ptr<paddle_infer::services::AsyncPredictor> predictor;
+} PD_AsyncPredictor;
+
+typedef struct PD_AsyncRequest {
+  std::vector<paddle::PaddleTensor> inputs;
+  std::vector<paddle::PaddleTensor> outputs;
+} PD_AsyncRequest;
@@ -29,6 +29,9 @@ import (
 
 type Predictor struct {
 	c *C.PD_Predictor
+	// The ExternalData bound to the tensors by name, which is kept alive as
+	// long as the tensors of the predictor may use it.
+	external map[string]*ExternalData
 }
 
 ///
@@ -39,7 +42,7 @@ type Predictor struct {
 ///
 func NewPredictor(config *Config) *Predictor {
 	cPredictor := C.PD_PredictorCreate(config.c)
-	predictor := &Predictor{c: cPredictor}
+	predictor := &Predictor{c: cPredictor, external: map[string]*ExternalData{}}
 	runtime.SetFinalizer(predictor, func(predictor *Predictor) {
 		C.PD_PredictorDestroy(predictor.c)
 	})
@@ -53,7 +56,7 @@ func NewPredictor(config *Config) *Predictor {
 ///
 func (p *Predictor) Clone() *Predictor {
 	cPredictor := C.PD_PredictorClone(p.c)
-	predictor := &Predictor{c: cPredictor}
+	predictor := &Predictor{c: cPredictor, external: map[string]*ExternalData{}}
 	runtime.SetFinalizer(predictor, func(predictor *Predictor) {
 		C.PD_PredictorDestroy(predictor.c)
 	})
@@ -114,7 +117,7 @@ func (p *Predictor) GetInputHandle(name string) *Tensor {
 	cName := C.CString(name)
 	cHandle := C.PD_PredictorGetInputHandle(p.c, cName)
 	C.free(unsafe.Pointer(cName))
-	handle := &Tensor{c: cHandle}
+	handle := &Tensor{c: cHandle, predictor: p}
 	runtime.SetFinalizer(handle, func(handle *Tensor) {
 		C.PD_TensorDestroy(handle.c)
 	})
@@ -131,7 +134,7 @@ func (p *Predictor) GetOutputHandle(name string) *Tensor {
 	cName := C.CString(name)
 	cHandle := C.PD_PredictorGetOutputHandle(p.c, cName)
 	C.free(unsafe.Pointer(cName))
-	handle := &Tensor{c: cHandle}
+	handle := &Tensor{c: cHandle, predictor: p}
 	runtime.SetFinalizer(handle, func(handle *Tensor) {
 		C.PD_TensorDestroy(handle.c)
 	})
@@ -108,6 +108,64 @@ func TestFromBuffer(t *testing.T) {
 	t.Log(outData)
 }
 
+func TestShareExternalData(t *testing.T) {
+	config := NewConfig()
+	config.SetModel("./mobilenetv1/inference.pdmodel", "./mobilenetv1/inference.pdiparams")
+	predictor := NewPredictor(config)
+	inNames := predictor.GetInputNames()
+	outNames := predictor.GetOutputNames()
+
+	inShape := []int32{1, 3, 224, 224}
+	inExternal, err := NewExternalData(Float32, int(numElements(inShape)))
+	if err != nil {
+		t.Fatal(err)
+	}
+	data := inExternal.Data().([]float32)
+	for i := range data {
+		data[i] = float32(i%255) * 0.1
+	}
+	inHandle := predictor.GetInputHandle(inNames[0])
+	if err := inHandle.ShareExternalData(inExternal, inShape); err != nil {
+		t.Fatal(err)
+	}
+	predictor.Run()
+	outHandle := predictor.GetOutputHandle(outNames[0])
+	outShape := outHandle.Shape()
+	expected := make([]float32, numElements(outShape))
+	outHandle.CopyToCpu(expected)
+
+	// Bind the output to the external data after its shape is known.
+	outExternal, err := NewExternalData(Float32, int(numElements(outShape)))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := outHandle.ShareExternalData(outExternal, outShape); err != nil {
+		t.Fatal(err)
+	}
+	predictor.Run()
+	outData := outExternal.Data().([]float32)
+	for i := range expected {
+		if outData[i] != expected[i] {
+			t.Fatalf("outData[%d] = %v, want %v", i, outData[i], expected[i])
+		}
+	}
+	outHandle.CopyToCpu(outData)
+
+	// The invalid bindings are rejected.
+	if err := outHandle.ShareExternalData(nil, outShape); err == nil {
+		t.Error("ShareExternalData(nil) succeeded")
+	}
+	if err := outHandle.ShareExternalData(outExternal, []int32{int32(len(outData)) + 1}); err == nil {
+		t.Error("ShareExternalData with a too small data succeeded")
+	}
+	if _, err := NewExternalData(Float32, 0); err == nil {
+		t.Error("NewExternalData of an empty data succeeded")
+	}
+	if _, err := NewExternalData(Unk, 1); err == nil {
+		t.Error("NewExternalData of an unsupported type succeeded")
+	}
+}
+
 func TestCollectShapeInfo(t *testing.T) {
 	config := NewConfig()
 	config.SetModel("./mobilenetv1/inference.pdmodel", "./mobilenetv1/inference.pdiparams")
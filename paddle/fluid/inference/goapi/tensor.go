@@ -23,6 +23,7 @@ import "C"
 import (
 	"fmt"
 	"reflect"
+	"runtime"
 	"unsafe"
 )
 
@@ -48,6 +49,8 @@ const (
 
 type Tensor struct {
 	c *C.PD_Tensor
+	// The predictor of the tensor, which keeps the bound ExternalData alive.
+	predictor *Predictor
 }
 
 ///
@@ -212,6 +215,153 @@ func (t *Tensor) CopyToCpu(value interface{}) {
 	}
 }
 
+///
+/// \brief The host memory allocated by C, which can be bound to a tensor with
+/// ShareExternalData. The memory of Go can not be kept by C across the calls,
+/// so the data shared with the predictor lives here instead of in a Go slice.
+/// The memory is freed when the ExternalData is garbage collected, which does
+/// not happen while it is bound to a tensor of a live predictor.
+///
+type ExternalData struct {
+	ptr   unsafe.Pointer
+	numel int
+	dtype DataType
+}
+
+// The max numel of an ExternalData, so its data fits in the array types used
+// to view it as a slice.
+const maxExternalDataNumel = 1 << 28
+
+func sizeOfDataType(dtype DataType) (int, error) {
+	switch dtype {
+	case Float32, Int32:
+		return 4, nil
+	case Int64:
+		return 8, nil
+	case Uint8, Int8:
+		return 1, nil
+	}
+	return 0, fmt.Errorf("unsupported data type %v", dtype)
+}
+
+///
+/// \brief Allocate the host memory for numel elements of the data type.
+///
+/// \param[in] dtype The data type of the elements.
+/// \param[in] numel The number of the elements, which should be positive.
+/// \return The ExternalData, or the error of an unsupported data type or an
+/// invalid numel.
+///
+func NewExternalData(dtype DataType, numel int) (*ExternalData, error) {
+	size, err := sizeOfDataType(dtype)
+	if err != nil {
+		return nil, err
+	}
+	if numel <= 0 || numel > maxExternalDataNumel {
+		return nil, fmt.Errorf("invalid numel %d of the external data", numel)
+	}
+	ptr := C.calloc(C.size_t(numel), C.size_t(size))
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to allocate %d bytes for the external data", numel*size)
+	}
+	data := &ExternalData{ptr: ptr, numel: numel, dtype: dtype}
+	runtime.SetFinalizer(data, func(data *ExternalData) {
+		C.free(data.ptr)
+	})
+	return data, nil
+}
+
+///
+/// \brief Get the data type of the elements.
+///
+func (d *ExternalData) Type() DataType {
+	return d.dtype
+}
+
+///
+/// \brief Get the number of the elements.
+///
+func (d *ExternalData) Numel() int {
+	return d.numel
+}
+
+///
+/// \brief Get the slice over the memory, which is one of []float32, []int32,
+/// []int64, []uint8 and []int8 by the data type. The slice is valid as long as
+/// the ExternalData is alive, the caller must keep a reference to the
+/// ExternalData while using it.
+///
+func (d *ExternalData) Data() interface{} {
+	n := d.numel
+	switch d.dtype {
+	case Float32:
+		return (*[maxExternalDataNumel]float32)(d.ptr)[:n:n]
+	case Int32:
+		return (*[maxExternalDataNumel]int32)(d.ptr)[:n:n]
+	case Int64:
+		return (*[maxExternalDataNumel]int64)(d.ptr)[:n:n]
+	case Uint8:
+		return (*[maxExternalDataNumel]uint8)(d.ptr)[:n:n]
+	case Int8:
+		return (*[maxExternalDataNumel]int8)(d.ptr)[:n:n]
+	}
+	return nil
+}
+
+///
+/// \brief Bind the tensor to the host memory of the ExternalData, without
+/// copy. The predictor reads the input from, or writes the output to, the
+/// memory directly. An output is only written to the memory when it is large
+/// enough, so CopyToCpu is still needed, which skips the copy if the data is
+/// already there. The ExternalData is kept alive by the predictor until the
+/// next ShareExternalData of the tensor with the same name. The binding is
+/// released by the next Reshape or CopyFromCpu. Only the CPU place is
+/// supported now.
+///
+/// \param[in] data The ExternalData, of at least the numel of the shape.
+/// \param[in] shape The shape of the tensor.
+/// \return The error of an invalid data or shape, in which case the tensor is
+/// not changed.
+///
+func (t *Tensor) ShareExternalData(data *ExternalData, shape []int32) error {
+	if data == nil {
+		return fmt.Errorf("the external data of tensor %s is nil", t.Name())
+	}
+	numel := 1
+	for _, dim := range shape {
+		if dim < 0 {
+			return fmt.Errorf("invalid shape %v of tensor %s", shape, t.Name())
+		}
+		numel *= int(dim)
+	}
+	if numel > data.numel {
+		return fmt.Errorf("the shape %v of tensor %s needs %d elements, but the external data has %d",
+			shape, t.Name(), numel, data.numel)
+	}
+	cShapeSize := C.size_t(len(shape))
+	var cShape *C.int32_t
+	if len(shape) > 0 {
+		cShape = (*C.int32_t)(unsafe.Pointer(&shape[0]))
+	}
+
+	switch data.dtype {
+	case Float32:
+		C.PD_TensorShareExternalDataFloat(t.c, (*C.float)(data.ptr), cShapeSize, cShape)
+	case Int32:
+		C.PD_TensorShareExternalDataInt32(t.c, (*C.int32_t)(data.ptr), cShapeSize, cShape)
+	case Int64:
+		C.PD_TensorShareExternalDataInt64(t.c, (*C.int64_t)(data.ptr), cShapeSize, cShape)
+	case Uint8:
+		C.PD_TensorShareExternalDataUint8(t.c, (*C.uint8_t)(data.ptr), cShapeSize, cShape)
+	case Int8:
+		C.PD_TensorShareExternalDataInt8(t.c, (*C.int8_t)(data.ptr), cShapeSize, cShape)
+	default:
+		return fmt.Errorf("unsupported data type %v of the external data", data.dtype)
+	}
+	t.predictor.external[t.Name()] = data
+	return nil
+}
+
 var types = []struct {
 	typ      reflect.Type
 	dataType C.PD_DataType
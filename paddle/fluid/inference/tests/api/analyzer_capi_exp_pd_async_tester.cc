@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "paddle/fluid/inference/capi_exp/pd_inference_api.h"
+#include "paddle/fluid/inference/tests/api/tester_helper.h"
+
+namespace paddle {
+namespace inference {
+namespace analysis {
+
+void on_done(PD_Bool success, PD_AsyncRequest* request, void* user_data) {
+  EXPECT_TRUE(success);
+  EXPECT_GT(PD_AsyncRequestGetOutputNum(request), 0UL);
+  reinterpret_cast<std::atomic<int>*>(user_data)->fetch_add(1);
+}
+
+void async_run(int worker_num, int request_num) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config, (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_AsyncPredictor* predictor = PD_AsyncPredictorCreate(config, worker_num);
+  PD_OneDimArrayCstr* input_names = PD_AsyncPredictorGetInputNames(predictor);
+
+  int32_t shapes[4] = {1, 3, 300, 300};
+  std::vector<float> input(1 * 3 * 300 * 300, 0);
+  std::vector<PD_AsyncRequest*> requests(request_num);
+  std::atomic<int> done_num{0};
+  for (int i = 0; i < request_num; ++i) {
+    requests[i] = PD_AsyncRequestCreate();
+    PD_AsyncRequestSetInputFloat(requests[i], input_names->data[0], 4, shapes,
+                                 input.data());
+    PD_AsyncPredictorRun(predictor, requests[i], on_done, &done_num);
+  }
+  // The queued requests are finished before the predictor is destroyed.
+  PD_AsyncPredictorDestroy(predictor);
+  ASSERT_EQ(done_num.load(), request_num);
+
+  size_t size0 = 0;
+  const float* out0 = reinterpret_cast<const float*>(
+      PD_AsyncRequestGetOutputData(requests[0], 0, &size0));
+  EXPECT_EQ(PD_AsyncRequestGetOutputDataType(requests[0], 0), PD_DATA_FLOAT32);
+  ASSERT_GT(size0, 0UL);
+  for (int i = 1; i < request_num; ++i) {
+    size_t size = 0;
+    const float* out = reinterpret_cast<const float*>(
+        PD_AsyncRequestGetOutputData(requests[i], 0, &size));
+    ASSERT_EQ(size, size0);
+    for (size_t j = 0; j < size / sizeof(float); ++j) {
+      ASSERT_EQ(out[j], out0[j]);
+    }
+  }
+  for (int i = 0; i < request_num; ++i) {
+    PD_AsyncRequestDestroy(requests[i]);
+  }
+  PD_OneDimArrayCstrDestroy(input_names);
+}
+
+TEST(PD_AsyncPredictor, PD_async_run) { async_run(4, 16); }
+
+}  // namespace analysis
+}  // namespace inference
+}  // namespace paddle
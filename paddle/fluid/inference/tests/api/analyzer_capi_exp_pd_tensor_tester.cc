@@ -169,6 +169,56 @@ TEST(PD_Tensor, uint8) {
   PD_PredictorDestroy(predictor);
 }
 
+TEST(PD_Tensor, share_external_data) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config, (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_Predictor* predictor = PD_PredictorCreate(config);
+  PD_OneDimArrayCstr* input_names = PD_PredictorGetInputNames(predictor);
+  PD_Tensor* tensor =
+      PD_PredictorGetInputHandle(predictor, input_names->data[0]);
+  int32_t shapes[4] = {1, 3, 300, 300};
+  std::vector<float> input(1 * 3 * 300 * 300, 0);
+  int32_t size;
+  PD_PlaceType place;
+  PD_TensorShareExternalDataFloat(tensor, input.data(), 4, shapes);
+  float* data_ptr = PD_TensorDataFloat(tensor, &place, &size);
+  EXPECT_EQ(data_ptr, input.data());
+  EXPECT_EQ(place, PD_PLACE_CPU);
+  EXPECT_EQ(size, 1 * 3 * 300 * 300);
+  PD_PredictorRun(predictor);
+
+  // Bind the output to the caller's memory after its shape is known.
+  PD_OneDimArrayCstr* output_names = PD_PredictorGetOutputNames(predictor);
+  PD_Tensor* output_tensor =
+      PD_PredictorGetOutputHandle(predictor, output_names->data[0]);
+  PD_OneDimArrayInt32* output_shape = PD_TensorGetShape(output_tensor);
+  int32_t out_num = std::accumulate(output_shape->data,
+                                    output_shape->data + output_shape->size, 1,
+                                    std::multiplies<int32_t>());
+  std::vector<float> expected(out_num);
+  PD_TensorCopyToCpuFloat(output_tensor, expected.data());
+  std::vector<float> out_data(out_num, 0);
+  PD_TensorShareExternalDataFloat(output_tensor, out_data.data(),
+                                  output_shape->size, output_shape->data);
+  PD_PredictorRun(predictor);
+  // The output stays in the bound buffer after the run.
+  EXPECT_EQ(PD_TensorDataFloat(output_tensor, &place, &size), out_data.data());
+  EXPECT_EQ(size, out_num);
+  for (int32_t i = 0; i < out_num; ++i) {
+    EXPECT_NEAR(out_data[i], expected[i], 1e-5);
+  }
+  PD_TensorCopyToCpuFloat(output_tensor, out_data.data());
+
+  PD_OneDimArrayInt32Destroy(output_shape);
+  PD_TensorDestroy(output_tensor);
+  PD_OneDimArrayCstrDestroy(output_names);
+  PD_TensorDestroy(tensor);
+  PD_OneDimArrayCstrDestroy(input_names);
+  PD_PredictorDestroy(predictor);
+}
+
 std::string read_file(std::string filename) {
   std::ifstream file(filename);
   return std::string((std::istreambuf_iterator<char>(file)),
@@ -0,0 +1,224 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/cpu_workspace_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+constexpr size_t CPUWorkspaceAllocator::kAlignment;
+constexpr size_t CPUWorkspaceAllocator::kMinChunkSize;
+
+CPUWorkspaceAllocation* CPUWorkspace::Allocate(size_t size) {
+  size_t aligned_size =
+      AlignedSize(std::max<size_t>(size, 1), CPUWorkspaceAllocator::kAlignment);
+  std::lock_guard<std::mutex> guard(mtx_);
+  size_t chunk = 0;
+  size_t offset = 0;
+  if (!blocks_.empty()) {
+    chunk = blocks_.back().chunk;
+    offset = blocks_.back().offset + blocks_.back().size;
+  }
+  if (chunk < chunks_.size() &&
+      offset + aligned_size > chunks_[chunk]->size()) {
+    ++chunk;
+    offset = 0;
+  }
+  if (chunk < chunks_.size() && aligned_size > chunks_[chunk]->size()) {
+    // The chunks above are unused, and too small.
+    chunks_.resize(chunk);
+  }
+  if (chunk == chunks_.size()) {
+    // Grow by at least the capacity, so that the stack needs few chunks.
+    size_t chunk_size =
+        std::max({aligned_size, reserved_size_, CapacityWithoutLock(),
+                  CPUWorkspaceAllocator::kMinChunkSize});
+    VLOG(10) << "CPUWorkspace allocates a chunk of " << chunk_size << " bytes";
+    chunks_.emplace_back(underlying_allocator_->Allocate(chunk_size));
+    reserved_size_ = 0;
+  }
+  blocks_.push_back({chunk, offset, aligned_size, false});
+  auto* ptr = static_cast<uint8_t*>(chunks_[chunk]->ptr()) + offset;
+  return new CPUWorkspaceAllocation(ptr, size, chunks_[chunk]->place(),
+                                    shared_from_this(), blocks_.size() - 1);
+}
+
+void CPUWorkspace::Free(CPUWorkspaceAllocation* allocation) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  blocks_[allocation->block()].freed = true;
+  while (!blocks_.empty() && blocks_.back().freed) {
+    blocks_.pop_back();
+  }
+  if (blocks_.empty() && chunks_.size() > 1) {
+    reserved_size_ = CapacityWithoutLock();
+    chunks_.clear();
+  }
+}
+
+uint64_t CPUWorkspace::Release() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  if (!blocks_.empty()) {
+    return 0;
+  }
+  uint64_t released = CapacityWithoutLock();
+  chunks_.clear();
+  reserved_size_ = 0;
+  return released;
+}
+
+size_t CPUWorkspace::Capacity() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  return CapacityWithoutLock();
+}
+
+size_t CPUWorkspace::NumBlocks() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  return blocks_.size();
+}
+
+size_t CPUWorkspace::CapacityWithoutLock() const {
+  size_t capacity = 0;
+  for (auto& chunk : chunks_) {
+    capacity += chunk->size();
+  }
+  return capacity;
+}
+
+// The live allocators, by id. Leaked, so that the thread_local caches of the
+// threads exiting after the static destruction can still use it.
+static std::mutex& RegistryMutex() {
+  static auto* mtx = new std::mutex();
+  return *mtx;
+}
+
+static std::unordered_map<uint64_t, CPUWorkspaceAllocator*>& Registry() {
+  static auto* registry =
+      new std::unordered_map<uint64_t, CPUWorkspaceAllocator*>();
+  return *registry;
+}
+
+// The workspaces of a thread, which are dropped from their allocators when
+// the thread exits.
+struct CPUWorkspaceAllocator::ThreadCache {
+  ~ThreadCache() {
+    auto thread_id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> guard(RegistryMutex());
+    for (auto& item : workspaces) {
+      auto iter = Registry().find(item.first);
+      if (iter == Registry().end()) {
+        continue;
+      }
+      auto* allocator = iter->second;
+      std::lock_guard<std::mutex> allocator_guard(allocator->mtx_);
+      allocator->workspaces_.erase(thread_id);
+    }
+  }
+
+  using Entry = std::pair<uint64_t, std::weak_ptr<CPUWorkspace>>;
+  std::vector<Entry> workspaces;
+};
+
+CPUWorkspaceAllocator::CPUWorkspaceAllocator(
+    std::shared_ptr<Allocator> underlying_allocator)
+    : underlying_allocator_(std::move(underlying_allocator)) {
+  static std::atomic<uint64_t> next_id{0};
+  id_ = next_id++;
+  std::lock_guard<std::mutex> guard(RegistryMutex());
+  Registry()[id_] = this;
+}
+
+CPUWorkspaceAllocator::~CPUWorkspaceAllocator() {
+  std::lock_guard<std::mutex> guard(RegistryMutex());
+  Registry().erase(id_);
+}
+
+std::shared_ptr<CPUWorkspace> CPUWorkspaceAllocator::ThreadWorkspace() {
+  thread_local ThreadCache cache;
+  for (auto& item : cache.workspaces) {
+    if (item.first == id_) {
+      auto workspace = item.second.lock();
+      if (workspace != nullptr) {
+        return workspace;
+      }
+      break;
+    }
+  }
+
+  // The first allocation of the thread.
+  std::shared_ptr<CPUWorkspace> workspace;
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    auto& thread_workspace = workspaces_[std::this_thread::get_id()];
+    if (thread_workspace == nullptr) {
+      thread_workspace = std::make_shared<CPUWorkspace>(underlying_allocator_);
+    }
+    workspace = thread_workspace;
+  }
+  // Drops the entries of the allocators destroyed.
+  auto& entries = cache.workspaces;
+  entries.erase(
+      std::remove_if(entries.begin(), entries.end(),
+                     [this](const ThreadCache::Entry& item) {
+                       return item.first == id_ || item.second.expired();
+                     }),
+      entries.end());
+  entries.emplace_back(id_, workspace);
+  return workspace;
+}
+
+size_t CPUWorkspaceAllocator::NumWorkspaces() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  return workspaces_.size();
+}
+
+uint64_t CPUWorkspaceAllocator::ReleaseAll() {
+  std::lock_guard<std::mutex> guard(RegistryMutex());
+  uint64_t released = 0;
+  for (auto& item : Registry()) {
+    released += item.second->Release(platform::CPUPlace());
+  }
+  return released;
+}
+
+Allocation* CPUWorkspaceAllocator::AllocateImpl(size_t size) {
+  return ThreadWorkspace()->Allocate(size);
+}
+
+void CPUWorkspaceAllocator::FreeImpl(Allocation* allocation) {
+  auto* workspace_allocation = static_cast<CPUWorkspaceAllocation*>(allocation);
+  // Keeps the workspace alive until the allocation is deleted.
+  auto workspace = workspace_allocation->workspace();
+  workspace->Free(workspace_allocation);
+  delete workspace_allocation;
+}
+
+uint64_t CPUWorkspaceAllocator::ReleaseImpl(const platform::Place& place) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  uint64_t released = 0;
+  for (auto& item : workspaces_) {
+    released += item.second->Release();
+  }
+  return released;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,131 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CPUWorkspace;
+
+class CPUWorkspaceAllocation : public Allocation {
+ public:
+  CPUWorkspaceAllocation(void* ptr, size_t size, platform::Place place,
+                         std::shared_ptr<CPUWorkspace> workspace, size_t block)
+      : Allocation(ptr, size, place),
+        workspace_(std::move(workspace)),
+        block_(block) {}
+
+  const std::shared_ptr<CPUWorkspace>& workspace() const { return workspace_; }
+  size_t block() const { return block_; }
+
+ private:
+  std::shared_ptr<CPUWorkspace> workspace_;
+  size_t block_;
+};
+
+// The scratch memory of one thread, allocated like a stack. The allocations
+// are placed on the top of the stack, and the top is lowered as soon as the
+// allocations on it are freed, so that the scratch memory freed by a kernel
+// is reused by the next one without any system allocation. An allocation
+// freed out of order is reclaimed when all the ones above it are freed.
+// The stack grows by new chunks, which are merged into one chunk of the peak
+// size the next time the stack is empty.
+class CPUWorkspace : public std::enable_shared_from_this<CPUWorkspace> {
+ public:
+  explicit CPUWorkspace(std::shared_ptr<Allocator> underlying_allocator)
+      : underlying_allocator_(std::move(underlying_allocator)) {}
+
+  CPUWorkspaceAllocation* Allocate(size_t size);
+  void Free(CPUWorkspaceAllocation* allocation);
+  // Frees the chunks if the stack is empty, returns the bytes freed.
+  uint64_t Release();
+
+  // The bytes of the chunks.
+  size_t Capacity();
+  // The number of the allocations not reclaimed yet.
+  size_t NumBlocks();
+
+ private:
+  struct Block {
+    size_t chunk;
+    size_t offset;
+    size_t size;
+    bool freed;
+  };
+
+  size_t CapacityWithoutLock() const;
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  std::mutex mtx_;
+  std::vector<AllocationPtr> chunks_;
+  std::vector<Block> blocks_;
+  // The size of the chunk to allocate when the stack is used next time.
+  size_t reserved_size_{0};
+};
+
+// Allocates from the CPUWorkspace of the calling thread. The allocations can
+// be freed on any thread. The workspace of a thread is cached in a
+// thread_local, so allocating takes no lock shared among the threads, and it
+// is dropped when the thread exits. The chunks of all the allocators are
+// released by memory::Release of CPUPlace.
+class CPUWorkspaceAllocator : public Allocator {
+ public:
+  explicit CPUWorkspaceAllocator(
+      std::shared_ptr<Allocator> underlying_allocator);
+
+  ~CPUWorkspaceAllocator();
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  std::shared_ptr<CPUWorkspace> ThreadWorkspace();
+
+  // The number of the threads holding a workspace of the allocator.
+  size_t NumWorkspaces();
+
+  // Releases the free chunks of all the CPUWorkspaceAllocators, returns the
+  // bytes freed.
+  static uint64_t ReleaseAll();
+
+  constexpr static size_t kAlignment = 64UL;
+  constexpr static size_t kMinChunkSize = 64UL << 10;
+
+ protected:
+  Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(Allocation* allocation) override;
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  struct ThreadCache;
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  // Unique among the allocators, unlike the address.
+  uint64_t id_;
+  std::mutex mtx_;
+  std::unordered_map<std::thread::id, std::shared_ptr<CPUWorkspace>>
+      workspaces_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/cpu_workspace_allocator.h"
+
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(CPUWorkspaceAllocator, stack) {
+  CPUWorkspaceAllocator allocator(std::make_shared<CPUAllocator>());
+  auto workspace = allocator.ThreadWorkspace();
+
+  void* first = nullptr;
+  {
+    auto a = allocator.Allocate(100);
+    auto b = allocator.Allocate(10);
+    first = a->ptr();
+    EXPECT_EQ(a->size(), 100UL);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a->ptr()) %
+                  CPUWorkspaceAllocator::kAlignment,
+              0UL);
+    EXPECT_EQ(static_cast<uint8_t*>(b->ptr()),
+              static_cast<uint8_t*>(a->ptr()) + 128);
+    EXPECT_EQ(workspace->NumBlocks(), 2UL);
+  }
+  // Released at the end of the scope, and reused by the next allocation.
+  EXPECT_EQ(workspace->NumBlocks(), 0UL);
+  auto c = allocator.Allocate(64);
+  EXPECT_EQ(c->ptr(), first);
+}
+
+TEST(CPUWorkspaceAllocator, free_out_of_order) {
+  CPUWorkspaceAllocator allocator(std::make_shared<CPUAllocator>());
+  auto workspace = allocator.ThreadWorkspace();
+
+  auto a = allocator.Allocate(64);
+  auto b = allocator.Allocate(64);
+  a.reset();
+  // a is below b, so it is reclaimed after b is freed.
+  EXPECT_EQ(workspace->NumBlocks(), 2UL);
+  b.reset();
+  EXPECT_EQ(workspace->NumBlocks(), 0UL);
+}
+
+TEST(CPUWorkspaceAllocator, grow_and_merge) {
+  CPUWorkspaceAllocator allocator(std::make_shared<CPUAllocator>());
+  auto workspace = allocator.ThreadWorkspace();
+
+  size_t peak = 0;
+  {
+    auto a = allocator.Allocate(1 << 10);
+    size_t capacity = workspace->Capacity();
+    // Does not fit in the first chunk, which is still used by a.
+    auto b = allocator.Allocate(capacity);
+    peak = workspace->Capacity();
+    EXPECT_GT(peak, capacity);
+  }
+  {
+    // Merged into one chunk, which holds both of them.
+    auto a = allocator.Allocate(1 << 10);
+    auto b = allocator.Allocate(1 << 10);
+    EXPECT_EQ(workspace->Capacity(), peak);
+    EXPECT_EQ(static_cast<uint8_t*>(b->ptr()),
+              static_cast<uint8_t*>(a->ptr()) + (1 << 10));
+  }
+  EXPECT_EQ(allocator.Release(platform::CPUPlace()), peak);
+  EXPECT_EQ(workspace->Capacity(), 0UL);
+}
+
+TEST(CPUWorkspaceAllocator, per_thread) {
+  CPUWorkspaceAllocator allocator(std::make_shared<CPUAllocator>());
+  auto a = allocator.Allocate(64);
+  AllocationPtr b;
+  std::shared_ptr<CPUWorkspace> other;
+  std::thread thread([&] {
+    b = allocator.Allocate(64);
+    other = allocator.ThreadWorkspace();
+  });
+  thread.join();
+  EXPECT_NE(other, allocator.ThreadWorkspace());
+  // The workspace of the exited thread is dropped, and kept alive by b.
+  EXPECT_EQ(allocator.NumWorkspaces(), 1UL);
+  EXPECT_EQ(other->NumBlocks(), 1UL);
+  // Freed on another thread.
+  b.reset();
+  EXPECT_EQ(other->NumBlocks(), 0UL);
+}
+
+TEST(CPUWorkspaceAllocator, release_all) {
+  CPUWorkspaceAllocator allocator(std::make_shared<CPUAllocator>());
+  auto workspace = allocator.ThreadWorkspace();
+  auto a = allocator.Allocate(64);
+  size_t capacity = workspace->Capacity();
+  // The chunks in use are kept.
+  CPUWorkspaceAllocator::ReleaseAll();
+  EXPECT_EQ(workspace->Capacity(), capacity);
+  a.reset();
+  EXPECT_GE(CPUWorkspaceAllocator::ReleaseAll(), capacity);
+  EXPECT_EQ(workspace->Capacity(), 0UL);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/memory/malloc.h"
 
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
+#include "paddle/fluid/memory/allocation/cpu_workspace_allocator.h"
 #include "paddle/fluid/platform/place.h"
 
 namespace paddle {
@@ -30,7 +31,12 @@ AllocationPtr Alloc(const platform::Place &place, size_t size) {
 }
 
 uint64_t Release(const platform::Place &place) {
-  return allocation::AllocatorFacade::Instance().Release(place);
+  uint64_t released = allocation::AllocatorFacade::Instance().Release(place);
+  if (platform::is_cpu_place(place)) {
+    // The scratch workspaces of the CPU kernels.
+    released += allocation::CPUWorkspaceAllocator::ReleaseAll();
+  }
+  return released;
 }
 
 }  // namespace memory
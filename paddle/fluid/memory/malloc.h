@@ -38,6 +38,14 @@ extern AllocationPtr Alloc(const platform::Place& place, size_t size);
 
 extern AllocationPtr Alloc(const platform::DeviceContext& dev_ctx, size_t size);
 
+// Allocates the scratch memory of a kernel, which is taken from the workspace
+// of the calling thread on CPU and reused as soon as it is freed, without any
+// system allocation once the workspace is large enough. Only meant for the
+// temporary buffers freed at the end of the kernel; on the other devices it is
+// the same as Alloc.
+extern AllocationPtr AllocScratch(const platform::DeviceContext& dev_ctx,
+                                  size_t size);
+
 extern uint64_t Release(const platform::Place& place);
 
 }  // namespace memory
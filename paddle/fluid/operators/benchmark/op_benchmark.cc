@@ -0,0 +1,207 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/benchmark/op_benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <utility>
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace operators {
+namespace benchmark {
+
+double OpBenchmarkResult::GBps() const {
+  return p50_ms > 0 ? bytes / (p50_ms * 1e6) : 0.0;
+}
+
+double OpBenchmarkResult::GFLOPs() const {
+  return p50_ms > 0 ? flops / (p50_ms * 1e6) : 0.0;
+}
+
+static std::string JsonEscape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+std::string OpBenchmarkResult::ToJson() const {
+  std::ostringstream os;
+  os.precision(6);
+  os << std::fixed;
+  os << "{\"name\": \"" << JsonEscape(name) << "\", \"op_type\": \""
+     << JsonEscape(op_type) << "\", \"num_threads\": " << num_threads
+     << ", \"warmup\": " << warmup << ", \"repeat\": " << repeat
+     << ", \"mean_ms\": " << mean_ms << ", \"min_ms\": " << min_ms
+     << ", \"max_ms\": " << max_ms << ", \"stddev_ms\": " << stddev_ms
+     << ", \"p50_ms\": " << p50_ms << ", \"p90_ms\": " << p90_ms
+     << ", \"p99_ms\": " << p99_ms << ", \"bytes\": " << bytes
+     << ", \"flops\": " << flops << ", \"GBps\": " << GBps()
+     << ", \"GFLOPs\": " << GFLOPs() << "}";
+  return os.str();
+}
+
+// The nearest-rank percentile of the sorted samples.
+static double Percentile(const std::vector<double>& sorted, double percent) {
+  size_t rank = static_cast<size_t>(
+      std::ceil(percent / 100.0 * static_cast<double>(sorted.size())));
+  rank = std::max<size_t>(rank, 1);
+  return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+void ComputeLatencyStats(std::vector<double> samples_ms,
+                         OpBenchmarkResult* result) {
+  PADDLE_ENFORCE_GT(samples_ms.size(), 0U,
+                    platform::errors::InvalidArgument(
+                        "The latency samples of the benchmark are empty."));
+  std::sort(samples_ms.begin(), samples_ms.end());
+  double sum = 0.0;
+  for (double sample : samples_ms) {
+    sum += sample;
+  }
+  double mean = sum / samples_ms.size();
+  double square_sum = 0.0;
+  for (double sample : samples_ms) {
+    square_sum += (sample - mean) * (sample - mean);
+  }
+
+  result->repeat = static_cast<int>(samples_ms.size());
+  result->mean_ms = mean;
+  result->min_ms = samples_ms.front();
+  result->max_ms = samples_ms.back();
+  result->stddev_ms = std::sqrt(square_sum / samples_ms.size());
+  result->p50_ms = Percentile(samples_ms, 50);
+  result->p90_ms = Percentile(samples_ms, 90);
+  result->p99_ms = Percentile(samples_ms, 99);
+}
+
+void SaveBenchmarkResults(const std::vector<OpBenchmarkResult>& results,
+                          const std::string& filename) {
+  std::ofstream fout(filename);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fout), true,
+      platform::errors::Unavailable("Cannot open %s to save the benchmark "
+                                    "results.",
+                                    filename));
+  fout << "{\n\"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    fout << results[i].ToJson() << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  fout << "]\n}\n";
+}
+
+// Find the value of key in a line written by OpBenchmarkResult::ToJson.
+static bool FindJsonValue(const std::string& line, const std::string& key,
+                          std::string* value) {
+  std::string pattern = "\"" + key + "\": ";
+  size_t pos = line.find(pattern);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  pos += pattern.size();
+  value->clear();
+  if (pos < line.size() && line[pos] == '"') {
+    for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+      if (line[pos] == '\\') {
+        ++pos;
+      }
+      if (pos < line.size()) {
+        *value += line[pos];
+      }
+    }
+  } else {
+    size_t end = line.find_first_of(",}", pos);
+    *value = line.substr(pos, end - pos);
+  }
+  return true;
+}
+
+std::vector<OpBenchmarkResult> LoadBenchmarkResults(
+    const std::string& filename) {
+  std::ifstream fin(filename);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fin), true,
+      platform::errors::NotFound("Cannot open the benchmark results %s.",
+                                 filename));
+  std::vector<OpBenchmarkResult> results;
+  std::string line;
+  while (std::getline(fin, line)) {
+    OpBenchmarkResult result;
+    std::string value;
+    if (!FindJsonValue(line, "name", &result.name)) {
+      continue;
+    }
+    FindJsonValue(line, "op_type", &result.op_type);
+    std::map<std::string, double*> fields = {
+        {"mean_ms", &result.mean_ms},     {"min_ms", &result.min_ms},
+        {"max_ms", &result.max_ms},       {"stddev_ms", &result.stddev_ms},
+        {"p50_ms", &result.p50_ms},       {"p90_ms", &result.p90_ms},
+        {"p99_ms", &result.p99_ms},       {"bytes", &result.bytes},
+        {"flops", &result.flops}};
+    for (auto& field : fields) {
+      if (FindJsonValue(line, field.first, &value)) {
+        *field.second = std::stod(value);
+      }
+    }
+    if (FindJsonValue(line, "num_threads", &value)) {
+      result.num_threads = std::stoi(value);
+    }
+    if (FindJsonValue(line, "warmup", &value)) {
+      result.warmup = std::stoi(value);
+    }
+    if (FindJsonValue(line, "repeat", &value)) {
+      result.repeat = std::stoi(value);
+    }
+    results.push_back(result);
+  }
+  return results;
+}
+
+std::vector<std::string> CompareWithBaseline(
+    const std::vector<OpBenchmarkResult>& results,
+    const std::vector<OpBenchmarkResult>& baseline, double threshold) {
+  std::map<std::pair<std::string, int>, const OpBenchmarkResult*> base_map;
+  for (auto& result : baseline) {
+    base_map[std::make_pair(result.name, result.num_threads)] = &result;
+  }
+
+  std::vector<std::string> regressions;
+  for (auto& result : results) {
+    auto it = base_map.find(std::make_pair(result.name, result.num_threads));
+    if (it == base_map.end() || it->second->p50_ms <= 0) {
+      continue;
+    }
+    double ratio = result.p50_ms / it->second->p50_ms;
+    if (ratio > 1.0 + threshold) {
+      std::ostringstream os;
+      os << result.name << " (" << result.num_threads
+         << " threads): p50 latency " << it->second->p50_ms << " ms -> "
+         << result.p50_ms << " ms, " << (ratio - 1.0) * 100 << "% slower";
+      regressions.push_back(os.str());
+    }
+  }
+  return regressions;
+}
+
+}  // namespace benchmark
+}  // namespace operators
+}  // namespace paddle
@@ -0,0 +1,72 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace operators {
+namespace benchmark {
+
+struct OpBenchmarkResult {
+  std::string name;  // name of the config, op_type if not set
+  std::string op_type;
+  int num_threads{1};
+  int warmup{0};
+  int repeat{0};
+
+  // latency of a run in ms
+  double mean_ms{0.0};
+  double min_ms{0.0};
+  double max_ms{0.0};
+  double stddev_ms{0.0};
+  double p50_ms{0.0};
+  double p90_ms{0.0};
+  double p99_ms{0.0};
+
+  // bytes of the inputs and outputs, and floating-point operations of a run,
+  // 0 if unknown
+  double bytes{0.0};
+  double flops{0.0};
+
+  // throughput at the median latency
+  double GBps() const;
+  double GFLOPs() const;
+
+  std::string ToJson() const;
+};
+
+// Fill the latency statistics of result from the latencies of the runs.
+void ComputeLatencyStats(std::vector<double> samples_ms,
+                         OpBenchmarkResult* result);
+
+// The results are saved one per line, so that the files of two builds can be
+// compared by diff.
+void SaveBenchmarkResults(const std::vector<OpBenchmarkResult>& results,
+                          const std::string& filename);
+std::vector<OpBenchmarkResult> LoadBenchmarkResults(
+    const std::string& filename);
+
+// Returns the descriptions of the results whose median latency is larger
+// than that of the baseline result with the same name and num_threads by
+// more than threshold, e.g. 0.1 for 10%.
+std::vector<std::string> CompareWithBaseline(
+    const std::vector<OpBenchmarkResult>& results,
+    const std::vector<OpBenchmarkResult>& baseline, double threshold);
+
+}  // namespace benchmark
+}  // namespace operators
+}  // namespace paddle
@@ -0,0 +1,75 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/benchmark/op_benchmark.h"
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace operators {
+namespace benchmark {
+
+TEST(op_benchmark, latency_stats) {
+  std::vector<double> samples;
+  for (int i = 100; i > 0; --i) {
+    samples.push_back(static_cast<double>(i));
+  }
+  OpBenchmarkResult result;
+  result.bytes = 50.0 * 1e6;
+  result.flops = 100.0 * 1e6;
+  ComputeLatencyStats(samples, &result);
+  EXPECT_EQ(result.repeat, 100);
+  EXPECT_DOUBLE_EQ(result.mean_ms, 50.5);
+  EXPECT_DOUBLE_EQ(result.min_ms, 1.0);
+  EXPECT_DOUBLE_EQ(result.max_ms, 100.0);
+  EXPECT_DOUBLE_EQ(result.p50_ms, 50.0);
+  EXPECT_DOUBLE_EQ(result.p90_ms, 90.0);
+  EXPECT_DOUBLE_EQ(result.p99_ms, 99.0);
+  EXPECT_NEAR(result.stddev_ms, 28.866, 1e-3);
+  EXPECT_DOUBLE_EQ(result.GBps(), 1.0);
+  EXPECT_DOUBLE_EQ(result.GFLOPs(), 2.0);
+}
+
+TEST(op_benchmark, save_load_compare) {
+  std::vector<OpBenchmarkResult> baseline(2);
+  baseline[0].name = "softmax_\"large\"";
+  baseline[0].op_type = "softmax";
+  ComputeLatencyStats({1.0, 2.0, 3.0}, &baseline[0]);
+  baseline[1] = baseline[0];
+  baseline[1].num_threads = 4;
+  baseline[1].bytes = 1024;
+
+  std::string filename = "op_benchmark_test.json";
+  SaveBenchmarkResults(baseline, filename);
+  std::vector<OpBenchmarkResult> loaded = LoadBenchmarkResults(filename);
+  ASSERT_EQ(loaded.size(), 2U);
+  EXPECT_EQ(loaded[0].name, baseline[0].name);
+  EXPECT_EQ(loaded[0].op_type, "softmax");
+  EXPECT_EQ(loaded[1].num_threads, 4);
+  EXPECT_EQ(loaded[1].repeat, 3);
+  EXPECT_DOUBLE_EQ(loaded[1].p50_ms, 2.0);
+  EXPECT_DOUBLE_EQ(loaded[1].bytes, 1024);
+  EXPECT_TRUE(CompareWithBaseline(loaded, baseline, 0.1).empty());
+
+  std::vector<OpBenchmarkResult> results = loaded;
+  results[1].p50_ms = 2.5;
+  std::vector<std::string> regressions =
+      CompareWithBaseline(results, baseline, 0.1);
+  ASSERT_EQ(regressions.size(), 1U);
+  EXPECT_NE(regressions[0].find("4 threads"), std::string::npos);
+  EXPECT_TRUE(CompareWithBaseline(results, baseline, 0.3).empty());
+}
+
+}  // namespace benchmark
+}  // namespace operators
+}  // namespace paddle
@@ -13,12 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "paddle/fluid/operators/benchmark/op_tester.h"
+#include <chrono>  // NOLINT
 #include <fstream>
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/op_info.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/variable_helper.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/init.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/timer.h"
@@ -30,6 +32,28 @@ namespace benchmark {
 
 DEFINE_string(op_config_list, "", "Path of op config file.");
 DEFINE_int32(specified_config_id, -1, "Test the specified op config.");
+DEFINE_string(op_bench_num_threads, "",
+              "Comma separated numbers of CPU math library threads to "
+              "benchmark the ops with, e.g. 1,2,4. Use num_threads of the op "
+              "configs if empty.");
+DEFINE_string(op_bench_json, "", "Path to save the benchmark results.");
+DEFINE_string(op_bench_baseline, "",
+              "Path of the benchmark results of a previous build to compare "
+              "with, the test fails if any op regresses.");
+DEFINE_double(op_bench_regression_threshold, 0.1,
+              "The ratio of the median latency over that of the baseline, "
+              "above which an op is regarded as regressed.");
+
+template <typename T>
+static std::vector<T> StringToVector(const std::string &str) {
+  std::vector<T> values;
+  std::string token;
+  std::istringstream token_stream(str);
+  while (std::getline(token_stream, token, ',')) {
+    values.push_back(StringTo<T>(token));
+  }
+  return values;
+}
 
 void OpTester::Init(const std::string &filename) {
   Init(OpTesterConfig(filename));
@@ -70,7 +94,9 @@ void OpTester::Run() {
   }
 
   // Warm up
-  RunImpl();
+  for (int i = 0; i < config_.warmup; ++i) {
+    RunImpl();
+  }
 
   platform::Timer timer;
   if (config_.profile) {
@@ -105,18 +131,101 @@ void OpTester::Run() {
             << " times, latency: " << config_.runtime << " ms ===";
 }
 
+OpBenchmarkResult OpTester::Benchmark(int num_threads) {
+  platform::SetNumThreads(num_threads);
+  for (int i = 0; i < config_.warmup; ++i) {
+    RunImpl();
+  }
+
+  std::vector<double> samples_ms;
+  samples_ms.reserve(config_.repeat);
+  for (int i = 0; i < config_.repeat; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    RunImpl();
+    auto end = std::chrono::steady_clock::now();
+    samples_ms.push_back(
+        std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  OpBenchmarkResult result;
+  result.name = config_.name.empty() ? type_ : config_.name;
+  result.op_type = type_;
+  result.num_threads = num_threads;
+  result.warmup = config_.warmup;
+  ComputeLatencyStats(samples_ms, &result);
+  result.bytes = GetMemoryBytes();
+  result.flops = GetFlops();
+  LOG(INFO) << "=== " << result.name << ", " << num_threads
+            << " threads, latency p50: " << result.p50_ms
+            << " ms, p99: " << result.p99_ms << " ms, " << result.GBps()
+            << " GB/s, " << result.GFLOPs() << " GFLOP/s ===";
+  return result;
+}
+
 void OpTester::RunImpl() {
   op_->Run(*scope_, place_);
   platform::DeviceContextPool::Instance().Get(place_)->Wait();
   scope_->DropKids();
 }
 
+static const framework::LoDTensor *FindTensor(
+    const framework::Scope &scope, const std::vector<std::string> &names) {
+  if (names.empty()) {
+    return nullptr;
+  }
+  auto *var = scope.FindVar(names[0]);
+  if (var == nullptr || !var->IsType<framework::LoDTensor>() ||
+      !var->Get<framework::LoDTensor>().IsInitialized()) {
+    return nullptr;
+  }
+  return &var->Get<framework::LoDTensor>();
+}
+
+double OpTester::GetMemoryBytes() {
+  double bytes = 0;
+  std::vector<std::string> names = op_desc_.InputArgumentNames();
+  for (auto &name : op_desc_.OutputArgumentNames()) {
+    names.push_back(name);
+  }
+  for (auto &name : names) {
+    auto *tensor = FindTensor(*scope_, {name});
+    if (tensor != nullptr) {
+      bytes += tensor->numel() * framework::SizeOfType(tensor->type());
+    }
+  }
+  return bytes;
+}
+
+// Only the compute-bound ops are counted, the others are measured by the
+// memory throughput.
+double OpTester::GetFlops() {
+  if (type_ == "fc") {
+    auto *out = FindTensor(*scope_, op_desc_.Output("Out"));
+    auto *w = FindTensor(*scope_, op_desc_.Input("W"));
+    if (out != nullptr && w != nullptr) {
+      return 2.0 * out->numel() * w->dims()[0];
+    }
+  } else if (type_ == "conv2d" || type_ == "depthwise_conv2d") {
+    // The shape of Filter is [C_out, C_in / groups, H_f, W_f].
+    auto *out = FindTensor(*scope_, op_desc_.Output("Output"));
+    auto *filter = FindTensor(*scope_, op_desc_.Input("Filter"));
+    if (out != nullptr && filter != nullptr) {
+      return 2.0 * out->numel() * (filter->numel() / filter->dims()[0]);
+    }
+  }
+  return 0.0;
+}
+
 std::vector<std::string> OpTester::GetOpProtoInputNames() {
   std::vector<std::string> input_names;
   const framework::proto::OpProto &proto =
       framework::OpInfoMap::Instance().Get(type_).Proto();
   for (int i = 0; i != proto.inputs_size(); ++i) {
     const auto &input = proto.inputs(i);
+    // The dispensable inputs are only created if they are configured.
+    if (input.dispensable() && config_.GetInput(input.name()) == nullptr) {
+      continue;
+    }
     input_names.push_back(input.name());
   }
   return input_names;
@@ -219,8 +328,10 @@ void OpTester::CreateOpDesc() {
     const std::string &value_str = item.second;
     const framework::proto::AttrType &type = attr_types[name];
     switch (type) {
-      case framework::proto::AttrType::BOOLEAN:
-        break;
+      case framework::proto::AttrType::BOOLEAN: {
+        bool value = value_str == "true" || value_str == "1";
+        op_desc_.SetAttr(name, value);
+      } break;
       case framework::proto::AttrType::INT: {
         int value = StringTo<int>(value_str);
         op_desc_.SetAttr(name, {value});
@@ -232,9 +343,13 @@ void OpTester::CreateOpDesc() {
       case framework::proto::AttrType::STRING: {
         op_desc_.SetAttr(name, {value_str});
       } break;
+      case framework::proto::AttrType::INTS: {
+        op_desc_.SetAttr(name, StringToVector<int>(value_str));
+      } break;
+      case framework::proto::AttrType::FLOATS: {
+        op_desc_.SetAttr(name, StringToVector<float>(value_str));
+      } break;
       case framework::proto::AttrType::BOOLEANS:
-      case framework::proto::AttrType::INTS:
-      case framework::proto::AttrType::FLOATS:
       case framework::proto::AttrType::STRINGS:
         PADDLE_THROW(platform::errors::Unimplemented(
             "Unsupported STRINGS type in OpTester yet."));
@@ -282,21 +397,22 @@ void OpTester::SetupTensor(framework::LoDTensor *tensor,
     cpu_ptr = ptr;
   }
 
+  int64_t numel = tensor->numel();
   if (initializer == "random") {
-    for (int i = 0; i < cpu_tensor.numel(); ++i) {
+    for (int64_t i = 0; i < numel; ++i) {
       cpu_ptr[i] = static_cast<T>(uniform_dist(rng) * (upper - lower) + lower);
     }
   } else if (initializer == "natural") {
-    for (int i = 0; i < cpu_tensor.numel(); ++i) {
+    for (int64_t i = 0; i < numel; ++i) {
       cpu_ptr[i] = static_cast<T>(lower + i);
     }
   } else if (initializer == "zeros") {
-    for (int i = 0; i < cpu_tensor.numel(); ++i) {
+    for (int64_t i = 0; i < numel; ++i) {
       cpu_ptr[i] = static_cast<T>(0);
     }
   } else if (initializer == "file") {
     std::ifstream is(filename);
-    for (int i = 0; i < cpu_tensor.numel(); ++i) {
+    for (int64_t i = 0; i < numel; ++i) {
       T value;
       is >> value;
       cpu_ptr[i] = static_cast<T>(value);
@@ -488,7 +604,48 @@ std::string OpTester::DebugString() {
   return ss.str();
 }
 
+static bool IsBenchmarkMode() {
+  return !FLAGS_op_bench_num_threads.empty() || !FLAGS_op_bench_json.empty() ||
+         !FLAGS_op_bench_baseline.empty();
+}
+
+static void RunOpTester(const OpTesterConfig &config,
+                        std::vector<OpBenchmarkResult> *results) {
+  OpTester tester;
+  tester.Init(config);
+  if (!IsBenchmarkMode()) {
+    tester.Run();
+    return;
+  }
+  std::vector<int> num_threads = {config.num_threads};
+  if (!FLAGS_op_bench_num_threads.empty()) {
+    num_threads = StringToVector<int>(FLAGS_op_bench_num_threads);
+  }
+  for (int n : num_threads) {
+    results->push_back(tester.Benchmark(n));
+  }
+}
+
+static void ReportBenchmarkResults(
+    const std::vector<OpBenchmarkResult> &results) {
+  if (!FLAGS_op_bench_json.empty()) {
+    SaveBenchmarkResults(results, FLAGS_op_bench_json);
+    LOG(INFO) << "Save the benchmark results to " << FLAGS_op_bench_json;
+  }
+  if (!FLAGS_op_bench_baseline.empty()) {
+    std::vector<OpBenchmarkResult> baseline =
+        LoadBenchmarkResults(FLAGS_op_bench_baseline);
+    std::vector<std::string> regressions = CompareWithBaseline(
+        results, baseline, FLAGS_op_bench_regression_threshold);
+    for (auto &regression : regressions) {
+      LOG(ERROR) << "Regression: " << regression;
+    }
+    EXPECT_TRUE(regressions.empty());
+  }
+}
+
 TEST(op_tester, base) {
+  std::vector<OpBenchmarkResult> results;
   if (!FLAGS_op_config_list.empty()) {
     std::ifstream fin(FLAGS_op_config_list, std::ios::in | std::ios::binary);
     PADDLE_ENFORCE_EQ(
@@ -506,18 +663,13 @@ TEST(op_tester, base) {
     }
     if (FLAGS_specified_config_id >= 0 &&
         FLAGS_specified_config_id < static_cast<int>(op_configs.size())) {
-      OpTester tester;
-      tester.Init(op_configs[FLAGS_specified_config_id]);
-      tester.Run();
+      RunOpTester(op_configs[FLAGS_specified_config_id], &results);
     } else {
       for (size_t i = 0; i < op_configs.size(); ++i) {
-        OpTester tester;
-        tester.Init(op_configs[i]);
-        tester.Run();
+        RunOpTester(op_configs[i], &results);
       }
     }
   } else {
-    OpTester tester;
     OpTesterConfig config;
     config.op_type = "elementwise_add";
     config.inputs.resize(2);
@@ -525,9 +677,9 @@ TEST(op_tester, base) {
     config.inputs[0].dims = {64, 64};
     config.inputs[1].name = "Y";
     config.inputs[1].dims = {64, 1};
-    tester.Init(config);
-    tester.Run();
+    RunOpTester(config, &results);
   }
+  ReportBenchmarkResults(results);
 }
 
 }  // namespace benchmark
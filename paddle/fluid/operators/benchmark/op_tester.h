@@ -21,6 +21,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/ddim.h"
 #include "paddle/fluid/framework/op_desc.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/operators/benchmark/op_benchmark.h"
 #include "paddle/fluid/operators/benchmark/op_tester_config.h"
 
 namespace paddle {
@@ -36,6 +37,9 @@ class OpTester {
 
   void Run();
 
+  // Time every run of the op with num_threads CPU math library threads.
+  OpBenchmarkResult Benchmark(int num_threads);
+
   std::string DebugString();
 
  private:
@@ -59,6 +63,9 @@ class OpTester {
 
   void RunImpl();
 
+  double GetMemoryBytes();
+  double GetFlops();
+
  private:
   OpTesterConfig config_;
   std::string type_;
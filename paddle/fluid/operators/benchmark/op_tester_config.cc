@@ -177,10 +177,17 @@ bool OpTesterConfig::Init(std::istream& is) {
       is >> sep;
       if (sep == "op_type" || sep == "op_type:") {
         is >> op_type;
+      } else if (sep == "name" || sep == "name:") {
+        is >> name;
+        EraseEndSep(&name);
       } else if (sep == "device_id" || sep == "device_id:") {
         is >> device_id;
       } else if (sep == "repeat" || sep == "repeat:") {
         is >> repeat;
+      } else if (sep == "warmup" || sep == "warmup:") {
+        is >> warmup;
+      } else if (sep == "num_threads" || sep == "num_threads:") {
+        is >> num_threads;
       } else if (sep == "profile" || sep == "profile:") {
         is >> profile;
       } else if (sep == "print_debug_string" || sep == "print_debug_string:") {
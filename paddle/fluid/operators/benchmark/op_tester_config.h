@@ -51,11 +51,14 @@ struct OpTesterConfig {
 
   const OpInputConfig* GetInput(const std::string& name);
 
+  std::string name;  // name of the config in the benchmark results
   std::string op_type;
   std::vector<OpInputConfig> inputs;
   std::unordered_map<std::string, std::string> attrs;
   int device_id{-1};  // CPU: -1
   int repeat{1};
+  int warmup{1};
+  int num_threads{1};  // CPU math library threads
   int profile{0};
   int print_debug_string{0};
   double runtime{0.0};
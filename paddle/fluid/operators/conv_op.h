@@ -25,6 +25,7 @@ limitations under the License. */
 #include "paddle/fluid/operators/math/depthwise_conv.h"
 #include "paddle/fluid/operators/math/im2col.h"
 #include "paddle/fluid/operators/math/vol2col.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 
 namespace paddle {
 namespace operators {
@@ -300,19 +301,27 @@ class GemmConvKernel : public framework::OpKernel<T> {
     framework::DDim col_matrix_shape =
         framework::flatten_to_2d(col_shape, data_dim);
 
-    bool is_expand = IsExpand(filter_shape_vec, strides, paddings, dilations);
-
-    Tensor col;
-    // col_matrix shares the same piece of data with col,
-    // but will be reshaped into a two-dimensional matrix shape
-    // to call the matrix multiplication interface.
-    Tensor col_matrix;
-    if (is_expand) {
-      col = context.AllocateTmpTensor<T, DeviceContext>(col_shape, dev_ctx);
-      col_matrix.ShareDataWith(col);
-      col_matrix.Resize(col_matrix_shape);
+    // The depthwise convolution on CPU is computed directly, without the
+    // im2col and the gemm of one channel a time.
+    if (platform::is_cpu_place(context.GetPlace()) && data_dim == 2U &&
+        groups > 1 && groups == trans_in_dims[1] && filter_dims[1] == 1) {
+      math::DepthwiseConvFunctor<platform::CPUDeviceContext, T> depthwise_conv;
+      depthwise_conv(
+          context.template device_context<platform::CPUDeviceContext>(),
+          transformed_input, filter, strides,
+          std::vector<int>{paddings[0], paddings[2]}, dilations,
+          &transformed_output);
+      if (channel_last) {
+        TransToChannelLast<DeviceContext, T>(context, &transformed_output,
+                                             output);
+      }
+      return;
     }
 
+    // The col of the 1x1 convolution with stride 1 and no padding is the input
+    // itself, which needs neither the im2col nor a col buffer.
+    bool is_expand = IsExpand(filter_shape_vec, strides, paddings, dilations);
+
     framework::DDim in_matrix_shape = framework::slice_ddim(
         transformed_input.dims(), 1, transformed_input.dims().size());
 
@@ -329,39 +338,80 @@ class GemmConvKernel : public framework::OpKernel<T> {
     int in_step = static_cast<int>(transformed_input.dims()[1]) / groups;
     int out_step = static_cast<int>(transformed_output.dims()[1]) / groups;
 
-    math::Vol2ColFunctor<DeviceContext, T> vol2col;
-    math::Im2ColFunctor<math::ColFormat::kCFO, DeviceContext, T> im2col;
-
     auto blas = math::GetBlas<DeviceContext, T>(dev_ctx);
-    for (int i = 0; i < batch_size; i++) {
-      Tensor in_batch =
-          transformed_input.Slice(i, i + 1).Resize(in_matrix_shape);
-      Tensor out_batch =
-          transformed_output.Slice(i, i + 1).Resize(output_matrix_shape);
-
-      for (int g = 0; g < groups; g++) {
-        Tensor in_slice = in_batch.Slice(g * in_step, (g + 1) * in_step);
-
-        if (!is_expand) {
-          col.ShareDataWith(in_slice);
-          col_matrix.ShareDataWith(col);
-          col_matrix.Resize(col_matrix_shape);
-        } else if (data_dim == 2U) {
-          im2col(dev_ctx, in_slice, dilations, strides,
-                 std::vector<int>{paddings[0], paddings[2], paddings[1],
-                                  paddings[3]},
-                 &col);
-
-        } else if (data_dim == 3U) {
-          vol2col(dev_ctx, in_slice, dilations, strides, paddings, &col);
-        }
+    // Computes the images [begin, end) of the batch, with the col buffer col.
+    auto conv_images = [&](int begin, int end, Tensor col) {
+      math::Vol2ColFunctor<DeviceContext, T> vol2col;
+      math::Im2ColFunctor<math::ColFormat::kCFO, DeviceContext, T> im2col;
+      // col_matrix shares the same piece of data with col,
+      // but will be reshaped into a two-dimensional matrix shape
+      // to call the matrix multiplication interface.
+      Tensor col_matrix;
+      if (is_expand) {
+        col_matrix.ShareDataWith(col);
+        col_matrix.Resize(col_matrix_shape);
+      }
+      for (int i = begin; i < end; i++) {
+        Tensor in_batch =
+            transformed_input.Slice(i, i + 1).Resize(in_matrix_shape);
+        Tensor out_batch =
+            transformed_output.Slice(i, i + 1).Resize(output_matrix_shape);
+
+        for (int g = 0; g < groups; g++) {
+          Tensor in_slice = in_batch.Slice(g * in_step, (g + 1) * in_step);
 
-        // gemm
-        Tensor out_slice = out_batch.Slice(g * out_step, (g + 1) * out_step);
-        Tensor filter_slice = filter.Slice(g * out_step, (g + 1) * out_step);
-        blas.MatMul(filter_slice, false, col_matrix, false, T(1.0), &out_slice,
-                    T(0.0));
+          if (!is_expand) {
+            col.ShareDataWith(in_slice);
+            col_matrix.ShareDataWith(col);
+            col_matrix.Resize(col_matrix_shape);
+          } else if (data_dim == 2U) {
+            im2col(dev_ctx, in_slice, dilations, strides,
+                   std::vector<int>{paddings[0], paddings[2], paddings[1],
+                                    paddings[3]},
+                   &col);
+
+          } else if (data_dim == 3U) {
+            vol2col(dev_ctx, in_slice, dilations, strides, paddings, &col);
+          }
+
+          // gemm
+          Tensor out_slice = out_batch.Slice(g * out_step, (g + 1) * out_step);
+          Tensor filter_slice = filter.Slice(g * out_step, (g + 1) * out_step);
+          blas.MatMul(filter_slice, false, col_matrix, false, T(1.0),
+                      &out_slice, T(0.0));
+        }
+      }
+    };
+
+    // On CPU, the batch is split into one chunk per thread, and each chunk
+    // has its own col buffer from the temporary allocator. The gemm of one
+    // image is then run by its thread only, instead of running the im2col
+    // serially between the multi-threaded gemms.
+    int num_chunks = 1;
+    if (platform::is_cpu_place(context.GetPlace())) {
+      num_chunks = std::min(batch_size, platform::GetNumThreads());
+    }
+    if (num_chunks > 1) {
+      Tensor cols;
+      if (is_expand) {
+        cols = context.AllocateScratchTensor<T, DeviceContext>(
+            {num_chunks, framework::product(col_shape)}, dev_ctx);
+      }
+      platform::ParallelFor(num_chunks, [&](int chunk) {
+        Tensor col;
+        if (is_expand) {
+          col = cols.Slice(chunk, chunk + 1).Resize(col_shape);
+        }
+        conv_images(batch_size * chunk / num_chunks,
+                    batch_size * (chunk + 1) / num_chunks, col);
+      });
+    } else {
+      Tensor col;
+      if (is_expand) {
+        col = context.AllocateScratchTensor<T, DeviceContext>(col_shape,
+                                                              dev_ctx);
       }
+      conv_images(0, batch_size, col);
     }
     if (channel_last) {
       TransToChannelLast<DeviceContext, T>(context, &transformed_output,
@@ -480,7 +530,7 @@ class GemmConvGradKernel : public framework::OpKernel<T> {
     // to call the matrix multiplication interface.
     Tensor col_matrix;
     if (is_expand) {
-      col = context.AllocateTmpTensor<T, DeviceContext>(col_shape, dev_ctx);
+      col = context.AllocateScratchTensor<T, DeviceContext>(col_shape, dev_ctx);
       col_matrix.ShareDataWith(col);
       col_matrix.Resize(col_matrix_shape);
     }
@@ -687,7 +737,7 @@ class GemmConvDoubleGradKernel : public framework::OpKernel<T> {
     Tensor col;
     Tensor col_matrix;
     if (is_expand) {
-      col = ctx.AllocateTmpTensor<T, DeviceContext>(col_shape, dev_ctx);
+      col = ctx.AllocateScratchTensor<T, DeviceContext>(col_shape, dev_ctx);
       col_matrix.ShareDataWith(col);
       col_matrix.Resize(col_matrix_shape);
     }
@@ -193,8 +193,9 @@ class GemmConvTransposeKernel : public framework::OpKernel<T> {
     // size: (o_c/g * k_h * k_w, h * w) or (o_c/g * k_d * k_h * k_w, d * h * w)
     DDim col_matrix_shape = framework::flatten_to_2d(col_shape, data_dim + 1);
 
-    Tensor col;
-    col.mutable_data<T>(col_shape, context.GetPlace());
+    auto& dev_ctx = context.template device_context<DeviceContext>();
+    Tensor col =
+        context.AllocateScratchTensor<T, DeviceContext>(col_shape, dev_ctx);
     // col_matrix shares the same piece of data with col,
     // but will be reshaped into a two-dimensional matrix shape
     // to call the matrix multiplication interface.
@@ -227,7 +228,6 @@ class GemmConvTransposeKernel : public framework::OpKernel<T> {
 
     output->mutable_data<T>(context.GetPlace());
     math::SetConstant<DeviceContext, T> set_zero;
-    auto& dev_ctx = context.template device_context<DeviceContext>();
     auto blas = math::GetBlas<DeviceContext, T>(dev_ctx);
     set_zero(dev_ctx, output, static_cast<T>(0));
 
@@ -212,19 +212,30 @@ inline void GetBroadcastDimsArrays(const framework::DDim &x_dims,
                     platform::errors::InvalidArgument(
                         "Axis should be less than %d, but received axis is %d.",
                         max_dim, axis));
+  // The trailing dims of size 1 of the smaller input may go beyond max_dim
+  // when axis is given, e.g. x = [2, 3, 4], y = [3, 4, 1] and axis = 1.
+  auto trimmed_size = [max_dim, axis](const framework::DDim &dims) {
+    int size = dims.size();
+    while (size > 0 && axis + size > max_dim && dims[size - 1] == 1) {
+      --size;
+    }
+    return size;
+  };
   if (x_dims.size() > y_dims.size()) {
+    int y_size = trimmed_size(y_dims);
     std::fill(y_dims_array, y_dims_array + axis, 1);
-    if (axis + y_dims.size() < max_dim) {
-      std::fill(y_dims_array + axis + y_dims.size(), y_dims_array + max_dim, 1);
+    if (axis + y_size < max_dim) {
+      std::fill(y_dims_array + axis + y_size, y_dims_array + max_dim, 1);
     }
     std::copy(x_dims.Get(), x_dims.Get() + x_dims.size(), x_dims_array);
-    std::copy(y_dims.Get(), y_dims.Get() + y_dims.size(), y_dims_array + axis);
+    std::copy(y_dims.Get(), y_dims.Get() + y_size, y_dims_array + axis);
   } else {
+    int x_size = trimmed_size(x_dims);
     std::fill(x_dims_array, x_dims_array + axis, 1);
-    if (axis + x_dims.size() < max_dim) {
-      std::fill(x_dims_array + axis + x_dims.size(), x_dims_array + max_dim, 1);
+    if (axis + x_size < max_dim) {
+      std::fill(x_dims_array + axis + x_size, x_dims_array + max_dim, 1);
     }
-    std::copy(x_dims.Get(), x_dims.Get() + x_dims.size(), x_dims_array + axis);
+    std::copy(x_dims.Get(), x_dims.Get() + x_size, x_dims_array + axis);
     std::copy(y_dims.Get(), y_dims.Get() + y_dims.size(), y_dims_array);
   }
 
@@ -247,6 +258,113 @@ inline void GetBroadcastDimsArrays(const framework::DDim &x_dims,
   }
 }
 
+// Elementwise broadcast on CPU is run on the merged dims of x, y and out:
+// the dims of size 1 in out are dropped, and adjacent dims in which x and y
+// are both broadcast or both not broadcast are merged. Then the last dim is
+// contiguous in out, and either contiguous or broadcast in x and y, so every
+// row of out is a plain inner loop, and the rows can run in parallel.
+//
+// Example: x = [2, 3, 4, 5], y = [1, 1, 4, 5] -> out = [6, 20],
+//          x_strides = [20, 1], y_strides = [0, 1].
+struct CPUBroadcastDims {
+  CPUBroadcastDims(const int *x_dims_array, const int *y_dims_array,
+                   const int *out_dims_array, int max_dim) {
+    std::vector<bool> x_bcast, y_bcast;
+    for (int i = 0; i < max_dim; ++i) {
+      if (out_dims_array[i] <= 0) {
+        out_size = 0;
+        return;
+      }
+      if (out_dims_array[i] == 1) continue;
+      bool xb = x_dims_array[i] <= 1;
+      bool yb = y_dims_array[i] <= 1;
+      if (!out_dims.empty() && xb == x_bcast.back() && yb == y_bcast.back()) {
+        out_dims.back() *= out_dims_array[i];
+      } else {
+        out_dims.push_back(out_dims_array[i]);
+        x_bcast.push_back(xb);
+        y_bcast.push_back(yb);
+      }
+    }
+    if (out_dims.empty()) {
+      out_dims.push_back(1);
+      x_bcast.push_back(false);
+      y_bcast.push_back(false);
+    }
+
+    int n = static_cast<int>(out_dims.size());
+    x_strides.resize(n);
+    y_strides.resize(n);
+    int64_t x_stride = 1, y_stride = 1;
+    for (int i = n - 1; i >= 0; --i) {
+      x_strides[i] = x_bcast[i] ? 0 : x_stride;
+      y_strides[i] = y_bcast[i] ? 0 : y_stride;
+      x_stride *= x_bcast[i] ? 1 : out_dims[i];
+      y_stride *= y_bcast[i] ? 1 : out_dims[i];
+    }
+    x_broadcast = std::find(x_bcast.begin(), x_bcast.end(), true) !=
+                  x_bcast.end();
+    y_broadcast = std::find(y_bcast.begin(), y_bcast.end(), true) !=
+                  y_bcast.end();
+    inner_size = out_dims.back();
+    out_size = std::accumulate(out_dims.begin(), out_dims.end(),
+                               static_cast<int64_t>(1),
+                               std::multiplies<int64_t>());
+    outer_size = out_size / inner_size;
+  }
+
+  // The offsets of the first element of out row `row` in x and y.
+  void RowOffsets(int64_t row, int64_t *x_offset, int64_t *y_offset) const {
+    *x_offset = 0;
+    *y_offset = 0;
+    for (int i = static_cast<int>(out_dims.size()) - 2; i >= 0 && row > 0;
+         --i) {
+      int64_t index = row % out_dims[i];
+      row /= out_dims[i];
+      *x_offset += index * x_strides[i];
+      *y_offset += index * y_strides[i];
+    }
+  }
+
+  std::vector<int64_t> out_dims;
+  // 0 in the broadcast dims
+  std::vector<int64_t> x_strides;
+  std::vector<int64_t> y_strides;
+  // whether x or y is broadcast in any dim
+  bool x_broadcast{false};
+  bool y_broadcast{false};
+  int64_t inner_size{1};
+  int64_t outer_size{0};
+  int64_t out_size{0};
+};
+
+// The rows are run in parallel only when there is enough work for them.
+constexpr int64_t kCPUBroadcastParallelSize = 1 << 15;
+
+// out[i] = func(a[i * a_step], b[i * b_step]), the steps are 0 or 1.
+template <typename Functor, typename T, typename OutType>
+inline void BroadcastRowCPU(const T *a, int64_t a_step, const T *b,
+                            int64_t b_step, int64_t n, OutType *out,
+                            Functor func) {
+  if (a_step != 0 && b_step != 0) {
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(a[i], b[i]);
+    }
+  } else if (a_step != 0) {
+    const T b_value = *b;
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(a[i], b_value);
+    }
+  } else if (b_step != 0) {
+    const T a_value = *a;
+    for (int64_t i = 0; i < n; ++i) {
+      out[i] = func(a_value, b[i]);
+    }
+  } else {
+    std::fill(out, out + n, static_cast<OutType>(func(*a, *b)));
+  }
+}
+
 template <typename Functor, typename T, typename OutType = T>
 void CommonForwardBroadcastCPU(const framework::Tensor *x,
                                const framework::Tensor *y, framework::Tensor *z,
@@ -255,7 +373,6 @@ void CommonForwardBroadcastCPU(const framework::Tensor *x,
                                const platform::CPUDeviceContext &ctx,
                                Functor func,
                                const bool is_xsize_larger = true) {
-  std::vector<int> index_array(max_dim, 0);
   const T *x_data = x->data<T>();
   const T *y_data = y->data<T>();
   PADDLE_ENFORCE_NOT_NULL(x_data, platform::errors::InvalidArgument(
@@ -264,19 +381,83 @@ void CommonForwardBroadcastCPU(const framework::Tensor *x,
                                       "The input Y should not be empty."));
   OutType *out_data = z->mutable_data<OutType>(ctx.GetPlace());
 
-  const int out_size = std::accumulate(out_dims_array, out_dims_array + max_dim,
-                                       1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
+  CPUBroadcastDims dims(x_dims_array, y_dims_array, out_dims_array, max_dim);
+  const int64_t inner = dims.inner_size;
+  const int64_t x_step = dims.x_strides.back();
+  const int64_t y_step = dims.y_strides.back();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (dims.outer_size > 1 && \
+                             dims.out_size >= kCPUBroadcastParallelSize)
+#endif
+  for (int64_t row = 0; row < dims.outer_size; ++row) {
+    int64_t x_offset, y_offset;
+    dims.RowOffsets(row, &x_offset, &y_offset);
     if (is_xsize_larger) {
-      out_data[out_index] = func(x_data[x_index], y_data[y_index]);
+      BroadcastRowCPU(x_data + x_offset, x_step, y_data + y_offset, y_step,
+                      inner, out_data + row * inner, func);
     } else {
-      out_data[out_index] = func(y_data[y_index], x_data[x_index]);
+      BroadcastRowCPU(y_data + y_offset, y_step, x_data + x_offset, x_step,
+                      inner, out_data + row * inner, func);
     }
+  }
+}
+
+// Compute the gradient of one input by `op`. The gradient of an input that
+// is not broadcast is written row by row in parallel, while the gradient of
+// a broadcast input is accumulated serially, since the rows of out reduce
+// into the same elements of it.
+template <typename T, typename OP>
+void CommonGradBroadcastInputCPU(const T *x_data, const T *y_data,
+                                 const T *out_data, const T *dout_data,
+                                 const CPUBroadcastDims &dims, bool is_x,
+                                 T *d_data, OP op) {
+  const int64_t inner = dims.inner_size;
+  const int64_t x_step = dims.x_strides.back();
+  const int64_t y_step = dims.y_strides.back();
+  const int64_t d_step = is_x ? x_step : y_step;
+  const bool broadcast = is_x ? dims.x_broadcast : dims.y_broadcast;
+  if (!broadcast) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (dims.outer_size > 1 && \
+                             dims.out_size >= kCPUBroadcastParallelSize)
+#endif
+    for (int64_t row = 0; row < dims.outer_size; ++row) {
+      int64_t x_offset, y_offset;
+      dims.RowOffsets(row, &x_offset, &y_offset);
+      const T *x_row = x_data + x_offset;
+      const T *y_row = y_data + y_offset;
+      const T *out_row = out_data + row * inner;
+      const T *dout_row = dout_data + row * inner;
+      T *d_row = d_data + (is_x ? x_offset : y_offset);
+      for (int64_t i = 0; i < inner; ++i) {
+        d_row[i] =
+            op(x_row[i * x_step], y_row[i * y_step], out_row[i], dout_row[i]);
+      }
+    }
+    return;
+  }
 
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
+  for (int64_t row = 0; row < dims.outer_size; ++row) {
+    int64_t x_offset, y_offset;
+    dims.RowOffsets(row, &x_offset, &y_offset);
+    const T *x_row = x_data + x_offset;
+    const T *y_row = y_data + y_offset;
+    const T *out_row = out_data + row * inner;
+    const T *dout_row = dout_data + row * inner;
+    T *d_row = d_data + (is_x ? x_offset : y_offset);
+    if (d_step != 0) {
+      for (int64_t i = 0; i < inner; ++i) {
+        d_row[i] +=
+            op(x_row[i * x_step], y_row[i * y_step], out_row[i], dout_row[i]);
+      }
+    } else {
+      T sum = static_cast<T>(0);
+      for (int64_t i = 0; i < inner; ++i) {
+        sum += op(x_row[i * x_step], y_row[i * y_step], out_row[i],
+                  dout_row[i]);
+      }
+      *d_row += sum;
+    }
   }
 }
 
@@ -287,35 +468,28 @@ void CommonGradBroadcastCPU(
     framework::Tensor *dx, framework::Tensor *dy, int *x_dims_array,
     int *y_dims_array, int *out_dims_array, int max_dim,
     const platform::CPUDeviceContext &ctx, DX_OP dx_op, DY_OP dy_op) {
-  std::vector<int> index_array(max_dim, 0);
   const T *x_data = x.data<T>();
   const T *y_data = y.data<T>();
   const T *out_data = out.data<T>();
   const T *dout_data = dout.data<T>();
   T *dx_data = dx == nullptr ? nullptr : dx->mutable_data<T>(ctx.GetPlace());
   T *dy_data = dy == nullptr ? nullptr : dy->mutable_data<T>(ctx.GetPlace());
-  if (dx_data != nullptr) {
+  CPUBroadcastDims dims(x_dims_array, y_dims_array, out_dims_array, max_dim);
+  // the gradient of a broadcast input is accumulated
+  if (dx_data != nullptr && (dims.x_broadcast || dims.out_size == 0)) {
     memset(dx_data, 0, dx->numel() * sizeof(T));
   }
-  if (dy_data != nullptr) {
+  if (dy_data != nullptr && (dims.y_broadcast || dims.out_size == 0)) {
     memset(dy_data, 0, dy->numel() * sizeof(T));
   }
-  const int out_size = std::accumulate(out_dims_array, out_dims_array + max_dim,
-                                       1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
-    if (dx_data != nullptr) {
-      dx_data[x_index] += dx_op(x_data[x_index], y_data[y_index],
-                                out_data[out_index], dout_data[out_index]);
-    }
-    if (dy_data != nullptr) {
-      dy_data[y_index] += dy_op(x_data[x_index], y_data[y_index],
-                                out_data[out_index], dout_data[out_index]);
-    }
 
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
+  if (dx_data != nullptr) {
+    CommonGradBroadcastInputCPU<T, DX_OP>(x_data, y_data, out_data, dout_data,
+                                          dims, true, dx_data, dx_op);
+  }
+  if (dy_data != nullptr) {
+    CommonGradBroadcastInputCPU<T, DY_OP>(x_data, y_data, out_data, dout_data,
+                                          dims, false, dy_data, dy_op);
   }
 }
 
@@ -1729,8 +1903,9 @@ void ElemwiseGradComputeWithBroadcast(
     get_mid_dims(y_dims, x_dims_trimed, axis_trim, &pre, &n, &post,
                  &is_run_common_broadcast);
   }
-  // special case for common backward implementation.
-  if (is_run_common_broadcast) {
+  // special case for common backward implementation, all the broadcast
+  // cases on CPU run on the merged dims, see CommonGradBroadcastCPU.
+  if (is_run_common_broadcast || platform::is_cpu_place(ctx.GetPlace())) {
     CommonElementwiseBroadcastBackward<DeviceContext, T, DX_OP, DY_OP>(
         ctx, x_dims, y_dims, x, y, out, dout, axis, dx, dy, dx_op, dy_op);
     return;
@@ -1900,34 +2075,10 @@ void ElementwiseComputeEx(const framework::ExecutionContext &ctx,
                         "Axis should be less than %d, but received axis is %d.",
                         max_dim, axis));
 
-  int pre, n, post, is_run_common_broadcast, axis_trim = 0;
-  if (is_xsize_larger) {
-    auto y_dims_trimed = trim_trailing_singular_dims(y_dims);
-    axis_trim = (y_dims_trimed.size() == 0) ? x_dims.size() : axis;
-    get_mid_dims(x_dims, y_dims_trimed, axis_trim, &pre, &n, &post,
-                 &is_run_common_broadcast);
-  } else {
-    auto x_dims_trimed = trim_trailing_singular_dims(x_dims);
-    axis_trim = (x_dims_trimed.size() == 0) ? y_dims.size() : axis;
-    get_mid_dims(y_dims, x_dims_trimed, axis_trim, &pre, &n, &post,
-                 &is_run_common_broadcast);
-  }
-  // special case for common implementation.
-  // case 1: x=[2,3,1,5], y=[2,1,4,1]
-  // case 2: x=[2,3,4], y=[1,1,4]
-  if (is_run_common_broadcast == 1) {
-    CommonElementwiseBroadcastForward<Functor, DeviceContext, T, OutType>(
-        ctx, x, y, z, x_dims, y_dims, func, axis, is_xsize_larger);
-    return;
-  }
-
-  if (post == 1) {
-    functor.RunRowWise(n, pre);
-    return;
-  } else {
-    functor.RunMidWise(n, pre, post);
-    return;
-  }
+  // All the broadcast cases on CPU run on the merged dims of x, y and out,
+  // see CommonForwardBroadcastCPU.
+  CommonElementwiseBroadcastForward<Functor, DeviceContext, T, OutType>(
+      ctx, x, y, z, x_dims, y_dims, func, axis, is_xsize_larger);
 }
 
 // FusedElemwiseAndAct
@@ -0,0 +1,111 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/operators/elementwise/elementwise_op_function.h"
+
+namespace paddle {
+namespace operators {
+
+TEST(CPUBroadcastDims, MergeDims) {
+  std::vector<int> x_dims = {2, 3, 4, 5};
+  std::vector<int> y_dims = {1, 1, 4, 5};
+  std::vector<int> out_dims = {2, 3, 4, 5};
+  CPUBroadcastDims dims(x_dims.data(), y_dims.data(), out_dims.data(), 4);
+  EXPECT_EQ(dims.out_dims, std::vector<int64_t>({6, 20}));
+  EXPECT_EQ(dims.x_strides, std::vector<int64_t>({20, 1}));
+  EXPECT_EQ(dims.y_strides, std::vector<int64_t>({0, 1}));
+  EXPECT_FALSE(dims.x_broadcast);
+  EXPECT_TRUE(dims.y_broadcast);
+  EXPECT_EQ(dims.outer_size, 6);
+  EXPECT_EQ(dims.inner_size, 20);
+
+  // dims of size 1 in out are dropped
+  x_dims = {2, 1, 3, 1};
+  y_dims = {1, 1, 3, 4};
+  out_dims = {2, 1, 3, 4};
+  CPUBroadcastDims dims2(x_dims.data(), y_dims.data(), out_dims.data(), 4);
+  EXPECT_EQ(dims2.out_dims, std::vector<int64_t>({2, 3, 4}));
+  EXPECT_EQ(dims2.x_strides, std::vector<int64_t>({3, 1, 0}));
+  EXPECT_EQ(dims2.y_strides, std::vector<int64_t>({0, 4, 1}));
+  int64_t x_offset, y_offset;
+  dims2.RowOffsets(4, &x_offset, &y_offset);
+  EXPECT_EQ(x_offset, 4);
+  EXPECT_EQ(y_offset, 4);
+}
+
+static void TestBroadcast(const framework::DDim& x_dims,
+                          const framework::DDim& y_dims) {
+  platform::CPUPlace place;
+  platform::CPUDeviceContext ctx(place);
+  framework::Tensor x, y, out, dout, dx, dy;
+  float* x_data = x.mutable_data<float>(x_dims, place);
+  float* y_data = y.mutable_data<float>(y_dims, place);
+  for (int64_t i = 0; i < x.numel(); ++i) x_data[i] = static_cast<float>(i);
+  for (int64_t i = 0; i < y.numel(); ++i) y_data[i] = static_cast<float>(i % 7);
+
+  int max_dim = x_dims.size();
+  std::vector<int> x_dims_array(max_dim), y_dims_array(max_dim),
+      out_dims_array(max_dim);
+  GetBroadcastDimsArrays(x_dims, y_dims, x_dims_array.data(),
+                         y_dims_array.data(), out_dims_array.data(), max_dim,
+                         0);
+  out.Resize(framework::make_ddim(out_dims_array));
+  CommonForwardBroadcastCPU<MulFunctor<float>, float>(
+      &x, &y, &out, x_dims_array.data(), y_dims_array.data(),
+      out_dims_array.data(), max_dim, ctx, MulFunctor<float>());
+
+  float* dout_data = dout.mutable_data<float>(out.dims(), place);
+  for (int64_t i = 0; i < dout.numel(); ++i) dout_data[i] = 1.0f;
+  dx.Resize(x_dims);
+  dy.Resize(y_dims);
+  auto dx_op = [](float x, float y, float out, float dout) { return dout * y; };
+  auto dy_op = [](float x, float y, float out, float dout) { return dout * x; };
+  CommonGradBroadcastCPU<float>(x, y, out, dout, &dx, &dy, x_dims_array.data(),
+                                y_dims_array.data(), out_dims_array.data(),
+                                max_dim, ctx, dx_op, dy_op);
+
+  // reference by the index of every element
+  std::vector<float> dx_expect(x.numel(), 0), dy_expect(y.numel(), 0);
+  std::vector<int> index(max_dim, 0);
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    int x_index = GetElementwiseIndex(x_dims_array.data(), max_dim,
+                                      index.data());
+    int y_index = GetElementwiseIndex(y_dims_array.data(), max_dim,
+                                      index.data());
+    EXPECT_EQ(out.data<float>()[i], x_data[x_index] * y_data[y_index]);
+    dx_expect[x_index] += y_data[y_index];
+    dy_expect[y_index] += x_data[x_index];
+    UpdateElementwiseIndexArray(out_dims_array.data(), max_dim, index.data());
+  }
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    EXPECT_EQ(dx.data<float>()[i], dx_expect[i]);
+  }
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    EXPECT_EQ(dy.data<float>()[i], dy_expect[i]);
+  }
+}
+
+TEST(CommonBroadcastCPU, ForwardAndGrad) {
+  TestBroadcast({2, 3, 4, 5}, {1, 1, 4, 5});
+  TestBroadcast({2, 3, 4, 5}, {2, 1, 4, 1});
+  TestBroadcast({2, 1, 4, 1}, {1, 3, 1, 5});
+  TestBroadcast({64, 128, 8}, {64, 1, 8});
+  TestBroadcast({3, 1}, {1, 1});
+}
+
+}  // namespace operators
+}  // namespace paddle
@@ -0,0 +1,214 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/fluid/operators/jit/autotune.h"
+#include <xxhash.h>  // XXH64
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/operators/jit/helper.h"
+#include "paddle/fluid/platform/cpu_info.h"
+#include "paddle/fluid/platform/enforce.h"
+
+DEFINE_bool(jit_autotune, false,
+            "Whether to time all the candidate implementations of a jit "
+            "kernel on the first use of an attr and use the fastest one, "
+            "instead of the first one in the static order.");
+DEFINE_string(jit_autotune_file, "",
+              "The file to load the jit kernel autotune results from and "
+              "save them to at exit, so that the kernels are only tuned once "
+              "on a CPU model. Empty means the results are not persisted.");
+
+namespace paddle {
+namespace operators {
+namespace jit {
+
+// The model name of the CPU, or the best instruction set if unknown.
+static std::string GetCPUModel() {
+  std::string model;
+  std::ifstream fin("/proc/cpuinfo");
+  std::string line;
+  while (fin && std::getline(fin, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      size_t pos = line.find(':');
+      if (pos != std::string::npos) {
+        model = line.substr(line.find_first_not_of(' ', pos + 1));
+      }
+      break;
+    }
+  }
+  if (model.empty()) {
+    if (platform::MayIUse(platform::avx512f)) {
+      model = "avx512f";
+    } else if (platform::MayIUse(platform::avx2)) {
+      model = "avx2";
+    } else if (platform::MayIUse(platform::avx)) {
+      model = "avx";
+    } else {
+      model = "isa_any";
+    }
+  }
+  // The model is a field of the tab separated file.
+  for (auto& c : model) {
+    if (c == '\t' || c == '\n') c = ' ';
+  }
+  return model;
+}
+
+template <>
+int64_t AutotuneKey<seq_pool_attr_t>(const seq_pool_attr_t& attr) {
+  int h = 1;
+  while (h < attr.h && h < (1 << 30)) {
+    h <<= 1;
+  }
+  int keys[3] = {attr.w, static_cast<int>(attr.type), h};
+  return XXH64(keys, sizeof(int) * 3, 0);
+}
+
+AutotuneTable& AutotuneTable::Instance() {
+  static AutotuneTable table;
+  return table;
+}
+
+// Reads the entries of the file, the existing ones are only replaced if
+// overwrite.
+static void ReadEntries(std::istream& fin,
+                        std::map<std::string, std::string>* entries,
+                        bool overwrite) {
+  std::string line;
+  while (std::getline(fin, line)) {
+    size_t pos = line.rfind('\t');
+    if (line.empty() || pos == std::string::npos) {
+      continue;
+    }
+    if (overwrite) {
+      (*entries)[line.substr(0, pos)] = line.substr(pos + 1);
+    } else {
+      entries->emplace(line.substr(0, pos), line.substr(pos + 1));
+    }
+  }
+}
+
+AutotuneTable::AutotuneTable()
+    : cpu_model_(GetCPUModel()), filename_(FLAGS_jit_autotune_file) {
+  if (!filename_.empty()) {
+    std::ifstream fin(filename_);
+    if (fin) {
+      Load(filename_);
+    }
+  }
+}
+
+// The results are saved once at exit instead of on every Insert, which runs
+// on the first use of a kernel.
+AutotuneTable::~AutotuneTable() {
+  if (!filename_.empty() && dirty_) {
+    Save(filename_);
+  }
+}
+
+std::string AutotuneTable::Key(const std::string& cpu_model,
+                               KernelType kernel_type,
+                               int64_t attr_key) const {
+  std::ostringstream os;
+  os << cpu_model << '\t' << to_string(kernel_type) << '\t' << attr_key;
+  return os.str();
+}
+
+bool AutotuneTable::Find(KernelType kernel_type, int64_t attr_key,
+                         std::string* impl) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(Key(cpu_model_, kernel_type, attr_key));
+  if (it == entries_.end()) {
+    return false;
+  }
+  *impl = it->second;
+  return true;
+}
+
+void AutotuneTable::Insert(KernelType kernel_type, int64_t attr_key,
+                           const std::string& impl) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_[Key(cpu_model_, kernel_type, attr_key)] = impl;
+  dirty_ = true;
+}
+
+void AutotuneTable::Load(const std::string& filename) {
+  std::ifstream fin(filename);
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fin), true,
+      platform::errors::NotFound("Cannot open the jit kernel autotune file %s.",
+                                 filename));
+  std::lock_guard<std::mutex> guard(mutex_);
+  ReadEntries(fin, &entries_, true);
+  VLOG(3) << "Loaded " << entries_.size()
+          << " jit kernel autotune results from " << filename;
+}
+
+void AutotuneTable::Save(const std::string& filename) const {
+  std::map<std::string, std::string> entries;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    entries = entries_;
+    if (filename == filename_) {
+      dirty_ = false;
+    }
+  }
+  // The file is read and written outside the lock. The entries saved by the
+  // other processes since the load are merged, the ones of this process win.
+  {
+    std::ifstream fin(filename);
+    if (fin) {
+      ReadEntries(fin, &entries, false);
+    }
+  }
+  // Write to a temporary file of this process then rename it, so that the
+  // processes sharing the file never read a partial one.
+  std::random_device rd;
+  std::string tmp_filename = filename + ".tmp" + std::to_string(rd());
+  {
+    std::ofstream fout(tmp_filename);
+    if (!fout) {
+      LOG(WARNING) << "Cannot save the jit kernel autotune results to "
+                   << filename;
+      return;
+    }
+    for (auto& entry : entries) {
+      fout << entry.first << '\t' << entry.second << '\n';
+    }
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    LOG(WARNING) << "Cannot save the jit kernel autotune results to "
+                 << filename;
+    std::remove(tmp_filename.c_str());
+  }
+}
+
+size_t AutotuneTable::Size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+void AutotuneTable::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+}
+
+}  // namespace jit
+}  // namespace operators
+}  // namespace paddle
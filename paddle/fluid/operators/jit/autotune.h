@@ -0,0 +1,193 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "paddle/fluid/operators/jit/kernel_base.h"
+#include "paddle/fluid/operators/jit/kernel_key.h"
+
+DECLARE_bool(jit_autotune);
+DECLARE_string(jit_autotune_file);
+
+namespace paddle {
+namespace operators {
+namespace jit {
+
+// The best implementation of each (kernel type, attr) on the CPU model of
+// this machine, found by timing all the candidates on the first use.
+// The entries of the other CPU models loaded from the file are kept and saved
+// back, so one file can be shared by machines of different CPU generations.
+class AutotuneTable {
+ public:
+  static AutotuneTable& Instance();
+
+  // Returns false if the kernel with this attr has not been tuned on this CPU.
+  bool Find(KernelType kernel_type, int64_t attr_key, std::string* impl) const;
+  void Insert(KernelType kernel_type, int64_t attr_key,
+              const std::string& impl);
+
+  // The file has one "cpu_model<TAB>kernel_type<TAB>attr_key<TAB>impl"
+  // entry per line. Save merges the entries already in the file, so the
+  // processes sharing it keep the results of each other.
+  void Load(const std::string& filename);
+  void Save(const std::string& filename) const;
+
+  size_t Size() const;
+  void Clear();
+
+  const std::string& CPUModel() const { return cpu_model_; }
+
+ private:
+  AutotuneTable();
+  ~AutotuneTable();
+  std::string Key(const std::string& cpu_model, KernelType kernel_type,
+                  int64_t attr_key) const;
+
+  std::string cpu_model_;
+  // FLAGS_jit_autotune_file when the table is created.
+  std::string filename_;
+  mutable std::mutex mutex_;
+  std::map<std::string, std::string> entries_;
+  // Whether there are entries not saved to filename_ yet.
+  mutable bool dirty_{false};
+
+  DISABLE_COPY_AND_ASSIGN(AutotuneTable);
+};
+
+// The key of the attr in the AutotuneTable and in the cache of the autotuned
+// functions. It is the JitCodeKey, unless the fastest implementation also
+// depends on the part of the attr only read at runtime.
+template <typename Attr>
+int64_t AutotuneKey(const Attr& attr) {
+  return JitCodeKey<Attr>(attr);
+}
+
+// The jitcode of SeqPool reads the height at runtime, but the fastest
+// implementation depends on it. The height is rounded up to a power of two, so
+// that the sequences of similar lengths share one tuning.
+template <>
+int64_t AutotuneKey<seq_pool_attr_t>(const seq_pool_attr_t& attr);
+
+// The average time in us of one run, the fastest of several trials.
+template <typename Callable>
+double AutotuneTimeUs(Callable run, int64_t work) {
+  constexpr int64_t kWorkPerTrial = 1 << 16;
+  constexpr int kTrials = 5;
+  int64_t repeat = std::min<int64_t>(
+      std::max<int64_t>(kWorkPerTrial / std::max<int64_t>(work, 1), 1), 1000);
+  run();  // warm up
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < kTrials; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t j = 0; j < repeat; ++j) {
+      run();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / repeat);
+  }
+  return best;
+}
+
+template <typename T>
+std::vector<T> AutotuneData(int64_t n) {
+  // Small values, so that exp, sigmoid and the like do not overflow.
+  std::vector<T> data(std::max<int64_t>(n, 1));
+  for (int64_t i = 0; i < n; ++i) {
+    data[i] = static_cast<T>(static_cast<double>(i % 17) / 17.0 - 0.5);
+  }
+  return data;
+}
+
+// The arguments of a kernel can only be made up from its attr for the kernel
+// tuples overloaded below. The other kernels are not timed and keep the
+// default best implementation, for which -1 is returned.
+template <typename Func, typename Attr>
+double AutotuneTimeFunc(const void*, Func func, const Attr& attr) {
+  return -1.0;
+}
+
+template <typename T>
+double AutotuneTimeFunc(const XYZNTuple<T>*,
+                        typename XYZNTuple<T>::func_type func, const int& n) {
+  auto x = AutotuneData<T>(n);
+  auto y = AutotuneData<T>(n);
+  std::vector<T> z(std::max(n, 1));
+  return AutotuneTimeUs([&] { func(x.data(), y.data(), z.data(), n); }, n);
+}
+
+template <typename T>
+double AutotuneTimeFunc(const XYNTuple<T>*,
+                        typename XYNTuple<T>::func_type func, const int& n) {
+  auto x = AutotuneData<T>(n);
+  std::vector<T> y(std::max(n, 1));
+  return AutotuneTimeUs([&] { func(x.data(), y.data(), n); }, n);
+}
+
+template <typename T>
+double AutotuneTimeFunc(const VBroadcastTuple<T>*,
+                        typename VBroadcastTuple<T>::func_type func,
+                        const int64_t& w) {
+  constexpr int64_t kHeight = 16;
+  auto x = AutotuneData<T>(w);
+  std::vector<T> y(std::max<int64_t>(kHeight * w, 1));
+  return AutotuneTimeUs([&] { func(x.data(), y.data(), kHeight, w); },
+                        kHeight * w);
+}
+
+template <typename T>
+double AutotuneTimeFunc(const SoftmaxTuple<T>*,
+                        typename SoftmaxTuple<T>::func_type func,
+                        const int& n) {
+  constexpr int kBatchSize = 16;
+  auto x = AutotuneData<T>(kBatchSize * n);
+  std::vector<T> y(std::max(kBatchSize * n, 1));
+  return AutotuneTimeUs([&] { func(x.data(), y.data(), n, kBatchSize, 1); },
+                        kBatchSize * n);
+}
+
+template <typename T>
+double AutotuneTimeFunc(const SeqPoolTuple<T>*,
+                        typename SeqPoolTuple<T>::func_type func,
+                        const seq_pool_attr_t& attr) {
+  auto x = AutotuneData<T>(static_cast<int64_t>(attr.h) * attr.w);
+  std::vector<T> y(std::max(attr.w, 1));
+  return AutotuneTimeUs([&] { func(x.data(), y.data(), &attr); },
+                        static_cast<int64_t>(attr.h) * attr.w);
+}
+
+template <typename T>
+double AutotuneTimeFunc(const MatMulTuple<T>*,
+                        typename MatMulTuple<T>::func_type func,
+                        const matmul_attr_t& attr) {
+  auto a = AutotuneData<T>(static_cast<int64_t>(attr.m) * attr.k);
+  auto b = AutotuneData<T>(static_cast<int64_t>(attr.k) * attr.n);
+  std::vector<T> c(std::max(attr.m * attr.n, 1));
+  return AutotuneTimeUs([&] { func(a.data(), b.data(), c.data(), &attr); },
+                        static_cast<int64_t>(attr.m) * attr.n * attr.k);
+}
+
+}  // namespace jit
+}  // namespace operators
+}  // namespace paddle
@@ -19,6 +19,7 @@
 #include "glog/logging.h"
 #include "paddle/fluid/framework/tensor.h"
 #include "paddle/fluid/operators/jit/kernels.h"
+#include "paddle/fluid/platform/cpu_info.h"
 #include "paddle/fluid/platform/device_tracer.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/place.h"
@@ -106,6 +107,38 @@ struct BenchFunc {
 
 namespace jit = paddle::operators::jit;
 
+// Generate the jitcode with FLAGS_jit_avx512 off, which is not cached in the
+// JitCodePool, to compare the ISA levels on the CPUs supporting AVX-512.
+template <typename KernelTuple, typename PlaceType>
+std::unique_ptr<jit::GenBase> CreateJitCodeWithoutAVX512(
+    const typename KernelTuple::attr_type& attr) {
+  using Attr = typename KernelTuple::attr_type;
+  std::unique_ptr<jit::GenBase> code;
+  if (!std::is_same<typename KernelTuple::data_type, float>::value ||
+      !paddle::platform::MayIUse(paddle::platform::avx512f)) {
+    return code;
+  }
+  jit::KernelKey kkey(KernelTuple::kernel_type, PlaceType());
+  auto& creator_map = jit::JitCodeCreatorPool::Instance().AllCreators();
+  auto iter = creator_map.find(kkey);
+  if (iter == creator_map.end()) {
+    return code;
+  }
+  bool use_avx512 = FLAGS_jit_avx512;
+  FLAGS_jit_avx512 = false;
+  for (auto& cur : iter->second) {
+    auto i = dynamic_cast<const jit::JitCodeCreator<Attr>*>(cur.get());
+    if (i && i->CanBeUsed(attr)) {
+      code = i->CreateJitCode(attr);
+      if (code) {
+        break;
+      }
+    }
+  }
+  FLAGS_jit_avx512 = use_avx512;
+  return code;
+}
+
 template <typename KernelTuple, typename PlaceType, typename... Args>
 void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
   BenchFunc<KernelTuple, Args...> benchmark;
@@ -115,6 +148,13 @@ void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
     infos.push_back(std::make_pair(f.first, benchmark(f.second, args...)));
   }
 
+  auto code = CreateJitCodeWithoutAVX512<KernelTuple, PlaceType>(attr);
+  if (code) {
+    auto func = code->template getCode<typename KernelTuple::func_type>();
+    infos.push_back(
+        std::make_pair("JitCode_NoAVX512", benchmark(func, args...)));
+  }
+
   // Test result from Get function
   auto tgt = jit::KernelFuncs<KernelTuple, PlaceType>::Cache().At(attr);
   if (!tgt) {
@@ -361,6 +401,101 @@ void BenchKernelSgd() {
   }
 }
 
+// The optimizers update param_h / 10 rows of the param inplace.
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelAdam() {
+  using T = typename KernelTuple::data_type;
+  const T lr = 0.1, beta1_pow = 0.9, beta2_pow = 0.999;
+  for (int param_h : {1, 1000}) {
+    for (int grad_w : {1, 8, 30, 256}) {
+      int rows_size = std::max(param_h / 10, 1);
+      Tensor param, mom1, mom2, grad;
+      param.Resize({param_h, grad_w});
+      mom1.Resize({param_h, grad_w});
+      mom2.Resize({param_h, grad_w});
+      grad.Resize({rows_size, grad_w});
+      T* param_data = param.mutable_data<T>(PlaceType());
+      T* mom1_data = mom1.mutable_data<T>(PlaceType());
+      T* mom2_data = mom2.mutable_data<T>(PlaceType());
+      RandomVec<T>(param_h * grad_w, param_data, -2.f, 2.f);
+      RandomVec<T>(param_h * grad_w, mom1_data, -2.f, 2.f);
+      RandomVec<T>(param_h * grad_w, mom2_data, 0.f, 2.f);
+      RandomVec<T>(rows_size * grad_w, grad.mutable_data<T>(PlaceType()),
+                   -2.f, 2.f);
+      std::vector<int64_t> rows(rows_size);
+      for (int i = 0; i < rows_size; ++i) {
+        rows[i] = i * (param_h / rows_size);
+      }
+      jit::adam_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size);
+      BenchAllImpls<KernelTuple, PlaceType>(
+          attr, &lr, &beta1_pow, &beta2_pow, grad.data<T>(), rows.data(),
+          param_data, mom1_data, mom2_data, &attr);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelAdagrad() {
+  using T = typename KernelTuple::data_type;
+  const T lr = 0.1;
+  for (int param_h : {1, 1000}) {
+    for (int grad_w : {1, 8, 30, 256}) {
+      int rows_size = std::max(param_h / 10, 1);
+      Tensor param, moment, grad;
+      param.Resize({param_h, grad_w});
+      moment.Resize({param_h, grad_w});
+      grad.Resize({rows_size, grad_w});
+      T* param_data = param.mutable_data<T>(PlaceType());
+      T* moment_data = moment.mutable_data<T>(PlaceType());
+      RandomVec<T>(param_h * grad_w, param_data, -2.f, 2.f);
+      RandomVec<T>(param_h * grad_w, moment_data, 0.f, 2.f);
+      RandomVec<T>(rows_size * grad_w, grad.mutable_data<T>(PlaceType()),
+                   -2.f, 2.f);
+      std::vector<int64_t> rows(rows_size);
+      for (int i = 0; i < rows_size; ++i) {
+        rows[i] = i * (param_h / rows_size);
+      }
+      jit::adagrad_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size);
+      BenchAllImpls<KernelTuple, PlaceType>(attr, &lr, grad.data<T>(),
+                                            rows.data(), param_data,
+                                            moment_data, &attr);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelFtrl() {
+  using T = typename KernelTuple::data_type;
+  const T lr = 0.1;
+  for (int param_h : {1, 1000}) {
+    for (int grad_w : {1, 8, 30, 256}) {
+      int rows_size = std::max(param_h / 10, 1);
+      Tensor param, sq_accum, lin_accum, grad;
+      param.Resize({param_h, grad_w});
+      sq_accum.Resize({param_h, grad_w});
+      lin_accum.Resize({param_h, grad_w});
+      grad.Resize({rows_size, grad_w});
+      T* param_data = param.mutable_data<T>(PlaceType());
+      T* sq_accum_data = sq_accum.mutable_data<T>(PlaceType());
+      T* lin_accum_data = lin_accum.mutable_data<T>(PlaceType());
+      RandomVec<T>(param_h * grad_w, param_data, -2.f, 2.f);
+      RandomVec<T>(param_h * grad_w, sq_accum_data, 0.1f, 2.f);
+      RandomVec<T>(param_h * grad_w, lin_accum_data, -2.f, 2.f);
+      RandomVec<T>(rows_size * grad_w, grad.mutable_data<T>(PlaceType()),
+                   -2.f, 2.f);
+      std::vector<int64_t> rows(rows_size);
+      for (int i = 0; i < rows_size; ++i) {
+        rows[i] = i * (param_h / rows_size);
+      }
+      jit::ftrl_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size,
+                            0.1f, 0.1f, -0.5f);
+      BenchAllImpls<KernelTuple, PlaceType>(
+          attr, &lr, grad.data<T>(), rows.data(), param_data, sq_accum_data,
+          lin_accum_data, &attr);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelMatMul() {
   using T = typename KernelTuple::data_type;
@@ -560,6 +695,11 @@ BENCH_FP32_CPU(Softmax);
 BENCH_FP32_CPU(Sgd);
 BENCH_FP32_CPU(VBroadcast);
 
+// optimizers
+BENCH_FP32_CPU(Adam);
+BENCH_FP32_CPU(Adagrad);
+BENCH_FP32_CPU(Ftrl);
+
 // Benchmark all jit kernels including jitcode, mkl and refer.
 // To use this tool, run command: ./benchmark [options...]
 // Options:
@@ -45,6 +45,10 @@ const int ALIGN32_BEG exp_int_0x7f[] ALIGN32_END = {REPEAT_8TIMES(0x7f)};
 int ALIGN32_BEG g_tmp_mem[16] ALIGN32_END = {0};
 
 void VActJitCode::genCode() {
+  if (use_avx512_) {
+    genAVX512Code();
+    return;
+  }
   int offset = 0;
   for (int i = 0; i < num_ / YMM_FLOAT_BLOCK; ++i) {
     vmovups(ymm_src, ptr[param1 + offset]);
@@ -79,6 +83,26 @@ void VActJitCode::genCode() {
   ret();
 }
 
+void VActJitCode::genAVX512Code() {
+  int offset = 0;
+  for (int i = 0; i < num_ / ZMM_FLOAT_BLOCK; ++i) {
+    vmovups(zmm_src, ptr[param1 + offset]);
+    act<zmm_t>(zmm_dst, zmm_src, type_);
+    vmovups(ptr[param2 + offset], zmm_dst);
+    offset += sizeof(float) * ZMM_FLOAT_BLOCK;
+  }
+  int rest = num_ % ZMM_FLOAT_BLOCK;
+  if (rest > 0) {
+    // the masked out lanes are zeros, which are computed but not stored
+    SetTailMask(k_tail, rest, eax);
+    vmovups(zmm_src | k_tail | T_z, ptr[param1 + offset]);
+    act<zmm_t>(zmm_dst, zmm_src, type_);
+    vmovups(ptr[param2 + offset] | k_tail, zmm_dst);
+  }
+  vzeroupper();
+  ret();
+}
+
 #define DECLARE_ACT_CREATOR(name)                                            \
   class name##Creator : public JitCodeCreator<int> {                         \
    public:                                                                   \
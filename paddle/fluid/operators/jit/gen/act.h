@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 
 #include "glog/logging.h"
 #include "paddle/fluid/operators/jit/gen/jitcode.h"
@@ -68,21 +69,42 @@ class VActFunc : public JitCode {
   virtual void genCode() = 0;
 
  protected:
-  // compute RELU with ymm, xmm
+  // vxorps of zmm needs AVX512DQ, while vpxord only needs AVX512F
+  template <typename JMM>
+  void zero_jmm(JMM& reg) {  // NOLINT
+    if (std::is_same<JMM, zmm_t>::value) {
+      vpxord(reg, reg, reg);
+    } else {
+      vxorps(reg, reg, reg);
+    }
+  }
+
+  // load one constant of exp_float_consts, which only has YMM_FLOAT_BLOCK
+  // copies of each constant, so zmm broadcasts the first one
+  template <typename JMM>
+  void load_const_jmm(JMM& dst, const Xbyak::Address& addr) {  // NOLINT
+    if (std::is_same<JMM, zmm_t>::value) {
+      vbroadcastss(dst, addr);
+    } else {
+      vmovaps(dst, addr);
+    }
+  }
+
+  // compute RELU with zmm, ymm, xmm
   template <typename JMM>
   void relu_jmm(JMM& dst, JMM& src, int zero_idx = 15) {  // NOLINT
     JMM zero = JMM(zero_idx);
-    vxorps(zero, zero, zero);
+    zero_jmm<JMM>(zero);
     vmaxps(dst, src, zero);
   }
 
-  // compute SQUARE with ymm, xmm
+  // compute SQUARE with zmm, ymm, xmm
   template <typename JMM>
   void square_jmm(JMM& dst, JMM& src) {  // NOLINT
     vmulps(dst, src, src);
   }
 
-  // compute EXP with ymm, xmm
+  // compute EXP with zmm, ymm, xmm
   template <typename JMM>
   void exp_jmm(JMM& dst, JMM& src, int src_idx = 11, int fx_idx = 12,  // NOLINT
                int fy_idx = 13, int mask_idx = 14, int tmp_idx = 15) {
@@ -97,49 +119,59 @@ class VActFunc : public JitCode {
     push(reg_ptr_global);
     vmovaps(jmm_src, src);
     mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_HIG]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_HIG]);
     vminps(jmm_src, jmm_src, jmm_tmp);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOW]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOW]);
     vmaxps(jmm_src, jmm_src, jmm_tmp);
     // express exp(x) as exp(g + n*log(2))
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOG2EF]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_LOG2EF]);
     vmulps(jmm_fx, jmm_src, jmm_tmp);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_0P5]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_0P5]);
     vaddps(jmm_fx, jmm_fx, jmm_tmp);
-    vroundps(jmm_fy, jmm_fx, 0x01);
-    // if greater, substract 1
-    vcmpgtps(jmm_mask, jmm_fy, jmm_fx);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global]);
-    vandps(jmm_mask, jmm_mask, jmm_tmp);
-    vsubps(jmm_fx, jmm_fy, jmm_mask);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C1]);
+    if (std::is_same<JMM, zmm_t>::value) {
+      // the compare of zmm writes a mask register, round down directly
+      vrndscaleps(jmm_fx, jmm_fx, 0x01);
+    } else {
+      vroundps(jmm_fy, jmm_fx, 0x01);
+      // if greater, substract 1
+      vcmpgtps(jmm_mask, jmm_fy, jmm_fx);
+      vmovaps(jmm_tmp, ptr[reg_ptr_global]);
+      vandps(jmm_mask, jmm_mask, jmm_tmp);
+      vsubps(jmm_fx, jmm_fy, jmm_mask);
+    }
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C1]);
     vmulps(jmm_fy, jmm_fx, jmm_tmp);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C2]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_C2]);
     JMM ymm_z = JMM(jmm_mask.getIdx());
     vmulps(ymm_z, jmm_fx, jmm_tmp);
     vsubps(jmm_src, jmm_src, jmm_fy);
     vsubps(jmm_src, jmm_src, ymm_z);
     vmulps(ymm_z, jmm_src, jmm_src);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P0]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P0]);
     vmulps(dst, jmm_src, jmm_tmp);
     for (size_t i = OFFSET_EXP_P1; i < OFFSET_EXP_P5;
          i += (YMM_FLOAT_BLOCK * sizeof(float))) {
-      vmovaps(jmm_tmp, ptr[reg_ptr_global + i]);  // P1~P4
+      load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + i]);  // P1~P4
       vaddps(dst, dst, jmm_tmp);
       vmulps(dst, dst, jmm_src);
     }
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P5]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_P5]);
     vaddps(dst, dst, jmm_tmp);
     vmulps(dst, dst, ymm_z);
     vaddps(dst, dst, jmm_src);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global]);
     vaddps(dst, dst, jmm_tmp);
     // build 2^n
     JMM ymm_int = jmm_fx;
     vcvttps2dq(ymm_int, jmm_fx);
     mov(reg_ptr_global, reinterpret_cast<size_t>(exp_int_0x7f));
-    vmovdqa(jmm_tmp, ptr[reg_ptr_global]);
-    if (MayIUse(avx2) || std::is_same<JMM, xmm_t>::value) {
+    if (std::is_same<JMM, zmm_t>::value) {
+      vpbroadcastd(jmm_tmp, ptr[reg_ptr_global]);
+    } else {
+      vmovdqa(jmm_tmp, ptr[reg_ptr_global]);
+    }
+    if (MayIUse(avx2) || std::is_same<JMM, xmm_t>::value ||
+        std::is_same<JMM, zmm_t>::value) {
       vpaddd(ymm_int, ymm_int, jmm_tmp);
       vpslld(ymm_int, ymm_int, 23);
     } else if (MayIUse(avx)) {
@@ -166,7 +198,7 @@ class VActFunc : public JitCode {
     pop(reg_ptr_global);
   }
 
-  // compute SIGMOID with ymm, xmm
+  // compute SIGMOID with zmm, ymm, xmm
   template <typename JMM>
   void sigmoid_jmm(JMM& dst, JMM& src, int src_idx = 11,  // NOLINT
                    int fx_idx = 12, int fy_idx = 13, int mask_idx = 14,
@@ -178,20 +210,20 @@ class VActFunc : public JitCode {
     push(reg_ptr_global);
     vmovaps(jmm_src, src);
     mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MAX]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MAX]);
     vminps(jmm_src, jmm_src, jmm_tmp);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MIN]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_SIGMOID_MIN]);
     vmaxps(jmm_src, jmm_src, jmm_tmp);
-    vxorps(jmm_tmp, jmm_tmp, jmm_tmp);
+    zero_jmm<JMM>(jmm_tmp);
     vsubps(jmm_src, jmm_tmp, jmm_src);
     exp_jmm<JMM>(dst, jmm_src, src_idx, fx_idx, fy_idx, mask_idx, tmp_idx);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
     vaddps(dst, dst, jmm_tmp);
     vdivps(dst, jmm_tmp, dst);
     pop(reg_ptr_global);
   }
 
-  // compute TANH with ymm, xmm
+  // compute TANH with zmm, ymm, xmm
   template <typename JMM>
   void tanh_jmm(JMM& dst, JMM& src, int src_idx = 11,  // NOLINT
                 int fx_idx = 12, int fy_idx = 13, int mask_idx = 14,
@@ -204,25 +236,25 @@ class VActFunc : public JitCode {
     push(reg_ptr_global);
     vmovaps(jmm_src, src);
     mov(reg_ptr_global, reinterpret_cast<size_t>(exp_float_consts));
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
-    vxorps(jmm_zero, jmm_zero, jmm_zero);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
+    zero_jmm<JMM>(jmm_zero);
     vsubps(jmm_tmp, jmm_zero, jmm_tmp);
     vmulps(jmm_src, jmm_src, jmm_tmp);
     exp_jmm<JMM>(dst, jmm_src, src_idx, fx_idx, fy_idx, mask_idx, tmp_idx);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
     vaddps(dst, dst, jmm_tmp);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_TWO]);
     vdivps(dst, jmm_tmp, dst);
-    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
+    load_const_jmm<JMM>(jmm_tmp, ptr[reg_ptr_global + OFFSET_EXP_ONE]);
     vsubps(dst, dst, jmm_tmp);
     pop(reg_ptr_global);
   }
 
-  // compute IDENTITY with ymm, xmm
+  // compute IDENTITY with zmm, ymm, xmm
   template <typename JMM>
   void identity_jmm(JMM& dst, JMM& src, int zero_idx) {  // NOLINT
     JMM zero = JMM(zero_idx);
-    vxorps(zero, zero, zero);
+    zero_jmm<JMM>(zero);
     vaddps(dst, src, zero);
     // TODO(TJ): use below
     // dst.setIdx(src.getIdx());
@@ -262,7 +294,10 @@ class VActJitCode : public VActFunc {
  public:
   explicit VActJitCode(int d, operand_type type, size_t code_size,
                        void* code_ptr = nullptr)
-      : VActFunc(code_size, code_ptr), num_(d), type_(type) {
+      : VActFunc(code_size, code_ptr),
+        num_(d),
+        type_(type),
+        use_avx512_(UseAVX512()) {
     if (!(type_ == operand_type::RELU || type_ == operand_type::EXP ||
           type_ == operand_type::SIGMOID || type_ == operand_type::TANH ||
           type_ == operand_type::IDENTITY || type_ == operand_type::SQUARE)) {
@@ -296,13 +331,19 @@ class VActJitCode : public VActFunc {
       default:
         break;
     }
+    if (use_avx512_) {
+      base += "_AVX512";
+    }
     return base;
   }
   void genCode() override;
 
  protected:
+  void genAVX512Code();
+
   int num_;
   operand_type type_;
+  bool use_avx512_;
   reg64_t param1{abi_param1};
   reg64_t param2{abi_param2};
 
@@ -311,6 +352,10 @@ class VActJitCode : public VActFunc {
 
   xmm_t xmm_dst = xmm_t(1);
   ymm_t ymm_dst = ymm_t(1);
+
+  zmm_t zmm_src = zmm_t(0);
+  zmm_t zmm_dst = zmm_t(1);
+  opmask_t k_tail = opmask_t(1);
 };
 
 #define DECLARE_ACT_JITCODE(name, op_type)                                    \
@@ -24,6 +24,10 @@ namespace jit {
 namespace gen {
 
 void VXXJitCode::genCode() {
+  if (use_avx512_) {
+    genAVX512Code();
+    return;
+  }
   // do not need push stack, and do not need save avx512reg if do not use avx512
   int offset = 0;
   if (with_relu_) {
@@ -111,6 +115,58 @@ void VXXJitCode::genCode() {
   ret();
 }
 
+void VXXJitCode::computeAVX512(const zmm_t& src1, const zmm_t& src2,
+                               const zmm_t& dst) {
+  if (type_ == operand_type::MUL) {
+    vmulps(dst, src1, src2);
+  } else if (type_ == operand_type::ADD) {
+    vaddps(dst, src1, src2);
+  } else if (type_ == operand_type::SUB) {
+    vsubps(dst, src1, src2);
+  }
+  if (with_relu_) {
+    vmaxps(dst, zmm_zero, dst);
+  }
+}
+
+void VXXJitCode::genAVX512Code() {
+  int offset = 0;
+  if (with_relu_) {
+    vpxord(zmm_zero, zmm_zero, zmm_zero);
+  }
+  if (scalar_index_ == 1) {
+    vbroadcastss(zmm_src1, ptr[param1]);
+  } else if (scalar_index_ == 2) {
+    vbroadcastss(zmm_src2, ptr[param2]);
+  }
+  for (int i = 0; i < num_ / ZMM_FLOAT_BLOCK; ++i) {
+    if (scalar_index_ != 1) {
+      vmovups(zmm_src1, ptr[param1 + offset]);
+    }
+    if (scalar_index_ != 2) {
+      vmovups(zmm_src2, ptr[param2 + offset]);
+    }
+    computeAVX512(zmm_src1, zmm_src2, zmm_dst);
+    vmovups(ptr[param3 + offset], zmm_dst);
+    offset += sizeof(float) * ZMM_FLOAT_BLOCK;
+  }
+  int rest = num_ % ZMM_FLOAT_BLOCK;
+  if (rest > 0) {
+    // the masked out lanes are neither loaded nor stored
+    SetTailMask(k_tail, rest, eax);
+    if (scalar_index_ != 1) {
+      vmovups(zmm_src1 | k_tail | T_z, ptr[param1 + offset]);
+    }
+    if (scalar_index_ != 2) {
+      vmovups(zmm_src2 | k_tail | T_z, ptr[param2 + offset]);
+    }
+    computeAVX512(zmm_src1, zmm_src2, zmm_dst);
+    vmovups(ptr[param3 + offset] | k_tail, zmm_dst);
+  }
+  vzeroupper();
+  ret();
+}
+
 void NCHW16CMulNCJitCode::genCode() {
   // RDI is ptr x_input
   // RSI is ptr y_input
@@ -35,7 +35,8 @@ class VXXJitCode : public JitCode {
         num_(d),
         type_(type),
         scalar_index_(scalar_index),
-        with_relu_(with_relu) {
+        with_relu_(with_relu),
+        use_avx512_(UseAVX512()) {
     if (!(type_ == operand_type::MUL || type_ == operand_type::ADD ||
           type_ == operand_type::SUB)) {
       PADDLE_THROW(platform::errors::Unimplemented(
@@ -64,16 +65,21 @@ class VXXJitCode : public JitCode {
       base += "_Vec";
     }
     base += (with_relu_ ? "_Relu" : "");
+    base += (use_avx512_ ? "_AVX512" : "");
     base += "_D" + std::to_string(num_);
     return base;
   }
   void genCode() override;
 
  private:
+  void genAVX512Code();
+  void computeAVX512(const zmm_t& src1, const zmm_t& src2, const zmm_t& dst);
+
   int num_;
   operand_type type_;
   int scalar_index_;
   bool with_relu_;
+  bool use_avx512_;
   reg64_t param1{abi_param1};
   reg64_t param2{abi_param2};
   reg64_t param3{abi_param3};
@@ -87,6 +93,12 @@ class VXXJitCode : public JitCode {
   ymm_t ymm_src2 = ymm_t(1);
   ymm_t ymm_dst = ymm_t(2);
   ymm_t ymm_zero = ymm_t(3);
+
+  zmm_t zmm_src1 = zmm_t(0);
+  zmm_t zmm_src2 = zmm_t(1);
+  zmm_t zmm_dst = zmm_t(2);
+  zmm_t zmm_zero = zmm_t(3);
+  opmask_t k_tail = opmask_t(1);
 };
 
 #define DECLARE_BLAS_JITCODE(name, op_type, scalar_idx, with_relu)             \
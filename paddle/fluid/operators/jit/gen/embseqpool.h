@@ -32,7 +32,8 @@ class EmbSeqPoolJitCode : public JitCode {
                              void* code_ptr = nullptr)
       : JitCode(code_size, code_ptr),
         tbl_w_(attr.table_width),
-        type_(attr.pool_type) {
+        type_(attr.pool_type),
+        use_avx512_(UseAVX512()) {
     if (type_ != SeqPoolType::kSum) {
       PADDLE_THROW(
           platform::errors::Unimplemented("Only supports sum pool yet."));
@@ -49,14 +50,89 @@ class EmbSeqPoolJitCode : public JitCode {
     } else if (type_ == SeqPoolType::kSqrt) {
       base += "_Sqrt";
     }
+    base += (use_avx512_ ? "_AVX512" : "");
     base += ("_W" + std::to_string(tbl_w_));
     return base;
   }
   void genCode() override;
 
+ protected:
+  // pools the next num_regs blocks of the table width to the dst at
+  // dst_offset, then moves param_tbl to the blocks after them
+  template <typename JMM>
+  void pool_group(int num_regs, int block, size_t dst_offset) {
+    const size_t block_size = sizeof(float) * block;
+    const size_t tbl_width_in_byte = sizeof(float) * tbl_w_;
+    Label l_next_idx_w, l_next_idx_h, l_save_now;
+    xor_(reg_idx_w_i_in_byte, reg_idx_w_i_in_byte);
+    mov(reg_ptr_dst_i, reg_ptr_param_dst);
+    add(reg_ptr_dst_i, dst_offset);
+
+    L(l_next_idx_w);
+    {
+      // h == 0
+      mov(reg_ptr_idx_i, param_idx);
+      add(reg_ptr_idx_i, reg_idx_w_i_in_byte);
+      mov(reg_idx, qword[reg_ptr_idx_i]);
+      mov(rax, tbl_width_in_byte);
+      mul(reg_idx);
+      mov(reg_ptr_tbl_i, rax);        // reg is offset now
+      add(reg_ptr_tbl_i, param_tbl);  // reg is ptr_i now
+      size_t w_offset = 0;
+      for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
+        vmovups(JMM(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
+        w_offset += block_size;
+      }
+      add(reg_ptr_idx_i, reg_idx_width_in_byte);
+
+      // end condition of idx h
+      mov(reg_idx_h_end, reg_idx_height);
+      mov(rax, reg_idx_width_in_byte);
+      mul(reg_idx_h_end);
+      mov(reg_idx_h_end, rax);
+      add(reg_idx_h_end, reg_idx_w_i_in_byte);
+      add(reg_idx_h_end, param_idx);
+
+      cmp(reg_ptr_idx_i, reg_idx_h_end);
+      jge(l_save_now, T_NEAR);
+      L(l_next_idx_h);
+      {
+        mov(reg_idx, qword[reg_ptr_idx_i]);
+        mov(reg_ptr_tbl_i, reg_idx);
+        mov(rax, tbl_width_in_byte);
+        mul(reg_idx);
+        mov(reg_ptr_tbl_i, rax);
+        add(reg_ptr_tbl_i, param_tbl);
+        size_t w_offset = 0;
+        for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
+          vmovups(JMM(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
+          vaddps(JMM(reg_i + num_regs), JMM(reg_i + num_regs), JMM(reg_i));
+          w_offset += block_size;
+        }
+        add(reg_ptr_idx_i, reg_idx_width_in_byte);
+        cmp(reg_ptr_idx_i, reg_idx_h_end);
+        jl(l_next_idx_h, T_NEAR);
+      }  // end of idx h
+      L(l_save_now);
+      // avg or sqrt here, if needed
+      w_offset = 0;
+      for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
+        vmovups(ptr[reg_ptr_dst_i + w_offset], JMM(reg_i + num_regs));
+        w_offset += block_size;
+      }
+      add(reg_ptr_dst_i, tbl_width_in_byte);
+      add(reg_idx_w_i_in_byte, sizeof(int64_t));
+      cmp(reg_idx_w_i_in_byte, reg_idx_width_in_byte);
+      jl(l_next_idx_w, T_NEAR);
+    }  // end of idx w
+
+    add(param_tbl, num_regs * block_size);
+  }
+
  private:
   int tbl_w_;
   SeqPoolType type_;
+  bool use_avx512_;
   reg64_t param_tbl{abi_param1};
   reg64_t param_idx{abi_param2};
   reg64_t param_dst{abi_param3};
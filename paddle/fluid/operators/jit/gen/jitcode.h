@@ -45,6 +45,7 @@ using reg32_t = const Xbyak::Reg32;
 using xmm_t = const Xbyak::Xmm;
 using ymm_t = const Xbyak::Ymm;
 using zmm_t = const Xbyak::Zmm;
+using opmask_t = const Xbyak::Opmask;
 using Label = Xbyak::Label;
 
 typedef enum {
@@ -63,6 +64,11 @@ typedef enum {
 #define DECLARE_JIT_CODE(codename) \
   std::string name() const override { return #codename; }
 
+// Whether the jitcode with 16 floats zmm registers should be generated.
+inline bool UseAVX512() {
+  return FLAGS_jit_avx512 && platform::MayIUse(platform::avx512f);
+}
+
 class JitCode : public GenBase, public Xbyak::CodeGenerator {
  public:
   explicit JitCode(size_t code_size, void* code_ptr = nullptr)
@@ -97,6 +103,12 @@ class JitCode : public GenBase, public Xbyak::CodeGenerator {
     }
     ret();
   }
+  // Set the lowest rest bits of the mask, to load and store the tail of rest
+  // floats with one masked zmm instruction. The tmp register is clobbered.
+  void SetTailMask(opmask_t& mask, int rest, reg32_t& tmp) {  // NOLINT
+    mov(tmp, (1 << rest) - 1);
+    kmovw(mask, tmp);
+  }
   void L(const char* label) { Xbyak::CodeGenerator::L(label); }
   void L(Xbyak::Label& label) { Xbyak::CodeGenerator::L(label); }  // NOLINT
   // Enhanced vector extension
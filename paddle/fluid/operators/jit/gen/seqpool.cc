@@ -24,8 +24,9 @@ namespace jit {
 namespace gen {
 
 void SeqPoolJitCode::genCode() {
-  constexpr int block = YMM_FLOAT_BLOCK;
-  constexpr int max_num_regs = 8;
+  // with AVX-512, pool by zmm and the rest floats by one masked zmm
+  const int block = use_avx512_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  const int max_num_regs = use_avx512_ ? 16 : 8;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
   int rest_num_regs = num_block % max_num_regs;
@@ -45,14 +46,29 @@ void SeqPoolJitCode::genCode() {
   }
   const int group_len = max_num_regs * block * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
-    pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    if (use_avx512_) {
+      pool_height<zmm_t>(g * group_len, block, max_num_regs);
+    } else {
+      pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    }
   }
   if (rest_num_regs > 0) {
-    pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    if (use_avx512_) {
+      pool_height<zmm_t>(num_groups * group_len, block, rest_num_regs);
+    } else {
+      pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    }
   }
   // part of rest_w * height
   const int rest = w_ % block;
-  pool_height_of_rest_width(rest, (w_ - rest) * sizeof(float), max_num_regs);
+  if (use_avx512_) {
+    if (rest > 0) {
+      pool_height_of_rest_width_avx512(rest, (w_ - rest) * sizeof(float));
+    }
+    vzeroupper();
+  } else {
+    pool_height_of_rest_width(rest, (w_ - rest) * sizeof(float), max_num_regs);
+  }
   ret();
 }
 
@@ -30,7 +30,10 @@ class SeqPoolJitCode : public JitCode {
   explicit SeqPoolJitCode(const seq_pool_attr_t& attr,
                           size_t code_size = 256 * 1024,
                           void* code_ptr = nullptr)
-      : JitCode(code_size, code_ptr), w_(attr.w), type_(attr.type) {
+      : JitCode(code_size, code_ptr),
+        w_(attr.w),
+        type_(attr.type),
+        use_avx512_(UseAVX512()) {
     if (!(type_ == SeqPoolType::kSum || type_ == SeqPoolType::kAvg ||
           type_ == SeqPoolType::kSqrt)) {
       PADDLE_THROW(platform::errors::Unimplemented(
@@ -49,6 +52,7 @@ class SeqPoolJitCode : public JitCode {
     } else if (type_ == SeqPoolType::kSqrt) {
       base += "_Sqrt";
     }
+    base += (use_avx512_ ? "_AVX512" : "");
     base += ("_W" + std::to_string(w_));
     return base;
   }
@@ -154,6 +158,35 @@ class SeqPoolJitCode : public JitCode {
     save_rest(rest, w_offset);
   }
 
+  // the rest floats are pooled in one zmm, the masked out lanes are neither
+  // loaded nor stored
+  void pool_height_of_rest_width_avx512(int rest, int w_offset) {
+    SetTailMask(k_tail, rest, eax);
+    vmovups(zmm_t(0) | k_tail | T_z, ptr[param_src + w_offset]);
+    cmp(reg32_int_h, 1);
+    Label l_next_h, l_h_done;
+    jle(l_h_done, T_NEAR);
+    mov(reg_h_i, 1);
+    mov(reg_tmp, param_src);
+    add(reg_tmp, w_ * sizeof(float) + w_offset);
+    L(l_next_h);
+    {
+      vmovups(zmm_t(1) | k_tail | T_z, ptr[reg_tmp]);
+      vaddps(zmm_t(0), zmm_t(0), zmm_t(1));
+      inc(reg_h_i);
+      add(reg_tmp, w_ * sizeof(float));
+      cmp(reg_h_i, reg32_int_h);
+      jl(l_next_h, T_NEAR);
+    }
+    L(l_h_done);
+    if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
+      mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
+      vbroadcastss(zmm_t(1), ptr[reg_tmp]);
+      vmulps(zmm_t(0), zmm_t(0), zmm_t(1));
+    }
+    vmovups(ptr[param_dst + w_offset] | k_tail, zmm_t(0));
+  }
+
   // return the number of used regs, use start from reg 0
   int load_rest(int rest, int w_offset, const int num_shift_regs,
                 const int reg_start = 0) {
@@ -203,6 +236,7 @@ class SeqPoolJitCode : public JitCode {
   float ALIGN32_BEG fp_h_[1] ALIGN32_END;
   int w_;
   SeqPoolType type_;
+  bool use_avx512_;
   reg64_t param_src{abi_param1};
   reg64_t param_dst{abi_param2};
   reg64_t param_attr{abi_param3};
@@ -213,6 +247,8 @@ class SeqPoolJitCode : public JitCode {
 
   reg64_t reg_h_i{r10};
   reg64_t reg_ptr_src_i{r11};
+
+  opmask_t k_tail = opmask_t(1);
 };
 
 }  // namespace gen
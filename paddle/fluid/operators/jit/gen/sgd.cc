@@ -24,40 +24,47 @@ namespace operators {
 namespace jit {
 namespace gen {
 
-void SgdJitCode::mainCode(int num_regs) {
-  constexpr size_t block_size = sizeof(float) * YMM_FLOAT_BLOCK;
+template <typename JMM>
+void SgdJitCode::mainCode(int num_regs, int block) {
+  const size_t block_size = sizeof(float) * block;
   // load grad
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ymm_t(reg_i), ptr[reg_ptr_grad_i]);
+    vmovups(JMM(reg_i), ptr[reg_ptr_grad_i]);
     add(reg_ptr_grad_i, block_size);
   }
   // load param
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_param_i]);
+    vmovups(JMM(reg_i + num_regs), ptr[reg_ptr_param_i]);
     add(reg_ptr_param_i, block_size);
   }
   // compute out
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmulps(ymm_t(reg_i), ymm_t(reg_i), ymm_lr);
-    vsubps(ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
+    vmulps(JMM(reg_i), JMM(reg_i), JMM(lr_idx));
+    vsubps(JMM(reg_i + num_regs), JMM(reg_i + num_regs), JMM(reg_i));
   }
   // save out
   for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-    vmovups(ptr[reg_ptr_out_i], ymm_t(reg_i + num_regs));
+    vmovups(ptr[reg_ptr_out_i], JMM(reg_i + num_regs));
     add(reg_ptr_out_i, block_size);
   }
 }
 
 void SgdJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
+  // with AVX-512, update by zmm and the last YMM_FLOAT_BLOCK floats if any by
+  // ymm
+  const int block = use_avx512_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
   constexpr int max_num_regs = 7;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
   int rest_num_regs = num_block % max_num_regs;
   const size_t width_size = w_ * sizeof(float);
 
-  vbroadcastss(ymm_lr, ptr[param_lr]);
+  if (use_avx512_) {
+    vbroadcastss(zmm_t(lr_idx), ptr[param_lr]);
+  } else {
+    vbroadcastss(ymm_t(lr_idx), ptr[param_lr]);
+  }
 
   mov(reg_ptr_grad_i, param_grad);
   mov(reg_ptr_rows_i, param_rows);
@@ -90,19 +97,33 @@ void SgdJitCode::genCode() {
       cmp(rax, num_groups);
       jnb(escape_loop, T_NEAR);
 
-      mainCode(max_num_regs);
+      if (use_avx512_) {
+        mainCode<zmm_t>(max_num_regs, block);
+      } else {
+        mainCode<ymm_t>(max_num_regs, block);
+      }
 
       inc(rax);
       jmp(inner_loop, T_NEAR);
     }
     L(escape_loop);
-    mainCode(rest_num_regs);
+    if (use_avx512_) {
+      mainCode<zmm_t>(rest_num_regs, block);
+      if (w_ % ZMM_FLOAT_BLOCK != 0) {
+        mainCode<ymm_t>(1, YMM_FLOAT_BLOCK);
+      }
+    } else {
+      mainCode<ymm_t>(rest_num_regs, block);
+    }
 
     add(reg_ptr_rows_i, sizeof(int64_t));
 
     cmp(reg_ptr_rows_i, reg_rows_size_in_byte);
     jl(l_next_row, T_NEAR);
   }
+  if (use_avx512_) {
+    vzeroupper();
+  }
   postCode();
 }
 
@@ -29,16 +29,22 @@ class SgdJitCode : public JitCode {
  public:
   explicit SgdJitCode(const sgd_attr_t& attr, size_t code_size = 256 * 1024,
                       void* code_ptr = nullptr)
-      : JitCode(code_size, code_ptr), w_(attr.grad_width) {
+      : JitCode(code_size, code_ptr),
+        w_(attr.grad_width),
+        use_avx512_(UseAVX512()) {
     this->genCode();
   }
 
-  DECLARE_JIT_CODE(SgdJitCode);
+  std::string name() const override {
+    return use_avx512_ ? "SgdJitCode_AVX512" : "SgdJitCode";
+  }
   void genCode() override;
-  void mainCode(int num_regs);
+  template <typename JMM>
+  void mainCode(int num_regs, int block);
 
  private:
   int w_;
+  bool use_avx512_;
   reg64_t param_lr{abi_param1};
   reg64_t param_param{abi_param2};
   reg64_t param_grad{abi_param3};
@@ -46,7 +52,9 @@ class SgdJitCode : public JitCode {
   reg64_t param_out{abi_param5};
   reg64_t param_attr{abi_param6};
 
-  ymm_t ymm_lr = ymm_t(15);
+  // the lr is broadcast to the whole zmm with AVX-512, so the ymm of the same
+  // index holds it as well
+  const int lr_idx = 15;
 
   reg64_t reg_ptr_grad_i{r10};
   reg64_t reg_ptr_rows_i{r11};
@@ -24,7 +24,9 @@ namespace gen {
 
 void VBroadcastJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
+  // with AVX-512, copy by zmm and the last YMM_FLOAT_BLOCK floats if any by ymm
+  const int block = use_avx512_ ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  const bool has_ymm_tail = use_avx512_ && w_ % ZMM_FLOAT_BLOCK != 0;
   constexpr int max_num_regs = 16;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
@@ -46,23 +48,39 @@ void VBroadcastJitCode::genCode() {
     for (int num_regs : groups) {
       size_t w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ymm_t(reg_i), ptr[reg_ptr_src_i + w_offset]);
+        if (use_avx512_) {
+          vmovups(zmm_t(reg_i), ptr[reg_ptr_src_i + w_offset]);
+        } else {
+          vmovups(ymm_t(reg_i), ptr[reg_ptr_src_i + w_offset]);
+        }
         w_offset += block_size;
       }
       add(reg_ptr_src_i, num_regs * block_size);
 
       w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i));
+        if (use_avx512_) {
+          vmovups(ptr[reg_ptr_dst_i + w_offset], zmm_t(reg_i));
+        } else {
+          vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i));
+        }
         w_offset += block_size;
       }
       add(reg_ptr_dst_i, num_regs * block_size);
     }  // end of groups
+    if (has_ymm_tail) {
+      vmovups(ymm_t(0), ptr[reg_ptr_src_i]);
+      vmovups(ptr[reg_ptr_dst_i], ymm_t(0));
+      add(reg_ptr_dst_i, sizeof(float) * YMM_FLOAT_BLOCK);
+    }
     inc(reg_h_i);
     cmp(reg_h_i, reg_height);
     jl(l_next_h, T_NEAR);
   }  // end of l_next_h
 
+  if (use_avx512_) {
+    vzeroupper();
+  }
   postCode();
 }
 
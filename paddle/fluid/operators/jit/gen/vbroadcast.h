@@ -28,7 +28,7 @@ class VBroadcastJitCode : public JitCode {
  public:
   explicit VBroadcastJitCode(const int64_t& w, size_t code_size = 256 * 1024,
                              void* code_ptr = nullptr)
-      : JitCode(code_size, code_ptr), w_(w) {
+      : JitCode(code_size, code_ptr), w_(w), use_avx512_(UseAVX512()) {
     this->genCode();
   }
 
@@ -37,6 +37,7 @@ class VBroadcastJitCode : public JitCode {
 
  private:
   int w_;
+  bool use_avx512_;
   reg64_t param_src{abi_param1};
   reg64_t param_dst{abi_param2};
   reg64_t param_h{abi_param3};
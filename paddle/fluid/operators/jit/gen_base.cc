@@ -24,6 +24,9 @@
 #endif
 
 DEFINE_bool(dump_jitcode, false, "Whether to dump the jitcode to file");
+DEFINE_bool(jit_avx512, true,
+            "Whether to generate the AVX-512 jitcode on the CPUs supporting "
+            "it. Set false to compare with the AVX2 jitcode.");
 
 namespace paddle {
 namespace operators {
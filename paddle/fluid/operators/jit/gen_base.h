@@ -22,6 +22,7 @@
 #include "paddle/fluid/operators/jit/kernel_base.h"
 
 DECLARE_bool(dump_jitcode);
+DECLARE_bool(jit_avx512);
 
 namespace paddle {
 namespace operators {
@@ -22,6 +22,7 @@
 #include <utility>  // for std::move
 #include <vector>
 
+#include "paddle/fluid/operators/jit/autotune.h"
 #include "paddle/fluid/operators/jit/gen_base.h"
 #include "paddle/fluid/operators/jit/kernel_base.h"
 #include "paddle/fluid/operators/jit/kernel_key.h"
@@ -185,12 +186,57 @@ typename KernelTuple::func_type GetDefaultBestFunc(
   PADDLE_ENFORCE_GE(funcs.size(), 1UL,
                     platform::errors::InvalidArgument(
                         "The candicate jit kernel is at least one in CPU."));
-  // Here could do some runtime benchmark of this attr and return the best one.
-  // But yet just get the first one as the default best one,
-  // which is searched in order and tuned by offline.
+  // Get the first one as the default best one, which is searched in order
+  // and tuned by offline. See GetAutotunedBestFunc for the runtime one.
   return funcs[0];
 }
 
+// Time all the candidates of this attr and return the fastest one. The result
+// is kept in the AutotuneTable, so every (kernel, attr) is only timed once on
+// a CPU model, or never if loaded from FLAGS_jit_autotune_file.
+template <typename KernelTuple, typename PlaceType = platform::CPUPlace>
+typename KernelTuple::func_type GetAutotunedBestFunc(
+    const typename KernelTuple::attr_type& attr) {
+  auto funcs = GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
+  PADDLE_ENFORCE_GE(funcs.size(), 1UL,
+                    platform::errors::InvalidArgument(
+                        "The candicate jit kernel is at least one in CPU."));
+  if (funcs.size() == 1 ||
+      !std::is_same<PlaceType, platform::CPUPlace>::value) {
+    return funcs[0].second;
+  }
+
+  auto& table = AutotuneTable::Instance();
+  int64_t attr_key = AutotuneKey<typename KernelTuple::attr_type>(attr);
+  std::string impl;
+  if (table.Find(KernelTuple::kernel_type, attr_key, &impl)) {
+    for (auto& func : funcs) {
+      if (func.first == impl) {
+        return func.second;
+      }
+    }
+    // The tuned implementation is not built in this binary, tune again.
+  }
+
+  size_t best = 0;
+  double best_time = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    double time = AutotuneTimeFunc(static_cast<const KernelTuple*>(nullptr),
+                                   funcs[i].second, attr);
+    if (time < 0) {
+      return funcs[0].second;
+    }
+    VLOG(4) << to_string(KernelTuple::kernel_type) << " " << attr << " "
+            << funcs[i].first << ": " << time << " us";
+    if (time < best_time) {
+      best = i;
+      best_time = time;
+    }
+  }
+  table.Insert(KernelTuple::kernel_type, attr_key, funcs[best].first);
+  return funcs[best].second;
+}
+
 extern std::map<size_t, std::shared_ptr<void>>& GetFuncCacheMap();
 
 template <typename KernelTuple, typename PlaceType>
@@ -215,12 +261,17 @@ class KernelFuncs {
   typename KernelTuple::func_type At(
       const typename KernelTuple::attr_type& attr) {
     // Maybe here is not good enough, not all kernels should have jitcode
-    int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
+    int64_t key =
+        FLAGS_jit_autotune
+            ? AutotuneKey<typename KernelTuple::attr_type>(attr)
+            : JitCodeKey<typename KernelTuple::attr_type>(attr);
     if (Has(key)) {
       return funcs_.at(key);
     }
     // If do not have this attr in cache then get the default best
-    auto func = GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
+    auto func = FLAGS_jit_autotune
+                    ? GetAutotunedBestFunc<KernelTuple, PlaceType>(attr)
+                    : GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
     Insert(key, func);
     return func;
   }
@@ -283,6 +334,32 @@ inline std::ostream& operator<<(std::ostream& os, const sgd_attr_t& attr) {
   return os;
 }
 
+inline std::ostream& operator<<(std::ostream& os, const adam_attr_t& attr) {
+  os << "param_height[" << attr.param_height << "],param_width["
+     << attr.param_width << "],grad_height[" << attr.grad_height
+     << "],grad_width[" << attr.grad_width << "],selected_rows_size["
+     << attr.selected_rows_size << "],beta1[" << attr.beta1 << "],beta2["
+     << attr.beta2 << "],epsilon[" << attr.epsilon << "]";
+  return os;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const adagrad_attr_t& attr) {
+  os << "param_height[" << attr.param_height << "],param_width["
+     << attr.param_width << "],grad_height[" << attr.grad_height
+     << "],grad_width[" << attr.grad_width << "],selected_rows_size["
+     << attr.selected_rows_size << "],epsilon[" << attr.epsilon << "]";
+  return os;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const ftrl_attr_t& attr) {
+  os << "param_height[" << attr.param_height << "],param_width["
+     << attr.param_width << "],grad_height[" << attr.grad_height
+     << "],grad_width[" << attr.grad_width << "],selected_rows_size["
+     << attr.selected_rows_size << "],l1[" << attr.l1 << "],l2[" << attr.l2
+     << "],lr_power[" << attr.lr_power << "]";
+  return os;
+}
+
 inline std::ostream& operator<<(std::ostream& os, const matmul_attr_t& attr) {
   os << "M[" << attr.m << "],N[" << attr.n << "],K[" << attr.k << "]";
   return os;
@@ -55,6 +55,9 @@ typedef enum {
   kVSquare,
   kVSub,
   kVTanh,
+  kAdam,
+  kAdagrad,
+  kFtrl,
 } KernelType;
 
 typedef enum {
@@ -269,6 +272,97 @@ struct SgdTuple {
                             const sgd_attr_t*);
 };
 
+// The rows of the optimizer kernels below are the same as sgd_attr_t:
+// param is a (param_height, param_width) matrix updated inplace, and the ith
+// row of grad is the gradient of the rows[i]th row of param.
+// A dense param is updated as one row of param_width, with rows = {0}.
+typedef struct adam_attr_s {
+  int64_t param_height, param_width;
+  int64_t grad_height, grad_width;
+  int64_t selected_rows_size;
+  float beta1, beta2, epsilon;
+  adam_attr_s() = default;
+  explicit adam_attr_s(int64_t param_h, int64_t param_w, int64_t grad_h,
+                       int64_t grad_w, int64_t selected_rows_sz,
+                       float beta1_ = 0.9f, float beta2_ = 0.999f,
+                       float epsilon_ = 1e-8f)
+      : param_height(param_h),
+        param_width(param_w),
+        grad_height(grad_h),
+        grad_width(grad_w),
+        selected_rows_size(selected_rows_sz),
+        beta1(beta1_),
+        beta2(beta2_),
+        epsilon(epsilon_) {}
+} adam_attr_t;
+
+// lr, beta1_pow, beta2_pow, grad, rows, param, moment1, moment2
+template <typename T>
+struct AdamTuple {
+  static constexpr KernelType kernel_type = kAdam;
+  typedef T data_type;
+  typedef adam_attr_t attr_type;
+  typedef void (*func_type)(const T*, const T*, const T*, const T*,
+                            const int64_t*, T*, T*, T*, const adam_attr_t*);
+};
+
+typedef struct adagrad_attr_s {
+  int64_t param_height, param_width;
+  int64_t grad_height, grad_width;
+  int64_t selected_rows_size;
+  float epsilon;
+  adagrad_attr_s() = default;
+  explicit adagrad_attr_s(int64_t param_h, int64_t param_w, int64_t grad_h,
+                          int64_t grad_w, int64_t selected_rows_sz,
+                          float epsilon_ = 1e-6f)
+      : param_height(param_h),
+        param_width(param_w),
+        grad_height(grad_h),
+        grad_width(grad_w),
+        selected_rows_size(selected_rows_sz),
+        epsilon(epsilon_) {}
+} adagrad_attr_t;
+
+// lr, grad, rows, param, moment
+template <typename T>
+struct AdagradTuple {
+  static constexpr KernelType kernel_type = kAdagrad;
+  typedef T data_type;
+  typedef adagrad_attr_t attr_type;
+  typedef void (*func_type)(const T*, const T*, const int64_t*, T*, T*,
+                            const adagrad_attr_t*);
+};
+
+typedef struct ftrl_attr_s {
+  int64_t param_height, param_width;
+  int64_t grad_height, grad_width;
+  int64_t selected_rows_size;
+  float l1, l2, lr_power;
+  ftrl_attr_s() = default;
+  explicit ftrl_attr_s(int64_t param_h, int64_t param_w, int64_t grad_h,
+                       int64_t grad_w, int64_t selected_rows_sz,
+                       float l1_ = 0.f, float l2_ = 0.f,
+                       float lr_power_ = -0.5f)
+      : param_height(param_h),
+        param_width(param_w),
+        grad_height(grad_h),
+        grad_width(grad_w),
+        selected_rows_size(selected_rows_sz),
+        l1(l1_),
+        l2(l2_),
+        lr_power(lr_power_) {}
+} ftrl_attr_t;
+
+// lr, grad, rows, param, squared_accum, linear_accum
+template <typename T>
+struct FtrlTuple {
+  static constexpr KernelType kernel_type = kFtrl;
+  typedef T data_type;
+  typedef ftrl_attr_t attr_type;
+  typedef void (*func_type)(const T*, const T*, const int64_t*, T*, T*, T*,
+                            const ftrl_attr_t*);
+};
+
 typedef struct matmul_attr_s {
   int m, n, k;
   void* packed_weight{nullptr};
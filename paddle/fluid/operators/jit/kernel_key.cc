@@ -63,6 +63,23 @@ int64_t JitCodeKey<sgd_attr_t>(const sgd_attr_t& attr) {
   return attr.grad_width;
 }
 
+// The hyperparameters are read from the attr on every call, so they are not
+// part of the key.
+template <>
+int64_t JitCodeKey<adam_attr_t>(const adam_attr_t& attr) {
+  return attr.grad_width;
+}
+
+template <>
+int64_t JitCodeKey<adagrad_attr_t>(const adagrad_attr_t& attr) {
+  return attr.grad_width;
+}
+
+template <>
+int64_t JitCodeKey<ftrl_attr_t>(const ftrl_attr_t& attr) {
+  return attr.grad_width;
+}
+
 }  // namespace jit
 }  // namespace operators
 }  // namespace paddle
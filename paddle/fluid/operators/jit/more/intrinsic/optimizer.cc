@@ -0,0 +1,208 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/fluid/operators/jit/more/intrinsic/optimizer.h"
+#include <cmath>
+#include "paddle/fluid/operators/jit/registry.h"
+#include "paddle/fluid/platform/cpu_info.h"
+
+namespace paddle {
+namespace operators {
+namespace jit {
+namespace more {
+namespace intrinsic {
+// Note: the rows are checked by the refer kernels only, the same as the
+// other kernels of sgd_attr_t.
+
+void Adam(const float* lr, const float* beta1_pow, const float* beta2_pow,
+          const float* grad, const int64_t* rows, float* param, float* mom1,
+          float* mom2, const adam_attr_t* attr) {
+  const float beta1 = attr->beta1;
+  const float beta2 = attr->beta2;
+  const float lr_t = lr[0] * std::sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
+  const float eps_t = attr->epsilon * std::sqrt(1 - beta2_pow[0]);
+  const int64_t width = attr->grad_width;
+  const int64_t end = width - width % YMM_FLOAT_BLOCK;
+
+  const __m256 beta1_vec = _mm256_set1_ps(beta1);
+  const __m256 beta2_vec = _mm256_set1_ps(beta2);
+  const __m256 one_minus_beta1_vec = _mm256_set1_ps(1 - beta1);
+  const __m256 one_minus_beta2_vec = _mm256_set1_ps(1 - beta2);
+  const __m256 lr_vec = _mm256_set1_ps(lr_t);
+  const __m256 eps_vec = _mm256_set1_ps(eps_t);
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const float* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    float* p = param + offset;
+    float* m1 = mom1 + offset;
+    float* m2 = mom2 + offset;
+    int64_t j = 0;
+    for (; j < end; j += YMM_FLOAT_BLOCK) {
+      __m256 g_vec = _mm256_loadu_ps(g + j);
+      __m256 m1_vec = _mm256_add_ps(
+          _mm256_mul_ps(beta1_vec, _mm256_loadu_ps(m1 + j)),
+          _mm256_mul_ps(one_minus_beta1_vec, g_vec));
+      __m256 m2_vec = _mm256_add_ps(
+          _mm256_mul_ps(beta2_vec, _mm256_loadu_ps(m2 + j)),
+          _mm256_mul_ps(_mm256_mul_ps(one_minus_beta2_vec, g_vec), g_vec));
+      __m256 update = _mm256_div_ps(
+          m1_vec, _mm256_add_ps(_mm256_sqrt_ps(m2_vec), eps_vec));
+      _mm256_storeu_ps(m1 + j, m1_vec);
+      _mm256_storeu_ps(m2 + j, m2_vec);
+      _mm256_storeu_ps(p + j, _mm256_sub_ps(_mm256_loadu_ps(p + j),
+                                            _mm256_mul_ps(lr_vec, update)));
+    }
+    for (; j < width; ++j) {
+      m1[j] = beta1 * m1[j] + (1 - beta1) * g[j];
+      m2[j] = beta2 * m2[j] + (1 - beta2) * g[j] * g[j];
+      p[j] -= lr_t * (m1[j] / (std::sqrt(m2[j]) + eps_t));
+    }
+  }
+}
+
+void Adagrad(const float* lr, const float* grad, const int64_t* rows,
+             float* param, float* moment, const adagrad_attr_t* attr) {
+  const float epsilon = attr->epsilon;
+  const int64_t width = attr->grad_width;
+  const int64_t end = width - width % YMM_FLOAT_BLOCK;
+
+  const __m256 lr_vec = _mm256_set1_ps(lr[0]);
+  const __m256 eps_vec = _mm256_set1_ps(epsilon);
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const float* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    float* p = param + offset;
+    float* m = moment + offset;
+    int64_t j = 0;
+    for (; j < end; j += YMM_FLOAT_BLOCK) {
+      __m256 g_vec = _mm256_loadu_ps(g + j);
+      __m256 m_vec =
+          _mm256_add_ps(_mm256_loadu_ps(m + j), _mm256_mul_ps(g_vec, g_vec));
+      __m256 update =
+          _mm256_div_ps(_mm256_mul_ps(lr_vec, g_vec),
+                        _mm256_add_ps(_mm256_sqrt_ps(m_vec), eps_vec));
+      _mm256_storeu_ps(m + j, m_vec);
+      _mm256_storeu_ps(p + j, _mm256_sub_ps(_mm256_loadu_ps(p + j), update));
+    }
+    for (; j < width; ++j) {
+      m[j] += g[j] * g[j];
+      p[j] -= lr[0] * g[j] / (std::sqrt(m[j]) + epsilon);
+    }
+  }
+}
+
+static inline void FtrlOne(float g, float lr, float l1, float l2,
+                           float lr_power, float* p, float* s_acc,
+                           float* l_acc) {
+  float new_acc = *s_acc + g * g;
+  float new_acc_pow, s_acc_pow;
+  if (lr_power == -0.5f) {
+    new_acc_pow = std::sqrt(new_acc);
+    s_acc_pow = std::sqrt(*s_acc);
+  } else {
+    new_acc_pow = std::pow(new_acc, -lr_power);
+    s_acc_pow = std::pow(*s_acc, -lr_power);
+  }
+  *l_acc += g - (new_acc_pow - s_acc_pow) / lr * (*p);
+  if (std::fabs(*l_acc) > l1) {
+    float x = *l_acc >= 0.f ? l1 - *l_acc : -l1 - *l_acc;
+    *p = x / (2.f * l2 + new_acc_pow / lr);
+  } else {
+    *p = 0.f;
+  }
+  *s_acc = new_acc;
+}
+
+void Ftrl(const float* lr, const float* grad, const int64_t* rows,
+          float* param, float* sq_accum, float* lin_accum,
+          const ftrl_attr_t* attr) {
+  const float l1 = attr->l1;
+  const float l2 = attr->l2;
+  const float lr_power = attr->lr_power;
+  const int64_t width = attr->grad_width;
+  // Only the common lr_power of -0.5 is vectorized, with sqrt instead of pow.
+  const int64_t end =
+      lr_power == -0.5f ? width - width % YMM_FLOAT_BLOCK : int64_t(0);
+
+  const __m256 lr_vec = _mm256_set1_ps(lr[0]);
+  const __m256 l1_vec = _mm256_set1_ps(l1);
+  const __m256 neg_l1_vec = _mm256_set1_ps(-l1);
+  const __m256 two_l2_vec = _mm256_set1_ps(2.f * l2);
+  const __m256 zero_vec = _mm256_setzero_ps();
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const float* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    float* p = param + offset;
+    float* s = sq_accum + offset;
+    float* l = lin_accum + offset;
+    int64_t j = 0;
+    for (; j < end; j += YMM_FLOAT_BLOCK) {
+      __m256 g_vec = _mm256_loadu_ps(g + j);
+      __m256 p_vec = _mm256_loadu_ps(p + j);
+      __m256 s_vec = _mm256_loadu_ps(s + j);
+      __m256 new_s_vec = _mm256_add_ps(s_vec, _mm256_mul_ps(g_vec, g_vec));
+      __m256 new_s_sqrt = _mm256_sqrt_ps(new_s_vec);
+      __m256 delta = _mm256_mul_ps(
+          _mm256_div_ps(_mm256_sub_ps(new_s_sqrt, _mm256_sqrt_ps(s_vec)),
+                        lr_vec),
+          p_vec);
+      __m256 l_vec = _mm256_add_ps(_mm256_loadu_ps(l + j),
+                                   _mm256_sub_ps(g_vec, delta));
+      // x = sign(l) * l1 - l, y = 2 * l2 + sqrt(new_s) / lr
+      __m256 x_vec = _mm256_sub_ps(
+          _mm256_blendv_ps(neg_l1_vec, l1_vec,
+                           _mm256_cmp_ps(l_vec, zero_vec, _CMP_GE_OQ)),
+          l_vec);
+      __m256 y_vec =
+          _mm256_add_ps(two_l2_vec, _mm256_div_ps(new_s_sqrt, lr_vec));
+      __m256 shrink = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, l_vec), l1_vec,
+                                    _CMP_GT_OQ);
+      _mm256_storeu_ps(l + j, l_vec);
+      _mm256_storeu_ps(s + j, new_s_vec);
+      _mm256_storeu_ps(p + j,
+                       _mm256_and_ps(shrink, _mm256_div_ps(x_vec, y_vec)));
+    }
+    for (; j < width; ++j) {
+      FtrlOne(g[j], lr[0], l1, l2, lr_power, p + j, s + j, l + j);
+    }
+  }
+}
+
+bool AdamKernel::CanBeUsed(const adam_attr_t& attr) const {
+  return platform::MayIUse(platform::avx) &&
+         attr.param_width == attr.grad_width;
+}
+
+bool AdagradKernel::CanBeUsed(const adagrad_attr_t& attr) const {
+  return platform::MayIUse(platform::avx) &&
+         attr.param_width == attr.grad_width;
+}
+
+bool FtrlKernel::CanBeUsed(const ftrl_attr_t& attr) const {
+  return platform::MayIUse(platform::avx) &&
+         attr.param_width == attr.grad_width;
+}
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace operators
+}  // namespace paddle
+
+namespace intrinsic = paddle::operators::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kAdam, intrinsic, intrinsic::AdamKernel);
+REGISTER_JITKERNEL_MORE(kAdagrad, intrinsic, intrinsic::AdagradKernel);
+REGISTER_JITKERNEL_MORE(kFtrl, intrinsic, intrinsic::FtrlKernel);
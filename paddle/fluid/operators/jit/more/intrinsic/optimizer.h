@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <type_traits>
+
+#include "paddle/fluid/operators/jit/kernel_base.h"
+
+namespace paddle {
+namespace operators {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+// The fused optimizer updates, which read and write every element only once.
+void Adam(const float* lr, const float* beta1_pow, const float* beta2_pow,
+          const float* grad, const int64_t* rows, float* param, float* mom1,
+          float* mom2, const adam_attr_t* attr);
+
+void Adagrad(const float* lr, const float* grad, const int64_t* rows,
+             float* param, float* moment, const adagrad_attr_t* attr);
+
+void Ftrl(const float* lr, const float* grad, const int64_t* rows,
+          float* param, float* sq_accum, float* lin_accum,
+          const ftrl_attr_t* attr);
+
+#define DECLARE_INTRINSIC_OPTIMIZER_KERNEL(name)                             \
+  class name##Kernel : public KernelMore<name##Tuple<float>> {               \
+   public:                                                                   \
+    name##Kernel() { this->func = name; }                                    \
+    bool CanBeUsed(                                                          \
+        const typename name##Tuple<float>::attr_type&) const override;       \
+    const char* ImplType() const override { return "Intrinsic"; }            \
+  }
+
+DECLARE_INTRINSIC_OPTIMIZER_KERNEL(Adam);
+DECLARE_INTRINSIC_OPTIMIZER_KERNEL(Adagrad);
+DECLARE_INTRINSIC_OPTIMIZER_KERNEL(Ftrl);
+
+#undef DECLARE_INTRINSIC_OPTIMIZER_KERNEL
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace operators
+}  // namespace paddle
@@ -58,4 +58,8 @@ REGISTER_REFER_KERNEL(EmbSeqPool);
 REGISTER_REFER_KERNEL(Sgd);
 REGISTER_REFER_KERNEL(VBroadcast);
 
+REGISTER_REFER_KERNEL(Adam);
+REGISTER_REFER_KERNEL(Adagrad);
+REGISTER_REFER_KERNEL(Ftrl);
+
 #undef REGISTER_REFER_KERNEL
@@ -552,6 +552,118 @@ void Sgd(const T* lr, const T* param, const T* grad, const int64_t* rows,
   }
 }
 
+// The rows shared by the optimizer kernels, see sgd_attr_t
+template <typename Attr>
+void CheckOptimizerRows(const char* name, const int64_t* rows,
+                        const Attr* attr) {
+  PADDLE_ENFORCE_EQ(attr->param_width, attr->grad_width,
+                    platform::errors::InvalidArgument(
+                        "The attribute param_width of %s should be "
+                        "equal to the attribute grad_width. But param_width "
+                        "is %d and grad_width is %d.",
+                        name, attr->param_width, attr->grad_width));
+  PADDLE_ENFORCE_LE(attr->selected_rows_size, attr->grad_height,
+                    platform::errors::InvalidArgument(
+                        "The attribute selected_rows_size of %s should be "
+                        "equal to or less than the attribute grad_height. "
+                        "But selected_rows_size is %d and grad_height is %d.",
+                        name, attr->selected_rows_size, attr->grad_height));
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    PADDLE_ENFORCE_EQ(
+        rows[i] >= 0 && rows[i] < attr->param_height, true,
+        platform::errors::InvalidArgument(
+            "The rows of %s should be in [0, %d). But %dth of rows is %d.",
+            name, attr->param_height, i, rows[i]));
+  }
+}
+
+// Adam with the bias correction, inplace on the selected rows:
+// m1 = beta1 * m1 + (1 - beta1) * g
+// m2 = beta2 * m2 + (1 - beta2) * g * g
+// param -= lr * sqrt(1 - beta2_pow) / (1 - beta1_pow) *
+//          m1 / (sqrt(m2) + epsilon * sqrt(1 - beta2_pow))
+template <typename T>
+void Adam(const T* lr, const T* beta1_pow, const T* beta2_pow, const T* grad,
+          const int64_t* rows, T* param, T* mom1, T* mom2,
+          const adam_attr_t* attr) {
+  CheckOptimizerRows("Adam", rows, attr);
+  const T beta1 = static_cast<T>(attr->beta1);
+  const T beta2 = static_cast<T>(attr->beta2);
+  const T lr_t = lr[0] * std::sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
+  const T eps_t = static_cast<T>(attr->epsilon) * std::sqrt(1 - beta2_pow[0]);
+  const int64_t width = attr->grad_width;
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const T* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    for (int64_t j = 0; j < width; ++j) {
+      T m1 = beta1 * mom1[offset + j] + (1 - beta1) * g[j];
+      T m2 = beta2 * mom2[offset + j] + (1 - beta2) * g[j] * g[j];
+      mom1[offset + j] = m1;
+      mom2[offset + j] = m2;
+      param[offset + j] -= lr_t * (m1 / (std::sqrt(m2) + eps_t));
+    }
+  }
+}
+
+// Adagrad inplace on the selected rows:
+// moment += g * g
+// param -= lr * g / (sqrt(moment) + epsilon)
+template <typename T>
+void Adagrad(const T* lr, const T* grad, const int64_t* rows, T* param,
+             T* moment, const adagrad_attr_t* attr) {
+  CheckOptimizerRows("Adagrad", rows, attr);
+  const T epsilon = static_cast<T>(attr->epsilon);
+  const int64_t width = attr->grad_width;
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const T* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    for (int64_t j = 0; j < width; ++j) {
+      T m = moment[offset + j] + g[j] * g[j];
+      moment[offset + j] = m;
+      param[offset + j] -= lr[0] * g[j] / (std::sqrt(m) + epsilon);
+    }
+  }
+}
+
+// FTRL-Proximal inplace on the selected rows, the same as the ftrl op.
+template <typename T>
+void Ftrl(const T* lr, const T* grad, const int64_t* rows, T* param,
+          T* sq_accum, T* lin_accum, const ftrl_attr_t* attr) {
+  CheckOptimizerRows("Ftrl", rows, attr);
+  const T l1 = static_cast<T>(attr->l1);
+  const T l2 = static_cast<T>(attr->l2);
+  const T lr_power = static_cast<T>(attr->lr_power);
+  const int64_t width = attr->grad_width;
+  for (int64_t i = 0; i < attr->selected_rows_size; ++i) {
+    const T* g = grad + i * width;
+    int64_t offset = rows[i] * width;
+    for (int64_t j = 0; j < width; ++j) {
+      T p = param[offset + j];
+      T s_acc = sq_accum[offset + j];
+      T new_acc = s_acc + g[j] * g[j];
+      T new_acc_pow, s_acc_pow;
+      if (lr_power == static_cast<T>(-0.5)) {
+        new_acc_pow = std::sqrt(new_acc);
+        s_acc_pow = std::sqrt(s_acc);
+      } else {
+        new_acc_pow = std::pow(new_acc, -lr_power);
+        s_acc_pow = std::pow(s_acc, -lr_power);
+      }
+      T l_acc = lin_accum[offset + j] +
+                (g[j] - (new_acc_pow - s_acc_pow) / lr[0] * p);
+      lin_accum[offset + j] = l_acc;
+      if (std::fabs(l_acc) > l1) {
+        T x = l_acc >= static_cast<T>(0) ? l1 - l_acc : -l1 - l_acc;
+        T y = static_cast<T>(2) * l2 + new_acc_pow / lr[0];
+        param[offset + j] = x / y;
+      } else {
+        param[offset + j] = static_cast<T>(0);
+      }
+      sq_accum[offset + j] = new_acc;
+    }
+  }
+}
+
 #define DECLARE_REFER_KERNEL(name)                          \
   template <typename T>                                     \
   class name##Kernel : public ReferKernel<name##Tuple<T>> { \
@@ -606,6 +718,11 @@ DECLARE_REFER_KERNEL(EmbSeqPool);
 DECLARE_REFER_KERNEL(Sgd);
 DECLARE_REFER_KERNEL(VBroadcast);
 
+// optimizers
+DECLARE_REFER_KERNEL(Adam);
+DECLARE_REFER_KERNEL(Adagrad);
+DECLARE_REFER_KERNEL(Ftrl);
+
 #undef DECLARE_REFER_KERNEL
 
 }  // namespace refer
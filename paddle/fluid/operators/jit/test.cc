@@ -12,6 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <random>
 
@@ -939,6 +941,161 @@ void TestKernelSgd() {
   }
 }
 
+// rows_size different rows of [0, param_h) in random order
+std::vector<int64_t> RandomRows(int param_h, int rows_size) {
+  std::vector<int64_t> all(param_h);
+  for (int i = 0; i < param_h; ++i) {
+    all[i] = i;
+  }
+  std::default_random_engine rng(param_h * 100 + rows_size);
+  std::shuffle(all.begin(), all.end(), rng);
+  return std::vector<int64_t>(all.begin(), all.begin() + rows_size);
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelAdam() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const T lr = 0.1;
+  const T beta1_pow = 0.9 * 0.9 * 0.9;
+  const T beta2_pow = 0.999 * 0.999 * 0.999;
+  for (int param_h : {1, 10}) {
+    for (int grad_w : TestSizes()) {
+      std::vector<T> param(param_h * grad_w), mom1(param.size()),
+          mom2(param.size());
+      RandomVec<T>(param.size(), param.data());
+      RandomVec<T>(mom1.size(), mom1.data());
+      RandomVec<T>(mom2.size(), mom2.data(), 0.f, 2.f);
+      for (int rows_size : {1, param_h}) {
+        std::vector<T> grad(rows_size * grad_w);
+        RandomVec<T>(grad.size(), grad.data());
+        std::vector<int64_t> rows = RandomRows(param_h, rows_size);
+        jit::adam_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size,
+                              0.9f, 0.999f, 1e-8f);
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        std::vector<T> pref(param), m1ref(mom1), m2ref(mom2);
+        ref(&lr, &beta1_pow, &beta2_pow, grad.data(), rows.data(), pref.data(),
+            m1ref.data(), m2ref.data(), &attr);
+
+        auto verifier = [](
+            const typename KernelTuple::func_type tgt, const T lr,
+            const T beta1_pow, const T beta2_pow, const std::vector<T>& grad,
+            const std::vector<int64_t>& rows, const std::vector<T>& param,
+            const std::vector<T>& mom1, const std::vector<T>& mom2,
+            const std::vector<T>& pref, const std::vector<T>& m1ref,
+            const std::vector<T>& m2ref,
+            const typename KernelTuple::attr_type& attr) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> p(param), m1(mom1), m2(mom2);
+          tgt(&lr, &beta1_pow, &beta2_pow, grad.data(), rows.data(), p.data(),
+              m1.data(), m2.data(), &attr);
+          ExpectEQ<T>(p.data(), pref.data(), p.size());
+          ExpectEQ<T>(m1.data(), m1ref.data(), m1.size());
+          ExpectEQ<T>(m2.data(), m2ref.data(), m2.size());
+        };
+        TestAllImpls<KernelTuple, PlaceType>(
+            attr, verifier, lr, beta1_pow, beta2_pow, grad, rows, param, mom1,
+            mom2, pref, m1ref, m2ref, attr);
+      }
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelAdagrad() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const T lr = 0.1;
+  for (int param_h : {1, 10}) {
+    for (int grad_w : TestSizes()) {
+      std::vector<T> param(param_h * grad_w), moment(param.size());
+      RandomVec<T>(param.size(), param.data());
+      RandomVec<T>(moment.size(), moment.data(), 0.f, 2.f);
+      for (int rows_size : {1, param_h}) {
+        std::vector<T> grad(rows_size * grad_w);
+        RandomVec<T>(grad.size(), grad.data());
+        std::vector<int64_t> rows = RandomRows(param_h, rows_size);
+        jit::adagrad_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size,
+                                 1e-6f);
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        std::vector<T> pref(param), mref(moment);
+        ref(&lr, grad.data(), rows.data(), pref.data(), mref.data(), &attr);
+
+        auto verifier = [](const typename KernelTuple::func_type tgt,
+                           const T lr, const std::vector<T>& grad,
+                           const std::vector<int64_t>& rows,
+                           const std::vector<T>& param,
+                           const std::vector<T>& moment,
+                           const std::vector<T>& pref,
+                           const std::vector<T>& mref,
+                           const typename KernelTuple::attr_type& attr) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> p(param), m(moment);
+          tgt(&lr, grad.data(), rows.data(), p.data(), m.data(), &attr);
+          ExpectEQ<T>(p.data(), pref.data(), p.size());
+          ExpectEQ<T>(m.data(), mref.data(), m.size());
+        };
+        TestAllImpls<KernelTuple, PlaceType>(attr, verifier, lr, grad, rows,
+                                             param, moment, pref, mref, attr);
+      }
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelFtrl() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  auto last_acc = FLAGS_acc;
+  FLAGS_acc = 1e-4;
+  const T lr = 0.5;
+  for (float lr_power : {-0.5f, -0.3f}) {
+    for (int param_h : {1, 10}) {
+      for (int grad_w : TestSizes()) {
+        std::vector<T> param(param_h * grad_w), sq_accum(param.size()),
+            lin_accum(param.size());
+        RandomVec<T>(param.size(), param.data());
+        RandomVec<T>(sq_accum.size(), sq_accum.data(), 0.1f, 2.f);
+        RandomVec<T>(lin_accum.size(), lin_accum.data());
+        for (int rows_size : {1, param_h}) {
+          std::vector<T> grad(rows_size * grad_w);
+          RandomVec<T>(grad.size(), grad.data());
+          std::vector<int64_t> rows = RandomRows(param_h, rows_size);
+          jit::ftrl_attr_t attr(param_h, grad_w, rows_size, grad_w, rows_size,
+                                0.1f, 0.1f, lr_power);
+          auto ref = jit::GetReferFunc<KernelTuple>();
+          EXPECT_TRUE(ref != nullptr);
+          std::vector<T> pref(param), sref(sq_accum), lref(lin_accum);
+          ref(&lr, grad.data(), rows.data(), pref.data(), sref.data(),
+              lref.data(), &attr);
+
+          auto verifier = [](
+              const typename KernelTuple::func_type tgt, const T lr,
+              const std::vector<T>& grad, const std::vector<int64_t>& rows,
+              const std::vector<T>& param, const std::vector<T>& sq_accum,
+              const std::vector<T>& lin_accum, const std::vector<T>& pref,
+              const std::vector<T>& sref, const std::vector<T>& lref,
+              const typename KernelTuple::attr_type& attr) {
+            EXPECT_TRUE(tgt != nullptr);
+            std::vector<T> p(param), s(sq_accum), l(lin_accum);
+            tgt(&lr, grad.data(), rows.data(), p.data(), s.data(), l.data(),
+                &attr);
+            ExpectEQ<T>(p.data(), pref.data(), p.size());
+            ExpectEQ<T>(s.data(), sref.data(), s.size());
+            ExpectEQ<T>(l.data(), lref.data(), l.size());
+          };
+          TestAllImpls<KernelTuple, PlaceType>(attr, verifier, lr, grad, rows,
+                                               param, sq_accum, lin_accum,
+                                               pref, sref, lref, attr);
+        }
+      }
+    }
+  }
+  FLAGS_acc = last_acc;
+}
+
 template <typename KernelTuple, typename PlaceType>
 void TestKernelVBroadcast() {
   using T = typename KernelTuple::data_type;
@@ -1096,6 +1253,204 @@ TEST(JITKernel_helper, GetAllCandidateFuncs) {
   }
 }
 
+TEST(JITKernel_helper, GetAutotunedBestFunc) {
+  auto& table = jit::AutotuneTable::Instance();
+  table.Clear();
+  size_t num_tuned = 0;
+  for (int d : {8, 100, 2000}) {
+    auto funcs =
+        jit::GetAllCandidateFuncsWithTypes<jit::VExpTuple<float>, CPUPlace>(d);
+    std::vector<float> x(d), tgt(d), ref(d);
+    RandomVec<float>(d, x.data());
+    jit::GetReferFunc<jit::VExpTuple<float>>()(x.data(), ref.data(), d);
+    auto best = jit::GetAutotunedBestFunc<jit::VExpTuple<float>, CPUPlace>(d);
+    best(x.data(), tgt.data(), d);
+    ExpectEQ<float>(tgt.data(), ref.data(), d);
+
+    std::string impl;
+    if (funcs.size() > 1) {
+      ++num_tuned;
+      ASSERT_TRUE(table.Find(jit::kVExp, d, &impl));
+      bool found = false;
+      for (auto& f : funcs) {
+        if (f.first == impl) {
+          EXPECT_TRUE(f.second == best);
+          found = true;
+        }
+      }
+      EXPECT_TRUE(found);
+    } else {
+      EXPECT_FALSE(table.Find(jit::kVExp, d, &impl));
+    }
+  }
+  EXPECT_EQ(table.Size(), num_tuned);
+
+  // not timed, the default best one is used
+  jit::lstm_attr_t attr(8, jit::kVSigmoid, jit::kVTanh, jit::kVTanh);
+  auto lstm = jit::GetAutotunedBestFunc<jit::LSTMCtHtTuple<float>, CPUPlace>(
+      attr);
+  EXPECT_TRUE(lstm ==
+              (jit::GetDefaultBestFunc<jit::LSTMCtHtTuple<float>, CPUPlace>(
+                  attr)));
+
+  // the seqpool is tuned per bucket of its height, which the jitcode ignores
+  jit::seq_pool_attr_t short_seq(16, jit::SeqPoolType::kSum, 5);
+  jit::seq_pool_attr_t similar_seq(16, jit::SeqPoolType::kSum, 8);
+  jit::seq_pool_attr_t long_seq(16, jit::SeqPoolType::kSum, 200);
+  EXPECT_EQ(jit::JitCodeKey(short_seq), jit::JitCodeKey(long_seq));
+  EXPECT_EQ(jit::AutotuneKey(short_seq), jit::AutotuneKey(similar_seq));
+  EXPECT_NE(jit::AutotuneKey(short_seq), jit::AutotuneKey(long_seq));
+
+  std::string filename = "jit_autotune_test.txt";
+  std::remove(filename.c_str());
+  table.Insert(jit::kVExp, 1, "Refer");
+  table.Save(filename);
+  table.Clear();
+  EXPECT_EQ(table.Size(), 0UL);
+  table.Load(filename);
+  EXPECT_EQ(table.Size(), num_tuned + 1);
+  std::string impl;
+  ASSERT_TRUE(table.Find(jit::kVExp, 1, &impl));
+  EXPECT_EQ(impl, "Refer");
+  EXPECT_FALSE(table.Find(jit::kVMul, 1, &impl));
+
+  // the entries saved by another process are kept, the ones of this process
+  // replace the same keys in the file
+  {
+    std::ofstream fout(filename, std::ios::app);
+    fout << table.CPUModel() << "\t" << jit::to_string(jit::kVMul)
+         << "\t1\tRefer\n";
+    fout << table.CPUModel() << "\t" << jit::to_string(jit::kVExp)
+         << "\t1\tJitCode\n";
+  }
+  table.Clear();
+  table.Insert(jit::kVExp, 1, "Refer");
+  table.Save(filename);
+  table.Clear();
+  table.Load(filename);
+  EXPECT_EQ(table.Size(), num_tuned + 2);
+  ASSERT_TRUE(table.Find(jit::kVMul, 1, &impl));
+  EXPECT_EQ(impl, "Refer");
+  ASSERT_TRUE(table.Find(jit::kVExp, 1, &impl));
+  EXPECT_EQ(impl, "Refer");
+  table.Clear();
+  std::remove(filename.c_str());
+}
+
+// Generate the jitcode of the kernel with and without AVX-512 directly from
+// the creators, since the JitCodePool caches the one of the first use.
+template <typename KernelTuple>
+std::vector<std::unique_ptr<jit::GenBase>> CreateJitCodesOfAllISA(
+    const typename KernelTuple::attr_type& attr) {
+  using Attr = typename KernelTuple::attr_type;
+  std::vector<std::unique_ptr<jit::GenBase>> codes;
+  jit::KernelKey kkey(KernelTuple::kernel_type, CPUPlace());
+  auto& creator_map = jit::JitCodeCreatorPool::Instance().AllCreators();
+  auto iter = creator_map.find(kkey);
+  if (iter == creator_map.end()) {
+    return codes;
+  }
+  bool use_avx512 = FLAGS_jit_avx512;
+  for (bool avx512 : {true, false}) {
+    FLAGS_jit_avx512 = avx512;
+    for (auto& cur : iter->second) {
+      auto i = dynamic_cast<const jit::JitCodeCreator<Attr>*>(cur.get());
+      if (i && i->CanBeUsed(attr)) {
+        codes.emplace_back(i->CreateJitCode(attr));
+        break;
+      }
+    }
+  }
+  FLAGS_jit_avx512 = use_avx512;
+  return codes;
+}
+
+TEST(JITKernel_helper, jitcode_avx512) {
+  for (int d = 1; d <= 40; ++d) {
+    std::vector<float> x(d), y(d), zref(d), ztgt(d);
+    RandomVec<float>(d, x.data());
+    RandomVec<float>(d, y.data());
+    jit::GetReferFunc<jit::VAddReluTuple<float>>()(x.data(), y.data(),
+                                                    zref.data(), d);
+    for (auto& code : CreateJitCodesOfAllISA<jit::VAddReluTuple<float>>(d)) {
+      auto func = code->getCode<jit::VAddReluTuple<float>::func_type>();
+      func(x.data(), y.data(), ztgt.data(), d);
+      ExpectEQ<float>(ztgt.data(), zref.data(), d);
+    }
+
+    jit::GetReferFunc<jit::VSigmoidTuple<float>>()(x.data(), zref.data(), d);
+    for (auto& code : CreateJitCodesOfAllISA<jit::VSigmoidTuple<float>>(d)) {
+      auto func = code->getCode<jit::VSigmoidTuple<float>::func_type>();
+      func(x.data(), ztgt.data(), d);
+      ExpectEQ<float>(ztgt.data(), zref.data(), d);
+    }
+  }
+
+  for (int64_t w : {8, 16, 24, 136}) {
+    const int64_t h = 3;
+    std::vector<float> x(w), yref(h * w), ytgt(h * w);
+    RandomVec<float>(w, x.data());
+    jit::GetReferFunc<jit::VBroadcastTuple<float>>()(x.data(), yref.data(), h,
+                                                      w);
+    for (auto& code : CreateJitCodesOfAllISA<jit::VBroadcastTuple<float>>(w)) {
+      auto func = code->getCode<jit::VBroadcastTuple<float>::func_type>();
+      func(x.data(), ytgt.data(), h, w);
+      ExpectEQ<float>(ytgt.data(), yref.data(), h * w);
+    }
+  }
+
+  for (int w : {1, 7, 16, 23, 40, 136, 300}) {
+    const int h = 3;
+    std::vector<float> x(h * w), yref(w), ytgt(w);
+    RandomVec<float>(h * w, x.data());
+    for (auto type : {jit::SeqPoolType::kSum, jit::SeqPoolType::kAvg,
+                      jit::SeqPoolType::kSqrt}) {
+      jit::seq_pool_attr_t attr(w, type, h);
+      jit::GetReferFunc<jit::SeqPoolTuple<float>>()(x.data(), yref.data(),
+                                                     &attr);
+      for (auto& code :
+           CreateJitCodesOfAllISA<jit::SeqPoolTuple<float>>(attr)) {
+        auto func = code->getCode<jit::SeqPoolTuple<float>::func_type>();
+        func(x.data(), ytgt.data(), &attr);
+        ExpectEQ<float>(ytgt.data(), yref.data(), w);
+      }
+    }
+  }
+
+  for (int64_t w : {8, 16, 24, 136}) {
+    const int64_t tbl_h = 10, idx_h = 4, idx_w = 2;
+    std::vector<float> table(tbl_h * w), oref(idx_w * w), otgt(idx_w * w);
+    RandomVec<float>(tbl_h * w, table.data());
+    std::vector<int64_t> idx{0, 9, 3, 3, 7, 1, 5, 2};
+    jit::emb_seq_pool_attr_t emb_attr(tbl_h, w, idx_h, idx_w, idx_w * w);
+    jit::GetReferFunc<jit::EmbSeqPoolTuple<float>>()(
+        table.data(), idx.data(), oref.data(), &emb_attr);
+    for (auto& code :
+         CreateJitCodesOfAllISA<jit::EmbSeqPoolTuple<float>>(emb_attr)) {
+      auto func = code->getCode<jit::EmbSeqPoolTuple<float>::func_type>();
+      func(table.data(), idx.data(), otgt.data(), &emb_attr);
+      ExpectEQ<float>(otgt.data(), oref.data(), idx_w * w);
+    }
+
+    const int64_t param_h = 10;
+    const float lr = 0.1f;
+    std::vector<int64_t> rows{1, 3, 4, 8};
+    std::vector<float> param(param_h * w), grad(rows.size() * w);
+    RandomVec<float>(param_h * w, param.data());
+    RandomVec<float>(rows.size() * w, grad.data());
+    std::vector<float> pref(param), ptgt(param);
+    jit::sgd_attr_t sgd_attr(param_h, w, rows.size(), w, rows.size());
+    jit::GetReferFunc<jit::SgdTuple<float>>()(&lr, param.data(), grad.data(),
+                                               rows.data(), pref.data(),
+                                               &sgd_attr);
+    for (auto& code : CreateJitCodesOfAllISA<jit::SgdTuple<float>>(sgd_attr)) {
+      auto func = code->getCode<jit::SgdTuple<float>::func_type>();
+      func(&lr, param.data(), grad.data(), rows.data(), ptgt.data(), &sgd_attr);
+      ExpectEQ<float>(ptgt.data(), pref.data(), param_h * w);
+    }
+  }
+}
+
 TEST(JITKernel_helper, pack_weights) {
   const int N = 8 * 60, K = 2;
   float src[K][N], yref[K][N], y[K * N];
@@ -1148,8 +1503,10 @@ TEST(JITKernel_helper, attr) {
       << jit::to_string(jit::kVMul) << jit::to_string(jit::kVRelu)
       << jit::to_string(jit::kVScal) << jit::to_string(jit::kSgd)
       << jit::to_string(jit::kVSigmoid) << jit::to_string(jit::kVSquare)
-      << jit::to_string(jit::kVSub) << jit::to_string(jit::kVTanh);
-  EXPECT_EQ(out.str().size(), 234UL);
+      << jit::to_string(jit::kVSub) << jit::to_string(jit::kVTanh)
+      << jit::to_string(jit::kAdam) << jit::to_string(jit::kAdagrad)
+      << jit::to_string(jit::kFtrl);
+  EXPECT_EQ(out.str().size(), 252UL);
 
   // SeqPoolTypes
   out.str("");
@@ -1183,6 +1540,10 @@ TEST(JITKernel_helper, attr) {
   out << jit::sgd_attr_t(1, 2, 3, 4, 5);
   EXPECT_EQ(out.str().size(), 81UL);
 
+  out.str("");
+  out << jit::adagrad_attr_t(1, 2, 3, 4, 5, 0.5f);
+  EXPECT_EQ(out.str().size(), 94UL);
+
   out.str("");
   out << jit::matmul_attr_t(1, 2, 3);
   EXPECT_EQ(out.str().size(), 14UL);
@@ -1316,6 +1677,18 @@ TEST(JITKernel_key, sgd) {
   EXPECT_TRUE(key4 != key5);
 }
 
+TEST(JITKernel_key, adam) {
+  // only the width decides the kernel, the hyperparameters are read per call
+  jit::adam_attr_t attr1(1, 2, 3, 2, 3, 0.9f, 0.999f, 1e-8f);
+  jit::adam_attr_t attr2(9, 2, 7, 2, 6, 0.5f, 0.9f, 1e-6f);
+  jit::adam_attr_t attr3(1, 4, 3, 4, 3, 0.9f, 0.999f, 1e-8f);
+
+  EXPECT_TRUE(jit::JitCodeKey<jit::adam_attr_t>(attr1) ==
+              jit::JitCodeKey<jit::adam_attr_t>(attr2));
+  EXPECT_TRUE(jit::JitCodeKey<jit::adam_attr_t>(attr1) !=
+              jit::JitCodeKey<jit::adam_attr_t>(attr3));
+}
+
 // test kernerls
 #define TestKernelVMul TestKernelXYZN
 #define TestKernelVAdd TestKernelXYZN
@@ -1385,6 +1758,9 @@ TEST_CPU_KERNEL(MatMul);
 TEST_CPU_KERNEL(Softmax);
 TEST_CPU_KERNEL(Sgd);
 TEST_CPU_KERNEL(VBroadcast);
+TEST_CPU_KERNEL(Adam);
+TEST_CPU_KERNEL(Adagrad);
+TEST_CPU_KERNEL(Ftrl);
 
 TEST_CPU_KERNEL(StrideASum);
 TEST_CPU_KERNEL(StrideScal);
@@ -0,0 +1,157 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/fluid/platform/float16.h"
+
+/**
+ * CPU implementation of the compute primitives in compute_primitives.h. A
+ * block is processed by one thread on CPU, see datamover_primitives_cpu.h.
+ */
+
+namespace paddle {
+namespace operators {
+namespace kernel_primitives {
+namespace details {
+
+constexpr int kReduceMaxThread = 1;
+constexpr int kWarpSize = 1;
+
+// kGlobalMode: block reduce, each block gets an output;
+// kLocalMode: thread reduce, each thread gets an output;
+enum ReduceMode { kGlobalMode, kLocalMode };
+
+template <typename T>
+class MPTypeTrait {
+ public:
+  using Type = T;
+};
+
+template <>
+class MPTypeTrait<platform::float16> {
+ public:
+  using Type = float;
+};
+
+}  // namespace details
+
+/**
+ * @brief Run func(block_id) for every block in [0, num_blocks). This is the
+ * CPU counterpart of launching a grid of kernel blocks, blocks are split
+ * between the OpenMP threads.
+ */
+template <typename Func>
+inline void ParallelForBlocks(int64_t num_blocks, Func func) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (num_blocks > 1)
+#endif
+  for (int64_t block_id = 0; block_id < num_blocks; ++block_id) {
+    func(block_id);
+  }
+}
+
+/**
+ * @brief Perform unary calculation according to OpFunc. Size of input and
+ * output are the same.
+ */
+template <typename InT, typename OutT, int NX, int NY, int BlockSize,
+          class OpFunc>
+inline void ElementwiseUnary(OutT* out, const InT* in, OpFunc compute) {
+  for (int idx = 0; idx < NX * NY; idx++) {
+    out[idx] = static_cast<OutT>(compute(in[idx]));
+  }
+}
+
+/**
+ * @brief Binary calculation according to OpFunc. Size of The input and output
+ * are the same.
+ */
+template <typename InT, typename OutT, int NX, int NY, int BlockSize,
+          class OpFunc>
+inline void ElementwiseBinary(OutT* out, const InT* in1, const InT* in2,
+                              OpFunc compute) {
+  for (int idx = 0; idx < NX * NY; ++idx) {
+    out[idx] = static_cast<OutT>(compute(in1[idx], in2[idx]));
+  }
+}
+
+/**
+ * @brief Ternary calculation according to OpFunc. Size of input and output
+ * are the same.
+ */
+template <typename InT, typename OutT, int NX, int NY, int BlockSize,
+          class OpFunc>
+inline void ElementwiseTernary(OutT* out, const InT* in1, const InT* in2,
+                               const InT* in3, OpFunc compute) {
+  for (int idx = 0; idx < NX * NY; ++idx) {
+    out[idx] = static_cast<OutT>(compute(in1[idx], in2[idx], in3[idx]));
+  }
+}
+
+/**
+ * @brief Multivariate calculation according to OpFunc. Size of input and output
+ * are the same.
+ */
+template <typename InT, typename OutT, int NX, int NY, int BlockSize, int Arity,
+          class OpFunc>
+inline void ElementwiseAny(OutT* out, InT (*ins)[NX * NY], OpFunc compute) {
+  InT args[Arity];
+  for (int idx = 0; idx < NX * NY; ++idx) {
+    for (int j = 0; j < Arity; ++j) {
+      args[j] = ins[j][idx];
+    }
+    out[idx] = static_cast<OutT>(compute(args));
+  }
+}
+
+/**
+ * @brief Binary calculation according to OpFunc. Shape of in1 is [1, NX], but
+ * in2's shape is [NY, NX], the output shape is [NY, NX].
+ */
+template <typename InT, typename OutT, int NX, int NY, int BlockSize,
+          class OpFunc>
+inline void CycleBinary(OutT* out, const InT* in1, const InT* in2,
+                        OpFunc compute) {
+  for (int idy = 0; idy < NY; idy++) {
+    for (int idx = 0; idx < NX; idx++) {
+      out[idx + idy * NX] =
+          static_cast<OutT>(compute(in1[idx], in2[idx + idy * NX]));
+    }
+  }
+}
+
+/**
+ * @brief Reduce the data of a block. When ReduceMode == kLocalMode, reduce
+ * along nx. Since a block only has one thread on CPU, the kGlobalMode reduce
+ * between threads does nothing.
+ */
+template <typename T, int NX, int NY, int BlockSize, class ReduceFunctor,
+          details::ReduceMode Mode>
+inline void Reduce(T* out, const T* in, ReduceFunctor reducer,
+                   bool reduce_last_dim) {
+  if (Mode == details::ReduceMode::kLocalMode) {
+    for (int i = 0; i < NY; ++i) {
+      for (int j = 0; j < NX; ++j) {
+        out[i] = reducer(out[i], in[i * NX + j]);
+      }
+    }
+  }
+}
+
+}  // namespace kernel_primitives
+}  // namespace operators
+}  // namespace paddle
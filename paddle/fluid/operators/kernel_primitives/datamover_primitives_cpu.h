@@ -0,0 +1,303 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "paddle/fluid/framework/ddim.h"
+#include "paddle/fluid/platform/hostdevice.h"
+
+/**
+ * CPU implementation of the data movement primitives in
+ * datamover_primitives.h. The template parameters and arguments are the same
+ * as the GPU version, so that a kernel body written against the primitives
+ * can be instantiated for both backends.
+ *
+ * On CPU a block is processed by one thread, which means threadIdx.x is
+ * always 0 and blockDim.x is always 1: the pointers and block_offset passed in
+ * already point to the data of the current block. To keep the per-call
+ * overhead small, kernels should use a much larger NX on CPU (e.g. 256) than
+ * on GPU, the loops below are plain unit-stride loops which the compiler
+ * vectorizes.
+ */
+
+namespace paddle {
+namespace operators {
+namespace kernel_primitives {
+namespace details {
+
+#define INT_BITS 32
+
+template <typename T, int VecSize>
+struct alignas(sizeof(T) * VecSize) VectorType {
+  T val[VecSize];
+};
+
+/**
+ * Same as the GPU FastDivMod, the high 32 bits multiplication is done by a
+ * 64 bits multiplication on CPU, which is still much cheaper than division.
+ */
+struct FastDivMod {
+  using DivModT = VectorType<uint32_t, 2>;
+
+  FastDivMod() {}
+  HOSTDEVICE FastDivMod(uint32_t d) : divisor(d) {
+    static_assert(sizeof(unsigned int) == 4,
+                  "Only Support 32-bit unsigned int.");
+
+    for (shift_val = 0; shift_val < INT_BITS; ++shift_val) {
+      auto shift_limit = 1 << shift_val;
+      if (shift_limit >= divisor) break;
+    }
+    uint64_t long_one = 1;
+    uint64_t temp_div =
+        ((long_one << INT_BITS) * ((long_one << shift_val) - divisor)) /
+            divisor +
+        1;
+    multiplier = temp_div;
+  }
+
+  inline uint32_t Div(uint32_t n) const {
+    uint32_t t = static_cast<uint32_t>(
+        (static_cast<uint64_t>(n) * multiplier) >> INT_BITS);
+    return (t + n) >> shift_val;
+  }
+
+  inline DivModT Divmod(uint32_t n) const {
+    uint32_t q = Div(n);
+    DivModT result = {q, n - q * divisor};
+    return result;
+  }
+
+  int32_t divisor;
+  int32_t shift_val;
+  uint32_t multiplier;
+};
+
+/**
+ * Configuration of broadcast, same as the GPU version. If input or output
+ * shape is [dim0, dim1] then dims must be [dim1, dim0].
+ */
+template <int kDims>
+struct BroadcastConfig {
+  FastDivMod divmoders[kDims];
+  uint32_t strides[framework::DDim::kMaxRank];
+  HOSTDEVICE BroadcastConfig() {}
+
+  HOSTDEVICE BroadcastConfig(const std::vector<int64_t>& out_dims,
+                             const std::vector<int64_t>& in_dims,
+                             int dim_size) {
+    std::vector<uint32_t> strides_in;
+    std::vector<FastDivMod> divmoders_in;
+    // for divmoders
+    divmoders_in.resize(dim_size);
+    for (int i = 0; i < dim_size; ++i) {
+      divmoders_in[i] = FastDivMod(out_dims[i]);
+    }
+    // for strides
+    strides_in.resize(dim_size, 1);
+    for (int i = 0; i < dim_size; ++i) {
+      strides_in[i] = in_dims[i] == 1 ? 0 : strides_in[i];
+      strides_in[i] =
+          (i != 0 && strides_in[i] != 0)
+              ? std::accumulate(in_dims.begin(), in_dims.begin() + i, 1,
+                                std::multiplies<int64_t>())
+              : strides_in[i];
+    }
+
+    memcpy(strides, strides_in.data(), kDims * sizeof(uint32_t));
+    memcpy(divmoders, divmoders_in.data(), kDims * sizeof(FastDivMod));
+  }
+};
+
+#undef INT_BITS
+}  // namespace details
+
+/**
+ * @brief Read 2D data from memory to registers according to Tx type, and
+ * store it as Ty type. See the GPU version for the meaning of the parameters.
+ */
+template <typename Tx, typename Ty, int NX, int NY, int BlockSize,
+          bool IsBoundary = false>
+inline void ReadData(Ty* dst, const Tx* __restrict__ src, int size_nx,
+                     int size_ny, int stride_nx, int stride_ny) {
+  for (int idy = 0; idy < NY; ++idy) {
+    if (IsBoundary && idy >= size_ny) {
+      break;
+    }
+    for (int idx = 0; idx < NX; ++idx) {
+      if (IsBoundary && idx >= size_nx) {
+        break;
+      }
+      dst[idy * NX + idx] =
+          static_cast<Ty>(src[idx * stride_nx + idy * stride_ny]);
+    }
+  }
+}
+
+/**
+ * @brief Initialize register with init_data.
+ */
+template <typename T, int NX>
+inline void Init(T* dst, T init_data) {
+  for (int i = 0; i < NX; i++) {
+    dst[i] = init_data;
+  }
+}
+
+/**
+ * @brief Read NX continuous data from memory to registers, only NY = 1 was
+ * supported. When IsBoundary = true only the first num data are loaded.
+ */
+template <typename T, int NX, int NY, int BlockSize, bool IsBoundary = false>
+inline void ReadData(T* dst, const T* __restrict__ src, int num) {
+  if (IsBoundary) {
+    int size = num < NX ? num : NX;
+    for (int idx = 0; idx < size; ++idx) {
+      dst[idx] = src[idx];
+    }
+  } else {
+    for (int idx = 0; idx < NX; ++idx) {
+      dst[idx] = src[idx];
+    }
+  }
+}
+
+/**
+ * @brief Read 2D data from memory to registers for broadcast. See the GPU
+ * version for the meaning of the parameters.
+ *
+ * When stride_nx == 1 the coordinate of the first output of every row is
+ * computed by FastDivMod, and the following ones are obtained by carrying the
+ * coordinate, so no division is needed in the inner loop.
+ */
+template <typename T, int NX, int NY, int BlockSize, int Rank,
+          bool IsBoundary = false>
+inline void ReadDataBc(T* dst, const T* __restrict__ src,
+                       uint32_t block_offset,
+                       details::BroadcastConfig<Rank> config,
+                       int total_num_output, int stride_nx, int stride_ny) {
+  uint32_t total = static_cast<uint32_t>(total_num_output);
+  for (int ny = 0; ny < NY; ++ny) {
+    uint32_t row_offset = block_offset + ny * stride_ny;
+    if (IsBoundary && row_offset >= total) {
+      break;
+    }
+
+    if (stride_nx != 1) {
+      for (int nx = 0; nx < NX; ++nx) {
+        uint32_t index_output = row_offset + nx * stride_nx;
+        if (IsBoundary && index_output >= total) {
+          break;
+        }
+        uint32_t index_src = 0;
+        for (int i = 0; i < Rank; ++i) {
+          auto fast_divmoder = config.divmoders[i].Divmod(index_output);
+          index_output = fast_divmoder.val[0];
+          index_src += fast_divmoder.val[1] * config.strides[i];
+        }
+        dst[nx + ny * NX] = src[index_src];
+      }
+      continue;
+    }
+
+    uint32_t coords[Rank];
+    uint32_t index_output = row_offset;
+    uint32_t index_src = 0;
+    for (int i = 0; i < Rank; ++i) {
+      auto fast_divmoder = config.divmoders[i].Divmod(index_output);
+      index_output = fast_divmoder.val[0];
+      coords[i] = fast_divmoder.val[1];
+      index_src += coords[i] * config.strides[i];
+    }
+    int size = NX;
+    if (IsBoundary && total - row_offset < static_cast<uint32_t>(NX)) {
+      size = static_cast<int>(total - row_offset);
+    }
+    for (int nx = 0; nx < size; ++nx) {
+      dst[nx + ny * NX] = src[index_src];
+      for (int i = 0; i < Rank; ++i) {
+        index_src += config.strides[i];
+        if (++coords[i] < static_cast<uint32_t>(config.divmoders[i].divisor)) {
+          break;
+        }
+        index_src -= coords[i] * config.strides[i];
+        coords[i] = 0;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Read 2D data from memory to registers for reduce. See the GPU
+ * version for the meaning of the parameters, the thread offset in block is
+ * always 0 on CPU.
+ */
+template <typename T, int NX, int NY, int BlockSize, int Rank,
+          typename IndexCal, bool IsBoundary = false>
+inline void ReadDataReduce(T* dst, const T* __restrict__ src, int block_offset,
+                           const IndexCal& index_cal, int size_nx, int size_ny,
+                           int stride_nx, int stride_ny,
+                           bool reduce_last_dim) {
+  int thread_offset = block_offset;
+  if (NX == 1) {
+    for (int ny = 0; ny < NY; ++ny) {
+      if (IsBoundary && thread_offset >= size_ny) {
+        break;
+      }
+      uint32_t index_src = index_cal(thread_offset);
+      dst[ny] = src[index_src];
+      thread_offset += stride_ny;
+    }
+  } else {
+    for (int nx = 0; nx < NX; ++nx) {
+      if (IsBoundary && nx * stride_nx >= size_nx) {
+        break;
+      }
+      for (int ny = 0; ny < NY; ++ny) {
+        uint32_t index_src = index_cal(thread_offset);
+        dst[nx + ny * NX] = src[index_src];
+        thread_offset += stride_ny;
+      }
+      thread_offset += stride_nx;
+    }
+  }
+}
+
+/**
+ * @brief Write NX continuous data from registers to memory, only NY = 1 was
+ * supported. When IsBoundary = true only the first num data are stored.
+ */
+template <typename T, int NX, int NY, int BlockSize, bool IsBoundary = false>
+inline void WriteData(T* dst, T* __restrict__ src, int num) {
+  if (IsBoundary) {
+    int size = num < NX ? num : NX;
+    for (int idx = 0; idx < size; ++idx) {
+      dst[idx] = src[idx];
+    }
+  } else {
+    for (int idx = 0; idx < NX; ++idx) {
+      dst[idx] = src[idx];
+    }
+  }
+}
+
+}  // namespace kernel_primitives
+}  // namespace operators
+}  // namespace paddle
@@ -14,23 +14,27 @@
 
 #pragma once
 
+#include <cmath>
+
+#include "paddle/fluid/platform/eigen_ext.h"
+#include "paddle/fluid/platform/float16.h"
+#include "paddle/fluid/platform/hostdevice.h"
+
 namespace paddle {
 namespace operators {
 namespace kernel_primitives {
 namespace details {
 
-static __device__ __forceinline__ platform::float16 ExpFunctor(
-    platform::float16 x) {
+static HOSTDEVICE inline platform::float16 ExpFunctor(platform::float16 x) {
   return ::Eigen::numext::exp(x);
 }
-static __device__ __forceinline__ float ExpFunctor(float x) { return expf(x); }
-static __device__ __forceinline__ double ExpFunctor(double x) { return exp(x); }
-static __device__ __forceinline__ platform::float16 LogFunctor(
-    platform::float16 x) {
+static HOSTDEVICE inline float ExpFunctor(float x) { return expf(x); }
+static HOSTDEVICE inline double ExpFunctor(double x) { return exp(x); }
+static HOSTDEVICE inline platform::float16 LogFunctor(platform::float16 x) {
   return ::Eigen::numext::log(x);
 }
-static __device__ __forceinline__ float LogFunctor(float x) { return logf(x); }
-static __device__ __forceinline__ double LogFunctor(double x) { return log(x); }
+static HOSTDEVICE inline float LogFunctor(float x) { return logf(x); }
+static HOSTDEVICE inline double LogFunctor(double x) { return log(x); }
 
 /*************************** Compute Functor****************************/
 // for margin_cross_entropy
@@ -14,8 +14,15 @@
 
 #pragma once
 
+#if defined(__NVCC__) || defined(__HIPCC__)
 #include "paddle/fluid/operators/kernel_primitives/compute_primitives.h"
 #include "paddle/fluid/operators/kernel_primitives/datamover_primitives.h"
+#else
+// The primitives have the same interface on CPU, so that one kernel body can
+// be compiled for both CPU and GPU.
+#include "paddle/fluid/operators/kernel_primitives/compute_primitives_cpu.h"
+#include "paddle/fluid/operators/kernel_primitives/datamover_primitives_cpu.h"
+#endif
 #include "paddle/fluid/operators/kernel_primitives/helper_primitives.h"
 
 namespace paddle {
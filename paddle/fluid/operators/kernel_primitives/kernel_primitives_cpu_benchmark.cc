@@ -0,0 +1,221 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/operators/kernel_primitives/kernel_primitives.h"
+#include "paddle/fluid/platform/device_tracer.h"
+#include "paddle/fluid/platform/place.h"
+
+DEFINE_int32(burning, 10, "Burning times.");
+DEFINE_int32(repeat, 100, "Repeat times.");
+DEFINE_int32(rows, 4096, "The rows of the input.");
+DEFINE_int32(cols, 1024, "The cols of the input.");
+
+USE_OP(elementwise_add);
+USE_OP(reduce_sum);
+
+namespace framework = paddle::framework;
+namespace platform = paddle::platform;
+namespace kps = paddle::operators::kernel_primitives;
+
+// The number of data processed by a block. On CPU a block is processed by
+// one thread, so it is much larger than the VecSize used on GPU.
+constexpr int kNX = 256;
+
+template <typename T>
+struct AddFunctor {
+  inline T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <typename T, bool IsBoundary>
+void AddBlock(const T* x, const T* y, T* out, int num) {
+  T x_reg[kNX];
+  T y_reg[kNX];
+  T out_reg[kNX];
+  kps::ReadData<T, kNX, 1, 1, IsBoundary>(x_reg, x, num);
+  kps::ReadData<T, kNX, 1, 1, IsBoundary>(y_reg, y, num);
+  kps::ElementwiseBinary<T, T, kNX, 1, 1, AddFunctor<T>>(out_reg, x_reg, y_reg,
+                                                         AddFunctor<T>());
+  kps::WriteData<T, kNX, 1, 1, IsBoundary>(out, out_reg, num);
+}
+
+template <typename T, bool IsBoundary>
+void BroadcastAddBlock(const T* x, const T* y, T* out, uint32_t offset,
+                       const kps::details::BroadcastConfig<2>& config,
+                       int numel) {
+  T x_reg[kNX];
+  T y_reg[kNX];
+  T out_reg[kNX];
+  kps::ReadData<T, kNX, 1, 1, IsBoundary>(x_reg, x + offset, numel - offset);
+  kps::ReadDataBc<T, kNX, 1, 1, 2, IsBoundary>(y_reg, y, offset, config, numel,
+                                               1, 1);
+  kps::ElementwiseBinary<T, T, kNX, 1, 1, AddFunctor<T>>(out_reg, x_reg, y_reg,
+                                                         AddFunctor<T>());
+  kps::WriteData<T, kNX, 1, 1, IsBoundary>(out + offset, out_reg,
+                                           numel - offset);
+}
+
+template <typename T>
+void ReduceSumRow(const T* x, T* out, int cols) {
+  T reg[kNX];
+  T sum = static_cast<T>(0);
+  int offset = 0;
+  for (; offset + kNX <= cols; offset += kNX) {
+    kps::ReadData<T, kNX, 1, 1, false>(reg, x + offset, kNX);
+    kps::Reduce<T, kNX, 1, 1, AddFunctor<T>,
+                kps::details::ReduceMode::kLocalMode>(&sum, reg,
+                                                      AddFunctor<T>(), true);
+  }
+  if (offset < cols) {
+    kps::Init<T, kNX>(reg, static_cast<T>(0));
+    kps::ReadData<T, kNX, 1, 1, true>(reg, x + offset, cols - offset);
+    kps::Reduce<T, kNX, 1, 1, AddFunctor<T>,
+                kps::details::ReduceMode::kLocalMode>(&sum, reg,
+                                                      AddFunctor<T>(), true);
+  }
+  *out = sum;
+}
+
+// return the average time in us
+double Bench(const std::function<void()>& func) {
+  for (int i = 0; i < FLAGS_burning; ++i) {
+    func();
+  }
+  auto start = platform::PosixInNsec() * 1e-3;
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    func();
+  }
+  auto end = platform::PosixInNsec() * 1e-3;
+  return static_cast<double>(end - start) / FLAGS_repeat;
+}
+
+float* InitTensor(framework::Scope* scope, const std::string& name,
+                  const framework::DDim& dims, unsigned int seed) {
+  auto* tensor = scope->Var(name)->GetMutable<framework::LoDTensor>();
+  float* data = tensor->mutable_data<float>(dims, platform::CPUPlace());
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = dist(rng);
+  }
+  return data;
+}
+
+float* GetOutput(framework::Scope* scope, const std::string& name,
+                 const framework::DDim& dims) {
+  auto* tensor = scope->Var(name)->GetMutable<framework::LoDTensor>();
+  return tensor->mutable_data<float>(dims, platform::CPUPlace());
+}
+
+void BenchElementwiseAdd(bool broadcast) {
+  framework::Scope scope;
+  platform::CPUPlace place;
+  int rows = FLAGS_rows;
+  int cols = FLAGS_cols;
+  int numel = rows * cols;
+  auto y_dims = broadcast ? framework::make_ddim({cols})
+                          : framework::make_ddim({rows, cols});
+  const float* x = InitTensor(&scope, "x", {rows, cols}, 1);
+  const float* y = InitTensor(&scope, "y", y_dims, 2);
+  float* out = GetOutput(&scope, "out", {rows, cols});
+
+  auto op = framework::OpRegistry::CreateOp(
+      "elementwise_add", {{"X", {"x"}}, {"Y", {"y"}}}, {{"Out", {"out"}}},
+      {{"axis", -1}});
+  double op_time = Bench([&] { op->Run(scope, place); });
+
+  int64_t num_blocks = (numel + kNX - 1) / kNX;
+  double kps_time = 0.;
+  if (broadcast) {
+    kps::details::BroadcastConfig<2> config({cols, rows}, {cols, 1}, 2);
+    kps_time = Bench([&] {
+      kps::ParallelForBlocks(num_blocks, [&](int64_t block_id) {
+        uint32_t offset = block_id * kNX;
+        if (numel - offset < kNX) {
+          BroadcastAddBlock<float, true>(x, y, out, offset, config, numel);
+        } else {
+          BroadcastAddBlock<float, false>(x, y, out, offset, config, numel);
+        }
+      });
+    });
+  } else {
+    kps_time = Bench([&] {
+      kps::ParallelForBlocks(num_blocks, [&](int64_t block_id) {
+        int offset = block_id * kNX;
+        int num = numel - offset;
+        if (num < kNX) {
+          AddBlock<float, true>(x + offset, y + offset, out + offset, num);
+        } else {
+          AddBlock<float, false>(x + offset, y + offset, out + offset, num);
+        }
+      });
+    });
+  }
+
+  LOG(INFO) << "elementwise_add" << (broadcast ? " (broadcast)" : "") << " ["
+            << rows << ", " << cols << "]: op takes " << op_time
+            << " us; kernel_primitives takes " << kps_time << " us.";
+}
+
+void BenchReduceSum() {
+  framework::Scope scope;
+  platform::CPUPlace place;
+  int rows = FLAGS_rows;
+  int cols = FLAGS_cols;
+  const float* x = InitTensor(&scope, "x", {rows, cols}, 1);
+  float* out = GetOutput(&scope, "out", {rows});
+
+  auto op = framework::OpRegistry::CreateOp(
+      "reduce_sum", {{"X", {"x"}}}, {{"Out", {"out"}}},
+      {{"dim", std::vector<int>{-1}}, {"keep_dim", false}});
+  double op_time = Bench([&] { op->Run(scope, place); });
+
+  double kps_time = Bench([&] {
+    kps::ParallelForBlocks(rows, [&](int64_t row) {
+      ReduceSumRow<float>(x + row * cols, out + row, cols);
+    });
+  });
+
+  LOG(INFO) << "reduce_sum [" << rows << ", " << cols << "] along the last dim"
+            << ": op takes " << op_time << " us; kernel_primitives takes "
+            << kps_time << " us.";
+}
+
+// Compare the kernels written against the CPU kernel_primitives with the
+// current CPU kernels of elementwise_add and reduce_sum.
+// Options:
+//     --burning: the burning time before count
+//     --repeat: the repeat times
+//     --rows, --cols: the shape of the input
+int main(int argc, char* argv[]) {
+  ::GFLAGS_NAMESPACE::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  LOG(INFO) << "Burning " << FLAGS_burning << " times, Repeat " << FLAGS_repeat
+            << " times.";
+
+  BenchElementwiseAdd(false);
+  BenchElementwiseAdd(true);
+  BenchReduceSum();
+  return 0;
+}
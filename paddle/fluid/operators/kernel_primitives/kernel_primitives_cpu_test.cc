@@ -0,0 +1,196 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/operators/kernel_primitives/kernel_primitives.h"
+
+namespace kps = paddle::operators::kernel_primitives;
+
+namespace {
+
+constexpr int kNX = 64;
+
+template <typename T>
+struct AddFunctor {
+  inline T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <typename T>
+struct AddAnyFunctor {
+  inline T operator()(const T* args) const { return args[0] + args[1]; }
+};
+
+// The kernel body is the same as the GPU ones: data_offset is computed from
+// the block index and the primitives handle the offset inside the block.
+template <typename T, bool IsBoundary>
+void AddBlock(const T* x, const T* y, T* out, int num) {
+  T x_reg[kNX];
+  T y_reg[kNX];
+  T out_reg[kNX];
+  kps::Init<T, kNX>(x_reg, static_cast<T>(0));
+  kps::Init<T, kNX>(y_reg, static_cast<T>(0));
+  kps::ReadData<T, kNX, 1, 1, IsBoundary>(x_reg, x, num);
+  kps::ReadData<T, kNX, 1, 1, IsBoundary>(y_reg, y, num);
+  kps::ElementwiseBinary<T, T, kNX, 1, 1, AddFunctor<T>>(out_reg, x_reg, y_reg,
+                                                         AddFunctor<T>());
+  kps::WriteData<T, kNX, 1, 1, IsBoundary>(out, out_reg, num);
+}
+
+template <typename T>
+void Add(const T* x, const T* y, T* out, int numel) {
+  int64_t num_blocks = (numel + kNX - 1) / kNX;
+  kps::ParallelForBlocks(num_blocks, [=](int64_t block_id) {
+    int offset = block_id * kNX;
+    int num = numel - offset;
+    if (num < kNX) {
+      AddBlock<T, true>(x + offset, y + offset, out + offset, num);
+    } else {
+      AddBlock<T, false>(x + offset, y + offset, out + offset, num);
+    }
+  });
+}
+
+std::vector<float> RandomVector(int n, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> v(n);
+  for (auto& e : v) {
+    e = dist(rng);
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST(KernelPrimitivesCPU, ElementwiseBinary) {
+  for (int numel : {1, kNX - 1, kNX, 10 * kNX + 7}) {
+    auto x = RandomVector(numel, 1);
+    auto y = RandomVector(numel, 2);
+    std::vector<float> out(numel, 0.f);
+    Add(x.data(), y.data(), out.data(), numel);
+    for (int i = 0; i < numel; ++i) {
+      EXPECT_FLOAT_EQ(out[i], x[i] + y[i]);
+    }
+  }
+}
+
+TEST(KernelPrimitivesCPU, ElementwiseAny) {
+  auto x = RandomVector(kNX, 1);
+  auto y = RandomVector(kNX, 2);
+  float args[2][kNX];
+  float out[kNX];
+  kps::ReadData<float, kNX, 1, 1>(args[0], x.data(), kNX);
+  kps::ReadData<float, kNX, 1, 1>(args[1], y.data(), kNX);
+  kps::ElementwiseAny<float, float, kNX, 1, 1, 2, AddAnyFunctor<float>>(
+      out, args, AddAnyFunctor<float>());
+  for (int i = 0; i < kNX; ++i) {
+    EXPECT_FLOAT_EQ(out[i], x[i] + y[i]);
+  }
+}
+
+TEST(KernelPrimitivesCPU, ReadDataBc) {
+  // out: [4, 3, 5], in: [4, 1, 5], the dims are stored in reversed order.
+  const std::vector<int64_t> out_dims = {5, 3, 4};
+  const std::vector<int64_t> in_dims = {5, 1, 4};
+  const int numel = 4 * 3 * 5;
+  auto in = RandomVector(4 * 5, 3);
+  kps::details::BroadcastConfig<3> config(out_dims, in_dims, 3);
+
+  constexpr int kBcNX = 8;
+  std::vector<float> out(numel, 0.f);
+  for (int offset = 0; offset < numel; offset += kBcNX) {
+    float reg[kBcNX];
+    int num = std::min(kBcNX, numel - offset);
+    kps::ReadDataBc<float, kBcNX, 1, 1, 3, true>(reg, in.data(), offset,
+                                                  config, numel, 1, 1);
+    kps::WriteData<float, kBcNX, 1, 1, true>(out.data() + offset, reg, num);
+  }
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (int k = 0; k < 5; ++k) {
+        EXPECT_EQ(out[(i * 3 + j) * 5 + k], in[i * 5 + k]);
+      }
+    }
+  }
+
+  // Read with stride_nx != 1, every thread loads one column.
+  float reg[4];
+  kps::ReadDataBc<float, 4, 1, 1, 3, false>(reg, in.data(), 7, config, numel,
+                                            15, 1);
+  for (int i = 0; i < 4; ++i) {
+    // out index 7 + 15 * i is [i, 1, 2]
+    EXPECT_EQ(reg[i], in[i * 5 + 2]);
+  }
+}
+
+TEST(KernelPrimitivesCPU, ReduceLastDim) {
+  const int rows = 13;
+  const int cols = 3 * kNX + 5;
+  auto x = RandomVector(rows * cols, 4);
+  std::vector<float> out(rows, 0.f);
+
+  kps::ParallelForBlocks(rows, [&](int64_t row) {
+    const float* in = x.data() + row * cols;
+    float reg[kNX];
+    float sum = 0.f;
+    for (int offset = 0; offset < cols; offset += kNX) {
+      kps::Init<float, kNX>(reg, 0.f);
+      kps::ReadData<float, kNX, 1, 1, true>(reg, in + offset, cols - offset);
+      kps::Reduce<float, kNX, 1, 1, AddFunctor<float>,
+                  kps::details::ReduceMode::kLocalMode>(
+          &sum, reg, AddFunctor<float>(), true);
+    }
+    kps::Reduce<float, 1, 1, 1, AddFunctor<float>,
+                kps::details::ReduceMode::kGlobalMode>(
+        &sum, &sum, AddFunctor<float>(), true);
+    out[row] = sum;
+  });
+
+  for (int i = 0; i < rows; ++i) {
+    double expected = 0.;
+    for (int j = 0; j < cols; ++j) {
+      expected += x[i * cols + j];
+    }
+    EXPECT_NEAR(out[i], expected, 1e-4);
+  }
+}
+
+TEST(KernelPrimitivesCPU, ReadData2D) {
+  // Read a [3, 4] tile from a [5, 6] matrix with boundary check.
+  std::vector<int> src(5 * 6);
+  for (int i = 0; i < 30; ++i) {
+    src[i] = i;
+  }
+  int reg[3 * 4];
+  kps::Init<int, 12>(reg, -1);
+  kps::ReadData<int, int, 4, 3, 1, true>(reg, src.data() + 6 + 3, 3, 2, 1, 6);
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      int expected = (y < 2 && x < 3) ? (y + 1) * 6 + x + 3 : -1;
+      EXPECT_EQ(reg[y * 4 + x], expected);
+    }
+  }
+}
+
+TEST(KernelPrimitivesCPU, HelperFunctor) {
+  kps::details::ExpLogitTransformer<float> exp_functor(1);
+  EXPECT_FLOAT_EQ(exp_functor(1.f), std::exp(1.f));
+  kps::details::DivideFunctor<float> div_functor(4);
+  EXPECT_FLOAT_EQ(div_functor(2.f), 0.5f);
+}
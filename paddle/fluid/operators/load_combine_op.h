@@ -14,15 +14,22 @@ limitations under the License. */
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <string>
 #include <vector>
 
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/async_file_writer.h"
 #include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/threadpool.h"
 #include "paddle/fluid/platform/device_context.h"
 
+DECLARE_int32(load_combine_num_threads);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -41,6 +48,8 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "it to be greater than 0.",
                           out_var_names.size()));
     if (!model_from_memory) {
+      // the file may still be written by an asynchronous save_combine op
+      framework::AsyncFileWriter::Instance().Wait(filename);
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
           static_cast<bool>(fin), true,
@@ -48,6 +57,12 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
               "LoadCombine operator fails to open file %s, please check "
               "whether the model file is complete or damaged.",
               filename));
+      if (FLAGS_load_combine_num_threads > 1 && out_var_names.size() > 1 &&
+          platform::is_cpu_place(place)) {
+        LoadParamsInParallel(ctx, place, filename, &fin, load_as_fp16,
+                             out_var_names);
+        return;
+      }
       LoadParamsFromBuffer(ctx, place, &fin, load_as_fp16, out_var_names);
     } else {
       PADDLE_ENFORCE_NE(
@@ -70,45 +85,113 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
     auto out_vars = context.MultiOutputVar("Out");
 
     for (size_t i = 0; i < out_var_names.size(); i++) {
-      VLOG(4) << "loading tensor: " << out_var_names[i];
-      PADDLE_ENFORCE_NOT_NULL(
-          out_vars[i], platform::errors::InvalidArgument(
-                           "The variable %s to be loaded cannot be found.",
-                           out_var_names[i]));
-
-      auto *tensor = out_vars[i]->GetMutable<framework::LoDTensor>();
+      LoadTensor(place, dev_ctx, buffer, load_as_fp16, out_var_names[i],
+                 out_vars[i]);
+    }
+    CheckAllLoaded(buffer);
+  }
 
-      // Error checking
+  // Index the offset of every tensor in one pass over their headers, then
+  // read and deserialize the tensors with FLAGS_load_combine_num_threads
+  // threads. Every thread reads through its own file handle, so the reads
+  // are positioned independently of each other.
+  void LoadParamsInParallel(
+      const framework::ExecutionContext &context, const platform::Place &place,
+      const std::string &filename, std::ifstream *fin, bool load_as_fp16,
+      const std::vector<std::string> &out_var_names) const {
+    auto out_vars = context.MultiOutputVar("Out");
+    std::vector<std::streamoff> offsets(out_var_names.size());
+    std::streamoff offset = 0;
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      offsets[i] = offset;
+      offset += static_cast<std::streamoff>(
+          framework::SkipLoDTensorInStream(*fin));
       PADDLE_ENFORCE_EQ(
-          static_cast<bool>(*buffer), true,
+          static_cast<bool>(*fin), true,
           platform::errors::Unavailable(
               "An error occurred while loading model parameters. "
               "Please check whether the model file is complete or damaged."));
+    }
+    CheckAllLoaded(fin);
 
-      // Get data from fin to tensor
-      DeserializeFromStream(*buffer, tensor, dev_ctx);
-
-      auto in_dtype = tensor->type();
-      auto out_dtype =
-          load_as_fp16 ? framework::proto::VarType::FP16 : in_dtype;
-
-      if (in_dtype != out_dtype) {
-        // convert to float16 tensor
-        auto in_kernel_type = framework::OpKernelType(in_dtype, place);
-        auto out_kernel_type = framework::OpKernelType(out_dtype, place);
-        framework::LoDTensor fp16_tensor;
-        // copy LoD info to the new tensor
-        fp16_tensor.set_lod(tensor->lod());
-        framework::TransDataType(in_kernel_type, out_kernel_type, *tensor,
-                                 &fp16_tensor);
-
-        // reset output tensor
-        out_vars[i]->Clear();
-        tensor = out_vars[i]->GetMutable<framework::LoDTensor>();
-        tensor->set_lod(fp16_tensor.lod());
-        tensor->ShareDataWith(fp16_tensor);
-      }
+    size_t num_threads = std::min(
+        static_cast<size_t>(FLAGS_load_combine_num_threads),
+        out_var_names.size());
+    VLOG(3) << "load " << out_var_names.size() << " tensors from " << filename
+            << " with " << num_threads << " threads";
+    platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
+    auto &dev_ctx = *pool.Get(place);
+    // Tensors are taken one by one from a shared counter, so that a few
+    // large embeddings do not leave the other threads idle.
+    std::atomic<size_t> next{0};
+    framework::ThreadPool thread_pool(num_threads);
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      futures.emplace_back(thread_pool.Run([&] {
+        std::ifstream in(filename, std::ios::binary);
+        PADDLE_ENFORCE_EQ(
+            static_cast<bool>(in), true,
+            platform::errors::Unavailable(
+                "LoadCombine operator fails to open file %s, please check "
+                "whether the model file is complete or damaged.",
+                filename));
+        for (size_t i = next++; i < out_var_names.size(); i = next++) {
+          in.seekg(offsets[i]);
+          LoadTensor(place, dev_ctx, &in, load_as_fp16, out_var_names[i],
+                     out_vars[i]);
+        }
+      }));
     }
+    for (auto &f : futures) {
+      f.get();
+    }
+  }
+
+ private:
+  void LoadTensor(const platform::Place &place,
+                  const platform::DeviceContext &dev_ctx, std::istream *buffer,
+                  bool load_as_fp16, const std::string &var_name,
+                  framework::Variable *var) const {
+    VLOG(4) << "loading tensor: " << var_name;
+    PADDLE_ENFORCE_NOT_NULL(
+        var, platform::errors::InvalidArgument(
+                 "The variable %s to be loaded cannot be found.", var_name));
+
+    auto *tensor = var->GetMutable<framework::LoDTensor>();
+
+    // Error checking
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(*buffer), true,
+        platform::errors::Unavailable(
+            "An error occurred while loading model parameters. "
+            "Please check whether the model file is complete or damaged."));
+
+    // Get data from fin to tensor
+    DeserializeFromStream(*buffer, tensor, dev_ctx);
+
+    auto in_dtype = tensor->type();
+    auto out_dtype = load_as_fp16 ? framework::proto::VarType::FP16 : in_dtype;
+
+    if (in_dtype != out_dtype) {
+      // convert to float16 tensor
+      auto in_kernel_type = framework::OpKernelType(in_dtype, place);
+      auto out_kernel_type = framework::OpKernelType(out_dtype, place);
+      framework::LoDTensor fp16_tensor;
+      // copy LoD info to the new tensor
+      fp16_tensor.set_lod(tensor->lod());
+      framework::TransDataType(in_kernel_type, out_kernel_type, *tensor,
+                               &fp16_tensor);
+
+      // reset output tensor
+      var->Clear();
+      tensor = var->GetMutable<framework::LoDTensor>();
+      tensor->set_lod(fp16_tensor.lod());
+      tensor->ShareDataWith(fp16_tensor);
+    }
+  }
+
+  void CheckAllLoaded(std::istream *buffer) const {
     buffer->peek();
     PADDLE_ENFORCE_EQ(buffer->eof(), true,
                       platform::errors::Unavailable(
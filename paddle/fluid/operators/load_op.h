@@ -19,6 +19,7 @@ limitations under the License. */
 #include <vector>
 
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/async_file_writer.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/profiler.h"
@@ -33,6 +34,8 @@ class LoadOpKernel : public framework::OpKernel<T> {
     // FIXME(yuyang18): We save variable to local file now, but we should change
     // it to save an output stream.
     auto filename = ctx.Attr<std::string>("file_path");
+    // the file may still be written by an asynchronous save op
+    framework::AsyncFileWriter::Instance().Wait(filename);
     std::ifstream fin(filename, std::ios::binary);
     PADDLE_ENFORCE_EQ(static_cast<bool>(fin), true,
                       platform::errors::Unavailable(
@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/math/depthwise_conv.h"
+
+#include <algorithm>
+
+namespace paddle {
+namespace operators {
+namespace math {
+
+/*
+ * Each output channel is computed directly from its input channel, without
+ * the im2col buffer and the gemm of one channel a time. The planes of the
+ * batch are computed in parallel.
+ * Only the NCHW layout is supported, and the paddings are {pad_h, pad_w},
+ * the paddings of the top and the left.
+ */
+template <typename T, bool fuse_relu_before_conv>
+class DepthwiseConvFunctor<platform::CPUDeviceContext, T,
+                           fuse_relu_before_conv> {
+ public:
+  void operator()(const platform::CPUDeviceContext& context,
+                  const framework::Tensor& input,
+                  const framework::Tensor& filter,
+                  const std::vector<int>& strides,
+                  const std::vector<int>& paddings,
+                  const std::vector<int>& dilations, framework::Tensor* output,
+                  const DataLayout data_layout = DataLayout::kNCHW) {
+    PADDLE_ENFORCE_NE(data_layout, DataLayout::kNHWC,
+                      platform::errors::Unimplemented(
+                          "The depthwise convolution on CPU only supports the "
+                          "NCHW layout."));
+    const int batch_size = input.dims()[0];
+    const int input_channels = input.dims()[1];
+    const int input_height = input.dims()[2];
+    const int input_width = input.dims()[3];
+    const int output_channels = output->dims()[1];
+    const int output_height = output->dims()[2];
+    const int output_width = output->dims()[3];
+    const int ksize_height = filter.dims()[2];
+    const int ksize_width = filter.dims()[3];
+    const int stride_height = strides[0];
+    const int stride_width = strides[1];
+    const int padding_height = paddings[0];
+    const int padding_width = paddings[1];
+    const int dilate_height = dilations[0];
+    const int dilate_width = dilations[1];
+    const int filter_multiplier = output_channels / input_channels;
+
+    const T* input_data = input.data<T>();
+    const T* filter_data = filter.data<T>();
+    T* output_data = output->mutable_data<T>(context.GetPlace());
+
+    const int input_size = input_height * input_width;
+    const int output_size = output_height * output_width;
+    const int num_planes = batch_size * output_channels;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int plane = 0; plane < num_planes; ++plane) {
+      const int batch = plane / output_channels;
+      const int c_out = plane % output_channels;
+      const int c_in = c_out / filter_multiplier;
+      const T* in = input_data + (batch * input_channels + c_in) * input_size;
+      const T* weight = filter_data + c_out * ksize_height * ksize_width;
+      T* out = output_data + plane * output_size;
+      std::fill(out, out + output_size, static_cast<T>(0));
+
+      for (int kh = 0; kh < ksize_height; ++kh) {
+        for (int kw = 0; kw < ksize_width; ++kw) {
+          const T w = weight[kh * ksize_width + kw];
+          const int h_offset = kh * dilate_height - padding_height;
+          const int w_offset = kw * dilate_width - padding_width;
+          // The range of the output columns whose input column is inside.
+          int ow_begin = 0;
+          if (w_offset < 0) {
+            ow_begin = (-w_offset + stride_width - 1) / stride_width;
+          }
+          int ow_end = 0;
+          if (input_width - 1 - w_offset >= 0) {
+            ow_end = std::min(
+                output_width, (input_width - 1 - w_offset) / stride_width + 1);
+          }
+          for (int oh = 0; oh < output_height; ++oh) {
+            const int ih = oh * stride_height + h_offset;
+            if (ih < 0 || ih >= input_height) {
+              continue;
+            }
+            const T* in_row = in + ih * input_width;
+            T* out_row = out + oh * output_width;
+            for (int ow = ow_begin; ow < ow_end; ++ow) {
+              T value = in_row[ow * stride_width + w_offset];
+              if (fuse_relu_before_conv) {
+                value = std::max(value, static_cast<T>(0));
+              }
+              out_row[ow] += w * value;
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+template class DepthwiseConvFunctor<platform::CPUDeviceContext, float, false>;
+template class DepthwiseConvFunctor<platform::CPUDeviceContext, double, false>;
+template class DepthwiseConvFunctor<platform::CPUDeviceContext, float, true>;
+template class DepthwiseConvFunctor<platform::CPUDeviceContext, double, true>;
+
+}  // namespace math
+}  // namespace operators
+}  // namespace paddle
@@ -0,0 +1,95 @@
+/* Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/operators/math/depthwise_conv.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+template <bool fuse_relu>
+void TestDepthwiseConvCPU(int stride, int padding, int dilation) {
+  const int batch_size = 2, input_channels = 3, filter_multiplier = 2;
+  const int input_height = 7, input_width = 6, ksize = 3;
+  const int output_channels = input_channels * filter_multiplier;
+  const int output_height =
+      (input_height + 2 * padding - dilation * (ksize - 1) - 1) / stride + 1;
+  const int output_width =
+      (input_width + 2 * padding - dilation * (ksize - 1) - 1) / stride + 1;
+
+  paddle::platform::CPUPlace place;
+  paddle::platform::CPUDeviceContext context(place);
+  paddle::framework::Tensor input, filter, output;
+  float* input_data = input.mutable_data<float>(
+      {batch_size, input_channels, input_height, input_width}, place);
+  float* filter_data =
+      filter.mutable_data<float>({output_channels, 1, ksize, ksize}, place);
+  output.mutable_data<float>(
+      {batch_size, output_channels, output_height, output_width}, place);
+  for (int i = 0; i < input.numel(); ++i) {
+    input_data[i] = static_cast<float>(i % 11) - 5.f;
+  }
+  for (int i = 0; i < filter.numel(); ++i) {
+    filter_data[i] = static_cast<float>(i % 5) - 2.f;
+  }
+
+  paddle::operators::math::DepthwiseConvFunctor<
+      paddle::platform::CPUDeviceContext, float, fuse_relu>
+      depthwise_conv;
+  depthwise_conv(context, input, filter, {stride, stride}, {padding, padding},
+                 {dilation, dilation}, &output);
+
+  const float* output_data = output.data<float>();
+  for (int n = 0; n < batch_size; ++n) {
+    for (int c = 0; c < output_channels; ++c) {
+      for (int oh = 0; oh < output_height; ++oh) {
+        for (int ow = 0; ow < output_width; ++ow) {
+          float expected = 0.f;
+          for (int kh = 0; kh < ksize; ++kh) {
+            for (int kw = 0; kw < ksize; ++kw) {
+              int ih = oh * stride - padding + kh * dilation;
+              int iw = ow * stride - padding + kw * dilation;
+              if (ih < 0 || ih >= input_height || iw < 0 ||
+                  iw >= input_width) {
+                continue;
+              }
+              int c_in = c / filter_multiplier;
+              int in_offset =
+                  ((n * input_channels + c_in) * input_height + ih) *
+                      input_width +
+                  iw;
+              float in = input_data[in_offset];
+              if (fuse_relu) {
+                in = std::max(in, 0.f);
+              }
+              expected += filter_data[(c * ksize + kh) * ksize + kw] * in;
+            }
+          }
+          int out_offset =
+              ((n * output_channels + c) * output_height + oh) * output_width +
+              ow;
+          EXPECT_FLOAT_EQ(output_data[out_offset], expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(math, depthwise_conv_cpu) {
+  TestDepthwiseConvCPU<false>(1, 1, 1);
+  TestDepthwiseConvCPU<false>(2, 1, 1);
+  TestDepthwiseConvCPU<false>(1, 2, 2);
+  TestDepthwiseConvCPU<false>(2, 0, 1);
+  TestDepthwiseConvCPU<true>(1, 1, 1);
+}
@@ -17,6 +17,7 @@ limitations under the License. */
 
 #include <cmath>
 
+#include "paddle/fluid/operators/jit/kernels.h"
 #include "paddle/fluid/operators/math/math_function.h"
 #include "paddle/fluid/operators/math/selected_rows_functor.h"
 
@@ -121,25 +122,20 @@ struct SparseAdagradFunctor<platform::CPUDeviceContext, T> {
     auto& merge_rows = grad_merge.rows();
     auto* grad_merge_data = grad_merge.mutable_value()->template data<T>();
 
-    // 2. m += g_m * g_m
-    auto grad_square =
-        SquareSelectedRows<platform::CPUDeviceContext, T>(context, grad_merge);
-
-    math::SelectedRowsAddToTensor<platform::CPUDeviceContext, T> functor;
-    functor(context, grad_square, moment);
-
-    // 3. update parameter
-    auto* lr = learning_rate.data<T>();
-    auto* param_data = param->data<T>();
-    auto* moment_data = moment->data<T>();
-
-    for (size_t i = 0; i < merge_rows.size(); i++) {
-      for (int64_t j = 0; j < grad_width; j++) {
-        param_data[merge_rows[i] * grad_width + j] -=
-            lr[0] * grad_merge_data[i * grad_width + j] /
-            (std::sqrt(moment_data[merge_rows[i] * grad_width + j]) + epsilon);
-      }
-    }
+    // 2. m += g_m * g_m and update parameter in one pass
+    jit::adagrad_attr_t attr;
+    attr.param_height = param->dims()[0];
+    attr.param_width = param->numel() / attr.param_height;
+    attr.grad_height = merge_rows.size();
+    attr.grad_width = grad_width;
+    attr.selected_rows_size = merge_rows.size();
+    attr.epsilon = static_cast<float>(epsilon);
+
+    auto adagrad =
+        jit::KernelFuncs<jit::AdagradTuple<T>, platform::CPUPlace>::Cache().At(
+            attr);
+    adagrad(learning_rate.data<T>(), grad_merge_data, merge_rows.data(),
+            param->data<T>(), moment->data<T>(), &attr);
   }
 };
 
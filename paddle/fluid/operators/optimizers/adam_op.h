@@ -15,11 +15,13 @@ limitations under the License. */
 #pragma once
 #include <math.h>  // for sqrt in CPU and CUDA
 #include <Eigen/Dense>
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/threadpool.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 #include "paddle/fluid/operators/math/algorithm.h"
 #include "paddle/fluid/operators/math/selected_rows_functor.h"
 #include "paddle/fluid/platform/for_range.h"
@@ -58,6 +60,20 @@ class AdamOp : public framework::OperatorWithKernel {
 struct GPUAdam;
 struct CPUAdam;
 
+// The jit adam kernel updates the tensors inplace, so the output is copied from
+// the input first if they do not share the memory.
+template <typename T>
+static T* InplaceAdamOutput(const framework::Tensor& in,
+                            framework::Tensor* out,
+                            const platform::Place& place) {
+  T* out_data = out->mutable_data<T>(place);
+  const T* in_data = in.data<T>();
+  if (out_data != in_data) {
+    std::copy(in_data, in_data + in.numel(), out_data);
+  }
+  return out_data;
+}
+
 template <typename T, typename Flavour>
 class AdamFunctor;
 
@@ -506,13 +522,20 @@ class AdamOpKernel : public framework::OpKernel<T> {
     if (grad_var->IsType<framework::LoDTensor>()) {
       auto* grad = ctx.Input<LoDTensor>("Grad");
 
-      AdamFunctor<T, CPUAdam> functor(
-          beta1, beta2, epsilon, beta1_pow->data<T>(), beta2_pow->data<T>(),
-          mom1->data<T>(), mom1_out->mutable_data<T>(ctx.GetPlace()),
-          mom2->data<T>(), mom2_out->mutable_data<T>(ctx.GetPlace()),
-          lr->data<T>(), grad->data<T>(), param->data<T>(),
-          param_out->mutable_data<T>(ctx.GetPlace()));
-      functor(param->numel());
+      // The dense param is updated as one row.
+      const int64_t numel = param->numel();
+      const int64_t row = 0;
+      jit::adam_attr_t attr(1, numel, 1, numel, 1, beta1, beta2, epsilon);
+      T* param_out_data =
+          InplaceAdamOutput<T>(*param, param_out, ctx.GetPlace());
+      T* mom1_out_data = InplaceAdamOutput<T>(*mom1, mom1_out, ctx.GetPlace());
+      T* mom2_out_data = InplaceAdamOutput<T>(*mom2, mom2_out, ctx.GetPlace());
+      auto adam =
+          jit::KernelFuncs<jit::AdamTuple<T>, platform::CPUPlace>::Cache().At(
+              attr);
+      adam(lr->data<T>(), beta1_pow->data<T>(), beta2_pow->data<T>(),
+           grad->data<T>(), &row, param_out_data, mom1_out_data, mom2_out_data,
+           &attr);
       if (!use_global_beta_pow) {
         beta1_pow_out->mutable_data<T>(ctx.GetPlace())[0] =
             beta1 * beta1_pow->data<T>()[0];
@@ -570,14 +593,21 @@ class AdamOpKernel : public framework::OpKernel<T> {
       }
       if (lazy_mode) {
         VLOG(3) << "run cpu lazy mode";
-        size_t row_count = grad_merge.rows().size();
-        std::vector<int64_t> cpu_rows(grad_merge.rows());
-        for (size_t row_index = 0; row_index < row_count; ++row_index) {
-          for (size_t offset = 0; offset < row_numel; ++offset) {
-            size_t i = cpu_rows[row_index] * row_numel + offset;
-            functor.adam_update(i, grad_data[row_index * row_numel + offset]);
-          }
-        }
+        int64_t row_count = static_cast<int64_t>(grad_merge.rows().size());
+        jit::adam_attr_t attr(param->dims()[0], row_numel, row_count,
+                              row_numel, row_count, beta1, beta2, epsilon);
+        T* param_out_data =
+            InplaceAdamOutput<T>(*param, param_out, ctx.GetPlace());
+        T* mom1_out_data =
+            InplaceAdamOutput<T>(*mom1, mom1_out, ctx.GetPlace());
+        T* mom2_out_data =
+            InplaceAdamOutput<T>(*mom2, mom2_out, ctx.GetPlace());
+        auto adam =
+            jit::KernelFuncs<jit::AdamTuple<T>, platform::CPUPlace>::Cache().At(
+                attr);
+        adam(lr->data<T>(), beta1_pow->data<T>(), beta2_pow->data<T>(),
+             grad_data, rows, param_out_data, mom1_out_data, mom2_out_data,
+             &attr);
       }
 #ifndef _WIN32
       else if (FLAGS_inner_op_parallelism > 1 &&  // NOLINT
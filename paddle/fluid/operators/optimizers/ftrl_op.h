@@ -13,8 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <algorithm>
 #include "paddle/fluid/framework/eigen.h"
 #include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/operators/jit/kernels.h"
 #include "paddle/fluid/operators/math/selected_rows_functor.h"
 #include "paddle/fluid/platform/for_range.h"
 
@@ -193,6 +195,27 @@ class FTRLOpKernel : public framework::OpKernel<T> {
       auto row_numel = static_cast<int64_t>(merged_grad->value().dims()[1]);
       auto row_height = static_cast<int64_t>(merged_grad->rows().size());
 
+      if (platform::is_cpu_place(ctx.GetPlace())) {
+        // The jit kernel updates the selected rows inplace.
+        auto inplace_output = [&](const Tensor& in, Tensor* out) {
+          T* out_data = out->mutable_data<T>(ctx.GetPlace());
+          if (out_data != in.data<T>()) {
+            std::copy(in.data<T>(), in.data<T>() + in.numel(), out_data);
+          }
+          return out_data;
+        };
+        jit::ftrl_attr_t attr(param_in->dims()[0], row_numel, row_height,
+                              row_numel, row_height, l1, l2, lr_power);
+        auto ftrl =
+            jit::KernelFuncs<jit::FtrlTuple<T>, platform::CPUPlace>::Cache().At(
+                attr);
+        ftrl(lr_in->data<T>(), merged_grad->value().data<T>(), rows,
+             inplace_output(*param_in, param_out),
+             inplace_output(*sq_accum_in, sq_accum_out),
+             inplace_output(*lin_accum_in, lin_accum_out), &attr);
+        return;
+      }
+
       platform::ForRange<DeviceContext> for_range(
           static_cast<const DeviceContext&>(ctx.device_context()),
           row_numel * row_height);
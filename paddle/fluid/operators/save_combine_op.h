@@ -22,11 +22,14 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/async_file_writer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/port.h"
 
+DECLARE_bool(async_save);
+
 namespace paddle {
 namespace operators {
 template <typename DeviceContext, typename T>
@@ -40,6 +43,9 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
     auto save_to_memory = ctx.Attr<bool>("save_to_memory");
     auto output = ctx.Output<std::string>("Y");
 
+    if (!save_to_memory) {
+      framework::AsyncFileWriter::Instance().Wait(filename);
+    }
     bool is_present = FileExists(filename);
     if (is_present && !overwrite) {
       PADDLE_THROW(platform::errors::PreconditionNotMet(
@@ -103,6 +109,10 @@ class SaveCombineOpKernel : public framework::OpKernel<T> {
       *output = ss.str();
     } else {
       MkDirRecursively(DirName(filename).c_str());
+      if (FLAGS_async_save) {
+        framework::AsyncFileWriter::Instance().Write(filename, ss.str());
+        return;
+      }
       std::ofstream fout(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
                         platform::errors::Unavailable(
@@ -20,6 +20,9 @@ limitations under the License. */
 #include "paddle/fluid/platform/bfloat16.h"
 #include "paddle/fluid/platform/float16.h"
 
+DECLARE_bool(async_save);
+DECLARE_int32(load_combine_num_threads);
+
 USE_CPU_ONLY_OP(save_combine);
 USE_CPU_ONLY_OP(load_combine);
 
@@ -143,6 +146,21 @@ void SaveLoadCombineOp() {
 
 TEST(SaveLoadCombineOp, CPU) { SaveLoadCombineOp<int, int>(); }
 
+TEST(SaveLoadCombineOpInParallel, CPU) {
+  int num_threads = FLAGS_load_combine_num_threads;
+  FLAGS_load_combine_num_threads = 3;
+  SaveLoadCombineOp<int, int>();
+  SaveLoadCombineOp<paddle::platform::bfloat16, paddle::platform::bfloat16>();
+  FLAGS_load_combine_num_threads = num_threads;
+}
+
+TEST(SaveLoadCombineOpAsync, CPU) {
+  FLAGS_async_save = true;
+  // load_combine waits for the file written in the background
+  SaveLoadCombineOp<int, int>();
+  FLAGS_async_save = false;
+}
+
 TEST(SaveLoadCombineBF16Op, CPU) {
   SaveLoadCombineOp<paddle::platform::bfloat16, paddle::platform::bfloat16>();
 }
@@ -14,16 +14,20 @@ limitations under the License. */
 #include <stdint.h>
 #include <fstream>
 #include <numeric>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/async_file_writer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/selected_rows.h"
 #include "paddle/fluid/framework/variable.h"
 
+DECLARE_bool(async_save);
+
 namespace paddle {
 namespace operators {
 // define LOOKUP_TABLE_PATH for checkpoint notify to save lookup table variables
@@ -46,6 +50,7 @@ class SaveOpKernel : public framework::OpKernel<T> {
 
     VLOG(4) << "save output file_path: " << filename;
 
+    framework::AsyncFileWriter::Instance().Wait(filename);
     PADDLE_ENFORCE_EQ(
         FileExists(filename) && !overwrite, false,
         platform::errors::PreconditionNotMet(
@@ -78,10 +83,9 @@ class SaveOpKernel : public framework::OpKernel<T> {
 
     // FIXME(yuyang18): We save variable to local file now, but we should change
     // it to save an output stream.
-    std::ofstream fout(filename, std::ios::binary);
-    PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
-                      platform::errors::Unavailable(
-                          "Cannot open %s to save variables.", filename));
+    std::ostringstream ss;
+    std::ofstream fout;
+    std::ostream &os = OpenOutputStream(filename, &ss, &fout);
 
     auto save_as_fp16 = ctx.Attr<bool>("save_as_fp16");
     auto in_dtype = tensor.type();
@@ -94,11 +98,11 @@ class SaveOpKernel : public framework::OpKernel<T> {
       framework::TransDataType(in_kernel_type, out_kernel_type, tensor, &out);
       // copy LoD info to the new tensor
       out.set_lod(tensor.lod());
-      framework::SerializeToStream(fout, out, dev_ctx);
+      framework::SerializeToStream(os, out, dev_ctx);
     } else {
-      framework::SerializeToStream(fout, tensor, dev_ctx);
+      framework::SerializeToStream(os, tensor, dev_ctx);
     }
-    fout.close();
+    CloseOutputStream(filename, &ss, &fout);
   }
 
   void SaveSelectedRows(const framework::ExecutionContext &ctx,
@@ -113,12 +117,36 @@ class SaveOpKernel : public framework::OpKernel<T> {
 
     // FIXME(yuyang18): We save variable to local file now, but we should change
     // it to save an output stream.
-    std::ofstream fout(filename, std::ios::binary);
-    PADDLE_ENFORCE_EQ(static_cast<bool>(fout), true,
+    std::ostringstream ss;
+    std::ofstream fout;
+    std::ostream &os = OpenOutputStream(filename, &ss, &fout);
+    framework::SerializeToStream(os, selectedRows, dev_ctx);
+    CloseOutputStream(filename, &ss, &fout);
+  }
+
+ private:
+  // With FLAGS_async_save, the variable is serialized into `ss` and written
+  // to the file in the background by AsyncFileWriter.
+  std::ostream &OpenOutputStream(const std::string &filename,
+                                 std::ostringstream *ss,
+                                 std::ofstream *fout) const {
+    if (FLAGS_async_save) {
+      return *ss;
+    }
+    fout->open(filename, std::ios::binary);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(*fout), true,
                       platform::errors::Unavailable(
                           "Cannot open %s to save variables.", filename));
-    framework::SerializeToStream(fout, selectedRows, dev_ctx);
-    fout.close();
+    return *fout;
+  }
+
+  void CloseOutputStream(const std::string &filename, std::ostringstream *ss,
+                         std::ofstream *fout) const {
+    if (FLAGS_async_save) {
+      framework::AsyncFileWriter::Instance().Write(filename, ss->str());
+    } else {
+      fout->close();
+    }
   }
 };
 
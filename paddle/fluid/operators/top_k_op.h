@@ -15,10 +15,13 @@ limitations under the License. */
 #pragma once
 #include <algorithm>
 #include <iostream>
+#include <new>
 #include <utility>
 #include <vector>
 #include "paddle/fluid/framework/eigen.h"
 #include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 
 namespace paddle {
 namespace operators {
@@ -52,36 +55,37 @@ class TopkKernel : public framework::OpKernel<T> {
     const size_t row = framework::product(
         framework::slice_ddim(inputdims, 0, inputdims.size() - 1));
     const size_t col = inputdims[inputdims.size() - 1];
-    Eigen::DSizes<int, 2> flat2dims(row, col);
-// NOTE: eigen shape doesn't affect paddle tensor.
+    const T* input_data = input->data<T>();
+
+    // The rows are split into one chunk per thread, and each chunk sorts its
+    // rows one by one in its own part of the scratch buffer.
+    const int num_chunks =
+        std::max(std::min<int>(row, platform::GetNumThreads()), 1);
+    auto scratch = memory::AllocScratch(
+        ctx.device_context(),
+        num_chunks * col * sizeof(std::pair<T, size_t>));
+    auto* vecs = static_cast<std::pair<T, size_t>*>(scratch->ptr());
 #ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
+#pragma omp parallel for num_threads(num_chunks)
 #endif
-    for (size_t i = 0; i < row; i++) {
-      std::vector<std::pair<T, size_t>> vec;
-      vec.reserve(col);
-      // 1D vector
-      if (inputdims.size() == 1) {
-        auto eg_input = framework::EigenVector<T>::Flatten(*input);
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+      std::pair<T, size_t>* vec = vecs + chunk * col;
+      size_t begin = row * chunk / num_chunks;
+      size_t end = row * (chunk + 1) / num_chunks;
+      for (size_t i = begin; i < end; i++) {
         for (size_t j = 0; j < col; j++) {
-          vec.push_back(std::pair<T, size_t>(eg_input(j), j));
+          new (vec + j) std::pair<T, size_t>(input_data[i * col + j], j);
         }
-      } else {
-        auto eg_input =
-            framework::EigenMatrix<T>::Reshape(*input, inputdims.size() - 1);
-        for (size_t j = 0; j < col; j++) {
-          vec.push_back(std::pair<T, size_t>(eg_input(i, j), j));
-        }
-      }
 
-      std::partial_sort(
-          vec.begin(), vec.begin() + k, vec.end(),
-          [](const std::pair<T, size_t>& l, const std::pair<T, size_t>& r) {
-            return l.first > r.first;
-          });
-      for (size_t j = 0; j < k; j++) {
-        output_data[i * k + j] = vec[j].first;
-        indices_data[i * k + j] = int64_t(vec[j].second);
+        std::partial_sort(
+            vec, vec + k, vec + col,
+            [](const std::pair<T, size_t>& l, const std::pair<T, size_t>& r) {
+              return l.first > r.first;
+            });
+        for (size_t j = 0; j < k; j++) {
+          output_data[i * k + j] = vec[j].first;
+          indices_data[i * k + j] = int64_t(vec[j].second);
+        }
       }
     }
   }
@@ -14,6 +14,12 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#include <atomic>
+#include <exception>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <vector>
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -27,6 +33,10 @@ limitations under the License. */
 namespace paddle {
 namespace platform {
 
+// The number of threads set by SetNumThreads, used by the parallel loops when
+// they do not run with OpenMP.
+static std::atomic<int> num_threads_set{1};
+
 void SetNumThreads(int num_threads) {
 #ifdef PADDLE_USE_OPENBLAS
 // windows has no support for openblas multi-thread
@@ -37,13 +47,15 @@ void SetNumThreads(int num_threads) {
   }
 #endif
   int real_num_threads = num_threads > 1 ? num_threads : 1;
+  num_threads_set = real_num_threads;
   openblas_set_num_threads(real_num_threads);
 #elif defined(PADDLE_WITH_MKLML)
   int real_num_threads = num_threads > 1 ? num_threads : 1;
   platform::dynload::MKL_Set_Num_Threads(real_num_threads);
   omp_set_num_threads(real_num_threads);
 #elif defined(PADDLE_USE_REFERENCE_CBLAS)
-  // cblas not support multi-thread
+  // cblas not support multi-thread, but the parallel loops do
+  num_threads_set = num_threads > 1 ? num_threads : 1;
   return;
 #else
   PADDLE_THROW(platform::errors::Unimplemented(
@@ -52,5 +64,92 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+int GetNumThreads() {
+#ifdef PADDLE_WITH_MKLML
+  return omp_get_max_threads();
+#else
+  return num_threads_set;
+#endif
+}
+
+#if !defined(PADDLE_WITH_MKLML) && defined(PADDLE_USE_OPENBLAS)
+// Keeps OpenBLAS single-threaded while any parallel loop runs, and restores
+// the number of threads set by SetNumThreads after the last one.
+class SingleThreadedBlasGuard {
+ public:
+  SingleThreadedBlasGuard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (num_loops_++ == 0) {
+      openblas_set_num_threads(1);
+    }
+  }
+  ~SingleThreadedBlasGuard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_loops_ == 0) {
+      openblas_set_num_threads(num_threads_set);
+    }
+  }
+
+ private:
+  static std::mutex mutex_;
+  static int num_loops_;
+};
+
+std::mutex SingleThreadedBlasGuard::mutex_;
+int SingleThreadedBlasGuard::num_loops_ = 0;
+#endif
+
+void ParallelFor(int n, const std::function<void(int)>& fn) {
+  if (n <= 1) {
+    for (int i = 0; i < n; ++i) {
+      fn(i);
+    }
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+  // MKL runs single-threaded inside the parallel region.
+  std::exception_ptr error;
+#pragma omp parallel for num_threads(n)
+  for (int i = 0; i < n; ++i) {
+    try {
+      fn(i);
+    } catch (...) {
+#pragma omp critical
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+#else
+#ifdef PADDLE_USE_OPENBLAS
+  SingleThreadedBlasGuard blas_guard;
+#endif
+  std::vector<std::future<void>> futures;
+  futures.reserve(n - 1);
+  for (int i = 1; i < n; ++i) {
+    futures.emplace_back(std::async(std::launch::async, [&fn, i] { fn(i); }));
+  }
+  std::exception_ptr error;
+  try {
+    fn(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // fn may refer to the caller's stack, so all the threads are joined first.
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+#endif
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 }  // namespace platform
 }  // namespace paddle
@@ -16,11 +16,20 @@ limitations under the License. */
 
 #include <stddef.h>
 
+#include <functional>
+
 namespace paddle {
 namespace platform {
 
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Get the number of threads of the parallel loops in the CPU kernels.
+int GetNumThreads();
+
+//! Run fn(i) for every i in [0, n) on n threads, and rethrow the first error
+//! after all of them finish. The BLAS runs single-threaded inside fn.
+void ParallelFor(int n, const std::function<void(int)>& fn);
+
 }  // namespace platform
 }  // namespace paddle
@@ -14,9 +14,40 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#include <stdexcept>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(CpuHelper, SetNumThread) {
   paddle::platform::SetNumThreads(1);
   paddle::platform::SetNumThreads(4);
 }
+
+TEST(CpuHelper, GetNumThreads) {
+  paddle::platform::SetNumThreads(4);
+#if defined(_WIN32) && defined(PADDLE_USE_OPENBLAS)
+  EXPECT_EQ(paddle::platform::GetNumThreads(), 1);
+#else
+  EXPECT_EQ(paddle::platform::GetNumThreads(), 4);
+#endif
+  paddle::platform::SetNumThreads(1);
+  EXPECT_EQ(paddle::platform::GetNumThreads(), 1);
+}
+
+TEST(CpuHelper, ParallelFor) {
+  std::vector<int> done(4, 0);
+  paddle::platform::ParallelFor(4, [&done](int i) { done[i] += i + 1; });
+  EXPECT_EQ(done, std::vector<int>({1, 2, 3, 4}));
+
+  // an error is rethrown after all the others ran
+  EXPECT_THROW(paddle::platform::ParallelFor(4,
+                                             [&done](int i) {
+                                               done[i] = 0;
+                                               if (i == 2) {
+                                                 throw std::runtime_error("");
+                                               }
+                                             }),
+               std::runtime_error);
+  EXPECT_EQ(done, std::vector<int>({0, 0, 0, 0}));
+}
@@ -12,6 +12,8 @@ limitations under the License. */
 #include "paddle/fluid/platform/device_context.h"
 #include <set>
 
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/fluid/memory/allocation/cuda_device_context_allocator.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
@@ -59,6 +61,15 @@ AllocationPtr Alloc(const platform::DeviceContext& dev_ctx, size_t size) {
   }
 }
 
+AllocationPtr AllocScratch(const platform::DeviceContext& dev_ctx,
+                           size_t size) {
+  if (size == 0 || !platform::is_cpu_place(dev_ctx.GetPlace())) {
+    return Alloc(dev_ctx, size);
+  }
+  auto& cpu_dev_ctx = static_cast<const platform::CPUDeviceContext&>(dev_ctx);
+  return cpu_dev_ctx.workspace_allocator()->Allocate(size);
+}
+
 }  // namespace memory
 }  // namespace paddle
 
@@ -183,10 +194,14 @@ DeviceContextPool::DeviceContextPool(
 
 CPUDeviceContext::CPUDeviceContext() {
   eigen_device_.reset(new Eigen::DefaultDevice());
+  workspace_allocator_.reset(new memory::allocation::CPUWorkspaceAllocator(
+      std::make_shared<memory::allocation::CPUAllocator>()));
 }
 
 CPUDeviceContext::CPUDeviceContext(CPUPlace place) : place_(place) {
   eigen_device_.reset(new Eigen::DefaultDevice());
+  workspace_allocator_.reset(new memory::allocation::CPUWorkspaceAllocator(
+      std::make_shared<memory::allocation::CPUAllocator>()));
 }
 
 Eigen::DefaultDevice* CPUDeviceContext::eigen_device() const {
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <utility>
 #include <vector>
 
+#include "paddle/fluid/memory/allocation/cpu_workspace_allocator.h"
 #include "paddle/fluid/memory/malloc.h"
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/platform/cuda_helper.h"
@@ -126,9 +127,17 @@ class CPUDeviceContext : public DeviceContext {
 
   Place GetPlace() const override;
 
+  /*! \brief  Return the allocator of the scratch memory of the kernels,
+   *  which allocates from the stack-like workspace of the calling thread. */
+  memory::allocation::CPUWorkspaceAllocator* workspace_allocator() const {
+    return workspace_allocator_.get();
+  }
+
  private:
   CPUPlace place_;
   std::unique_ptr<Eigen::DefaultDevice> eigen_device_;
+  std::unique_ptr<memory::allocation::CPUWorkspaceAllocator>
+      workspace_allocator_;
 };
 
 template <typename Place>
@@ -627,6 +627,58 @@ PADDLE_DEFINE_EXPORTED_string(
     tracer_mkldnn_ops_off, "",
     "List of OneDNN operation types to be turned off");
 
+/**
+ * Dygraph related FLAG
+ * Name: FLAGS_tracer_op_cache_capacity
+ * Since Version: 2.2.0
+ * Value Range: int32, default=4096
+ * Example: FLAGS_tracer_op_cache_capacity=0 would disable the cache.
+ * Note: The maximum number of entries in the prepared op cache of the dygraph
+ *       Tracer, which reuses the operator instance, the checked attributes
+ *       and the selected kernel of the ops traced with the same type,
+ *       attributes, input types and place. The least recently used entry is
+ *       evicted when full. Only the ops in FLAGS_tracer_op_cache_ops are
+ *       cached.
+ */
+PADDLE_DEFINE_EXPORTED_int32(
+    tracer_op_cache_capacity, 4096,
+    "The maximum number of entries in the prepared op cache of Tracer, 0 "
+    "disables the cache.");
+
+/**
+ * Dygraph related FLAG
+ * Name: FLAGS_tracer_op_cache_ops
+ * Since Version: 2.2.0
+ * Value Range: string, default=""
+ * Example: FLAGS_tracer_op_cache_ops="matmul_v2,elementwise_add" would cache
+ *          the matmul_v2 and elementwise_add ops.
+ * Note: The op types cached by the prepared op cache of the dygraph Tracer,
+ *       separated by commas. The cache is disabled when empty. Only the ops
+ *       whose kernel choice depends on nothing but the attributes and the
+ *       types and places of the inputs can be cached.
+ */
+PADDLE_DEFINE_EXPORTED_string(
+    tracer_op_cache_ops, "",
+    "The op types cached by the prepared op cache of Tracer, separated by "
+    "commas. Empty disables the cache.");
+
+/**
+ * Dygraph related FLAG
+ * Name: FLAGS_dygraph_backward_num_threads
+ * Since Version: 2.2.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_dygraph_backward_num_threads=4 would run the independent grad
+ *          ops of a backward pass on 4 threads.
+ * Note: If larger than 1 and all the grad ops are on CPU, the ready grad nodes
+ *       of the dygraph backward pass run in parallel. Set
+ *       FLAGS_sort_sum_gradient=true as well to get deterministic gradients,
+ *       otherwise the order of the gradient summation depends on the timing.
+ */
+PADDLE_DEFINE_EXPORTED_int32(
+    dygraph_backward_num_threads, 0,
+    "The number of threads to run the grad ops of dygraph backward on CPU, "
+    "0 or 1 runs them on the calling thread.");
+
 /**
  * Debug related FLAG
  * Name: check_kernel_launch
@@ -681,6 +733,53 @@ PADDLE_DEFINE_EXPORTED_bool(
     apply_pass_to_program, false,
     "It controls whether to apply IR pass to program when using Fleet APIs");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_load_combine_num_threads
+ * Since Version: 2.2.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_load_combine_num_threads=8 would read and deserialize the
+ *          parameters of a combined file with 8 threads.
+ * Note: Only used by load_combine op when loading from a file to CPUPlace.
+ *       A value no greater than 1 keeps the sequential loading.
+ */
+PADDLE_DEFINE_EXPORTED_int32(
+    load_combine_num_threads, 1,
+    "Number of threads used by load_combine op to load the parameters of a "
+    "combined file on CPU.");
+
+/**
+ * Operator related FLAG
+ * Name: FLAGS_async_save
+ * Since Version: 2.2.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_async_save=true would let save and save_combine op return
+ *          once the variables are serialized into memory, and write the
+ *          files in a background thread.
+ * Note: Call paddle.fluid.core.wait_async_save() to wait for the files.
+ *       Loading a file that is being written waits for it.
+ */
+PADDLE_DEFINE_EXPORTED_bool(
+    async_save, false,
+    "Whether save and save_combine op write the files in a background "
+    "thread.");
+
+/**
+ * Performance related FLAG
+ * Name: FLAGS_cost_model_profile_path
+ * Since Version: 2.2.0
+ * Value Range: string, default=""
+ * Example: FLAGS_cost_model_profile_path=./cost.txt would load the cost data
+ *          saved by CostData::Save, and let the executors and the IR passes
+ *          query it to make cost-driven choices.
+ * Note: The profile is measured by CostModel::ProfileMeasure on the same
+ *       model and device. Empty means no profile is used.
+ */
+PADDLE_DEFINE_EXPORTED_string(
+    cost_model_profile_path, "",
+    "The path of the cost data profiled by CostModel, which is queried by "
+    "the executors and the IR passes. Empty means no profile is used.");
+
 DEFINE_int32(record_pool_max_size, 2000000,
              "SlotRecordDataset slot record pool max size");
 DEFINE_int32(slotpool_thread_num, 1, "SlotRecordDataset slot pool thread num");
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace paddle {
+namespace platform {
+
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kOctaves;
+constexpr int LatencyHistogram::kNumBuckets;
+
+int LatencyHistogram::BucketIndex(double us) {
+  if (!(us >= 1.0)) {
+    return 0;
+  }
+  int exp = 0;
+  // us = frac * 2^exp, with frac in [0.5, 1).
+  double frac = std::frexp(us, &exp);
+  int octave = exp - 1;
+  if (octave >= kOctaves) {
+    return kNumBuckets - 1;
+  }
+  int sub = static_cast<int>((frac * 2.0 - 1.0) * kSubBuckets);
+  return 1 + octave * kSubBuckets + std::min(sub, kSubBuckets - 1);
+}
+
+double LatencyHistogram::BucketLower(int index) {
+  if (index == 0) {
+    return 0.0;
+  }
+  int octave = (index - 1) / kSubBuckets;
+  int sub = (index - 1) % kSubBuckets;
+  return std::ldexp(1.0 + static_cast<double>(sub) / kSubBuckets, octave);
+}
+
+void LatencyHistogram::Record(double us) {
+  buckets_[BucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(static_cast<uint64_t>(std::max(us, 0.0) * 1000.0),
+                    std::memory_order_relaxed);
+}
+
+double LatencyHistogram::Mean() const {
+  uint64_t count = Count();
+  if (count == 0) {
+    return 0.0;
+  }
+  return sum_ns_.load(std::memory_order_relaxed) / 1000.0 / count;
+}
+
+double LatencyHistogram::Percentile(double q) const {
+  // The buckets may be recorded to meanwhile, so the total is summed from the
+  // same loads as the ranks.
+  std::array<uint64_t, kNumBuckets> counts;
+  uint64_t total = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+  double rank = std::min(std::max(q, 0.0), 1.0) * total;
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    if (seen + counts[i] >= rank) {
+      double lower = BucketLower(i);
+      // The last bucket is open, report its lower bound.
+      if (i == kNumBuckets - 1) {
+        return lower;
+      }
+      double upper = BucketLower(i + 1);
+      return lower + (upper - lower) * (rank - seen) / counts[i];
+    }
+    seen += counts[i];
+  }
+  return BucketLower(kNumBuckets - 1);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_ns_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace platform
+}  // namespace paddle
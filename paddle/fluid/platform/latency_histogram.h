@@ -0,0 +1,61 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "paddle/fluid/platform/macros.h"
+
+namespace paddle {
+namespace platform {
+
+// A histogram of latencies in microseconds, which can be recorded to from
+// several threads without a lock. The buckets are 4 per power of 2 from 1us
+// to about 2 minutes, so a percentile is within 25% of the exact one.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() { Reset(); }
+
+  void Record(double us);
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  double Mean() const;
+  // The q-th quantile, e.g. 0.99 for p99, interpolated in the bucket.
+  // 0 if nothing is recorded.
+  double Percentile(double q) const;
+
+  void Reset();
+
+ private:
+  static constexpr int kSubBuckets = 4;
+  static constexpr int kOctaves = 27;
+  // The first bucket is for the latencies under 1us.
+  static constexpr int kNumBuckets = 1 + kSubBuckets * kOctaves;
+
+  static int BucketIndex(double us);
+  static double BucketLower(int index);
+
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+  std::atomic<uint64_t> count_;
+  // In nanoseconds, to be added atomically as an integer.
+  std::atomic<uint64_t> sum_ns_;
+
+  DISABLE_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+}  // namespace platform
+}  // namespace paddle
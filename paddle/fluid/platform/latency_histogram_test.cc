@@ -0,0 +1,68 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/platform/latency_histogram.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace platform {
+
+TEST(LatencyHistogram, Percentile) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0UL);
+  EXPECT_EQ(histogram.Percentile(0.5), 0.0);
+
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.Record(i);
+  }
+  EXPECT_EQ(histogram.Count(), 1000UL);
+  EXPECT_NEAR(histogram.Mean(), 500.5, 1e-6);
+  // The buckets are within 25% of their lower bounds.
+  EXPECT_NEAR(histogram.Percentile(0.5), 500.0, 500.0 * 0.25);
+  EXPECT_NEAR(histogram.Percentile(0.99), 990.0, 990.0 * 0.25);
+  EXPECT_LE(histogram.Percentile(0.5), histogram.Percentile(0.99));
+
+  histogram.Record(0.1);
+  histogram.Record(1e12);
+  EXPECT_EQ(histogram.Count(), 1002UL);
+  EXPECT_LT(histogram.Percentile(0.0), 1.0);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0UL);
+  EXPECT_EQ(histogram.Mean(), 0.0);
+}
+
+TEST(LatencyHistogram, MultiThread) {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram] {
+      for (int i = 0; i < 10000; ++i) {
+        histogram.Record(100.0);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.Count(), 40000UL);
+  EXPECT_NEAR(histogram.Percentile(0.5), 100.0, 100.0 * 0.25);
+}
+
+}  // namespace platform
+}  // namespace paddle
@@ -100,6 +100,10 @@ class StatRegistry {
     stats_.insert(std::make_pair(name, stat));
     return 0;
   }
+  void remove(const std::string& name) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    stats_.erase(name);
+  }
 
   void publish(std::vector<ExportedStatValue<T>>& exported,  // NOLINT
                bool reset = false) {
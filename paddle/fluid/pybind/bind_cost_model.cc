@@ -30,7 +30,30 @@ void BindCostModel(py::module* m) {
   py::class_<CostData>(*m, "CostData")
       .def(py::init<>())
       .def("get_whole_time_ms", &CostData::GetWholeTimeMs)
-      .def("get_op_time_ms", &CostData::GetOpTimeMs);
+      .def("get_whole_memory_bytes", &CostData::GetWholeMemoryBytes)
+      .def("get_whole_peak_memory_bytes", &CostData::GetWholePeakMemoryBytes)
+      .def("get_op_time_ms",
+           [](const CostData& self, int op_id) {
+             return self.GetOpTimeMs(op_id);
+           })
+      .def("get_op_time_ms",
+           [](const CostData& self, int block_id, int op_id) {
+             return self.GetOpTimeMs(block_id, op_id);
+           })
+      .def("get_op_run_count", &CostData::GetOpRunCount)
+      .def("get_op_memory_bytes",
+           [](const CostData& self, int op_id) {
+             return self.GetOpMemoryBytes(op_id);
+           })
+      .def("get_op_memory_bytes",
+           [](const CostData& self, int block_id, int op_id) {
+             return self.GetOpMemoryBytes(block_id, op_id);
+           })
+      .def("get_op_peak_memory_bytes", &CostData::GetOpPeakMemoryBytes)
+      .def("get_op_type_time_ms", &CostData::GetOpTypeTimeMs)
+      .def("get_op_type_memory_bytes", &CostData::GetOpTypeMemoryBytes)
+      .def("save", &CostData::Save)
+      .def("load", &CostData::Load);
 
   py::class_<CostModel>(*m, "CostModel")
       .def(py::init<>())
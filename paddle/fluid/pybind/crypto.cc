@@ -14,12 +14,15 @@
 
 #include "paddle/fluid/pybind/crypto.h"
 
+#include <fstream>
 #include <memory>
 #include <string>
 
 #include "paddle/fluid/framework/io/crypto/aes_cipher.h"
 #include "paddle/fluid/framework/io/crypto/cipher.h"
+#include "paddle/fluid/framework/io/crypto/cipher_stream.h"
 #include "paddle/fluid/framework/io/crypto/cipher_utils.h"
+#include "paddle/fluid/platform/enforce.h"
 
 namespace py = pybind11;
 
@@ -86,6 +89,26 @@ void BindCipher(py::module* m) {
            [](Cipher& c, const std::string& key, const std::string& filename) {
              std::string ret = c.DecryptFromFile(key, filename);
              return py::bytes(ret);
+           })
+      .def("encrypt_file_by_chunk",
+           [](Cipher& c, const std::string& input_filename,
+              const std::string& key, const std::string& filename,
+              size_t chunk_size) {
+             std::ifstream fin(input_filename, std::ios::binary);
+             PADDLE_ENFORCE_EQ(fin.is_open(), true,
+                               platform::errors::Unavailable(
+                                   "Failed to open file %s.", input_filename));
+             std::ofstream fout(filename, std::ios::binary);
+             framework::EncryptStream(&c, key, &fin, &fout, chunk_size);
+           },
+           py::arg("input_filename"), py::arg("key"), py::arg("filename"),
+           py::arg("chunk_size") = framework::kCipherStreamChunkSize)
+      .def("decrypt_from_chunked_file",
+           [](Cipher& c, const std::string& key, const std::string& filename) {
+             framework::DecryptInputStream fin(&c, key, filename);
+             std::string ret{std::istreambuf_iterator<char>(fin),
+                             std::istreambuf_iterator<char>()};
+             return py::bytes(ret);
            });
 }
 
@@ -24,6 +24,7 @@ limitations under the License. */
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -1951,6 +1952,16 @@ void BindImperative(py::module *m_ptr) {
                     &imperative::Tracer::SetAMPLevel)
       .def_property("_has_grad", &imperative::Tracer::HasGrad,
                     &imperative::Tracer::SetHasGrad)
+      .def("_op_cache_stats",
+           [](imperative::Tracer &self) {
+             auto *op_cache = self.GetPreparedOpCache();
+             return std::make_tuple(op_cache->Hits(), op_cache->Misses(),
+                                    op_cache->Size());
+           })
+      .def("_clear_op_cache",
+           [](imperative::Tracer &self) {
+             self.GetPreparedOpCache()->Clear();
+           })
       .def_property(
           "_expected_place",
           [](const imperative::Tracer &self) -> py::object {
@@ -618,6 +618,10 @@ void BindAnalysisConfig(py::module *m) {
       .def("set_mkldnn_op", &AnalysisConfig::SetMKLDNNOp)
       .def("set_model_buffer", &AnalysisConfig::SetModelBuffer)
       .def("model_from_memory", &AnalysisConfig::model_from_memory)
+      .def("set_model_decryption", &AnalysisConfig::SetModelDecryption,
+           py::arg("cipher_config_file"), py::arg("key"))
+      .def("model_decryption_enabled",
+           &AnalysisConfig::model_decryption_enabled)
       .def("delete_pass",
            [](AnalysisConfig &self, const std::string &pass) {
              self.pass_builder()->DeletePass(pass);
@@ -36,6 +36,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/feed_fetch_method.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/garbage_collector.h"
+#include "paddle/fluid/framework/io/async_file_writer.h"
 #include "paddle/fluid/framework/io/fs.h"
 #include "paddle/fluid/framework/ir/coalesce_grad_tensor_pass.h"
 #include "paddle/fluid/framework/ir/cost_model.h"
@@ -577,6 +578,10 @@ PYBIND11_MODULE(core_noavx, m) {
         &pb_vmap);
   });
 
+  m.def("wait_async_save",
+        [] { framework::AsyncFileWriter::Instance().WaitAll(); },
+        py::call_guard<py::gil_scoped_release>());
+
   m.def("set_printoptions", [](const py::kwargs &kwargs) {
     auto &print_opt = framework::PrintOptions::Instance();
     if (kwargs.contains("precision")) {
@@ -285,6 +285,10 @@ class DownpourSGD(DeviceWorker):
                 dense_table.dense_grad_name.extend(
                     i.dense_gradient_variable_name)
         downpour.skip_ops.extend(worker.get_desc().skip_op)
+        if opt_info.get("pipeline_pull_sparse"):
+            downpour.pipeline_pull_sparse = True
+        if opt_info.get("max_inflight_push"):
+            downpour.max_inflight_push = opt_info["max_inflight_push"]
         if self._infer:
             downpour.push_dense = False
             downpour.push_sparse = False
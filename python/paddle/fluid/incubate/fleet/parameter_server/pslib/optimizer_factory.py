@@ -832,6 +832,9 @@ class DistributedAdam(DistributedOptimizerImplBase):
         opt_info["worker_class"] = strategy.get("worker_class",
                                                 "DownpourWorker")
         opt_info["stat_var_names"] = strategy.get("stat_var_names", [])
+        opt_info["pipeline_pull_sparse"] = strategy.get("pipeline_pull_sparse",
+                                                        False)
+        opt_info["max_inflight_push"] = strategy.get("max_inflight_push", 0)
         opt_info["local_tables"] = strategy.get("local_tables", [])
         opt_info["async_tables"] = strategy.get("async_tables", [])
         opt_info["async_tables"] = strategy.get("async_tables", [])
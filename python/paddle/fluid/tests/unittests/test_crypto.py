@@ -45,6 +45,20 @@ class CipherTestCase(unittest.TestCase):
         self.assertEqual(plaintext, plaintext1.decode())
         self.assertEqual(plaintext1, plaintext2)
 
+    def test_aes_cipher_by_chunk(self):
+        plaintext = b"hello world" * 100
+        with open("paddle_aes_test.plaintext", "wb") as f:
+            f.write(plaintext)
+        key = CipherUtils.gen_key(256)
+        cipher = CipherFactory.create_cipher()
+
+        cipher.encrypt_file_by_chunk("paddle_aes_test.plaintext", key,
+                                     "paddle_aes_test.chunked", 64)
+        plaintext1 = cipher.decrypt_from_chunked_file(
+            key, "paddle_aes_test.chunked")
+
+        self.assertEqual(plaintext, plaintext1)
+
 
 if __name__ == '__main__':
     unittest.main()